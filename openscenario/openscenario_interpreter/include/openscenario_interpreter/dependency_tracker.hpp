@@ -0,0 +1,111 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OPENSCENARIO_INTERPRETER__DEPENDENCY_TRACKER_HPP_
+#define OPENSCENARIO_INTERPRETER__DEPENDENCY_TRACKER_HPP_
+
+#include <cstdint>
+#include <string>
+#include <traffic_simulator_msgs/msg/entity_status.hpp>
+#include <unordered_map>
+#include <vector>
+
+namespace openscenario_interpreter
+{
+/* ---- DependencyTracker ------------------------------------------------------
+ *
+ *  Records when the inputs of conditions last changed, so that a condition
+ *  whose inputs did not change since its last evaluation can reuse its
+ *  result instead of asking the simulator again.
+ *
+ *  Time is counted in epochs. The status of every entity some condition
+ *  depends on is compared with the previous frame once per frame by update.
+ *  Everything a storyboard element does when it starts (teleporting or
+ *  spawning entities, setting parameters...) may change any input, so
+ *  invalidate is called then and every condition is evaluated again.
+ *
+ * -------------------------------------------------------------------------- */
+class DependencyTracker
+{
+public:
+  using Epoch = std::uint64_t;
+
+  /**
+   * @brief Inputs of one condition, recorded when the scenario is loaded.
+   * @note A volatile condition depends on something that is not tracked (the simulation time, the
+   * state of other storyboard elements, traffic signals...) and is evaluated every time.
+   */
+  struct Dependencies
+  {
+    bool is_volatile = true;
+
+    std::vector<std::size_t> entities;
+  };
+
+  auto clear() -> void;
+
+  auto enable(bool) -> void;
+
+  auto enabled() const noexcept { return is_enabled; }
+
+  auto epoch() const noexcept { return current_epoch; }
+
+  /**
+   * @brief Returns the identifier of the entity, registering it on first use.
+   */
+  auto track(const std::string & entity_ref) -> std::size_t;
+
+  /**
+   * @brief Compares the status of the tracked entities with the previous frame. Must be called
+   * once per frame before the storyboard is evaluated.
+   */
+  auto update() -> void;
+
+  auto invalidate() -> void;
+
+  /**
+   * @brief Returns true if the inputs may have changed after the epoch, so the condition must be
+   * evaluated again.
+   */
+  auto changedSince(const Dependencies &, Epoch) const -> bool;
+
+private:
+  struct Entity
+  {
+    const std::string name;
+
+    bool exists = false;
+
+    traffic_simulator_msgs::msg::EntityStatus status;
+
+    Epoch changed_epoch;
+  };
+
+  bool is_enabled = false;
+
+  Epoch current_epoch = 1;
+
+  Epoch invalidated_epoch = 1;
+
+  Epoch updated_epoch = 0;
+
+  std::vector<Entity> entities;
+
+  std::unordered_map<std::string, std::size_t> ids;
+};
+
+extern DependencyTracker dependency_tracker;
+}  // namespace openscenario_interpreter
+
+#endif  // OPENSCENARIO_INTERPRETER__DEPENDENCY_TRACKER_HPP_
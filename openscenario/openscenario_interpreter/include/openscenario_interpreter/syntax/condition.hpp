@@ -16,6 +16,7 @@
 #define OPENSCENARIO_INTERPRETER__SYNTAX__CONDITION_HPP_
 
 #include <nlohmann/json.hpp>
+#include <openscenario_interpreter/dependency_tracker.hpp>
 #include <openscenario_interpreter/scope.hpp>
 #include <openscenario_interpreter/syntax/condition_edge.hpp>
 #include <openscenario_interpreter/syntax/double.hpp>
@@ -49,6 +50,11 @@ struct Condition : public ComplexType
 
   bool current_value;
 
+  // Entities the result depends on, recorded when the scenario is loaded.
+  const DependencyTracker::Dependencies dependencies;
+
+  DependencyTracker::Epoch evaluated_epoch = 0;
+
   explicit Condition(const pugi::xml_node & node, Scope & scope);
 
   auto evaluate() -> Object;
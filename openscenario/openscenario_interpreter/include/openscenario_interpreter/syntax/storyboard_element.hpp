@@ -17,6 +17,7 @@
 
 #include <cstddef>
 #include <limits>
+#include <openscenario_interpreter/dependency_tracker.hpp>
 #include <openscenario_interpreter/procedure.hpp>
 #include <openscenario_interpreter/reader/attribute.hpp>
 #include <openscenario_interpreter/scope.hpp>
@@ -165,7 +166,10 @@ protected:
 public:
   auto evaluate()
   {
-    if (stop_trigger.evaluate().as<Boolean>()) {
+    // NOTE: A complete element has nothing left to stop, so its stop trigger is skipped if cached.
+    if (
+      not(dependency_tracker.enabled() and is<StoryboardElementState::completeState>()) and
+      stop_trigger.evaluate().as<Boolean>()) {
       override();
     }
 
@@ -193,6 +197,7 @@ public:
         *
         * ------------------------------------------------------------------- */
         start();
+        dependency_tracker.invalidate();
         ++current_execution_count;
         return current_state = running_state;
 
@@ -0,0 +1,108 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <boost/optional.hpp>
+#include <openscenario_interpreter/dependency_tracker.hpp>
+#include <openscenario_interpreter/procedure.hpp>
+#include <string>
+
+namespace openscenario_interpreter
+{
+DependencyTracker dependency_tracker;
+
+namespace
+{
+auto getStatus(const std::string & entity_ref)
+  -> boost::optional<traffic_simulator_msgs::msg::EntityStatus>
+try {
+  if (connection->entityExists(entity_ref)) {
+    auto status = connection->getEntityStatus(entity_ref);
+    // NOTE: The time stamp changes every frame even if nothing else does.
+    status.time = 0;
+    return status;
+  } else {
+    return boost::none;
+  }
+} catch (...) {
+  return boost::none;  // NOTE: The entity was spawned but its position is not specified yet.
+}
+}  // namespace
+
+auto DependencyTracker::clear() -> void
+{
+  entities.clear();
+  ids.clear();
+  invalidate();
+}
+
+auto DependencyTracker::enable(bool enabled) -> void
+{
+  is_enabled = enabled;
+  invalidate();
+}
+
+auto DependencyTracker::track(const std::string & entity_ref) -> std::size_t
+{
+  const auto iter = ids.find(entity_ref);
+  if (iter != std::end(ids)) {
+    return iter->second;
+  } else {
+    entities.push_back(Entity{entity_ref, false, {}, current_epoch});
+    return ids.emplace(entity_ref, entities.size() - 1).first->second;
+  }
+}
+
+auto DependencyTracker::update() -> void
+{
+  if (is_enabled) {
+    /* ---- NOTE -------------------------------------------------------------
+     *
+     *  The statuses seen by conditions evaluated after an invalidation in the
+     *  previous frame may differ from the ones recorded here, so they are all
+     *  considered changed once.
+     *
+     * -------------------------------------------------------------------- */
+    const auto invalidated = updated_epoch < invalidated_epoch;
+    updated_epoch = ++current_epoch;
+    for (auto && entity : entities) {
+      if (const auto status = getStatus(entity.name)) {
+        if (invalidated or not entity.exists or not(status.get() == entity.status)) {
+          entity.exists = true;
+          entity.status = status.get();
+          entity.changed_epoch = current_epoch;
+        }
+      } else if (invalidated or entity.exists) {
+        entity.exists = false;
+        entity.changed_epoch = current_epoch;
+      }
+    }
+  }
+}
+
+auto DependencyTracker::invalidate() -> void { invalidated_epoch = ++current_epoch; }
+
+auto DependencyTracker::changedSince(const Dependencies & dependencies, Epoch epoch) const -> bool
+{
+  if (not is_enabled or dependencies.is_volatile or epoch < invalidated_epoch) {
+    return true;
+  } else {
+    for (const auto id : dependencies.entities) {
+      if (epoch < entities[id].changed_epoch) {
+        return true;
+      }
+    }
+    return false;
+  }
+}
+}  // namespace openscenario_interpreter
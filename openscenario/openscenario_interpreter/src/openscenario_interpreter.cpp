@@ -16,6 +16,7 @@
 
 #include <algorithm>
 #include <nlohmann/json.hpp>
+#include <openscenario_interpreter/dependency_tracker.hpp>
 #include <openscenario_interpreter/openscenario_interpreter.hpp>
 #include <openscenario_interpreter/record.hpp>
 #include <openscenario_interpreter/syntax/object_controller.hpp>
@@ -76,6 +77,23 @@ auto Interpreter::makeCurrentConfiguration() const -> traffic_simulator::Configu
 
     configuration.scenario_path = osc_path;
 
+    configuration.precompiled_map_path = getParameter<std::string>("precompiled_map_path");
+
+    configuration.hdmap_cache_capacity = std::max(getParameter<int>("hdmap_cache_capacity", 0), 0);
+
+    configuration.route_table_horizon =
+      std::max(getParameter<double>("route_table_horizon", 0.0), 0.0);
+
+    configuration.npc_update_threads = std::max(getParameter<int>("npc_update_threads", 1), 1);
+
+    configuration.combine_frame_requests =
+      getParameter<bool>("combine_frame_requests", false);
+
+    configuration.entity_status_delta = getParameter<bool>("entity_status_delta", false);
+
+    configuration.transport_protocol = simulation_interface::toTransportProtocol(
+      getParameter<std::string>("transport_protocol", "tcp"));
+
     // XXX DIRTY HACK!!!
     if (not logic_file.isDirectory() and logic_file.filepath.extension() == ".osm") {
       configuration.lanelet2_map_file = logic_file.filepath.filename().string();
@@ -113,6 +131,8 @@ auto Interpreter::on_configure(const rclcpp_lifecycle::State &) -> Result
       GET_PARAMETER(osc_path);
       GET_PARAMETER(output_directory);
 
+      dependency_tracker.clear();
+
       script = std::make_shared<OpenScenario>(osc_path);
 
       if (script->category.is<ScenarioDefinition>()) {
@@ -169,6 +189,8 @@ auto Interpreter::on_activate(const rclcpp_lifecycle::State &) -> Result
 
         connect(shared_from_this(), makeCurrentConfiguration());
 
+        dependency_tracker.enable(getParameter<bool>("cache_conditions", false));
+
         initialize(local_real_time_factor, 1 / local_frame_rate * local_real_time_factor);
 
         execution_timer.clear();
@@ -14,10 +14,21 @@
 
 #include <openscenario_interpreter/reader/attribute.hpp>
 #include <openscenario_interpreter/reader/element.hpp>
+#include <openscenario_interpreter/syntax/acceleration_condition.hpp>
 #include <openscenario_interpreter/syntax/by_entity_condition.hpp>
 #include <openscenario_interpreter/syntax/by_value_condition.hpp>
+#include <openscenario_interpreter/syntax/collision_condition.hpp>
 #include <openscenario_interpreter/syntax/condition.hpp>
+#include <openscenario_interpreter/syntax/distance_condition.hpp>
+#include <openscenario_interpreter/syntax/parameter_condition.hpp>
+#include <openscenario_interpreter/syntax/position.hpp>
+#include <openscenario_interpreter/syntax/reach_position_condition.hpp>
+#include <openscenario_interpreter/syntax/relative_distance_condition.hpp>
+#include <openscenario_interpreter/syntax/relative_world_position.hpp>
+#include <openscenario_interpreter/syntax/speed_condition.hpp>
+#include <openscenario_interpreter/syntax/time_headway_condition.hpp>
 #include <openscenario_interpreter/utility/demangle.hpp>
+#include <string>
 
 namespace openscenario_interpreter
 {
@@ -27,6 +38,69 @@ static_assert(std::is_standard_layout<ConditionEdge>::value, "");
 
 static_assert(std::is_trivial<ConditionEdge>::value, "");
 
+/* ---- NOTE -------------------------------------------------------------------
+ *
+ *  Conditions that only read the status of entities (through getEntityStatus,
+ *  getRelativePose and so on) or parameters are not volatile. The others read
+ *  the simulation time or states that are not tracked, and are evaluated
+ *  every frame. Parameters only change when a storyboard element starts,
+ *  which invalidates every condition anyway.
+ *
+ * -------------------------------------------------------------------------- */
+static auto readDependencies(const ComplexType & condition) -> DependencyTracker::Dependencies
+{
+  DependencyTracker::Dependencies dependencies;
+
+  const auto track = [&](const std::string & entity_ref) {
+    dependencies.entities.push_back(dependency_tracker.track(entity_ref));
+  };
+
+  const auto track_triggering_entities = [&](const TriggeringEntities & triggering_entities) {
+    for (const auto & entity_ref : triggering_entities.entity_refs) {
+      track(entity_ref);
+    }
+    dependencies.is_volatile = false;
+  };
+
+  const auto track_position = [&](const Position & position) {
+    if (position.is<RelativeWorldPosition>()) {
+      track(position.as<RelativeWorldPosition>().reference);
+    }
+  };
+
+  if (condition.is<ByEntityCondition>()) {
+    const auto & entity_condition = condition.as<ByEntityCondition>();
+    if (entity_condition.is<AccelerationCondition>()) {
+      track_triggering_entities(entity_condition.as<AccelerationCondition>().triggering_entities);
+    } else if (entity_condition.is<CollisionCondition>()) {
+      const auto & collision_condition = entity_condition.as<CollisionCondition>();
+      if (collision_condition.another_given_entity.is<EntityRef>()) {
+        track(collision_condition.another_given_entity.as<EntityRef>());
+      }
+      track_triggering_entities(collision_condition.triggering_entities);
+    } else if (entity_condition.is<DistanceCondition>()) {
+      track_position(entity_condition.as<DistanceCondition>().position);
+      track_triggering_entities(entity_condition.as<DistanceCondition>().triggering_entities);
+    } else if (entity_condition.is<ReachPositionCondition>()) {
+      track_position(entity_condition.as<ReachPositionCondition>().position);
+      track_triggering_entities(entity_condition.as<ReachPositionCondition>().triggering_entities);
+    } else if (entity_condition.is<RelativeDistanceCondition>()) {
+      track(entity_condition.as<RelativeDistanceCondition>().entity_ref);
+      track_triggering_entities(
+        entity_condition.as<RelativeDistanceCondition>().triggering_entities);
+    } else if (entity_condition.is<SpeedCondition>()) {
+      track_triggering_entities(entity_condition.as<SpeedCondition>().triggering_entities);
+    } else if (entity_condition.is<TimeHeadwayCondition>()) {
+      track(entity_condition.as<TimeHeadwayCondition>().entity_ref);
+      track_triggering_entities(entity_condition.as<TimeHeadwayCondition>().triggering_entities);
+    }
+  } else if (condition.is<ByValueCondition>()) {
+    dependencies.is_volatile = not condition.as<ByValueCondition>().is<ParameterCondition>();
+  }
+
+  return dependencies;
+}
+
 Condition::Condition(const pugi::xml_node & node, Scope & scope)
 // clang-format off
 : ComplexType(
@@ -36,7 +110,8 @@ Condition::Condition(const pugi::xml_node & node, Scope & scope)
   name(readAttribute<String>("name", node, scope)),
   delay(readAttribute<Double>("delay", node, scope, Double())),
   condition_edge(readAttribute<ConditionEdge>("conditionEdge", node, scope)),
-  current_value(false)
+  current_value(false),
+  dependencies(readDependencies(*this))
 // clang-format on
 {
 }
@@ -45,7 +120,10 @@ auto Condition::evaluate() -> Object
 {
   if (condition_edge == ConditionEdge::sticky and current_value) {
     return true_v;
+  } else if (not dependency_tracker.changedSince(dependencies, evaluated_epoch)) {
+    return asBoolean(current_value);
   } else {
+    evaluated_epoch = dependency_tracker.epoch();
     return asBoolean(current_value = Object::evaluate().as<Boolean>());
   }
 }
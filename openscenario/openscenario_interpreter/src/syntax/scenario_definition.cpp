@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <openscenario_interpreter/dependency_tracker.hpp>
 #include <openscenario_interpreter/reader/element.hpp>
 #include <openscenario_interpreter/syntax/scenario_definition.hpp>
 
@@ -30,6 +31,7 @@ ScenarioDefinition::ScenarioDefinition(const pugi::xml_node & node, Scope & scop
 
 auto ScenarioDefinition::evaluate() -> Object
 {
+  dependency_tracker.update();
   road_network.evaluate();
   storyboard.evaluate();
   updateFrame();
@@ -0,0 +1,203 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <ament_index_cpp/get_package_share_directory.hpp>
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <memory>
+#include <openscenario_interpreter/dependency_tracker.hpp>
+#include <openscenario_interpreter/procedure.hpp>
+#include <openscenario_interpreter/syntax/openscenario.hpp>
+#include <openscenario_interpreter/syntax/scenario_definition.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <sstream>
+#include <string>
+
+namespace
+{
+std::string makeCondition(const std::string & condition)
+{
+  return R"(<StartTrigger><ConditionGroup><Condition name="" delay="0" conditionEdge="none">)" +
+         condition + "</Condition></ConditionGroup></StartTrigger>";
+}
+
+std::string makeEntityCondition(const std::string & entity, const std::string & condition)
+{
+  return makeCondition(
+    R"(<ByEntityCondition><TriggeringEntities triggeringEntitiesRule="any">)"
+    R"(<EntityRef entityRef=")" +
+    entity + R"("/></TriggeringEntities><EntityCondition>)" + condition +
+    "</EntityCondition></ByEntityCondition>");
+}
+
+std::string makeEvent(const std::string & name, const std::string & start_trigger)
+{
+  return R"(<Event name=")" + name + R"(" priority="parallel"><Action name="">)" +
+         R"(<UserDefinedAction><CustomCommandAction type="echo"/></UserDefinedAction></Action>)" +
+         start_trigger + "</Event>";
+}
+
+/**
+ * @note Every entity has a story whose events wait for conditions on it that never become true
+ * during the benchmark, like scenarios waiting for vehicles to arrive somewhere. Three quarters of
+ * the entities are parked, so their conditions do not need to be evaluated again.
+ */
+boost::filesystem::path makeScenario(std::size_t size)
+{
+  const std::string lanes[] = {"34513", "34684", "34510", "34411", "120659"};
+
+  const auto far_position = [](const std::string & lane) {
+    return R"(<Position><LanePosition roadId="" laneId=")" + lane +
+           R"(" s="0" offset="0"/></Position>)";
+  };
+
+  std::stringstream entities, init, stories;
+
+  for (std::size_t i = 0; i < size; ++i) {
+    const auto name = "npc" + std::to_string(i);
+    const auto next = "npc" + std::to_string((i + 1) % size);
+    const auto & lane = lanes[i % 5];
+
+    entities << R"(<ScenarioObject name=")" << name << R"(">)"
+             << R"(<Vehicle name="" vehicleCategory="car">)"
+             << R"(<BoundingBox><Center x="0" y="0" z="0"/>)"
+             << R"(<Dimensions width="2" length="4" height="2"/></BoundingBox>)"
+             << R"(<Performance maxSpeed="50" maxAcceleration="10" maxDeceleration="10"/>)"
+             << R"(<Axles><FrontAxle maxSteering="0.5" wheelDiameter="0.6" trackWidth="1.8")"
+             << R"( positionX="2" positionZ="0.3"/><RearAxle maxSteering="0" wheelDiameter="0.6")"
+             << R"( trackWidth="1.8" positionX="0" positionZ="0.3"/></Axles>)"
+             << R"(<Properties/></Vehicle></ScenarioObject>)";
+
+    init << R"(<Private entityRef=")" << name << R"("><PrivateAction><TeleportAction><Position>)"
+         << R"(<LanePosition roadId="" laneId=")" << lane << R"(" s=")" << 8 * (i / 5) + 1
+         << R"(" offset="0"/></Position></TeleportAction></PrivateAction>)"
+         << R"(<PrivateAction><LongitudinalAction><SpeedAction><SpeedActionDynamics)"
+         << R"( dynamicsDimension="time" value="0" dynamicsShape="step"/><SpeedActionTarget>)"
+         << R"(<AbsoluteTargetSpeed value=")" << (i % 4 == 0 ? 5 : 0) << R"("/>)"
+         << R"(</SpeedActionTarget></SpeedAction></LongitudinalAction></PrivateAction></Private>)";
+
+    stories << R"(<Story name=")" << name << R"("><Act name=""><ManeuverGroup name="")"
+            << R"( maximumExecutionCount="1"><Actors selectTriggeringEntities="false">)"
+            << R"(<EntityRef entityRef=")" << name << R"("/></Actors><Maneuver name="">)"
+            << makeEvent(
+                 "distance", makeEntityCondition(
+                               name, R"(<DistanceCondition freespace="false")"
+                                     R"( alongRoute="false" value="1" rule="lessThan">)" +
+                                       far_position("34600") + "</DistanceCondition>"))
+            << makeEvent(
+                 "relative_distance",
+                 makeEntityCondition(
+                   name, R"(<RelativeDistanceCondition entityRef=")" + next +
+                           R"(" relativeDistanceType="cartesianDistance" freespace="false")"
+                           R"( value="0.01" rule="lessThan"/>)"))
+            << makeEvent(
+                 "reach_position",
+                 makeEntityCondition(
+                   name, R"(<ReachPositionCondition tolerance="1">)" + far_position("34600") +
+                           "</ReachPositionCondition>"))
+            << makeEvent(
+                 "speed",
+                 makeEntityCondition(name, R"(<SpeedCondition value="100" rule="greaterThan"/>)"))
+            << R"(</Maneuver></ManeuverGroup>)"
+            << makeCondition(
+                 R"(<ByValueCondition><SimulationTimeCondition value="0" rule="greaterThan"/>)"
+                 R"(</ByValueCondition>)")
+            << R"(<StopTrigger><ConditionGroup><Condition name="" delay="0" conditionEdge="none">)"
+            << R"(<ByValueCondition><SimulationTimeCondition value="1e9" rule="greaterThan"/>)"
+            << R"(</ByValueCondition></Condition></ConditionGroup></StopTrigger></Act></Story>)";
+  }
+
+  const auto path = boost::filesystem::temp_directory_path() /
+                    ("benchmark_trigger_evaluation_" + std::to_string(size) + ".xosc");
+
+  std::ofstream(path.string())
+    << R"(<?xml version="1.0" encoding="UTF-8"?><OpenSCENARIO>)"
+    << R"(<FileHeader revMajor="1" revMinor="0" date="2021-01-01T00:00:00" description="")"
+    << R"( author=""/><ParameterDeclarations/><CatalogLocations/><RoadNetwork>)"
+    << R"(<LogicFile filepath=")"
+    << ament_index_cpp::get_package_share_directory("traffic_simulator") + "/map"
+    << R"("/></RoadNetwork><Entities>)" << entities.str()
+    << R"(</Entities><Storyboard><Init><Actions>)" << init.str() << R"(</Actions></Init>)"
+    << stories.str()
+    << R"(<StopTrigger><ConditionGroup><Condition name="" delay="0" conditionEdge="none">)"
+    << R"(<ByValueCondition><SimulationTimeCondition value="1e9" rule="greaterThan"/>)"
+    << R"(</ByValueCondition></Condition></ConditionGroup></StopTrigger>)"
+    << R"(</Storyboard></OpenSCENARIO>)";
+
+  return path;
+}
+
+void evaluateScenario(benchmark::State & state, bool cache_conditions)
+{
+  using namespace openscenario_interpreter;
+
+  const auto node = std::make_shared<rclcpp::Node>("benchmark_trigger_evaluation");
+
+  dependency_tracker.clear();
+
+  const OpenScenario script(makeScenario(state.range(0)));
+
+  auto configuration = traffic_simulator::Configuration(
+    ament_index_cpp::get_package_share_directory("traffic_simulator") + "/map");
+  configuration.standalone_mode = true;
+  configuration.auto_sink = false;
+
+  connect(node, configuration);
+
+  dependency_tracker.enable(cache_conditions);
+
+  initialize(1.0, 0.05);
+
+  auto & scenario_definition = script.category.as<ScenarioDefinition>();
+
+  for (int i = 0; i < 5; ++i) {
+    scenario_definition.evaluate();  // NOTE: Spawn entities and start stories.
+  }
+
+  for (auto _ : state) {
+    scenario_definition.evaluate();
+  }
+
+  disconnect();
+}
+}  // namespace
+
+/**
+ * @brief One frame of a scenario with four start triggers per entity, evaluating every condition.
+ */
+static void EvaluateAllConditionsPerFrame(benchmark::State & state)
+{
+  evaluateScenario(state, false);
+}
+BENCHMARK(EvaluateAllConditionsPerFrame)->Arg(50)->Arg(200)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Same as EvaluateAllConditionsPerFrame, skipping conditions whose entities did not change.
+ */
+static void SkipUnchangedConditionsPerFrame(benchmark::State & state)
+{
+  evaluateScenario(state, true);
+}
+BENCHMARK(SkipUnchangedConditionsPerFrame)->Arg(50)->Arg(200)->Unit(benchmark::kMillisecond);
+
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  rclcpp::shutdown();
+  return 0;
+}
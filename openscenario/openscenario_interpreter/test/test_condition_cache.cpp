@@ -0,0 +1,265 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <ament_index_cpp/get_package_share_directory.hpp>
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <openscenario_interpreter/dependency_tracker.hpp>
+#include <openscenario_interpreter/procedure.hpp>
+#include <openscenario_interpreter/syntax/openscenario.hpp>
+#include <openscenario_interpreter/syntax/scenario_definition.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+std::string makeCondition(const std::string & name, const std::string & condition)
+{
+  return R"(<Condition name=")" + name + R"(" delay="0" conditionEdge="none">)" + condition +
+         "</Condition>";
+}
+
+std::string makeEntityCondition(
+  const std::string & name, const std::string & entity, const std::string & condition)
+{
+  return makeCondition(
+    name, R"(<ByEntityCondition><TriggeringEntities triggeringEntitiesRule="any">)"
+          R"(<EntityRef entityRef=")" +
+            entity + R"("/></TriggeringEntities><EntityCondition>)" + condition +
+            "</EntityCondition></ByEntityCondition>");
+}
+
+std::string makeSimulationTimeCondition(const std::string & name, double value)
+{
+  return makeCondition(
+    name, R"(<ByValueCondition><SimulationTimeCondition value=")" + std::to_string(value) +
+            R"(" rule="greaterThan"/></ByValueCondition>)");
+}
+
+std::string makeLanePosition(double s)
+{
+  return R"(<Position><LanePosition roadId="" laneId="34513" s=")" + std::to_string(s) +
+         R"(" offset="0"/></Position>)";
+}
+
+std::string makeEvent(
+  const std::string & name, const std::string & action, const std::string & condition)
+{
+  return R"(<Event name=")" + name + R"(" priority="parallel"><Action name="">)" + action +
+         R"(</Action><StartTrigger><ConditionGroup>)" + condition +
+         "</ConditionGroup></StartTrigger></Event>";
+}
+
+/**
+ * @note The "parked" vehicle stands still and the "mover" drives away from it along the same lane.
+ * The conditions on the parked vehicle which refer to the mover must follow the mover, the
+ * parameter set at 1 s must be seen by the parameter condition, and the parked vehicle is
+ * teleported ahead of the mover at 3 s. The watched conditions are grouped with a condition which
+ * is never true, so they are evaluated every frame without starting anything.
+ */
+boost::filesystem::path makeScenario()
+{
+  const auto vehicle = [](const std::string & name) {
+    return R"(<ScenarioObject name=")" + name + R"(">)"
+           R"(<Vehicle name="" vehicleCategory="car">)"
+           R"(<BoundingBox><Center x="0" y="0" z="0"/>)"
+           R"(<Dimensions width="2" length="4" height="2"/></BoundingBox>)"
+           R"(<Performance maxSpeed="50" maxAcceleration="10" maxDeceleration="10"/>)"
+           R"(<Axles><FrontAxle maxSteering="0.5" wheelDiameter="0.6" trackWidth="1.8")"
+           R"( positionX="2" positionZ="0.3"/><RearAxle maxSteering="0" wheelDiameter="0.6")"
+           R"( trackWidth="1.8" positionX="0" positionZ="0.3"/></Axles>)"
+           R"(<Properties/></Vehicle></ScenarioObject>)";
+  };
+
+  const auto initialize = [](const std::string & name, double s, double speed) {
+    return R"(<Private entityRef=")" + name +
+           R"("><PrivateAction><TeleportAction>)" + makeLanePosition(s) +
+           R"(</TeleportAction></PrivateAction>)"
+           R"(<PrivateAction><LongitudinalAction><SpeedAction><SpeedActionDynamics)"
+           R"( dynamicsDimension="time" value="0" dynamicsShape="step"/><SpeedActionTarget>)"
+           R"(<AbsoluteTargetSpeed value=")" +
+           std::to_string(speed) +
+           R"("/></SpeedActionTarget></SpeedAction></LongitudinalAction></PrivateAction>)"
+           R"(</Private>)";
+  };
+
+  const auto relative_world_position =
+    R"(<Position><RelativeWorldPosition entityRef="mover" dx="0" dy="0" dz="0"/></Position>)";
+
+  const auto watched_conditions =
+    makeEntityCondition(
+      "parked_to_mover_position", "parked",
+      std::string(R"(<DistanceCondition freespace="false" alongRoute="false" value="20")"
+                  R"( rule="greaterThan">)") +
+        relative_world_position + "</DistanceCondition>") +
+    makeEntityCondition(
+      "parked_reaches_mover", "parked",
+      std::string(R"(<ReachPositionCondition tolerance="5">)") + relative_world_position +
+        "</ReachPositionCondition>") +
+    makeEntityCondition(
+      "parked_to_mover", "parked",
+      R"(<RelativeDistanceCondition entityRef="mover" relativeDistanceType="cartesianDistance")"
+      R"( freespace="false" value="20" rule="greaterThan"/>)") +
+    makeEntityCondition(
+      "parked_to_lane", "parked",
+      R"(<DistanceCondition freespace="false" alongRoute="false" value="20" rule="greaterThan">)" +
+        makeLanePosition(1) + "</DistanceCondition>") +
+    makeEntityCondition(
+      "parked_speed", "parked", R"(<SpeedCondition value="1" rule="lessThan"/>)") +
+    makeEntityCondition(
+      "mover_speed", "mover", R"(<SpeedCondition value="1" rule="greaterThan"/>)") +
+    makeCondition(
+      "flag", R"(<ByValueCondition><ParameterCondition parameterRef="flag" value="1")"
+              R"( rule="equalTo"/></ByValueCondition>)") +
+    makeSimulationTimeCondition("time", 2.5) + makeSimulationTimeCondition("never", 1e9);
+
+  const auto path = boost::filesystem::temp_directory_path() / "test_condition_cache.xosc";
+
+  std::ofstream(path.string())
+    << R"(<?xml version="1.0" encoding="UTF-8"?><OpenSCENARIO>)"
+    << R"(<FileHeader revMajor="1" revMinor="0" date="2021-01-01T00:00:00" description="")"
+    << R"( author=""/><ParameterDeclarations>)"
+    << R"(<ParameterDeclaration name="flag" parameterType="integer" value="0"/>)"
+    << R"(</ParameterDeclarations><CatalogLocations/><RoadNetwork><LogicFile filepath=")"
+    << ament_index_cpp::get_package_share_directory("traffic_simulator") + "/map"
+    << R"("/></RoadNetwork><Entities>)" << vehicle("parked") << vehicle("mover")
+    << R"(</Entities><Storyboard><Init><Actions>)" << initialize("parked", 1, 0)
+    << initialize("mover", 10, 5) << R"(</Actions></Init>)"
+    << R"(<Story name=""><Act name=""><ManeuverGroup name="" maximumExecutionCount="1">)"
+    << R"(<Actors selectTriggeringEntities="false"><EntityRef entityRef="parked"/></Actors>)"
+    << R"(<Maneuver name="">)"
+    << makeEvent(
+         "set_flag",
+         R"(<GlobalAction><ParameterAction parameterRef="flag"><SetAction value="1"/>)"
+         R"(</ParameterAction></GlobalAction>)",
+         makeSimulationTimeCondition("", 1.0))
+    << makeEvent(
+         "teleport",
+         "<PrivateAction><TeleportAction>" + makeLanePosition(40) +
+           "</TeleportAction></PrivateAction>",
+         makeSimulationTimeCondition("", 3.0))
+    << makeEvent(
+         "watch", R"(<UserDefinedAction><CustomCommandAction type="echo"/></UserDefinedAction>)",
+         watched_conditions)
+    << R"(</Maneuver></ManeuverGroup><StartTrigger><ConditionGroup>)"
+    << makeSimulationTimeCondition("", 0) << R"(</ConditionGroup></StartTrigger>)"
+    << R"(<StopTrigger><ConditionGroup>)" << makeSimulationTimeCondition("", 1e9)
+    << R"(</ConditionGroup></StopTrigger></Act></Story>)"
+    << R"(<StopTrigger><ConditionGroup>)" << makeSimulationTimeCondition("", 1e9)
+    << R"(</ConditionGroup></StopTrigger></Storyboard></OpenSCENARIO>)";
+
+  return path;
+}
+
+/**
+ * @brief Removes the descriptions of the conditions, which are only for humans, and keeps their
+ * values and the states of the storyboard elements.
+ */
+void removeDescriptions(nlohmann::json & json)
+{
+  if (json.is_object()) {
+    json.erase("currentEvaluation");
+  }
+  if (json.is_object() or json.is_array()) {
+    for (auto & each : json) {
+      removeDescriptions(each);
+    }
+  }
+}
+
+/**
+ * @brief Runs the scenario for 6 seconds, and returns the values of its conditions and the states
+ * of its storyboard elements after each frame.
+ */
+std::vector<nlohmann::json> simulate(bool cache_conditions)
+{
+  using namespace openscenario_interpreter;
+
+  const auto node = std::make_shared<rclcpp::Node>("test_condition_cache");
+
+  dependency_tracker.clear();
+
+  const OpenScenario script(makeScenario());
+
+  auto configuration = traffic_simulator::Configuration(
+    ament_index_cpp::get_package_share_directory("traffic_simulator") + "/map");
+  configuration.standalone_mode = true;
+  configuration.auto_sink = false;
+
+  connect(node, configuration);
+
+  dependency_tracker.enable(cache_conditions);
+
+  initialize(1.0, 0.05);
+
+  auto & scenario_definition = script.category.as<ScenarioDefinition>();
+
+  std::vector<nlohmann::json> frames;
+
+  for (int i = 0; i < 120; ++i) {
+    scenario_definition.evaluate();
+    nlohmann::json json;
+    json << scenario_definition;
+    removeDescriptions(json);
+    frames.push_back(json);
+  }
+
+  disconnect();
+
+  return frames;
+}
+}  // namespace
+
+/**
+ * @note The cache must only skip evaluations whose result would not change, so every frame must
+ * give the same condition values and storyboard states as evaluating every condition.
+ */
+TEST(ConditionCache, SameValuesAsEvaluatingEveryCondition)
+{
+  const auto expected = simulate(false);
+  const auto actual = simulate(true);
+  ASSERT_EQ(actual.size(), expected.size());
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(actual[i], expected[i]) << "frame " << i << "\n" << expected[i].dump(2);
+  }
+  /**
+   * @note Makes sure the scenario exercises what it is meant to: the watched conditions change
+   * during the run.
+   */
+  const auto watched_values = [&](const nlohmann::json & frame) {
+    std::stringstream values;
+    for (const auto & condition : frame["Storyboard"]["Story"][0]["Act"][0]["ManeuverGroup"][0]
+                                       ["Maneuver"][0]["Event"][2]["StartTrigger"]["ConditionGroup"]
+                                       [0]["Condition"]) {
+      values << condition["currentValue"].get<std::string>();
+    }
+    return values.str();
+  };
+  EXPECT_NE(watched_values(expected.front()), watched_values(expected.back()));
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  rclcpp::init(argc, argv);
+  const auto result = RUN_ALL_TESTS();
+  rclcpp::shutdown();
+  return result;
+}
@@ -21,6 +21,8 @@
 #include <memory>
 #include <string>
 #include <traffic_simulator/entity/entity_base.hpp>
+#include <traffic_simulator/entity/entity_spatial_index.hpp>
+#include <traffic_simulator/entity/entity_status_store.hpp>
 #include <traffic_simulator/hdmap_utils/hdmap_utils.hpp>
 #include <traffic_simulator/helper/stop_watch.hpp>
 #include <traffic_simulator/math/catmull_rom_spline.hpp>
@@ -52,6 +54,9 @@ public:
   boost::optional<double> getDistanceToTrafficLightStopLine(
     const std::vector<std::int64_t> & route_lanelets,
     const std::vector<geometry_msgs::msg::Point> & waypoints);
+  boost::optional<double> getDistanceToTrafficLightStopLine(
+    const std::vector<std::int64_t> & route_lanelets,
+    const traffic_simulator::math::CatmullRomSpline & spline);
   std::vector<traffic_simulator_msgs::msg::EntityStatus> getRightOfWayEntities();
   std::vector<traffic_simulator_msgs::msg::EntityStatus> getRightOfWayEntities(
     const std::vector<std::int64_t> & following_lanelets);
@@ -72,34 +77,44 @@ public:
     return {
       BT::InputPort<std::string>("request"),
       BT::InputPort<std::shared_ptr<hdmap_utils::HdMapUtils>>("hdmap_utils"),
-      BT::InputPort<traffic_simulator_msgs::msg::EntityStatus>("entity_status"),
+      BT::InputPort<std::shared_ptr<const traffic_simulator_msgs::msg::EntityStatus>>(
+        "entity_status"),
       BT::InputPort<double>("current_time"),
       BT::InputPort<double>("step_time"),
       BT::InputPort<boost::optional<double>>("target_speed"),
       BT::OutputPort<traffic_simulator_msgs::msg::EntityStatus>("updated_status"),
       BT::OutputPort<std::string>("request"),
-      BT::InputPort<std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityStatus>>(
-        "other_entity_status"),
-      BT::InputPort<std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityType>>(
+      BT::InputPort<traffic_simulator::entity::EntityStatusView>("other_entity_status"),
+      BT::InputPort<std::shared_ptr<const traffic_simulator::entity::EntitySpatialIndex>>(
+        "entity_spatial_index"),
+      BT::InputPort<std::shared_ptr<
+        const std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityType>>>(
         "entity_type_list"),
-      BT::InputPort<std::vector<std::int64_t>>("route_lanelets"),
+      BT::InputPort<std::shared_ptr<const std::vector<std::int64_t>>>("route_lanelets"),
       BT::InputPort<std::shared_ptr<traffic_simulator::TrafficLightManagerBase>>(
         "traffic_light_manager"),
       BT::OutputPort<boost::optional<traffic_simulator_msgs::msg::Obstacle>>("obstacle"),
       BT::OutputPort<traffic_simulator_msgs::msg::WaypointsArray>("waypoints")};
   }
+  /**
+   * @note The entity status, the entity type list and the route lanelets are shared immutable
+   * snapshots owned by the blackboard, so getting them in each tick copies a pointer instead of
+   * the messages and containers.
+   */
   void getBlackBoardValues();
   std::string request;
   std::shared_ptr<hdmap_utils::HdMapUtils> hdmap_utils;
   std::shared_ptr<traffic_simulator::TrafficLightManagerBase> traffic_light_manager;
-  traffic_simulator_msgs::msg::EntityStatus entity_status;
+  std::shared_ptr<const traffic_simulator_msgs::msg::EntityStatus> entity_status;
   double current_time;
   double step_time;
   boost::optional<double> target_speed;
   traffic_simulator_msgs::msg::EntityStatus updated_status;
-  std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityStatus> other_entity_status;
-  std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityType> entity_type_list;
-  std::vector<std::int64_t> route_lanelets;
+  traffic_simulator::entity::EntityStatusView other_entity_status;
+  std::shared_ptr<const traffic_simulator::entity::EntitySpatialIndex> entity_spatial_index;
+  std::shared_ptr<const std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityType>>
+    entity_type_list;
+  std::shared_ptr<const std::vector<std::int64_t>> route_lanelets;
   traffic_simulator_msgs::msg::EntityStatus getEntityStatus(const std::string target_name) const;
   boost::optional<double> getDistanceToTargetEntityPolygon(
     const traffic_simulator::math::CatmullRomSpline & spline, const std::string target_name,
@@ -107,6 +122,13 @@ public:
     double length_extension_front = 0.0, double length_extension_rear = 0.0);
 
 private:
+  /**
+   * @brief Returns the positions in other_entity_status of the entities whose lanelet pose is on
+   * one of the lanelets, in ascending order.
+   */
+  std::vector<std::size_t> getOtherEntityIndices(
+    const std::vector<std::int64_t> & lanelet_ids) const;
+  bool spatialIndexAvailable() const;
   boost::optional<double> getDistanceToTargetEntityOnCrosswalk(
     const traffic_simulator::math::CatmullRomSpline & spline,
     const traffic_simulator_msgs::msg::EntityStatus & status);
@@ -115,6 +137,11 @@ private:
     const traffic_simulator_msgs::msg::EntityStatus & status, double width_extension_right = 0.0,
     double width_extension_left = 0.0, double length_extension_front = 0.0,
     double length_extension_rear = 0.0);
+  boost::optional<double> getDistanceToTargetEntityPolygon(
+    const traffic_simulator::math::CatmullRomSpline & spline, const geometry_msgs::msg::Pose & pose,
+    const traffic_simulator_msgs::msg::BoundingBox & bounding_box,
+    double width_extension_right = 0.0, double width_extension_left = 0.0,
+    double length_extension_front = 0.0, double length_extension_rear = 0.0);
   boost::optional<traffic_simulator_msgs::msg::EntityStatus> getConflictingEntityStatus(
     const std::vector<std::int64_t> & following_lanelets) const;
   std::vector<traffic_simulator_msgs::msg::EntityStatus> getConflictingEntityStatusOnCrossWalk(
@@ -51,22 +51,23 @@ public:
   DEFINE_GETTER_SETTER(CurrentTime, double)
   DEFINE_GETTER_SETTER(DebugMarker, std::vector<visualization_msgs::msg::Marker>)
   DEFINE_GETTER_SETTER(DriverModel, traffic_simulator_msgs::msg::DriverModel)
-  DEFINE_GETTER_SETTER(EntityStatus, traffic_simulator_msgs::msg::EntityStatus)
-  DEFINE_GETTER_SETTER(EntityTypeList, EntityTypeDict)
+  DEFINE_GETTER_SETTER(EntitySpatialIndex, std::shared_ptr<const traffic_simulator::entity::EntitySpatialIndex>)
+  DEFINE_GETTER_SETTER(EntityStatus, std::shared_ptr<const traffic_simulator_msgs::msg::EntityStatus>)
+  DEFINE_GETTER_SETTER(EntityTypeList, std::shared_ptr<const EntityTypeDict>)
   DEFINE_GETTER_SETTER(GoalPoses, std::vector<geometry_msgs::msg::Pose>)
   DEFINE_GETTER_SETTER(HdMapUtils, std::shared_ptr<hdmap_utils::HdMapUtils>)
   DEFINE_GETTER_SETTER(LaneChangeParameters, traffic_simulator::lane_change::Parameter)
   DEFINE_GETTER_SETTER(Obstacle, boost::optional<traffic_simulator_msgs::msg::Obstacle>)
-  DEFINE_GETTER_SETTER(OtherEntityStatus, EntityStatusDict)
-  DEFINE_GETTER_SETTER(PedestrianParameters, traffic_simulator_msgs::msg::PedestrianParameters)
+  DEFINE_GETTER_SETTER(OtherEntityStatus, EntityStatusView)
+  DEFINE_GETTER_SETTER(PedestrianParameters, std::shared_ptr<const traffic_simulator_msgs::msg::PedestrianParameters>)
   DEFINE_GETTER_SETTER(Request, std::string)
-  DEFINE_GETTER_SETTER(RouteLanelets, std::vector<std::int64_t>)
+  DEFINE_GETTER_SETTER(RouteLanelets, std::shared_ptr<const std::vector<std::int64_t>>)
   DEFINE_GETTER_SETTER(ReferenceTrajectory, std::shared_ptr<traffic_simulator::math::CatmullRomSpline>)
   DEFINE_GETTER_SETTER(StepTime, double)
   DEFINE_GETTER_SETTER(TargetSpeed, boost::optional<double>)
   DEFINE_GETTER_SETTER(TrafficLightManager, std::shared_ptr<traffic_simulator::TrafficLightManagerBase>)
   DEFINE_GETTER_SETTER(UpdatedStatus, traffic_simulator_msgs::msg::EntityStatus)
-  DEFINE_GETTER_SETTER(VehicleParameters, traffic_simulator_msgs::msg::VehicleParameters)
+  DEFINE_GETTER_SETTER(VehicleParameters, std::shared_ptr<const traffic_simulator_msgs::msg::VehicleParameters>)
   DEFINE_GETTER_SETTER(Waypoints, traffic_simulator_msgs::msg::WaypointsArray)
   // clang-format on
 
@@ -33,14 +33,15 @@ public:
   {
     BT::PortsList ports = {
       BT::InputPort<traffic_simulator_msgs::msg::DriverModel>("driver_model"),
-      BT::InputPort<traffic_simulator_msgs::msg::PedestrianParameters>("pedestrian_parameters")};
+      BT::InputPort<std::shared_ptr<const traffic_simulator_msgs::msg::PedestrianParameters>>(
+        "pedestrian_parameters")};
     BT::PortsList parent_ports = entity_behavior::ActionNode::providedPorts();
     for (const auto & parent_port : parent_ports) {
       ports.emplace(parent_port.first, parent_port.second);
     }
     return ports;
   }
-  traffic_simulator_msgs::msg::PedestrianParameters pedestrian_parameters;
+  std::shared_ptr<const traffic_simulator_msgs::msg::PedestrianParameters> pedestrian_parameters;
   traffic_simulator_msgs::msg::EntityStatus calculateEntityStatusUpdatedInWorldFrame(
     double target_speed);
   traffic_simulator_msgs::msg::EntityStatus calculateEntityStatusUpdated(double target_speed);
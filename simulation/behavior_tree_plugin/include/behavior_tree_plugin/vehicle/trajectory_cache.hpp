@@ -0,0 +1,90 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BEHAVIOR_TREE_PLUGIN__VEHICLE__TRAJECTORY_CACHE_HPP_
+#define BEHAVIOR_TREE_PLUGIN__VEHICLE__TRAJECTORY_CACHE_HPP_
+
+#include <cstdint>
+#include <memory>
+#include <traffic_simulator/math/catmull_rom_spline.hpp>
+#include <traffic_simulator_msgs/msg/waypoints_array.hpp>
+#include <vector>
+
+namespace entity_behavior
+{
+namespace vehicle
+{
+/**
+ * @brief Waypoints clipped from the reference trajectory of an entity, and the spline through
+ * them.
+ */
+class Trajectory
+{
+public:
+  explicit Trajectory(const std::vector<geometry_msgs::msg::Point> & waypoints);
+
+  const traffic_simulator_msgs::msg::WaypointsArray waypoints;
+
+  /**
+   * @brief Returns the spline through the waypoints, built on the first call.
+   * @note Throws like the constructor of CatmullRomSpline if there are too few waypoints.
+   */
+  auto getSpline() const -> const traffic_simulator::math::CatmullRomSpline &;
+
+private:
+  mutable std::unique_ptr<const traffic_simulator::math::CatmullRomSpline> spline_;
+};
+
+/**
+ * @brief Last trajectory clipped from the reference trajectory of an entity, shared by the
+ * action nodes of its behavior tree through the blackboard.
+ * @note The nodes of the follow lane sequence clip the same waypoints and build the same spline
+ * one after another in a tick, and again in each tick while the entity stands still. The cache
+ * rebuilds the trajectory only if the reference trajectory, the route lanelets or the s-window of
+ * the entity change. The reference trajectory is compared by address: the entity builds a new one
+ * whenever its route lanelets change, and the cache keeps the old one alive while it is the key.
+ * A behavior tree is ticked by one thread at a time, so the cache is not synchronized.
+ */
+class TrajectoryCache
+{
+public:
+  auto getTrajectory(
+    const std::shared_ptr<traffic_simulator::math::CatmullRomSpline> & reference_trajectory,
+    const std::vector<std::int64_t> & route_lanelets, double start_s, double end_s, double offset)
+    -> std::shared_ptr<const Trajectory>;
+
+  /**
+   * @brief Returns the number of trajectories built by the cache, for tests and benchmarks.
+   */
+  auto builds() const noexcept -> std::size_t { return builds_; }
+
+private:
+  std::shared_ptr<traffic_simulator::math::CatmullRomSpline> reference_trajectory_;
+
+  std::vector<std::int64_t> route_lanelets_;
+
+  double start_s_ = 0;
+
+  double end_s_ = 0;
+
+  double offset_ = 0;
+
+  std::shared_ptr<const Trajectory> trajectory_;
+
+  std::size_t builds_ = 0;
+};
+}  // namespace vehicle
+}  // namespace entity_behavior
+
+#endif  // BEHAVIOR_TREE_PLUGIN__VEHICLE__TRAJECTORY_CACHE_HPP_
@@ -18,6 +18,7 @@
 #include <behaviortree_cpp_v3/action_node.h>
 
 #include <behavior_tree_plugin/action_node.hpp>
+#include <behavior_tree_plugin/vehicle/trajectory_cache.hpp>
 #include <memory>
 #include <string>
 #include <traffic_simulator/helper/stop_watch.hpp>
@@ -40,9 +41,11 @@ public:
   {
     BT::PortsList ports = {
       BT::InputPort<traffic_simulator_msgs::msg::DriverModel>("driver_model"),
-      BT::InputPort<traffic_simulator_msgs::msg::VehicleParameters>("vehicle_parameters"),
+      BT::InputPort<std::shared_ptr<const traffic_simulator_msgs::msg::VehicleParameters>>(
+        "vehicle_parameters"),
       BT::InputPort<std::shared_ptr<traffic_simulator::math::CatmullRomSpline>>(
-        "reference_trajectory")};
+        "reference_trajectory"),
+      BT::InputPort<std::shared_ptr<vehicle::TrajectoryCache>>("trajectory_cache")};
     BT::PortsList parent_ports = entity_behavior::ActionNode::providedPorts();
     for (const auto & parent_port : parent_ports) {
       ports.emplace(parent_port.first, parent_port.second);
@@ -59,9 +62,17 @@ public:
     const traffic_simulator_msgs::msg::WaypointsArray & waypoints) = 0;
 
 protected:
+  /**
+   * @brief Returns the waypoints on the reference trajectory from the entity to the horizon at 1 m
+   * intervals, from the trajectory cache of the behavior tree if it has one.
+   * @note The waypoints are empty while the entity moves backward.
+   */
+  std::shared_ptr<const vehicle::Trajectory> getTrajectoryAhead();
+
   traffic_simulator_msgs::msg::DriverModel driver_model;
-  traffic_simulator_msgs::msg::VehicleParameters vehicle_parameters;
+  std::shared_ptr<const traffic_simulator_msgs::msg::VehicleParameters> vehicle_parameters;
   std::shared_ptr<traffic_simulator::math::CatmullRomSpline> reference_trajectory;
+  std::shared_ptr<vehicle::TrajectoryCache> trajectory_cache;
 };
 }  // namespace entity_behavior
 
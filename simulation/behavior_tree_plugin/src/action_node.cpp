@@ -22,6 +22,7 @@
 #include <set>
 #include <string>
 #include <traffic_simulator/math/bounding_box.hpp>
+#include <traffic_simulator/math/transform.hpp>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -53,7 +54,8 @@ void ActionNode::getBlackBoardValues()
         "traffic_light_manager", traffic_light_manager)) {
     THROW_SIMULATION_ERROR("failed to get input traffic_light_manager in ActionNode");
   }
-  if (!getInput<traffic_simulator_msgs::msg::EntityStatus>("entity_status", entity_status)) {
+  if (!getInput<std::shared_ptr<const traffic_simulator_msgs::msg::EntityStatus>>(
+        "entity_status", entity_status)) {
     THROW_SIMULATION_ERROR("failed to get input entity_status in ActionNode");
   }
 
@@ -61,42 +63,81 @@ void ActionNode::getBlackBoardValues()
     target_speed = boost::none;
   }
 
-  if (!getInput<std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityStatus>>(
+  if (!getInput<traffic_simulator::entity::EntityStatusView>(
         "other_entity_status", other_entity_status)) {
     THROW_SIMULATION_ERROR("failed to get input other_entity_status in ActionNode");
   }
-  if (!getInput<std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityType>>(
+  if (!getInput<std::shared_ptr<const traffic_simulator::entity::EntitySpatialIndex>>(
+        "entity_spatial_index", entity_spatial_index)) {
+    entity_spatial_index = nullptr;
+  }
+  if (!getInput<std::shared_ptr<
+        const std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityType>>>(
         "entity_type_list", entity_type_list)) {
     THROW_SIMULATION_ERROR("failed to get input entity_type_list in ActionNode");
   }
-  if (!getInput<std::vector<std::int64_t>>("route_lanelets", route_lanelets)) {
+  if (!getInput<std::shared_ptr<const std::vector<std::int64_t>>>(
+        "route_lanelets", route_lanelets)) {
     THROW_SIMULATION_ERROR("failed to get input route_lanelets in ActionNode");
   }
 }
 
 double ActionNode::getHorizon() const
 {
-  return boost::algorithm::clamp(entity_status.action_status.twist.linear.x * 5, 20, 50);
+  return boost::algorithm::clamp(entity_status->action_status.twist.linear.x * 5, 20, 50);
 }
 
 traffic_simulator_msgs::msg::EntityStatus ActionNode::stopAtEndOfRoad()
 {
-  traffic_simulator_msgs::msg::EntityStatus entity_status_updated = entity_status;
+  traffic_simulator_msgs::msg::EntityStatus entity_status_updated = *entity_status;
   entity_status_updated.time = current_time + step_time;
   entity_status_updated.action_status.twist = geometry_msgs::msg::Twist();
   entity_status_updated.action_status.accel = geometry_msgs::msg::Accel();
   return entity_status_updated;
 }
 
+/**
+ * @note The spatial index is used only if it was built from the same snapshot as the view, so the
+ * queries below return the same entities in the same order with or without it.
+ */
+bool ActionNode::spatialIndexAvailable() const
+{
+  return entity_spatial_index && entity_spatial_index->frame() == other_entity_status.frame() &&
+         entity_spatial_index->frame() != 0;
+}
+
+std::vector<std::size_t> ActionNode::getOtherEntityIndices(
+  const std::vector<std::int64_t> & lanelet_ids) const
+{
+  std::vector<std::size_t> indices;
+  if (spatialIndexAvailable()) {
+    for (const auto lanelet_id : lanelet_ids) {
+      for (const auto index : entity_spatial_index->getEntitiesOnLanelet(lanelet_id)) {
+        if (const auto i = other_entity_status.findIndex(index)) {
+          indices.emplace_back(i.get());
+        }
+      }
+    }
+    std::sort(indices.begin(), indices.end());
+    indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+  } else {
+    for (std::size_t i = 0; i < other_entity_status.size(); ++i) {
+      const auto lanelet_id = other_entity_status.getLaneletPose(i).lanelet_id;
+      if (std::find(lanelet_ids.begin(), lanelet_ids.end(), lanelet_id) != lanelet_ids.end()) {
+        indices.emplace_back(i);
+      }
+    }
+  }
+  return indices;
+}
+
 std::vector<traffic_simulator_msgs::msg::EntityStatus> ActionNode::getOtherEntityStatus(
   std::int64_t lanelet_id)
 {
   std::vector<traffic_simulator_msgs::msg::EntityStatus> ret;
-  for (const auto & status : other_entity_status) {
-    if (status.second.lanelet_pose_valid) {
-      if (status.second.lanelet_pose.lanelet_id == lanelet_id) {
-        ret.emplace_back(status.second);
-      }
+  for (const auto i : getOtherEntityIndices(std::vector<std::int64_t>{lanelet_id})) {
+    if (other_entity_status.laneletPoseValid(i)) {
+      ret.emplace_back(other_entity_status.getStatus(i));
     }
   }
   return ret;
@@ -112,7 +153,7 @@ boost::optional<double> ActionNode::getYieldStopDistance(
       const auto other_status = getOtherEntityStatus(right_of_way_id);
       if (other_status.size() != 0) {
         auto distance = hdmap_utils->getLongitudinalDistance(
-          entity_status.lanelet_pose.lanelet_id, entity_status.lanelet_pose.s, lanelet, 0);
+          entity_status->lanelet_pose.lanelet_id, entity_status->lanelet_pose.s, lanelet, 0);
         if (distance) {
           distances.insert(distance.get());
         }
@@ -130,11 +171,16 @@ std::vector<traffic_simulator_msgs::msg::EntityStatus> ActionNode::getRightOfWay
 {
   std::vector<traffic_simulator_msgs::msg::EntityStatus> ret;
   const auto lanelet_ids_list = hdmap_utils->getRightOfWayLaneletIds(following_lanelets);
-  for (const auto & status : other_entity_status) {
+  std::vector<std::int64_t> right_of_way_ids;
+  for (const auto & following_lanelet : following_lanelets) {
+    const auto & lanelet_ids = lanelet_ids_list.at(following_lanelet);
+    right_of_way_ids.insert(right_of_way_ids.end(), lanelet_ids.begin(), lanelet_ids.end());
+  }
+  for (const auto i : getOtherEntityIndices(right_of_way_ids)) {
     for (const auto & following_lanelet : following_lanelets) {
       for (const std::int64_t & lanelet_id : lanelet_ids_list.at(following_lanelet)) {
-        if (lanelet_id == status.second.lanelet_pose.lanelet_id) {
-          ret.emplace_back(status.second);
+        if (lanelet_id == other_entity_status.getLaneletPose(i).lanelet_id) {
+          ret.emplace_back(other_entity_status.getStatus(i));
         }
       }
     }
@@ -146,14 +192,14 @@ std::vector<traffic_simulator_msgs::msg::EntityStatus> ActionNode::getRightOfWay
 {
   std::vector<traffic_simulator_msgs::msg::EntityStatus> ret;
   const auto lanelet_ids =
-    hdmap_utils->getRightOfWayLaneletIds(entity_status.lanelet_pose.lanelet_id);
+    hdmap_utils->getRightOfWayLaneletIds(entity_status->lanelet_pose.lanelet_id);
   if (lanelet_ids.empty()) {
     return ret;
   }
-  for (const auto & status : other_entity_status) {
+  for (const auto i : getOtherEntityIndices(lanelet_ids)) {
     for (const std::int64_t & lanelet_id : lanelet_ids) {
-      if (lanelet_id == status.second.lanelet_pose.lanelet_id) {
-        ret.emplace_back(status.second);
+      if (lanelet_id == other_entity_status.getLaneletPose(i).lanelet_id) {
+        ret.emplace_back(other_entity_status.getStatus(i));
       }
     }
   }
@@ -163,6 +209,17 @@ std::vector<traffic_simulator_msgs::msg::EntityStatus> ActionNode::getRightOfWay
 boost::optional<double> ActionNode::getDistanceToTrafficLightStopLine(
   const std::vector<std::int64_t> & route_lanelets,
   const std::vector<geometry_msgs::msg::Point> & waypoints)
+{
+  if (waypoints.empty() || hdmap_utils->getTrafficLightIdsOnPath(route_lanelets).empty()) {
+    return boost::none;
+  }
+  return getDistanceToTrafficLightStopLine(
+    route_lanelets, traffic_simulator::math::CatmullRomSpline(waypoints));
+}
+
+boost::optional<double> ActionNode::getDistanceToTrafficLightStopLine(
+  const std::vector<std::int64_t> & route_lanelets,
+  const traffic_simulator::math::CatmullRomSpline & spline)
 {
   const auto traffic_light_ids = hdmap_utils->getTrafficLightIdsOnPath(route_lanelets);
   if (traffic_light_ids.empty()) {
@@ -174,7 +231,7 @@ boost::optional<double> ActionNode::getDistanceToTrafficLightStopLine(
     if (
       color == traffic_simulator::TrafficLightColor::RED ||
       color == traffic_simulator::TrafficLightColor::YELLOW) {
-      const auto collision_point = hdmap_utils->getDistanceToTrafficLightStopLine(waypoints, id);
+      const auto collision_point = hdmap_utils->getDistanceToTrafficLightStopLine(spline, id);
       if (collision_point) {
         collision_points.insert(collision_point.get());
       }
@@ -206,33 +263,46 @@ boost::optional<double> ActionNode::getDistanceToFrontEntity(
 boost::optional<std::string> ActionNode::getFrontEntityName(
   const traffic_simulator::math::CatmullRomSpline & spline)
 {
-  std::vector<double> distances;
-  std::vector<std::string> entities;
-  for (const auto & each : other_entity_status) {
-    const auto distance = getDistanceToTargetEntityPolygon(spline, each.first);
+  /**
+   * @note The polygons of the candidates are built first, so that the spline is tested against all
+   * of them in one call and its bounding boxes are shared between the entities.
+   */
+  std::vector<std::size_t> candidates;
+  std::vector<std::vector<geometry_msgs::msg::Point>> polygons;
+  for (std::size_t i = 0; i < other_entity_status.size(); ++i) {
+    if (!other_entity_status.laneletPoseValid(i)) {
+      continue;
+    }
     const auto quat = quaternion_operation::getRotation(
-      entity_status.pose.orientation, other_entity_status.at(each.first).pose.orientation);
+      entity_status->pose.orientation, other_entity_status.getPose(i).orientation);
     /**
      * @note hard-coded parameter, if the Yaw value of RPY is in ~1.5708 -> 1.5708, entity is a candidate of front entity.
      */
     if (
       std::fabs(quaternion_operation::convertQuaternionToEulerAngle(quat).z) <=
       boost::math::constants::half_pi<double>()) {
-      if (distance && distance.get() < 40) {
-        entities.emplace_back(each.first);
-        distances.emplace_back(distance.get());
-      }
+      candidates.emplace_back(i);
+      polygons.emplace_back(traffic_simulator::math::transformPoints(
+        other_entity_status.getPose(i),
+        traffic_simulator::math::getPointsFromBbox(other_entity_status.getBoundingBox(i))));
     }
   }
-  if (entities.size() != distances.size()) {
+  const auto distances = spline.getCollisionPointsIn2D(polygons, false, true);
+  if (candidates.size() != distances.size()) {
     THROW_SIMULATION_ERROR("size of entities and distances vector does not match.");
   }
-  if (distances.empty()) {
+  boost::optional<std::size_t> front;
+  for (std::size_t i = 0; i < distances.size(); ++i) {
+    if (
+      distances[i] && distances[i].get() < 40 &&
+      (!front || distances[i].get() < distances[front.get()].get())) {
+      front = i;
+    }
+  }
+  if (!front) {
     return boost::none;
   }
-  std::vector<double>::iterator iter = std::min_element(distances.begin(), distances.end());
-  size_t index = std::distance(distances.begin(), iter);
-  return entities[index];
+  return other_entity_status.getName(candidates[front.get()]);
 }
 
 boost::optional<double> ActionNode::getDistanceToTargetEntityOnCrosswalk(
@@ -249,8 +319,8 @@ boost::optional<double> ActionNode::getDistanceToTargetEntityOnCrosswalk(
 traffic_simulator_msgs::msg::EntityStatus ActionNode::getEntityStatus(
   const std::string target_name) const
 {
-  if (other_entity_status.find(target_name) != other_entity_status.end()) {
-    return other_entity_status.at(target_name);
+  if (const auto status = other_entity_status.getStatus(target_name)) {
+    return status.get();
   }
   THROW_SIMULATION_ERROR("other entity : ", target_name, " does not exist.");
 }
@@ -275,15 +345,25 @@ boost::optional<double> ActionNode::getDistanceToTargetEntityPolygon(
   double width_extension_left, double length_extension_front, double length_extension_rear)
 {
   if (status.lanelet_pose_valid) {
-    const auto polygon = traffic_simulator::math::transformPoints(
-      status.pose, traffic_simulator::math::getPointsFromBbox(
-                     status.bounding_box, width_extension_right, width_extension_left,
-                     length_extension_front, length_extension_rear));
-    return spline.getCollisionPointIn2D(polygon, false, true);
+    return getDistanceToTargetEntityPolygon(
+      spline, status.pose, status.bounding_box, width_extension_right, width_extension_left,
+      length_extension_front, length_extension_rear);
   }
   return boost::none;
 }
 
+boost::optional<double> ActionNode::getDistanceToTargetEntityPolygon(
+  const traffic_simulator::math::CatmullRomSpline & spline, const geometry_msgs::msg::Pose & pose,
+  const traffic_simulator_msgs::msg::BoundingBox & bounding_box, double width_extension_right,
+  double width_extension_left, double length_extension_front, double length_extension_rear)
+{
+  const auto polygon = traffic_simulator::math::transformPoints(
+    pose, traffic_simulator::math::getPointsFromBbox(
+            bounding_box, width_extension_right, width_extension_left, length_extension_front,
+            length_extension_rear));
+  return spline.getCollisionPointIn2D(polygon, false, true);
+}
+
 boost::optional<double> ActionNode::getDistanceToConflictingEntity(
   const std::vector<std::int64_t> & route_lanelets,
   const traffic_simulator::math::CatmullRomSpline & spline)
@@ -315,12 +395,12 @@ ActionNode::getConflictingEntityStatusOnCrossWalk(
 {
   std::vector<traffic_simulator_msgs::msg::EntityStatus> conflicting_entity_status;
   auto conflicting_crosswalks = hdmap_utils->getConflictingCrosswalkIds(route_lanelets);
-  for (const auto & status : other_entity_status) {
+  for (std::size_t i = 0; i < other_entity_status.size(); ++i) {
     if (
       std::count(
         conflicting_crosswalks.begin(), conflicting_crosswalks.end(),
-        status.second.lanelet_pose.lanelet_id) >= 1) {
-      conflicting_entity_status.push_back(status.second);
+        other_entity_status.getLaneletPose(i).lanelet_id) >= 1) {
+      conflicting_entity_status.push_back(other_entity_status.getStatus(i));
     }
   }
   return conflicting_entity_status;
@@ -331,12 +411,12 @@ std::vector<traffic_simulator_msgs::msg::EntityStatus> ActionNode::getConflictin
 {
   std::vector<traffic_simulator_msgs::msg::EntityStatus> conflicting_entity_status;
   auto conflicting_lanes = hdmap_utils->getConflictingLaneIds(route_lanelets);
-  for (const auto & status : other_entity_status) {
+  for (std::size_t i = 0; i < other_entity_status.size(); ++i) {
     if (
       std::count(
         conflicting_lanes.begin(), conflicting_lanes.end(),
-        status.second.lanelet_pose.lanelet_id) >= 1) {
-      conflicting_entity_status.push_back(status.second);
+        other_entity_status.getLaneletPose(i).lanelet_id) >= 1) {
+      conflicting_entity_status.push_back(other_entity_status.getStatus(i));
     }
   }
   return conflicting_entity_status;
@@ -346,17 +426,13 @@ bool ActionNode::foundConflictingEntity(const std::vector<std::int64_t> & follow
 {
   auto conflicting_crosswalks = hdmap_utils->getConflictingCrosswalkIds(following_lanelets);
   auto conflicting_lanes = hdmap_utils->getConflictingLaneIds(following_lanelets);
-  for (const auto & status : other_entity_status) {
+  for (std::size_t i = 0; i < other_entity_status.size(); ++i) {
+    const auto lanelet_id = other_entity_status.getLaneletPose(i).lanelet_id;
     if (
-      std::count(
-        conflicting_crosswalks.begin(), conflicting_crosswalks.end(),
-        status.second.lanelet_pose.lanelet_id) >= 1) {
+      std::count(conflicting_crosswalks.begin(), conflicting_crosswalks.end(), lanelet_id) >= 1) {
       return true;
     }
-    if (
-      std::count(
-        conflicting_lanes.begin(), conflicting_lanes.end(),
-        status.second.lanelet_pose.lanelet_id) >= 1) {
+    if (std::count(conflicting_lanes.begin(), conflicting_lanes.end(), lanelet_id) >= 1) {
       return true;
     }
   }
@@ -365,6 +441,6 @@ bool ActionNode::foundConflictingEntity(const std::vector<std::int64_t> & follow
 
 double ActionNode::calculateStopDistance() const
 {
-  return std::pow(entity_status.action_status.twist.linear.x, 2) / (2 * 5);
+  return std::pow(entity_status->action_status.twist.linear.x, 2) / (2 * 5);
 }
 }  // namespace entity_behavior
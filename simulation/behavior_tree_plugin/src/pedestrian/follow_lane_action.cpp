@@ -38,12 +38,12 @@ BT::NodeStatus FollowLaneAction::tick()
   if (request != "none" && request != "follow_lane") {
     return BT::NodeStatus::FAILURE;
   }
-  if (!entity_status.lanelet_pose_valid) {
+  if (!entity_status->lanelet_pose_valid) {
     setOutput("updated_status", stopAtEndOfRoad());
     return BT::NodeStatus::RUNNING;
   }
   auto following_lanelets =
-    hdmap_utils->getFollowingLanelets(entity_status.lanelet_pose.lanelet_id);
+    hdmap_utils->getFollowingLanelets(entity_status->lanelet_pose.lanelet_id);
   if (!target_speed) {
     target_speed = hdmap_utils->getSpeedLimit(following_lanelets);
   }
@@ -23,7 +23,9 @@
 #include <behavior_tree_plugin/vehicle/follow_lane_sequence/stop_at_traffic_light_action.hpp>
 #include <behavior_tree_plugin/vehicle/follow_lane_sequence/yield_action.hpp>
 #include <behavior_tree_plugin/vehicle/lane_change_action.hpp>
+#include <behavior_tree_plugin/vehicle/trajectory_cache.hpp>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <traffic_simulator_msgs/msg/driver_model.hpp>
 #include <utility>
@@ -52,6 +54,8 @@ void VehicleBehaviorTree::configure(const rclcpp::Logger & logger)
     "MoveBackward");
   factory_.registerNodeType<entity_behavior::vehicle::LaneChangeAction>("LaneChange");
   tree_ = factory_.createTreeFromFile(path);
+  tree_.rootBlackboard()->set<std::shared_ptr<entity_behavior::vehicle::TrajectoryCache>>(
+    "trajectory_cache", std::make_shared<entity_behavior::vehicle::TrajectoryCache>());
 
   logging_event_ptr_ =
     std::make_unique<behavior_tree_plugin::LoggingEvent>(tree_.rootNode(), logger);
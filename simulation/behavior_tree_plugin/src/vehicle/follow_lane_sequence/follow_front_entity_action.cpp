@@ -52,20 +52,7 @@ FollowFrontEntityAction::calculateObstacle(const traffic_simulator_msgs::msg::Wa
 
 const traffic_simulator_msgs::msg::WaypointsArray FollowFrontEntityAction::calculateWaypoints()
 {
-  if (!entity_status.lanelet_pose_valid) {
-    THROW_SIMULATION_ERROR("failed to assign lane");
-  }
-  if (entity_status.action_status.twist.linear.x >= 0) {
-    traffic_simulator_msgs::msg::WaypointsArray waypoints;
-    double horizon =
-      boost::algorithm::clamp(entity_status.action_status.twist.linear.x * 5, 20, 50);
-    waypoints.waypoints = reference_trajectory->getTrajectory(
-      entity_status.lanelet_pose.s, entity_status.lanelet_pose.s + horizon, 1.0,
-      entity_status.lanelet_pose.offset);
-    return waypoints;
-  } else {
-    return traffic_simulator_msgs::msg::WaypointsArray();
-  }
+  return getTrajectoryAhead()->waypoints;
 }
 
 BT::NodeStatus FollowFrontEntityAction::tick()
@@ -74,20 +61,20 @@ BT::NodeStatus FollowFrontEntityAction::tick()
   if (request != "none" && request != "follow_lane") {
     return BT::NodeStatus::FAILURE;
   }
-  if (getRightOfWayEntities(route_lanelets).size() != 0) {
+  if (getRightOfWayEntities(*route_lanelets).size() != 0) {
     return BT::NodeStatus::FAILURE;
   }
   if (!driver_model.see_around) {
     return BT::NodeStatus::FAILURE;
   }
-  const auto waypoints = calculateWaypoints();
+  const auto trajectory = getTrajectoryAhead();
+  const auto & waypoints = trajectory->waypoints;
   if (waypoints.waypoints.empty()) {
     return BT::NodeStatus::FAILURE;
   }
-  auto distance_to_stopline =
-    hdmap_utils->getDistanceToStopLine(route_lanelets, waypoints.waypoints);
-  const auto spline = traffic_simulator::math::CatmullRomSpline(waypoints.waypoints);
-  auto distance_to_conflicting_entity = getDistanceToConflictingEntity(route_lanelets, spline);
+  const auto & spline = trajectory->getSpline();
+  auto distance_to_stopline = hdmap_utils->getDistanceToStopLine(*route_lanelets, spline);
+  auto distance_to_conflicting_entity = getDistanceToConflictingEntity(*route_lanelets, spline);
   const auto front_entity_name = getFrontEntityName(spline);
   if (!front_entity_name) {
     return BT::NodeStatus::FAILURE;
@@ -108,7 +95,7 @@ BT::NodeStatus FollowFrontEntityAction::tick()
   }
   auto front_entity_status = getEntityStatus(front_entity_name.get());
   if (!target_speed) {
-    target_speed = hdmap_utils->getSpeedLimit(route_lanelets);
+    target_speed = hdmap_utils->getSpeedLimit(*route_lanelets);
   }
   if (target_speed.get() <= front_entity_status.action_status.twist.linear.x) {
     auto entity_status_updated = calculateEntityStatusUpdated(target_speed.get());
@@ -120,7 +107,7 @@ BT::NodeStatus FollowFrontEntityAction::tick()
   }
   if (
     distance_to_front_entity_.get() >=
-    (calculateStopDistance() + vehicle_parameters.bounding_box.dimensions.x + 5)) {
+    (calculateStopDistance() + vehicle_parameters->bounding_box.dimensions.x + 5)) {
     auto entity_status_updated =
       calculateEntityStatusUpdated(front_entity_status.action_status.twist.linear.x + 2);
     setOutput("updated_status", entity_status_updated);
@@ -39,18 +39,7 @@ const boost::optional<traffic_simulator_msgs::msg::Obstacle> FollowLaneAction::c
 
 const traffic_simulator_msgs::msg::WaypointsArray FollowLaneAction::calculateWaypoints()
 {
-  if (!entity_status.lanelet_pose_valid) {
-    THROW_SIMULATION_ERROR("failed to assign lane");
-  }
-  if (entity_status.action_status.twist.linear.x >= 0) {
-    traffic_simulator_msgs::msg::WaypointsArray waypoints;
-    waypoints.waypoints = reference_trajectory->getTrajectory(
-      entity_status.lanelet_pose.s, entity_status.lanelet_pose.s + getHorizon(), 1.0,
-      entity_status.lanelet_pose.offset);
-    return waypoints;
-  } else {
-    return traffic_simulator_msgs::msg::WaypointsArray();
-  }
+  return getTrajectoryAhead()->waypoints;
 }
 
 void FollowLaneAction::getBlackBoardValues()
@@ -71,54 +60,54 @@ BT::NodeStatus FollowLaneAction::tick()
   if (request != "none" && request != "follow_lane") {
     return BT::NodeStatus::FAILURE;
   }
-  if (!entity_status.lanelet_pose_valid) {
+  if (!entity_status->lanelet_pose_valid) {
     setOutput("updated_status", stopAtEndOfRoad());
     return BT::NodeStatus::RUNNING;
   }
-  const auto waypoints = calculateWaypoints();
+  const auto trajectory = getTrajectoryAhead();
+  const auto & waypoints = trajectory->waypoints;
   if (waypoints.waypoints.empty()) {
     return BT::NodeStatus::FAILURE;
   }
   if (driver_model.see_around) {
-    if (getRightOfWayEntities(route_lanelets).size() != 0) {
+    if (getRightOfWayEntities(*route_lanelets).size() != 0) {
       return BT::NodeStatus::FAILURE;
     }
-    const auto spline = traffic_simulator::math::CatmullRomSpline(waypoints.waypoints);
+    const auto & spline = trajectory->getSpline();
     auto distance_to_front_entity = getDistanceToFrontEntity(spline);
     if (distance_to_front_entity) {
       if (
         distance_to_front_entity.get() <=
-        calculateStopDistance() + vehicle_parameters.bounding_box.dimensions.x + 5) {
+        calculateStopDistance() + vehicle_parameters->bounding_box.dimensions.x + 5) {
         return BT::NodeStatus::FAILURE;
       }
     }
     const auto distance_to_traffic_stop_line =
-      getDistanceToTrafficLightStopLine(route_lanelets, waypoints.waypoints);
+      getDistanceToTrafficLightStopLine(*route_lanelets, spline);
     if (distance_to_traffic_stop_line) {
       if (distance_to_traffic_stop_line.get() <= getHorizon()) {
         return BT::NodeStatus::FAILURE;
       }
     }
-    auto distance_to_stopline =
-      hdmap_utils->getDistanceToStopLine(route_lanelets, waypoints.waypoints);
-    auto distance_to_conflicting_entity = getDistanceToConflictingEntity(route_lanelets, spline);
+    auto distance_to_stopline = hdmap_utils->getDistanceToStopLine(*route_lanelets, spline);
+    auto distance_to_conflicting_entity = getDistanceToConflictingEntity(*route_lanelets, spline);
     if (distance_to_stopline) {
       if (
         distance_to_stopline.get() <=
-        calculateStopDistance() + vehicle_parameters.bounding_box.dimensions.x * 0.5 + 5) {
+        calculateStopDistance() + vehicle_parameters->bounding_box.dimensions.x * 0.5 + 5) {
         return BT::NodeStatus::FAILURE;
       }
     }
     if (distance_to_conflicting_entity) {
       if (
         distance_to_conflicting_entity.get() <
-        (vehicle_parameters.bounding_box.dimensions.x + calculateStopDistance())) {
+        (vehicle_parameters->bounding_box.dimensions.x + calculateStopDistance())) {
         return BT::NodeStatus::FAILURE;
       }
     }
   }
   if (!target_speed) {
-    target_speed = hdmap_utils->getSpeedLimit(route_lanelets);
+    target_speed = hdmap_utils->getSpeedLimit(*route_lanelets);
   }
   auto updated_status = calculateEntityStatusUpdated(target_speed.get());
   setOutput("updated_status", updated_status);
@@ -34,19 +34,19 @@ const boost::optional<traffic_simulator_msgs::msg::Obstacle> MoveBackwardAction:
 
 const traffic_simulator_msgs::msg::WaypointsArray MoveBackwardAction::calculateWaypoints()
 {
-  if (!entity_status.lanelet_pose_valid) {
+  if (!entity_status->lanelet_pose_valid) {
     THROW_SIMULATION_ERROR("failed to assign lane");
   }
-  if (entity_status.action_status.twist.linear.x >= 0) {
+  if (entity_status->action_status.twist.linear.x >= 0) {
     return traffic_simulator_msgs::msg::WaypointsArray();
   }
-  const auto ids = hdmap_utils->getPreviousLanelets(entity_status.lanelet_pose.lanelet_id);
+  const auto ids = hdmap_utils->getPreviousLanelets(entity_status->lanelet_pose.lanelet_id);
   // DIFFERENT SPLINE - recalculation needed
   traffic_simulator::math::CatmullRomSpline spline(hdmap_utils->getCenterPoints(ids));
   double s_in_spline = 0;
   for (const auto id : ids) {
-    if (id == entity_status.lanelet_pose.lanelet_id) {
-      s_in_spline = s_in_spline + entity_status.lanelet_pose.s;
+    if (id == entity_status->lanelet_pose.lanelet_id) {
+      s_in_spline = s_in_spline + entity_status->lanelet_pose.s;
       break;
     } else {
       s_in_spline = hdmap_utils->getLaneletLength(id) + s_in_spline;
@@ -54,7 +54,7 @@ const traffic_simulator_msgs::msg::WaypointsArray MoveBackwardAction::calculateW
   }
   traffic_simulator_msgs::msg::WaypointsArray waypoints;
   waypoints.waypoints =
-    spline.getTrajectory(s_in_spline, s_in_spline - 5, 1.0, entity_status.lanelet_pose.offset);
+    spline.getTrajectory(s_in_spline, s_in_spline - 5, 1.0, entity_status->lanelet_pose.offset);
   return waypoints;
 }
 
@@ -66,7 +66,7 @@ BT::NodeStatus MoveBackwardAction::tick()
   if (request != "none" && request != "follow_lane") {
     return BT::NodeStatus::FAILURE;
   }
-  if (!entity_status.lanelet_pose_valid) {
+  if (!entity_status->lanelet_pose_valid) {
     return BT::NodeStatus::FAILURE;
   }
   const auto waypoints = calculateWaypoints();
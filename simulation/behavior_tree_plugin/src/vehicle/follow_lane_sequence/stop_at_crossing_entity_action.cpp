@@ -53,18 +53,7 @@ StopAtCrossingEntityAction::calculateObstacle(const traffic_simulator_msgs::msg:
 
 const traffic_simulator_msgs::msg::WaypointsArray StopAtCrossingEntityAction::calculateWaypoints()
 {
-  if (!entity_status.lanelet_pose_valid) {
-    THROW_SIMULATION_ERROR("failed to assign lane");
-  }
-  if (entity_status.action_status.twist.linear.x >= 0) {
-    traffic_simulator_msgs::msg::WaypointsArray waypoints;
-    waypoints.waypoints = reference_trajectory->getTrajectory(
-      entity_status.lanelet_pose.s, entity_status.lanelet_pose.s + getHorizon(), 1.0,
-      entity_status.lanelet_pose.offset);
-    return waypoints;
-  } else {
-    return traffic_simulator_msgs::msg::WaypointsArray();
-  }
+  return getTrajectoryAhead()->waypoints;
 }
 
 boost::optional<double> StopAtCrossingEntityAction::calculateTargetSpeed(double current_velocity)
@@ -73,7 +62,7 @@ boost::optional<double> StopAtCrossingEntityAction::calculateTargetSpeed(double
     return boost::none;
   }
   double rest_distance =
-    distance_to_stop_target_.get() - (vehicle_parameters.bounding_box.dimensions.x + 3);
+    distance_to_stop_target_.get() - (vehicle_parameters->bounding_box.dimensions.x + 3);
   if (rest_distance < calculateStopDistance()) {
     if (rest_distance > 0) {
       return std::sqrt(2 * driver_model.deceleration * rest_distance);
@@ -91,7 +80,7 @@ BT::NodeStatus StopAtCrossingEntityAction::tick()
     in_stop_sequence_ = false;
     return BT::NodeStatus::FAILURE;
   }
-  if (!entity_status.lanelet_pose_valid) {
+  if (!entity_status->lanelet_pose_valid) {
     in_stop_sequence_ = false;
     return BT::NodeStatus::FAILURE;
   }
@@ -99,18 +88,18 @@ BT::NodeStatus StopAtCrossingEntityAction::tick()
     in_stop_sequence_ = false;
     return BT::NodeStatus::FAILURE;
   }
-  if (getRightOfWayEntities(route_lanelets).size() != 0) {
+  if (getRightOfWayEntities(*route_lanelets).size() != 0) {
     in_stop_sequence_ = false;
     return BT::NodeStatus::FAILURE;
   }
-  const auto waypoints = calculateWaypoints();
+  const auto trajectory = getTrajectoryAhead();
+  const auto & waypoints = trajectory->waypoints;
   if (waypoints.waypoints.empty()) {
     return BT::NodeStatus::FAILURE;
   }
-  const auto spline = traffic_simulator::math::CatmullRomSpline(waypoints.waypoints);
-  distance_to_stop_target_ = getDistanceToConflictingEntity(route_lanelets, spline);
-  auto distance_to_stopline =
-    hdmap_utils->getDistanceToStopLine(route_lanelets, waypoints.waypoints);
+  const auto & spline = trajectory->getSpline();
+  distance_to_stop_target_ = getDistanceToConflictingEntity(*route_lanelets, spline);
+  auto distance_to_stopline = hdmap_utils->getDistanceToStopLine(*route_lanelets, spline);
   const auto distance_to_front_entity = getDistanceToFrontEntity(spline);
   if (!distance_to_stop_target_) {
     in_stop_sequence_ = false;
@@ -130,7 +119,7 @@ BT::NodeStatus StopAtCrossingEntityAction::tick()
   }
   boost::optional<double> target_linear_speed;
   if (distance_to_stop_target_) {
-    target_linear_speed = calculateTargetSpeed(entity_status.action_status.twist.linear.x);
+    target_linear_speed = calculateTargetSpeed(entity_status->action_status.twist.linear.x);
   } else {
     target_linear_speed = boost::none;
   }
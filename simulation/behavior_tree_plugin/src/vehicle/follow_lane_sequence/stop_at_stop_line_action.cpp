@@ -53,20 +53,7 @@ StopAtStopLineAction::calculateObstacle(const traffic_simulator_msgs::msg::Waypo
 
 const traffic_simulator_msgs::msg::WaypointsArray StopAtStopLineAction::calculateWaypoints()
 {
-  if (!entity_status.lanelet_pose_valid) {
-    THROW_SIMULATION_ERROR("failed to assign lane");
-  }
-  if (entity_status.action_status.twist.linear.x >= 0) {
-    traffic_simulator_msgs::msg::WaypointsArray waypoints;
-    double horizon =
-      boost::algorithm::clamp(entity_status.action_status.twist.linear.x * 5, 20, 50);
-    waypoints.waypoints = reference_trajectory->getTrajectory(
-      entity_status.lanelet_pose.s, entity_status.lanelet_pose.s + horizon, 1.0,
-      entity_status.lanelet_pose.offset);
-    return waypoints;
-  } else {
-    return traffic_simulator_msgs::msg::WaypointsArray();
-  }
+  return getTrajectoryAhead()->waypoints;
 }
 
 boost::optional<double> StopAtStopLineAction::calculateTargetSpeed(double current_velocity)
@@ -75,7 +62,7 @@ boost::optional<double> StopAtStopLineAction::calculateTargetSpeed(double curren
     return boost::none;
   }
   double rest_distance =
-    distance_to_stopline_.get() - (vehicle_parameters.bounding_box.dimensions.x);
+    distance_to_stopline_.get() - (vehicle_parameters->bounding_box.dimensions.x);
   if (rest_distance < calculateStopDistance()) {
     if (rest_distance > 0) {
       return std::sqrt(2 * driver_model.deceleration * rest_distance);
@@ -96,16 +83,17 @@ BT::NodeStatus StopAtStopLineAction::tick()
   if (!driver_model.see_around) {
     return BT::NodeStatus::FAILURE;
   }
-  if (getRightOfWayEntities(route_lanelets).size() != 0) {
+  if (getRightOfWayEntities(*route_lanelets).size() != 0) {
     return BT::NodeStatus::FAILURE;
   }
-  const auto waypoints = calculateWaypoints();
+  const auto trajectory = getTrajectoryAhead();
+  const auto & waypoints = trajectory->waypoints;
   if (waypoints.waypoints.empty()) {
     return BT::NodeStatus::FAILURE;
   }
-  distance_to_stopline_ = hdmap_utils->getDistanceToStopLine(route_lanelets, waypoints.waypoints);
-  const auto spline = traffic_simulator::math::CatmullRomSpline(waypoints.waypoints);
-  const auto distance_to_stop_target = getDistanceToConflictingEntity(route_lanelets, spline);
+  const auto & spline = trajectory->getSpline();
+  distance_to_stopline_ = hdmap_utils->getDistanceToStopLine(*route_lanelets, spline);
+  const auto distance_to_stop_target = getDistanceToConflictingEntity(*route_lanelets, spline);
   const auto distance_to_front_entity = getDistanceToFrontEntity(spline);
   if (!distance_to_stopline_) {
     stopped_ = false;
@@ -124,16 +112,16 @@ BT::NodeStatus StopAtStopLineAction::tick()
     }
   }
 
-  if (std::fabs(entity_status.action_status.twist.linear.x) < 0.001) {
+  if (std::fabs(entity_status->action_status.twist.linear.x) < 0.001) {
     if (distance_to_stopline_) {
-      if (distance_to_stopline_.get() <= vehicle_parameters.bounding_box.dimensions.x + 5) {
+      if (distance_to_stopline_.get() <= vehicle_parameters->bounding_box.dimensions.x + 5) {
         stopped_ = true;
       }
     }
   }
   if (stopped_) {
     if (!target_speed) {
-      target_speed = hdmap_utils->getSpeedLimit(route_lanelets);
+      target_speed = hdmap_utils->getSpeedLimit(*route_lanelets);
     }
     if (!distance_to_stopline_) {
       stopped_ = false;
@@ -149,7 +137,7 @@ BT::NodeStatus StopAtStopLineAction::tick()
     setOutput("obstacle", obstacle);
     return BT::NodeStatus::RUNNING;
   }
-  auto target_linear_speed = calculateTargetSpeed(entity_status.action_status.twist.linear.x);
+  auto target_linear_speed = calculateTargetSpeed(entity_status->action_status.twist.linear.x);
   if (!target_linear_speed) {
     stopped_ = false;
     return BT::NodeStatus::FAILURE;
@@ -52,18 +52,7 @@ StopAtTrafficLightAction::calculateObstacle(const traffic_simulator_msgs::msg::W
 
 const traffic_simulator_msgs::msg::WaypointsArray StopAtTrafficLightAction::calculateWaypoints()
 {
-  if (!entity_status.lanelet_pose_valid) {
-    THROW_SIMULATION_ERROR("failed to assign lane");
-  }
-  if (entity_status.action_status.twist.linear.x >= 0) {
-    traffic_simulator_msgs::msg::WaypointsArray waypoints;
-    waypoints.waypoints = reference_trajectory->getTrajectory(
-      entity_status.lanelet_pose.s, entity_status.lanelet_pose.s + getHorizon(), 1.0,
-      entity_status.lanelet_pose.offset);
-    return waypoints;
-  } else {
-    return traffic_simulator_msgs::msg::WaypointsArray();
-  }
+  return getTrajectoryAhead()->waypoints;
 }
 
 boost::optional<double> StopAtTrafficLightAction::calculateTargetSpeed(double current_velocity)
@@ -72,7 +61,7 @@ boost::optional<double> StopAtTrafficLightAction::calculateTargetSpeed(double cu
     return boost::none;
   }
   double rest_distance =
-    distance_to_stop_target_.get() - (vehicle_parameters.bounding_box.dimensions.x + 3);
+    distance_to_stop_target_.get() - (vehicle_parameters->bounding_box.dimensions.x + 3);
   if (rest_distance < calculateStopDistance()) {
     if (rest_distance > 0) {
       return std::sqrt(2 * driver_model.deceleration * rest_distance);
@@ -89,32 +78,33 @@ BT::NodeStatus StopAtTrafficLightAction::tick()
   if (request != "none" && request != "follow_lane") {
     return BT::NodeStatus::FAILURE;
   }
-  if (!entity_status.lanelet_pose_valid) {
+  if (!entity_status->lanelet_pose_valid) {
     return BT::NodeStatus::FAILURE;
   }
   if (!driver_model.see_around) {
     return BT::NodeStatus::FAILURE;
   }
-  if (getRightOfWayEntities(route_lanelets).size() != 0) {
+  if (getRightOfWayEntities(*route_lanelets).size() != 0) {
     return BT::NodeStatus::FAILURE;
   }
-  const auto waypoints = calculateWaypoints();
+  const auto trajectory = getTrajectoryAhead();
+  const auto & waypoints = trajectory->waypoints;
   if (waypoints.waypoints.empty()) {
     return BT::NodeStatus::FAILURE;
   }
-  const auto spline = traffic_simulator::math::CatmullRomSpline(waypoints.waypoints);
+  const auto & spline = trajectory->getSpline();
   const auto distance_to_traffic_stop_line =
-    hdmap_utils->getDistanceToTrafficLightStopLine(route_lanelets, waypoints.waypoints);
+    hdmap_utils->getDistanceToTrafficLightStopLine(*route_lanelets, spline);
   if (!distance_to_traffic_stop_line) {
     return BT::NodeStatus::FAILURE;
   }
-  distance_to_stop_target_ = getDistanceToTrafficLightStopLine(route_lanelets, waypoints.waypoints);
+  distance_to_stop_target_ = getDistanceToTrafficLightStopLine(*route_lanelets, spline);
   boost::optional<double> target_linear_speed;
   if (distance_to_stop_target_) {
     if (distance_to_stop_target_.get() > getHorizon()) {
       return BT::NodeStatus::FAILURE;
     }
-    target_linear_speed = calculateTargetSpeed(entity_status.action_status.twist.linear.x);
+    target_linear_speed = calculateTargetSpeed(entity_status->action_status.twist.linear.x);
   } else {
     return BT::NodeStatus::FAILURE;
   }
@@ -52,20 +52,7 @@ const boost::optional<traffic_simulator_msgs::msg::Obstacle> YieldAction::calcul
 
 const traffic_simulator_msgs::msg::WaypointsArray YieldAction::calculateWaypoints()
 {
-  if (!entity_status.lanelet_pose_valid) {
-    THROW_SIMULATION_ERROR("failed to assign lane");
-  }
-  if (entity_status.action_status.twist.linear.x >= 0) {
-    traffic_simulator_msgs::msg::WaypointsArray waypoints;
-    double horizon =
-      boost::algorithm::clamp(entity_status.action_status.twist.linear.x * 5, 20, 50);
-    waypoints.waypoints = reference_trajectory->getTrajectory(
-      entity_status.lanelet_pose.s, entity_status.lanelet_pose.s + horizon, 1.0,
-      entity_status.lanelet_pose.offset);
-    return waypoints;
-  } else {
-    return traffic_simulator_msgs::msg::WaypointsArray();
-  }
+  return getTrajectoryAhead()->waypoints;
 }
 
 boost::optional<double> YieldAction::calculateTargetSpeed()
@@ -74,7 +61,7 @@ boost::optional<double> YieldAction::calculateTargetSpeed()
     return boost::none;
   }
   double rest_distance =
-    distance_to_stop_target_.get() - (vehicle_parameters.bounding_box.dimensions.x) - 10;
+    distance_to_stop_target_.get() - (vehicle_parameters->bounding_box.dimensions.x) - 10;
   if (rest_distance < calculateStopDistance()) {
     if (rest_distance > 0) {
       return std::sqrt(2 * driver_model.deceleration * rest_distance);
@@ -82,7 +69,7 @@ boost::optional<double> YieldAction::calculateTargetSpeed()
       return 0;
     }
   }
-  return entity_status.action_status.twist.linear.x;
+  return entity_status->action_status.twist.linear.x;
 }
 
 BT::NodeStatus YieldAction::tick()
@@ -94,13 +81,13 @@ BT::NodeStatus YieldAction::tick()
   if (!driver_model.see_around) {
     return BT::NodeStatus::FAILURE;
   }
-  if (!entity_status.lanelet_pose_valid) {
+  if (!entity_status->lanelet_pose_valid) {
     return BT::NodeStatus::FAILURE;
   }
-  const auto right_of_way_entities = getRightOfWayEntities(route_lanelets);
+  const auto right_of_way_entities = getRightOfWayEntities(*route_lanelets);
   if (right_of_way_entities.empty()) {
     if (!target_speed) {
-      target_speed = hdmap_utils->getSpeedLimit(route_lanelets);
+      target_speed = hdmap_utils->getSpeedLimit(*route_lanelets);
     }
     setOutput("updated_status", calculateEntityStatusUpdated(target_speed.get()));
     const auto waypoints = calculateWaypoints();
@@ -112,10 +99,10 @@ BT::NodeStatus YieldAction::tick()
     setOutput("obstacle", obstacle);
     return BT::NodeStatus::SUCCESS;
   }
-  distance_to_stop_target_ = getYieldStopDistance(route_lanelets);
+  distance_to_stop_target_ = getYieldStopDistance(*route_lanelets);
   target_speed = calculateTargetSpeed();
   if (!target_speed) {
-    target_speed = hdmap_utils->getSpeedLimit(route_lanelets);
+    target_speed = hdmap_utils->getSpeedLimit(*route_lanelets);
   }
   setOutput("updated_status", calculateEntityStatusUpdated(target_speed.get()));
   const auto waypoints = calculateWaypoints();
@@ -46,10 +46,10 @@ const traffic_simulator_msgs::msg::WaypointsArray LaneChangeAction::calculateWay
   if (!lane_change_parameters_) {
     THROW_SIMULATION_ERROR("lane change parameter is null");
   }
-  if (entity_status.action_status.twist.linear.x >= 0) {
+  if (entity_status->action_status.twist.linear.x >= 0) {
     traffic_simulator_msgs::msg::WaypointsArray waypoints;
     double horizon =
-      boost::algorithm::clamp(entity_status.action_status.twist.linear.x * 5, 20, 50);
+      boost::algorithm::clamp(entity_status->action_status.twist.linear.x * 5, 20, 50);
     auto following_lanelets =
       hdmap_utils->getFollowingLanelets(lane_change_parameters_->target.lanelet_id, 0);
     double l = curve_->getLength();
@@ -104,7 +104,7 @@ BT::NodeStatus LaneChangeAction::tick()
   if (!curve_) {
     if (request == "lane_change") {
       if (!hdmap_utils->canChangeLane(
-            entity_status.lanelet_pose.lanelet_id, lane_change_parameters_->target.lanelet_id)) {
+            entity_status->lanelet_pose.lanelet_id, lane_change_parameters_->target.lanelet_id)) {
         return BT::NodeStatus::FAILURE;
       }
       boost::optional<std::pair<traffic_simulator::math::HermiteCurve, double>> traj_with_goal;
@@ -112,30 +112,30 @@ BT::NodeStatus LaneChangeAction::tick()
       switch (lane_change_parameters_->constraint.type) {
         case traffic_simulator::lane_change::Constraint::Type::NONE:
           traj_with_goal = hdmap_utils->getLaneChangeTrajectory(
-            hdmap_utils->toMapPose(entity_status.lanelet_pose).pose, lane_change_parameters_.get(),
+            hdmap_utils->toMapPose(entity_status->lanelet_pose).pose, lane_change_parameters_.get(),
             10.0, 20.0, 1.0);
           along_pose = hdmap_utils->getAlongLaneletPose(
-            entity_status.lanelet_pose,
+            entity_status->lanelet_pose,
             traffic_simulator::lane_change::Parameter::default_lanechange_distance);
           break;
         case traffic_simulator::lane_change::Constraint::Type::LATERAL_VELOCITY:
           traj_with_goal = hdmap_utils->getLaneChangeTrajectory(
-            entity_status.lanelet_pose, lane_change_parameters_.get());
+            entity_status->lanelet_pose, lane_change_parameters_.get());
           along_pose = hdmap_utils->getAlongLaneletPose(
-            entity_status.lanelet_pose,
+            entity_status->lanelet_pose,
             traffic_simulator::lane_change::Parameter::default_lanechange_distance);
           break;
         case traffic_simulator::lane_change::Constraint::Type::LONGITUDINAL_DISTANCE:
           traj_with_goal = hdmap_utils->getLaneChangeTrajectory(
-            entity_status.lanelet_pose, lane_change_parameters_.get());
+            entity_status->lanelet_pose, lane_change_parameters_.get());
           along_pose = hdmap_utils->getAlongLaneletPose(
-            entity_status.lanelet_pose, lane_change_parameters_->constraint.value);
+            entity_status->lanelet_pose, lane_change_parameters_->constraint.value);
           break;
         case traffic_simulator::lane_change::Constraint::Type::TIME:
           traj_with_goal = hdmap_utils->getLaneChangeTrajectory(
-            entity_status.lanelet_pose, lane_change_parameters_.get());
+            entity_status->lanelet_pose, lane_change_parameters_.get());
           along_pose = hdmap_utils->getAlongLaneletPose(
-            entity_status.lanelet_pose, lane_change_parameters_->constraint.value);
+            entity_status->lanelet_pose, lane_change_parameters_->constraint.value);
           break;
       }
       if (traj_with_goal) {
@@ -149,14 +149,14 @@ BT::NodeStatus LaneChangeAction::tick()
             .position.y);
         switch (lane_change_parameters_->constraint.type) {
           case traffic_simulator::lane_change::Constraint::Type::NONE:
-            lane_change_velocity_ = entity_status.action_status.twist.linear.x;
+            lane_change_velocity_ = entity_status->action_status.twist.linear.x;
             break;
           case traffic_simulator::lane_change::Constraint::Type::LATERAL_VELOCITY:
             lane_change_velocity_ =
               curve_->getLength() / (offset / lane_change_parameters_->constraint.value);
             break;
           case traffic_simulator::lane_change::Constraint::Type::LONGITUDINAL_DISTANCE:
-            lane_change_velocity_ = entity_status.action_status.twist.linear.x;
+            lane_change_velocity_ = entity_status->action_status.twist.linear.x;
             break;
           case traffic_simulator::lane_change::Constraint::Type::TIME:
             lane_change_velocity_ = curve_->getLength() / lane_change_parameters_->constraint.value;
@@ -169,23 +169,23 @@ BT::NodeStatus LaneChangeAction::tick()
   }
   if (curve_) {
     double target_accel = 0;
+    auto action_status = entity_status->action_status;
     switch (lane_change_parameters_->constraint.policy) {
       /**
        * @brief Force changing speed in order to fullfill constraint.
        */
       case traffic_simulator::lane_change::Constraint::Policy::FORCE:
-        entity_status.action_status.twist = geometry_msgs::msg::Twist();
-        entity_status.action_status.accel = geometry_msgs::msg::Accel();
-        entity_status.action_status.twist.linear.x = lane_change_velocity_;
-        current_s_ = current_s_ + entity_status.action_status.twist.linear.x * step_time;
+        action_status.twist = geometry_msgs::msg::Twist();
+        action_status.accel = geometry_msgs::msg::Accel();
+        action_status.twist.linear.x = lane_change_velocity_;
+        current_s_ = current_s_ + action_status.twist.linear.x * step_time;
         break;
       /**
        * @brief Changing linear speed and try to fullfill constraint.
        */
       case traffic_simulator::lane_change::Constraint::Policy::BEST_EFFORT:
-        target_accel =
-          (lane_change_velocity_ - entity_status.action_status.twist.linear.x) / step_time;
-        if (entity_status.action_status.twist.linear.x > target_speed) {
+        target_accel = (lane_change_velocity_ - action_status.twist.linear.x) / step_time;
+        if (action_status.twist.linear.x > target_speed) {
           target_accel = boost::algorithm::clamp(target_accel, driver_model.deceleration * -1, 0);
         } else {
           target_accel = boost::algorithm::clamp(target_accel, 0, driver_model.acceleration);
@@ -194,29 +194,37 @@ BT::NodeStatus LaneChangeAction::tick()
         accel_new.linear.x = target_accel;
         geometry_msgs::msg::Twist twist_new;
         twist_new.linear.x = boost::algorithm::clamp(
-          entity_status.action_status.twist.linear.x + accel_new.linear.x * step_time, -10,
-          vehicle_parameters.performance.max_speed);
+          action_status.twist.linear.x + accel_new.linear.x * step_time, -10,
+          vehicle_parameters->performance.max_speed);
         twist_new.linear.y = 0.0;
         twist_new.linear.z = 0.0;
         twist_new.angular.x = 0.0;
         twist_new.angular.y = 0.0;
         twist_new.angular.z = 0.0;
-        entity_status.action_status.twist = twist_new;
-        entity_status.action_status.accel = accel_new;
-        current_s_ = current_s_ + entity_status.action_status.twist.linear.x * step_time;
+        action_status.twist = twist_new;
+        action_status.accel = accel_new;
+        current_s_ = current_s_ + action_status.twist.linear.x * step_time;
         break;
     }
+    /**
+     * @note The waypoints ahead are calculated from the speed of the lane change, so the entity
+     * status of this tick is replaced by a snapshot with the new action status.
+     */
+    auto entity_status_changed = *entity_status;
+    entity_status_changed.action_status = action_status;
+    entity_status =
+      std::make_shared<const traffic_simulator_msgs::msg::EntityStatus>(entity_status_changed);
     if (current_s_ < curve_->getLength()) {
       geometry_msgs::msg::Pose pose = curve_->getPose(current_s_, true);
       traffic_simulator_msgs::msg::EntityStatus entity_status_updated;
       entity_status_updated.pose = pose;
-      auto lanelet_pose = hdmap_utils->toLaneletPose(pose, entity_status.bounding_box, false);
+      auto lanelet_pose = hdmap_utils->toLaneletPose(pose, entity_status->bounding_box, false);
       if (lanelet_pose) {
         entity_status_updated.lanelet_pose = lanelet_pose.get();
       } else {
         entity_status_updated.lanelet_pose_valid = false;
       }
-      entity_status_updated.action_status = entity_status.action_status;
+      entity_status_updated.action_status = entity_status->action_status;
       setOutput("updated_status", entity_status_updated);
       const auto waypoints = calculateWaypoints();
       if (waypoints.waypoints.empty()) {
@@ -245,7 +253,7 @@ BT::NodeStatus LaneChangeAction::tick()
       lanelet_pose.offset = 0;
       entity_status_updated.pose = hdmap_utils->toMapPose(lanelet_pose).pose;
       entity_status_updated.lanelet_pose = lanelet_pose;
-      entity_status_updated.action_status = entity_status.action_status;
+      entity_status_updated.action_status = entity_status->action_status;
       setOutput("updated_status", entity_status_updated);
       return BT::NodeStatus::SUCCESS;
     }
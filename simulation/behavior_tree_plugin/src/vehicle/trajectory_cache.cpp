@@ -0,0 +1,62 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <behavior_tree_plugin/vehicle/trajectory_cache.hpp>
+#include <memory>
+#include <vector>
+
+namespace entity_behavior
+{
+namespace vehicle
+{
+Trajectory::Trajectory(const std::vector<geometry_msgs::msg::Point> & waypoints)
+: waypoints([&]() {
+    traffic_simulator_msgs::msg::WaypointsArray waypoints_array;
+    waypoints_array.waypoints = waypoints;
+    return waypoints_array;
+  }())
+{
+}
+
+auto Trajectory::getSpline() const -> const traffic_simulator::math::CatmullRomSpline &
+{
+  if (!spline_) {
+    spline_ = std::make_unique<const traffic_simulator::math::CatmullRomSpline>(
+      waypoints.waypoints);
+  }
+  return *spline_;
+}
+
+auto TrajectoryCache::getTrajectory(
+  const std::shared_ptr<traffic_simulator::math::CatmullRomSpline> & reference_trajectory,
+  const std::vector<std::int64_t> & route_lanelets, double start_s, double end_s, double offset)
+  -> std::shared_ptr<const Trajectory>
+{
+  if (
+    !trajectory_ || reference_trajectory != reference_trajectory_ ||
+    route_lanelets != route_lanelets_ || start_s != start_s_ || end_s != end_s_ ||
+    offset != offset_) {
+    trajectory_ = std::make_shared<const Trajectory>(
+      reference_trajectory->getTrajectory(start_s, end_s, 1.0, offset));
+    reference_trajectory_ = reference_trajectory;
+    route_lanelets_ = route_lanelets;
+    start_s_ = start_s;
+    end_s_ = end_s;
+    offset_ = offset;
+    ++builds_;
+  }
+  return trajectory_;
+}
+}  // namespace vehicle
+}  // namespace entity_behavior
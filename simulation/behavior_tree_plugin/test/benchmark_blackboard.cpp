@@ -0,0 +1,195 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <autoware_auto_perception_msgs/msg/traffic_signal_array.hpp>
+#include <behavior_tree_plugin/pedestrian/behavior_tree.hpp>
+#include <behavior_tree_plugin/vehicle/behavior_tree.hpp>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <rclcpp/rclcpp.hpp>
+#include <string>
+#include <traffic_simulator/entity/entity_spatial_index.hpp>
+#include <traffic_simulator/entity/entity_status_store.hpp>
+#include <traffic_simulator/helper/helper.hpp>
+#include <traffic_simulator/traffic_lights/traffic_light_manager.hpp>
+#include <unordered_map>
+#include <vector>
+
+#include "traffic.hpp"
+
+namespace
+{
+std::atomic<std::uint64_t> allocation_count{0};
+
+std::atomic<std::uint64_t> allocated_byte_count{0};
+}  // namespace
+
+/**
+ * @note Same counting operator new as the allocation counter of the traffic_simulator benchmarks,
+ * which is not installed with the package.
+ */
+void * operator new(std::size_t size)
+{
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  allocated_byte_count.fetch_add(size, std::memory_order_relaxed);
+  if (auto pointer = std::malloc(size == 0 ? 1 : size)) {
+    return pointer;
+  } else {
+    throw std::bad_alloc();
+  }
+}
+
+void operator delete(void * pointer) noexcept { std::free(pointer); }
+
+void operator delete(void * pointer, std::size_t) noexcept { std::free(pointer); }
+
+namespace
+{
+/**
+ * @brief Inputs of the behavior tree of the entity "ego", surrounded by 200 vehicles lined up on
+ * the lanelets of the sample map, as the entity sets them before each tick.
+ */
+struct Inputs
+{
+  explicit Inputs(const std::shared_ptr<hdmap_utils::HdMapUtils> & hdmap_utils)
+  : hdmap_utils(hdmap_utils),
+    route_lanelets(hdmap_utils->getFollowingLanelets(34513, 300)),
+    reference_trajectory(std::make_shared<traffic_simulator::math::CatmullRomSpline>(
+      hdmap_utils->getCenterPoints(route_lanelets)))
+  {
+    const std::vector<std::int64_t> lanelet_ids = {34513, 34684, 34510, 34411, 120659};
+    auto store = std::make_shared<traffic_simulator::entity::EntityStatusStore>(1);
+    for (std::size_t i = 0; i <= 200; ++i) {
+      traffic_simulator_msgs::msg::EntityStatus status;
+      status.name = i == 0 ? "ego" : "npc" + std::to_string(i);
+      status.lanelet_pose = hdmap_utils->getAlongLaneletPose(
+        traffic_simulator::helper::constructLaneletPose(lanelet_ids[i % lanelet_ids.size()], 0),
+        8.0 * (i / lanelet_ids.size()));
+      status.lanelet_pose_valid = true;
+      status.pose = hdmap_utils->toMapPose(status.lanelet_pose).pose;
+      status.bounding_box.dimensions.x = 4.5;
+      status.bounding_box.dimensions.y = 2.1;
+      status.bounding_box.dimensions.z = 1.8;
+      status.action_status = traffic_simulator::helper::constructActionStatus(3.0 + i % 4);
+      store->emplace(status);
+      entity_type_list[status.name].type = traffic_simulator_msgs::msg::EntityType::VEHICLE;
+      if (i == 0) {
+        entity_status = status;
+      }
+    }
+    entity_spatial_index =
+      std::make_shared<const traffic_simulator::entity::EntitySpatialIndex>(store);
+    other_entity_status = traffic_simulator::entity::EntityStatusView(
+      entity_spatial_index, "ego", entity_status.pose.position, 1000);
+  }
+
+  const std::shared_ptr<hdmap_utils::HdMapUtils> hdmap_utils;
+
+  const std::vector<std::int64_t> route_lanelets;
+
+  const std::shared_ptr<traffic_simulator::math::CatmullRomSpline> reference_trajectory;
+
+  traffic_simulator_msgs::msg::EntityStatus entity_status;
+
+  std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityType> entity_type_list;
+
+  std::shared_ptr<const traffic_simulator::entity::EntitySpatialIndex> entity_spatial_index;
+
+  traffic_simulator::entity::EntityStatusView other_entity_status;
+};
+
+/**
+ * @brief Ticks the behavior tree with the same inputs in each iteration, setting them like
+ * VehicleEntity::onUpdate and PedestrianEntity::onUpdate do, and counts the heap allocations.
+ */
+template <typename BehaviorTree, typename Configure>
+void tick(benchmark::State & state, Configure && configure)
+{
+  Traffic traffic("benchmark_blackboard", 1);
+  const Inputs inputs(traffic.getHdmapUtils());
+  const auto node = std::make_shared<rclcpp::Node>("benchmark_blackboard_traffic_lights");
+  BehaviorTree tree;
+  tree.configure(rclcpp::get_logger("ego"));
+  tree.setHdMapUtils(inputs.hdmap_utils);
+  tree.setTrafficLightManager(
+    std::make_shared<traffic_simulator::TrafficLightManager<
+      autoware_auto_perception_msgs::msg::TrafficSignalArray>>(inputs.hdmap_utils, node));
+  tree.setDriverModel(traffic_simulator_msgs::msg::DriverModel());
+  tree.setRequest("follow_lane");
+  tree.setTargetSpeed(boost::none);
+  configure(tree);
+  const auto entity_type_list = std::make_shared<
+    const std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityType>>(
+    inputs.entity_type_list);
+  const auto allocations = allocation_count.load();
+  const auto allocated_bytes = allocated_byte_count.load();
+  double current_time = 0;
+  for (auto _ : state) {
+    tree.setOtherEntityStatus(inputs.other_entity_status);
+    tree.setEntitySpatialIndex(inputs.entity_spatial_index);
+    tree.setEntityTypeList(entity_type_list);
+    tree.setEntityStatus(
+      std::make_shared<const traffic_simulator_msgs::msg::EntityStatus>(inputs.entity_status));
+    tree.setRouteLanelets(std::make_shared<const std::vector<std::int64_t>>(inputs.route_lanelets));
+    tree.setReferenceTrajectory(inputs.reference_trajectory);
+    tree.update(current_time, 0.05);
+    benchmark::DoNotOptimize(tree.getUpdatedStatus());
+    current_time = current_time + 0.05;
+  }
+  state.counters["allocs_per_op"] = benchmark::Counter(
+    allocation_count.load() - allocations, benchmark::Counter::kAvgIterations);
+  state.counters["bytes_per_op"] = benchmark::Counter(
+    allocated_byte_count.load() - allocated_bytes, benchmark::Counter::kAvgIterations);
+}
+}  // namespace
+
+static void VehicleBehaviorTreeTick(benchmark::State & state)
+{
+  tick<entity_behavior::VehicleBehaviorTree>(state, [](auto & tree) {
+    traffic_simulator_msgs::msg::VehicleParameters parameters;
+    parameters.performance.max_speed = 69.444;
+    parameters.bounding_box.dimensions.x = 4.5;
+    parameters.bounding_box.dimensions.y = 2.1;
+    parameters.bounding_box.dimensions.z = 1.8;
+    tree.setVehicleParameters(
+      std::make_shared<const traffic_simulator_msgs::msg::VehicleParameters>(parameters));
+  });
+}
+BENCHMARK(VehicleBehaviorTreeTick)->Unit(benchmark::kMicrosecond);
+
+static void PedestrianBehaviorTreeTick(benchmark::State & state)
+{
+  tick<entity_behavior::PedestrianBehaviorTree>(state, [](auto & tree) {
+    traffic_simulator_msgs::msg::PedestrianParameters parameters;
+    parameters.bounding_box.dimensions.x = 1.0;
+    parameters.bounding_box.dimensions.y = 1.0;
+    parameters.bounding_box.dimensions.z = 2.0;
+    tree.setPedestrianParameters(
+      std::make_shared<const traffic_simulator_msgs::msg::PedestrianParameters>(parameters));
+  });
+}
+BENCHMARK(PedestrianBehaviorTreeTick)->Unit(benchmark::kMicrosecond);
+
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  rclcpp::shutdown();
+  return 0;
+}
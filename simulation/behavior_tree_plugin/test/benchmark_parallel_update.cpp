@@ -0,0 +1,57 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <rclcpp/rclcpp.hpp>
+#include <string>
+
+#include "traffic.hpp"
+
+/**
+ * @brief Time of one EntityManager::update with state.range(0) vehicles and state.range(1)
+ * threads.
+ */
+static void EntityManagerUpdate(benchmark::State & state)
+{
+  Traffic traffic(
+    "benchmark_parallel_update_" + std::to_string(state.range(0)) + "_" +
+      std::to_string(state.range(1)),
+    state.range(1));
+  traffic.spawnVehicles(state.range(0));
+  double current_time = 0;
+  for (auto _ : state) {
+    traffic.update(current_time, 0.05);
+    current_time = current_time + 0.05;
+  }
+}
+BENCHMARK(EntityManagerUpdate)
+  ->Apply([](benchmark::internal::Benchmark * benchmark) {
+    for (const int vehicles : {50, 200}) {
+      for (const int threads : {1, 2, 4, 8}) {
+        benchmark->Args({vehicles, threads});
+      }
+    }
+  })
+  ->Unit(benchmark::kMillisecond)
+  ->UseRealTime();
+
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  rclcpp::shutdown();
+  return 0;
+}
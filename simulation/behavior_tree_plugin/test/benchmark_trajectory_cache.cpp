@@ -0,0 +1,75 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <behavior_tree_plugin/vehicle/trajectory_cache.hpp>
+#include <memory>
+#include <rclcpp/rclcpp.hpp>
+#include <string>
+#include <vector>
+
+#include "traffic.hpp"
+
+/**
+ * @brief Time of the trajectory work of the six nodes of the follow lane sequence in one tick:
+ * each node clips the waypoints ahead of the entity, builds the spline through them and looks for
+ * the stop lines on it. The entity moves 0.5 m per tick if state.range(1) is 1, and stands still
+ * otherwise. The trajectory cache is used if state.range(0) is 1.
+ */
+static void FollowLaneSequenceTick(benchmark::State & state)
+{
+  Traffic traffic(
+    "benchmark_trajectory_cache_" + std::to_string(state.range(0)) + "_" +
+      std::to_string(state.range(1)),
+    1);
+  const auto hdmap_utils = traffic.getHdmapUtils();
+  const auto route = hdmap_utils->getFollowingLanelets(34513, 300);
+  const auto reference_trajectory = std::make_shared<traffic_simulator::math::CatmullRomSpline>(
+    hdmap_utils->getCenterPoints(route));
+  entity_behavior::vehicle::TrajectoryCache cache;
+  double s = 0;
+  for (auto _ : state) {
+    for (int node = 0; node < 6; ++node) {
+      if (state.range(0)) {
+        const auto trajectory = cache.getTrajectory(reference_trajectory, route, s, s + 30, 0);
+        benchmark::DoNotOptimize(
+          hdmap_utils->getDistanceToStopLine(route, trajectory->getSpline()));
+      } else {
+        const auto waypoints = reference_trajectory->getTrajectory(s, s + 30, 1.0, 0);
+        const traffic_simulator::math::CatmullRomSpline spline(waypoints);
+        benchmark::DoNotOptimize(spline.getLength());
+        benchmark::DoNotOptimize(hdmap_utils->getDistanceToStopLine(route, waypoints));
+      }
+    }
+    if (state.range(1)) {
+      s = s + 0.5 < reference_trajectory->getLength() - 30 ? s + 0.5 : 0;
+    }
+  }
+}
+BENCHMARK(FollowLaneSequenceTick)
+  ->Args({0, 0})
+  ->Args({1, 0})
+  ->Args({0, 1})
+  ->Args({1, 1})
+  ->Unit(benchmark::kMicrosecond);
+
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  rclcpp::shutdown();
+  return 0;
+}
@@ -0,0 +1,126 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <quaternion_operation/quaternion_operation.h>
+
+#include <behavior_tree_plugin/action_node.hpp>
+#include <cmath>
+#include <memory>
+#include <rclcpp/rclcpp.hpp>
+#include <string>
+#include <traffic_simulator/math/catmull_rom_spline.hpp>
+#include <tuple>
+#include <vector>
+
+#include "traffic.hpp"
+
+namespace
+{
+class QueryNode : public entity_behavior::ActionNode
+{
+public:
+  QueryNode() : entity_behavior::ActionNode("query", BT::NodeConfiguration()) {}
+
+  BT::NodeStatus tick() override { return BT::NodeStatus::SUCCESS; }
+};
+
+std::vector<std::string> getNames(
+  const std::vector<traffic_simulator_msgs::msg::EntityStatus> & statuses)
+{
+  std::vector<std::string> names;
+  for (const auto & status : statuses) {
+    names.emplace_back(status.name);
+  }
+  return names;
+}
+/**
+ * @brief The front entity found by testing the spline against the polygon of each entity in
+ * turn, as ActionNode::getFrontEntityName did before it tested all of them in one call.
+ */
+boost::optional<std::string> getFrontEntityName(
+  QueryNode & node, const traffic_simulator::math::CatmullRomSpline & spline)
+{
+  boost::optional<std::string> front_entity_name;
+  double front_distance = 0;
+  for (std::size_t i = 0; i < node.other_entity_status.size(); ++i) {
+    if (!node.other_entity_status.laneletPoseValid(i)) {
+      continue;
+    }
+    const auto & name = node.other_entity_status.getName(i);
+    const auto distance = node.getDistanceToTargetEntityPolygon(spline, name);
+    const auto quat = quaternion_operation::getRotation(
+      node.entity_status->pose.orientation, node.other_entity_status.getPose(i).orientation);
+    if (
+      std::fabs(quaternion_operation::convertQuaternionToEulerAngle(quat).z) <= M_PI / 2 &&
+      distance && distance.get() < 40 && (!front_entity_name || distance.get() < front_distance)) {
+      front_entity_name = name;
+      front_distance = distance.get();
+    }
+  }
+  return front_entity_name;
+}
+}  // namespace
+
+/**
+ * @note The same queries are run on the same view with and without the spatial index; they must
+ * return the same entities in the same order.
+ */
+TEST(ActionNode, SpatialIndexEqualsLinearScan)
+{
+  Traffic traffic("test_entity_spatial_index", 1);
+  traffic.spawnVehicles(40);
+  const auto hdmap_utils = traffic.getHdmapUtils();
+  for (int frame = 0; frame < 100; ++frame) {
+    traffic.update(frame * 0.05, 0.05);
+    auto store = std::make_shared<traffic_simulator::entity::EntityStatusStore>(frame + 1);
+    for (const auto & status : traffic.getStatuses()) {
+      store->emplace(status);
+    }
+    const auto index = std::make_shared<const traffic_simulator::entity::EntitySpatialIndex>(store);
+    for (std::size_t i = 0; i < store->size(); ++i) {
+      QueryNode node;
+      node.hdmap_utils = hdmap_utils;
+      node.entity_status =
+        std::make_shared<const traffic_simulator_msgs::msg::EntityStatus>(store->getStatus(i));
+      node.other_entity_status = traffic_simulator::entity::EntityStatusView(
+        index, store->getName(i), store->getPose(i).position, 30);
+      const auto lanelet_id = store->getLaneletPose(i).lanelet_id;
+      const auto following_lanelets = hdmap_utils->getFollowingLanelets(lanelet_id);
+      const traffic_simulator::math::CatmullRomSpline spline(
+        hdmap_utils->getCenterPoints(following_lanelets));
+      const auto query = [&]() {
+        return std::make_tuple(
+          getNames(node.getOtherEntityStatus(lanelet_id)),
+          getNames(node.getRightOfWayEntities(following_lanelets)),
+          node.getYieldStopDistance(following_lanelets), node.getFrontEntityName(spline));
+      };
+      node.entity_spatial_index = nullptr;
+      const auto linear_scan = query();
+      node.entity_spatial_index = index;
+      EXPECT_EQ(query(), linear_scan) << store->getName(i) << " at frame " << frame;
+      EXPECT_EQ(std::get<3>(linear_scan), getFrontEntityName(node, spline))
+        << store->getName(i) << " at frame " << frame;
+    }
+  }
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  rclcpp::init(argc, argv);
+  const auto result = RUN_ALL_TESTS();
+  rclcpp::shutdown();
+  return result;
+}
@@ -0,0 +1,68 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <rclcpp/rclcpp.hpp>
+#include <string>
+#include <vector>
+
+#include "traffic.hpp"
+
+namespace
+{
+using Trajectories = std::vector<std::vector<traffic_simulator_msgs::msg::EntityStatus>>;
+
+Trajectories simulate(std::size_t npc_update_threads)
+{
+  Traffic traffic("test_parallel_update_" + std::to_string(npc_update_threads), npc_update_threads);
+  traffic.spawnVehicles(30);
+  Trajectories trajectories;
+  for (int frame = 0; frame < 200; ++frame) {
+    traffic.update(frame * 0.05, 0.05);
+    trajectories.emplace_back(traffic.getStatuses());
+  }
+  return trajectories;
+}
+}  // namespace
+
+/**
+ * @note Statuses are compared with operator== on purpose: the parallel update must be bit-identical
+ * to the serial one, not only close to it.
+ */
+TEST(ParallelUpdate, BitIdenticalToSerialUpdate)
+{
+  const auto serial = simulate(1);
+  for (const std::size_t threads : {2, 4, 8}) {
+    const auto parallel = simulate(threads);
+    ASSERT_EQ(serial.size(), parallel.size());
+    for (std::size_t frame = 0; frame < serial.size(); ++frame) {
+      ASSERT_EQ(serial[frame].size(), parallel[frame].size());
+      for (std::size_t i = 0; i < serial[frame].size(); ++i) {
+        EXPECT_TRUE(serial[frame][i] == parallel[frame][i])
+          << "entity " << serial[frame][i].name << " differs at frame " << frame << " with "
+          << threads << " threads.";
+      }
+    }
+  }
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  rclcpp::init(argc, argv);
+  const auto result = RUN_ALL_TESTS();
+  rclcpp::shutdown();
+  return result;
+}
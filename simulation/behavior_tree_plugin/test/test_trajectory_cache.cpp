@@ -0,0 +1,145 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <behavior_tree_plugin/vehicle/trajectory_cache.hpp>
+#include <memory>
+#include <rclcpp/rclcpp.hpp>
+#include <scenario_simulator_exception/exception.hpp>
+#include <vector>
+
+#include "traffic.hpp"
+
+namespace
+{
+auto makeReferenceTrajectory() -> std::shared_ptr<traffic_simulator::math::CatmullRomSpline>
+{
+  std::vector<geometry_msgs::msg::Point> points;
+  for (int i = 0; i < 10; ++i) {
+    geometry_msgs::msg::Point point;
+    point.x = i * 10;
+    point.y = (i % 3) * 2;
+    points.emplace_back(point);
+  }
+  return std::make_shared<traffic_simulator::math::CatmullRomSpline>(points);
+}
+}  // namespace
+
+TEST(TrajectoryCache, ReuseWhileKeyIsUnchanged)
+{
+  const auto reference_trajectory = makeReferenceTrajectory();
+  entity_behavior::vehicle::TrajectoryCache cache;
+  const auto trajectory = cache.getTrajectory(reference_trajectory, {1, 2}, 3, 23, 0.5);
+  EXPECT_EQ(trajectory->waypoints.waypoints, reference_trajectory->getTrajectory(3, 23, 1.0, 0.5));
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(cache.getTrajectory(reference_trajectory, {1, 2}, 3, 23, 0.5), trajectory);
+  }
+  EXPECT_EQ(&trajectory->getSpline(), &trajectory->getSpline());
+  EXPECT_EQ(cache.builds(), 1U);
+}
+
+TEST(TrajectoryCache, RebuildWhenKeyChanges)
+{
+  const auto reference_trajectory = makeReferenceTrajectory();
+  entity_behavior::vehicle::TrajectoryCache cache;
+  cache.getTrajectory(reference_trajectory, {1, 2}, 3, 23, 0.5);
+  cache.getTrajectory(makeReferenceTrajectory(), {1, 2}, 3, 23, 0.5);
+  EXPECT_EQ(cache.builds(), 2U);
+  cache.getTrajectory(reference_trajectory, {1, 2}, 3, 23, 0.5);
+  EXPECT_EQ(cache.builds(), 3U);
+  cache.getTrajectory(reference_trajectory, {1, 3}, 3, 23, 0.5);
+  EXPECT_EQ(cache.builds(), 4U);
+  cache.getTrajectory(reference_trajectory, {1, 3}, 4, 23, 0.5);
+  EXPECT_EQ(cache.builds(), 5U);
+  cache.getTrajectory(reference_trajectory, {1, 3}, 4, 24, 0.5);
+  EXPECT_EQ(cache.builds(), 6U);
+  const auto trajectory = cache.getTrajectory(reference_trajectory, {1, 3}, 4, 24, 0);
+  EXPECT_EQ(cache.builds(), 7U);
+  EXPECT_EQ(trajectory->waypoints.waypoints, reference_trajectory->getTrajectory(4, 24, 1.0, 0));
+}
+
+TEST(TrajectoryCache, SplineThroughWaypoints)
+{
+  const auto reference_trajectory = makeReferenceTrajectory();
+  entity_behavior::vehicle::TrajectoryCache cache;
+  const auto trajectory = cache.getTrajectory(reference_trajectory, {1}, 12.5, 45, 0.25);
+  const traffic_simulator::math::CatmullRomSpline spline(trajectory->waypoints.waypoints);
+  EXPECT_EQ(trajectory->getSpline().getLength(), spline.getLength());
+  for (double s = 0; s < spline.getLength(); s = s + 0.7) {
+    EXPECT_EQ(trajectory->getSpline().getPoint(s), spline.getPoint(s));
+  }
+  EXPECT_THROW(
+    entity_behavior::vehicle::Trajectory({geometry_msgs::msg::Point()}).getSpline(),
+    common::SemanticError);
+}
+
+/**
+ * @note The trajectories ahead of the vehicles of a running simulation are profiled with and
+ * without the cache: the waypoints and the distances to the stop lines and traffic light stop
+ * lines computed from the cached spline must be the same as the ones computed from the waypoints.
+ */
+TEST(TrajectoryCache, SameDistancesOnSampleMap)
+{
+  Traffic traffic("test_trajectory_cache", 1);
+  traffic.spawnVehicles(20);
+  const auto hdmap_utils = traffic.getHdmapUtils();
+  std::vector<entity_behavior::vehicle::TrajectoryCache> caches(20);
+  std::vector<std::vector<std::int64_t>> routes(20);
+  std::vector<std::shared_ptr<traffic_simulator::math::CatmullRomSpline>> reference_trajectories(
+    20);
+  std::size_t windows = 0;
+  for (int frame = 0; frame < 100; ++frame) {
+    traffic.update(frame * 0.05, 0.05);
+    const auto statuses = traffic.getStatuses();
+    for (std::size_t i = 0; i < statuses.size(); ++i) {
+      const auto & lanelet_pose = statuses[i].lanelet_pose;
+      const auto route = hdmap_utils->getFollowingLanelets(lanelet_pose.lanelet_id);
+      if (route != routes[i]) {
+        routes[i] = route;
+        reference_trajectories[i] = std::make_shared<traffic_simulator::math::CatmullRomSpline>(
+          hdmap_utils->getCenterPoints(route));
+      }
+      const auto waypoints = reference_trajectories[i]->getTrajectory(
+        lanelet_pose.s, lanelet_pose.s + 30, 1.0, lanelet_pose.offset);
+      for (int node = 0; node < 6; ++node) {
+        const auto trajectory = caches[i].getTrajectory(
+          reference_trajectories[i], route, lanelet_pose.s, lanelet_pose.s + 30,
+          lanelet_pose.offset);
+        ASSERT_EQ(trajectory->waypoints.waypoints, waypoints);
+        EXPECT_EQ(
+          hdmap_utils->getDistanceToStopLine(route, trajectory->getSpline()),
+          hdmap_utils->getDistanceToStopLine(route, waypoints));
+        EXPECT_EQ(
+          hdmap_utils->getDistanceToTrafficLightStopLine(route, trajectory->getSpline()),
+          hdmap_utils->getDistanceToTrafficLightStopLine(route, waypoints));
+      }
+      ++windows;
+    }
+  }
+  std::size_t builds = 0;
+  for (const auto & cache : caches) {
+    builds = builds + cache.builds();
+  }
+  EXPECT_LE(builds, windows);
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  rclcpp::init(argc, argv);
+  const auto result = RUN_ALL_TESTS();
+  rclcpp::shutdown();
+  return result;
+}
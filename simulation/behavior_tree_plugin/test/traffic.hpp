@@ -0,0 +1,120 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BEHAVIOR_TREE_PLUGIN__TEST__TRAFFIC_HPP_
+#define BEHAVIOR_TREE_PLUGIN__TEST__TRAFFIC_HPP_
+
+#include <ament_index_cpp/get_package_share_directory.hpp>
+#include <memory>
+#include <rclcpp/rclcpp.hpp>
+#include <string>
+#include <traffic_simulator/api/configuration.hpp>
+#include <traffic_simulator/entity/entity_manager.hpp>
+#include <traffic_simulator/helper/helper.hpp>
+#include <vector>
+
+/**
+ * @brief Entity manager on the sample map of traffic_simulator, filled with vehicles driven by
+ * the behavior tree plugin.
+ */
+class Traffic
+{
+public:
+  Traffic(const std::string & name, std::size_t npc_update_threads)
+  : node_(std::make_shared<rclcpp::Node>(name)),
+    entity_manager_(node_, [&]() {
+      auto configuration = traffic_simulator::Configuration(
+        ament_index_cpp::get_package_share_directory("traffic_simulator") + "/map");
+      configuration.npc_update_threads = npc_update_threads;
+      return configuration;
+    }())
+  {
+  }
+
+  /**
+   * @note Vehicles are lined up on a few connected lanelets with 8 m gaps and different speeds,
+   * so they catch up with each other and the follow-front-entity logic is exercised.
+   */
+  void spawnVehicles(std::size_t size)
+  {
+    const std::vector<std::int64_t> lanelet_ids = {34513, 34684, 34510, 34411, 120659};
+    for (std::size_t i = 0; i < size; ++i) {
+      const auto name = "npc" + std::to_string(i);
+      entity_manager_.spawnEntity<traffic_simulator::entity::VehicleEntity>(
+        name, getVehicleParameters());
+      const auto lanelet_pose = entity_manager_.getHdmapUtils()->getAlongLaneletPose(
+        traffic_simulator::helper::constructLaneletPose(lanelet_ids[i % lanelet_ids.size()], 0),
+        8.0 * (i / lanelet_ids.size()));
+      traffic_simulator_msgs::msg::EntityStatus status;
+      status.name = name;
+      status.lanelet_pose = lanelet_pose;
+      status.lanelet_pose_valid = true;
+      status.pose = entity_manager_.toMapPose(lanelet_pose);
+      status.bounding_box = entity_manager_.getBoundingBox(name);
+      status.action_status = traffic_simulator::helper::constructActionStatus(3.0 + i % 4);
+      entity_manager_.setEntityStatus(name, status);
+      entity_manager_.requestSpeedChange(name, 5.0 + i % 3, true);
+      names_.emplace_back(name);
+    }
+  }
+
+  void update(double current_time, double step_time)
+  {
+    entity_manager_.update(current_time, step_time);
+  }
+
+  auto getHdmapUtils() { return entity_manager_.getHdmapUtils(); }
+
+  auto getStatuses() const -> std::vector<traffic_simulator_msgs::msg::EntityStatus>
+  {
+    std::vector<traffic_simulator_msgs::msg::EntityStatus> statuses;
+    for (const auto & name : names_) {
+      statuses.emplace_back(entity_manager_.getEntityStatus(name).get());
+    }
+    return statuses;
+  }
+
+private:
+  static auto getVehicleParameters() -> traffic_simulator_msgs::msg::VehicleParameters
+  {
+    traffic_simulator_msgs::msg::VehicleParameters parameters;
+    parameters.name = "vehicle.volkswagen.t";
+    parameters.subtype.value = traffic_simulator_msgs::msg::EntitySubtype::CAR;
+    parameters.performance.max_speed = 69.444;
+    parameters.performance.max_acceleration = 200;
+    parameters.performance.max_deceleration = 10.0;
+    parameters.bounding_box.center.x = 1.5;
+    parameters.bounding_box.center.z = 0.9;
+    parameters.bounding_box.dimensions.x = 4.5;
+    parameters.bounding_box.dimensions.y = 2.1;
+    parameters.bounding_box.dimensions.z = 1.8;
+    parameters.axles.front_axle.max_steering = 0.5;
+    parameters.axles.front_axle.wheel_diameter = 0.6;
+    parameters.axles.front_axle.track_width = 1.8;
+    parameters.axles.front_axle.position_x = 3.1;
+    parameters.axles.front_axle.position_z = 0.3;
+    parameters.axles.rear_axle.wheel_diameter = 0.6;
+    parameters.axles.rear_axle.track_width = 1.8;
+    parameters.axles.rear_axle.position_z = 0.3;
+    return parameters;
+  }
+
+  const rclcpp::Node::SharedPtr node_;
+
+  traffic_simulator::entity::EntityManager entity_manager_;
+
+  std::vector<std::string> names_;
+};
+
+#endif  // BEHAVIOR_TREE_PLUGIN__TEST__TRAFFIC_HPP_
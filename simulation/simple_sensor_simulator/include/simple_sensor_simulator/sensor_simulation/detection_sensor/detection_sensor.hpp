@@ -17,9 +17,12 @@
 
 #include <simulation_api_schema.pb.h>
 
+#include <array>
 #include <autoware_auto_perception_msgs/msg/predicted_objects.hpp>
 #include <memory>
 #include <rclcpp/rclcpp.hpp>
+#include <simple_sensor_simulator/sensor_simulation/lidar/raycaster.hpp>
+#include <simple_sensor_simulator/sensor_simulation/spatial_index.hpp>
 #include <string>
 #include <vector>
 
@@ -32,23 +35,47 @@ protected:
 
   simulation_api_schema::DetectionSensorConfiguration configuration_;
 
+  const std::array<double, 36> pose_covariance_;
+
+  const std::array<double, 36> twist_covariance_;
+
   explicit DetectionSensorBase(
     const double last_update_stamp,
-    const simulation_api_schema::DetectionSensorConfiguration & configuration)
-  : last_update_stamp_(last_update_stamp), configuration_(configuration)
-  {
-  }
+    const simulation_api_schema::DetectionSensorConfiguration & configuration);
 
-  const std::vector<std::string> getDetectedObjects(
-    const std::vector<traffic_simulator_msgs::EntityStatus> & status) const;
+  /**
+   * @brief Returns the indices in the status of the entities detected by this sensor, in ascending
+   * order.
+   * @note The entities are culled by range with the spatial index, or taken from the entities hit
+   * by the lidar sensors, then culled by direction and by occlusion, so the entities which are not
+   * detected are never converted to messages.
+   */
+  auto getDetectedObjects(
+    const std::vector<traffic_simulator_msgs::EntityStatus> & status, const SpatialIndex & index,
+    const std::vector<std::string> & lidar_detected_entity, const Raycaster * occluder) const
+    -> std::vector<std::size_t>;
 
   geometry_msgs::Pose getSensorPose(
-    const std::vector<traffic_simulator_msgs::EntityStatus> & status) const;
+    const std::vector<traffic_simulator_msgs::EntityStatus> & status,
+    const SpatialIndex & index) const;
 
 public:
+  virtual ~DetectionSensorBase() = default;
+
+  auto getEntity() const -> const std::string & { return configuration_.entity(); }
+
+  auto filterByOcclusion() const -> bool { return configuration_.filter_by_occlusion(); }
+
+  /**
+   * @param index Index of the status, built from it in this frame.
+   * @param occluder Raycaster of the lidar sensor attached to the same entity, if any. Needed if
+   * the entities are filtered by occlusion, in which case its scene must hold the status and the
+   * rays start from the origin of its last scan, where the lidar is mounted.
+   */
   virtual void update(
     const double, const std::vector<traffic_simulator_msgs::EntityStatus> &, const rclcpp::Time &,
-    const std::vector<std::string> & lidar_detected_entity) = 0;
+    const std::vector<std::string> & lidar_detected_entity, const SpatialIndex & index,
+    const Raycaster * occluder) = 0;
 };
 
 template <typename T>
@@ -67,13 +94,15 @@ public:
 
   auto update(
     const double, const std::vector<traffic_simulator_msgs::EntityStatus> &, const rclcpp::Time &,
-    const std::vector<std::string> & lidar_detected_entity) -> void override;
+    const std::vector<std::string> & lidar_detected_entity, const SpatialIndex & index,
+    const Raycaster * occluder) -> void override;
 };
 
 template <>
 void DetectionSensor<autoware_auto_perception_msgs::msg::PredictedObjects>::update(
   const double, const std::vector<traffic_simulator_msgs::EntityStatus> &, const rclcpp::Time &,
-  const std::vector<std::string> & lidar_detected_entity);
+  const std::vector<std::string> & lidar_detected_entity, const SpatialIndex & index,
+  const Raycaster * occluder);
 }  // namespace simple_sensor_simulator
 
 #endif  // SIMPLE_SENSOR_SIMULATOR__SENSOR_SIMULATION__DETECTION_SENSOR__DETECTION_SENSOR_HPP_
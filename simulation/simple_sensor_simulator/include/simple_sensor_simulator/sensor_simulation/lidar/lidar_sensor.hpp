@@ -17,10 +17,15 @@
 
 #include <simulation_api_schema.pb.h>
 
+#include <geometry_msgs/msg/pose.hpp>
 #include <memory>
 #include <rclcpp/rclcpp.hpp>
 #include <sensor_msgs/msg/point_cloud2.hpp>
+#include <simple_sensor_simulator/sensor_simulation/lidar/noise_model.hpp>
+#include <simple_sensor_simulator/sensor_simulation/lidar/raycaster.hpp>
+#include <simple_sensor_simulator/sensor_simulation/primitives/static_map.hpp>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace simple_sensor_simulator
@@ -34,18 +39,60 @@ protected:
 
   std::vector<std::string> detected_objects_;
 
+  /**
+   * @note Pose of the lidar in the frame of its entity, whose origin lies on the road. Rays cast
+   * from the origin of the entity would start on the road surface of the static map.
+   */
+  const geometry_msgs::msg::Pose mounting_pose_;
+
   explicit LidarSensorBase(
-    const double last_update_stamp, const simulation_api_schema::LidarConfiguration & configuration)
-  : last_update_stamp_(last_update_stamp), configuration_(configuration)
-  {
-  }
+    const double last_update_stamp,
+    const simulation_api_schema::LidarConfiguration & configuration);
+
+  /**
+   * @brief Returns the pose of the lidar in the map frame, given the pose of its entity.
+   */
+  auto getSensorPose(const geometry_msgs::msg::Pose & entity_pose) const
+    -> geometry_msgs::msg::Pose;
+
+  /**
+   * @brief Moves the points of a scan from the frame of the lidar into the frame of its entity.
+   */
+  auto toEntityFrame(sensor_msgs::msg::PointCloud2 & pointcloud) const -> void;
+
+  /**
+   * @brief Adds the entities of the status but the one of this sensor to the raycaster, and
+   * returns the pose of this sensor in the map frame.
+   */
+  auto addPrimitives(
+    Raycaster & raycaster, const std::vector<traffic_simulator_msgs::EntityStatus> & status) const
+    -> geometry_msgs::msg::Pose;
 
 public:
+  virtual ~LidarSensorBase() = default;
+
   virtual auto update(
     const double, const std::vector<traffic_simulator_msgs::EntityStatus> &, const rclcpp::Time &)
     -> void = 0;
 
   auto getDetectedObjects() const -> const std::vector<std::string> & { return detected_objects_; }
+
+  auto getEntity() const -> const std::string & { return configuration_.entity(); }
+
+  auto getLastUpdateStamp() const -> double { return last_update_stamp_; }
+
+  /**
+   * @brief Returns the raycaster of this sensor, whose scene is the one of its last scan or of
+   * its last updateScene.
+   */
+  virtual auto getRaycaster() const -> const Raycaster & = 0;
+
+  /**
+   * @brief Moves the entities in the scene of the raycaster to the status without scanning, so
+   * that the scene can be used between two scans.
+   */
+  virtual auto updateScene(const std::vector<traffic_simulator_msgs::EntityStatus> & status)
+    -> void = 0;
 };
 
 template <typename T>
@@ -53,15 +100,54 @@ class LidarSensor : public LidarSensorBase
 {
   const typename rclcpp::Publisher<T>::SharedPtr publisher_ptr_;
 
-  auto raycast(const std::vector<traffic_simulator_msgs::EntityStatus> &, const rclcpp::Time &)
-    -> T;
+  /**
+   * @note Kept across scans so that the Embree scene and the ray direction table are reused.
+   */
+  Raycaster raycaster_;
+
+  /**
+   * @note Kept across scans so that the sequence of its random numbers only depends on its seed.
+   */
+  NoiseModel noise_model_;
+
+  /**
+   * @note Written by every scan and published by reference, so that the buffer of its points is
+   * reused across scans.
+   */
+  T message_;
+
+  const bool use_loaned_messages_;
+
+  auto raycast(const std::vector<traffic_simulator_msgs::EntityStatus> &, const rclcpp::Time &, T &)
+    -> void;
 
 public:
+  /**
+   * @param use_loaned_messages If true and the middleware can loan messages, each scan is written
+   * into a message loaned by the middleware instead of the message kept by this sensor.
+   */
   explicit LidarSensor(
     const double current_time, const simulation_api_schema::LidarConfiguration & configuration,
-    const typename rclcpp::Publisher<T>::SharedPtr & publisher_ptr)
-  : LidarSensorBase(current_time, configuration), publisher_ptr_(publisher_ptr)
+    const typename rclcpp::Publisher<T>::SharedPtr & publisher_ptr,
+    const std::shared_ptr<const primitives::StaticMap> & static_map = nullptr,
+    std::size_t raycast_threads = 1, bool use_loaned_messages = false)
+  : LidarSensorBase(current_time, configuration),
+    publisher_ptr_(publisher_ptr),
+    noise_model_(configuration),
+    use_loaned_messages_(use_loaned_messages)
+  {
+    if (static_map) {
+      raycaster_.setStaticMap(*static_map);
+    }
+    raycaster_.setThreadCount(raycast_threads);
+  }
+
+  auto getRaycaster() const -> const Raycaster & override { return raycaster_; }
+
+  auto updateScene(const std::vector<traffic_simulator_msgs::EntityStatus> & status)
+    -> void override
   {
+    raycaster_.commitScene(addPrimitives(raycaster_, status));
   }
 
   auto update(
@@ -70,7 +156,14 @@ public:
   {
     if (current_time - last_update_stamp_ - configuration_.scan_duration() >= -0.002) {
       last_update_stamp_ = current_time;
-      publisher_ptr_->publish(raycast(status, stamp));
+      if (use_loaned_messages_ && publisher_ptr_->can_loan_messages()) {
+        auto message = publisher_ptr_->borrow_loaned_message();
+        raycast(status, stamp, message.get());
+        publisher_ptr_->publish(std::move(message));
+      } else {
+        raycast(status, stamp, message_);
+        publisher_ptr_->publish(message_);
+      }
     } else {
       detected_objects_ = {};
     }
@@ -79,8 +172,8 @@ public:
 
 template <>
 auto LidarSensor<sensor_msgs::msg::PointCloud2>::raycast(
-  const std::vector<traffic_simulator_msgs::EntityStatus> &, const rclcpp::Time &)
-  -> sensor_msgs::msg::PointCloud2;
+  const std::vector<traffic_simulator_msgs::EntityStatus> &, const rclcpp::Time &,
+  sensor_msgs::msg::PointCloud2 &) -> void;
 }  // namespace simple_sensor_simulator
 
 #endif  // SIMPLE_SENSOR_SIMULATOR__SENSOR_SIMULATION__LIDAR__LIDAR_SENSOR_HPP_
@@ -0,0 +1,61 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SIMPLE_SENSOR_SIMULATOR__SENSOR_SIMULATION__LIDAR__NOISE_MODEL_HPP_
+#define SIMPLE_SENSOR_SIMULATOR__SENSOR_SIMULATION__LIDAR__NOISE_MODEL_HPP_
+
+#include <simulation_api_schema.pb.h>
+
+#include <cstdint>
+#include <sensor_msgs/msg/point_cloud2.hpp>
+
+namespace simple_sensor_simulator
+{
+/**
+ * @brief Turns the perfect returns cast by Raycaster into returns of a real lidar, with gaussian
+ * noise on their range, a dropout growing with the square of their range, and an intensity falling
+ * with the cosine of their incidence angle.
+ * @note The random numbers of a return are a hash of the seed and of the index of the return among
+ * all the returns the model has seen, instead of the output of a random engine. So they are drawn
+ * without any dependency between returns, and the same seed and the same scans give the same point
+ * clouds on any platform.
+ */
+class NoiseModel
+{
+public:
+  explicit NoiseModel(const simulation_api_schema::LidarConfiguration & configuration);
+
+  /**
+   * @brief Applies the model in place to a pointcloud cast by Raycaster, removing the returns
+   * which are lost.
+   */
+  void apply(sensor_msgs::msg::PointCloud2 & pointcloud);
+
+private:
+  const float range_noise_standard_deviation_;
+
+  /**
+   * @note Probability of losing a return divided by its squared range.
+   */
+  const float dropout_factor_;
+
+  const float intensity_scale_;
+
+  const std::uint64_t seed_;
+
+  std::uint64_t returns_ = 0;
+};
+}  // namespace simple_sensor_simulator
+
+#endif  // SIMPLE_SENSOR_SIMULATOR__SENSOR_SIMULATION__LIDAR__NOISE_MODEL_HPP_
@@ -16,27 +16,43 @@
 #define SIMPLE_SENSOR_SIMULATOR__SENSOR_SIMULATION__LIDAR__RAYCASTER_HPP_
 
 #include <embree3/rtcore.h>
-#include <pcl_conversions/pcl_conversions.h>
 
+#include <Eigen/Core>
+#include <boost/optional.hpp>
+#include <cstdint>
+#include <geometry_msgs/msg/point.hpp>
 #include <geometry_msgs/msg/pose.hpp>
 #include <geometry_msgs/msg/vector3.hpp>
 #include <memory>
 #include <random>
+#include <rclcpp/time.hpp>
 #include <sensor_msgs/msg/point_cloud2.hpp>
 #include <simple_sensor_simulator/sensor_simulation/primitives/box.hpp>
 #include <simple_sensor_simulator/sensor_simulation/primitives/primitive.hpp>
+#include <simulation_interface/thread_pool.hpp>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
 namespace simple_sensor_simulator
 {
+/**
+ * @brief Casts lidar rays against the static map and the primitives added since the previous scan.
+ * @note The Embree scene lives as long as the raycaster. Each primitive is meshed once in its own
+ * coordinate frame and placed into the scene as an instance, so a scan in which an entity only
+ * moved updates a single transform instead of rebuilding its mesh. Primitives which were not added
+ * again before a scan are removed from the scene. The static map is built once into its own high
+ * quality BVH, which the scene holds as a single instance.
+ */
 class Raycaster
 {
 public:
   Raycaster();
   explicit Raycaster(std::string embree_config);
+  Raycaster(const Raycaster &) = delete;
+  Raycaster & operator=(const Raycaster &) = delete;
   ~Raycaster();
   template <typename T, typename... Ts>
   void addPrimitive(std::string name, Ts &&... xs)
@@ -52,7 +68,58 @@ public:
     double horizontal_resolution, std::vector<double> vertical_angles,
     double horizontal_angle_start = 0, double horizontal_angle_end = 2 * M_PI,
     double max_distance = 100, double min_distance = 0);
+  /**
+   * @brief Layout of a point in the data of the pointclouds cast by this class, without the
+   * padding of pcl::PointXYZI.
+   * @note The intensity is the cosine of the angle between the ray and the normal of the surface.
+   */
+  struct Point
+  {
+    float x;
+    float y;
+    float z;
+    float intensity;
+  };
+  /**
+   * @brief Casts a scan into the pointcloud, with the fields x, y, z and intensity as FLOAT32.
+   * @note Hits are written straight into the data of the pointcloud, so passing the same message
+   * every scan reuses its buffer instead of allocating and copying the points again.
+   */
+  void raycast(
+    sensor_msgs::msg::PointCloud2 & pointcloud, const std::string & frame_id,
+    const rclcpp::Time & stamp, const geometry_msgs::msg::Pose & origin,
+    double horizontal_resolution, const std::vector<double> & vertical_angles,
+    double horizontal_angle_start = 0, double horizontal_angle_end = 2 * M_PI,
+    double max_distance = 100, double min_distance = 0);
   const std::vector<std::string> & getDetectedObject() const;
+  /**
+   * @brief Puts the primitives added since the last scan into the scene without casting any ray,
+   * as if a scan was cast from the origin.
+   */
+  void commitScene(const geometry_msgs::msg::Pose & origin);
+  /**
+   * @brief Returns the origin of the last scan, or of the last commitScene.
+   */
+  const geometry_msgs::msg::Pose & getOrigin() const;
+  /**
+   * @brief Returns true if nothing but the primitive of the name lies between the origin and the
+   * target in the scene of the last scan.
+   * @note Primitives which were not in the last scan occlude nothing. Surfaces within a centimeter
+   * of the origin are ignored, like the road under a sensor mounted on it.
+   */
+  bool isVisible(
+    const geometry_msgs::msg::Point & origin, const geometry_msgs::msg::Point & target,
+    const std::string & name) const;
+  /**
+   * @brief Replaces the geometry which stays in the scene across scans, like the road surface.
+   * @note Hits on it are returned as points but never as detected objects.
+   */
+  void setStaticMap(const primitives::Primitive & static_map);
+  /**
+   * @brief Sets the number of threads casting the rays of a scan, including the calling thread.
+   * @note The result of a scan does not depend on it.
+   */
+  void setThreadCount(std::size_t thread_count);
 
 private:
   std::unordered_map<std::string, std::unique_ptr<primitives::Primitive>> primitive_ptrs_;
@@ -60,12 +127,73 @@ private:
   RTCScene scene_;
   std::random_device seed_gen_;
   std::default_random_engine engine_;
-  const sensor_msgs::msg::PointCloud2 raycast(
-    std::string frame_id, const rclcpp::Time & stamp, geometry_msgs::msg::Pose origin,
-    std::vector<geometry_msgs::msg::Quaternion> directions, double max_distance = 100,
-    double min_distance = 0);
+  void castRays(
+    sensor_msgs::msg::PointCloud2 & pointcloud, const geometry_msgs::msg::Pose & origin,
+    const std::vector<Eigen::Vector3d> & directions, double max_distance, double min_distance);
+  void updateScene();
   std::vector<std::string> detected_objects_;
   std::unordered_map<unsigned int, std::string> geometry_ids_;
+  geometry_msgs::msg::Pose origin_;
+
+  struct Instance
+  {
+    std::string type;
+    std::vector<Vertex> vertices;
+    RTCScene scene;
+    RTCGeometry geometry;
+    unsigned int geometry_id;
+  };
+  std::unordered_map<std::string, Instance> instances_;
+  boost::optional<Instance> static_map_;
+  /**
+   * @note Rotations of the instances indexed by their geometry ids, to bring the normals of the
+   * surfaces hit into the map frame.
+   */
+  std::vector<Eigen::Matrix3d> instance_rotations_;
+  void setInstanceRotation(
+    unsigned int geometry_id, const geometry_msgs::msg::Quaternion & orientation);
+  void releaseInstance(const Instance & instance);
+  Instance makeInstance(const primitives::Primitive & primitive, RTCBuildQuality quality);
+
+  /**
+   * @note Unit vectors of the rays in the sensor frame, rebuilt only when the scan pattern changes.
+   */
+  struct Pattern
+  {
+    double horizontal_resolution;
+    std::vector<double> vertical_angles;
+    double horizontal_angle_start;
+    double horizontal_angle_end;
+    bool operator==(const Pattern & other) const
+    {
+      return horizontal_resolution == other.horizontal_resolution &&
+             vertical_angles == other.vertical_angles &&
+             horizontal_angle_start == other.horizontal_angle_start &&
+             horizontal_angle_end == other.horizontal_angle_end;
+    }
+  };
+  boost::optional<Pattern> pattern_;
+  std::vector<Eigen::Vector3d> directions_;
+
+  /**
+   * @note Contiguous range of the direction table cast by one thread. Its hits are written into
+   * the data of the pointcloud from the point of its first ray, and its detected ids are kept
+   * across scans to reuse their memory.
+   */
+  struct Sector
+  {
+    std::size_t begin;
+    std::size_t end;
+    std::size_t point_count;
+    std::vector<unsigned int> detected_ids;
+    std::unordered_set<unsigned int> detected_id_set;
+  };
+  std::vector<Sector> sectors_;
+  std::unique_ptr<simulation_interface::ThreadPool> thread_pool_;
+  void castSector(
+    Sector & sector, std::uint8_t * data, const geometry_msgs::msg::Pose & origin,
+    const Eigen::Matrix3d & rotation, const std::vector<Eigen::Vector3d> & directions,
+    double max_distance, double min_distance);
 };
 }  // namespace simple_sensor_simulator
 
@@ -48,7 +48,13 @@ public:
   const std::string type;
   const geometry_msgs::msg::Pose pose;
   unsigned int addToScene(RTCDevice device, RTCScene scene);
+  /**
+   * @brief Adds the mesh in the coordinate frame of the primitive, ignoring its pose. The pose is
+   * expected to be applied by an instance transform.
+   */
+  unsigned int addToLocalScene(RTCDevice device, RTCScene scene) const;
   std::vector<Vertex> getVertex() const;
+  std::vector<Vertex> getLocalVertex() const;
   std::vector<Triangle> getTriangles() const;
 
 protected:
@@ -0,0 +1,51 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SIMPLE_SENSOR_SIMULATOR__SENSOR_SIMULATION__PRIMITIVES__STATIC_MAP_HPP_
+#define SIMPLE_SENSOR_SIMULATOR__SENSOR_SIMULATION__PRIMITIVES__STATIC_MAP_HPP_
+
+#include <lanelet2_core/LaneletMap.h>
+
+#include <simple_sensor_simulator/sensor_simulation/primitives/primitive.hpp>
+#include <string>
+
+namespace simple_sensor_simulator
+{
+namespace primitives
+{
+/**
+ * @brief Triangle mesh of the parts of a lanelet map which never move, in the map frame.
+ * @note The road surface is the strip between the left and right bounds of each lanelet, and
+ * curbs, fences, guard rails and walls are extruded upward from their line strings.
+ */
+class StaticMap : public Primitive
+{
+public:
+  explicit StaticMap(const lanelet::LaneletMap & lanelet_map);
+  explicit StaticMap(const std::string & lanelet2_map_path);
+  ~StaticMap() = default;
+
+  /**
+   * @brief Returns the height of the barrier along a line string of the type, or 0 if a line
+   * string of the type is not a barrier.
+   */
+  static auto getBarrierHeight(const std::string & type, const std::string & subtype) -> double;
+
+private:
+  void addLaneletMap(const lanelet::LaneletMap & lanelet_map);
+};
+}  // namespace primitives
+}  // namespace simple_sensor_simulator
+
+#endif  // SIMPLE_SENSOR_SIMULATOR__SENSOR_SIMULATION__PRIMITIVES__STATIC_MAP_HPP_
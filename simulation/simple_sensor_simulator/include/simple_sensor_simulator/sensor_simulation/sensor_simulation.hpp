@@ -17,11 +17,20 @@
 
 #include <simulation_api_schema.pb.h>
 
+#include <condition_variable>
+#include <exception>
 #include <iomanip>
 #include <memory>
+#include <mutex>
 #include <rclcpp/rclcpp.hpp>
 #include <simple_sensor_simulator/sensor_simulation/detection_sensor/detection_sensor.hpp>
 #include <simple_sensor_simulator/sensor_simulation/lidar/lidar_sensor.hpp>
+#include <simple_sensor_simulator/sensor_simulation/primitives/static_map.hpp>
+#include <simple_sensor_simulator/sensor_simulation/spatial_index.hpp>
+#include <simulation_interface/thread_pool.hpp>
+#include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 namespace simple_sensor_simulator
@@ -29,15 +38,38 @@ namespace simple_sensor_simulator
 class SensorSimulation
 {
 public:
+  /**
+   * @param raycast_threads Number of threads casting the rays of each lidar scan.
+   * @param use_loaned_messages Publishes lidar scans with messages loaned by the middleware.
+   * @param sensor_update_threads Number of threads updating the sensors of a frame, including the
+   * one running the frame. The threads of each lidar scan come in addition to these.
+   * @param async_sensor_update Runs the sensors of a frame on a background thread, so that
+   * updateSensorFrame returns as soon as the frame is started.
+   */
+  explicit SensorSimulation(
+    std::size_t raycast_threads = 1, bool use_loaned_messages = false,
+    std::size_t sensor_update_threads = 1, bool async_sensor_update = false);
+
+  SensorSimulation(const SensorSimulation &) = delete;
+  SensorSimulation & operator=(const SensorSimulation &) = delete;
+  ~SensorSimulation();
+
+  /**
+   * @note The attach functions may be called while a frame is updated, by another thread or in the
+   * background. The sensor is updated from the next frame on.
+   */
   auto attachLidarSensor(
     const double current_simulation_time,
     const simulation_api_schema::LidarConfiguration & configuration, rclcpp::Node & node) -> void
   {
     if (configuration.architecture_type() == "awf/universe") {
-      lidar_sensors_.push_back(std::make_unique<LidarSensor<sensor_msgs::msg::PointCloud2>>(
+      auto sensor = std::make_unique<LidarSensor<sensor_msgs::msg::PointCloud2>>(
         current_simulation_time, configuration,
         node.create_publisher<sensor_msgs::msg::PointCloud2>(
-          "/perception/obstacle_segmentation/pointcloud", 1)));
+          "/perception/obstacle_segmentation/pointcloud", 1),
+        static_map_, raycast_threads_, use_loaned_messages_);
+      std::lock_guard<std::mutex> lock(attach_mutex_);
+      attached_lidar_sensors_.push_back(std::move(sensor));
     } else {
       std::stringstream ss;
       ss << "Unexpected architecture_type " << std::quoted(configuration.architecture_type())
@@ -53,9 +85,11 @@ public:
   {
     if (configuration.architecture_type() == "awf/universe") {
       using Message = autoware_auto_perception_msgs::msg::PredictedObjects;
-      detection_sensors_.push_back(std::make_unique<DetectionSensor<Message>>(
+      auto sensor = std::make_unique<DetectionSensor<Message>>(
         current_simulation_time, configuration,
-        node.create_publisher<Message>("/perception/object_recognition/objects", 1)));
+        node.create_publisher<Message>("/perception/object_recognition/objects", 1));
+      std::lock_guard<std::mutex> lock(attach_mutex_);
+      attached_detection_sensors_.push_back(std::move(sensor));
     } else {
       std::stringstream ss;
       ss << "Unexpected architecture_type " << std::quoted(configuration.architecture_type())
@@ -64,13 +98,68 @@ public:
     }
   }
 
+  /**
+   * @brief Loads the road surface, curbs and walls of the lanelet map, which the lidar sensors
+   * attached after this call cast rays against. An empty path removes them.
+   */
+  void loadStaticMap(const std::string & lanelet2_map_path);
+
+  /**
+   * @brief Updates the sensors which are due at the current time, lidar sensors first because
+   * the detection sensors use the entities they hit and their scenes.
+   * @note The sensors of each kind run concurrently on the sensor update threads, and their
+   * messages do not depend on the number of threads. In asynchronous mode, the status is copied
+   * and the sensors run on the background thread while this call returns. The next call waits for
+   * them first, and throws what they threw instead of starting its own frame. Calls from several
+   * threads update one frame after the other.
+   */
   void updateSensorFrame(
     double current_time, const rclcpp::Time & current_ros_time,
     const std::vector<traffic_simulator_msgs::EntityStatus> & status);
 
+  /**
+   * @brief Returns when the sensors of the last frame are updated. What they threw is kept for the
+   * next updateSensorFrame.
+   */
+  void waitForSensorFrame();
+
 private:
+  void runSensorFrames();
+  void addAttachedSensors();
+
+  void updateSensors(
+    double current_time, const rclcpp::Time & current_ros_time,
+    const std::vector<traffic_simulator_msgs::EntityStatus> & status);
+
+  const std::size_t raycast_threads_;
+  const bool use_loaned_messages_;
+  const bool async_sensor_update_;
+  simulation_interface::ThreadPool sensor_update_pool_;
+  /**
+   * @note The frame given to the background thread, guarded by sensor_frame_mutex_ except for the
+   * status, which only the background thread reads while sensor_frame_pending_ is set.
+   */
+  std::mutex sensor_frame_mutex_;
+  std::condition_variable sensor_frame_condition_;
+  bool sensor_frame_pending_ = false;
+  bool stopping_ = false;
+  double sensor_frame_time_ = 0;
+  rclcpp::Time sensor_frame_ros_time_;
+  std::vector<traffic_simulator_msgs::EntityStatus> sensor_frame_status_;
+  std::exception_ptr sensor_frame_error_;
+  std::thread sensor_frame_thread_;
+  std::string lanelet2_map_path_;
+  std::shared_ptr<const primitives::StaticMap> static_map_;
+  /**
+   * @note Sensors attached since the last frame, added to the sensors of the frame at its start.
+   */
+  std::mutex attach_mutex_;
+  std::vector<std::unique_ptr<LidarSensorBase>> attached_lidar_sensors_;
+  std::vector<std::unique_ptr<DetectionSensorBase>> attached_detection_sensors_;
+  std::mutex update_mutex_;
   std::vector<std::unique_ptr<LidarSensorBase>> lidar_sensors_;
   std::vector<std::unique_ptr<DetectionSensorBase>> detection_sensors_;
+  SpatialIndex entity_index_;
 };
 }  // namespace simple_sensor_simulator
 
@@ -0,0 +1,71 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SIMPLE_SENSOR_SIMULATOR__SENSOR_SIMULATION__SPATIAL_INDEX_HPP_
+#define SIMPLE_SENSOR_SIMULATOR__SENSOR_SIMULATION__SPATIAL_INDEX_HPP_
+
+#include <simulation_api_schema.pb.h>
+
+#include <boost/optional.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace simple_sensor_simulator
+{
+/**
+ * @brief Index of the entities of a frame by name and by position.
+ * @note The positions are binned into square cells of the xy plane, and the entities are sorted by
+ * cell, so a query only visits the cells overlapping its range. It is rebuilt every frame and
+ * keeps its memory across frames.
+ */
+class SpatialIndex
+{
+public:
+  explicit SpatialIndex(double cell_size = 20);
+
+  void build(const std::vector<traffic_simulator_msgs::EntityStatus> & status);
+
+  /**
+   * @brief Returns the index in the status of the last build of the entity of the name.
+   */
+  auto find(const std::string & name) const -> boost::optional<std::size_t>;
+
+  /**
+   * @brief Sets the indices in the status of the last build of the entities whose position is
+   * within the range of the point, in ascending order.
+   */
+  void findWithin(
+    const geometry_msgs::Point & point, double range, std::vector<std::size_t> & indices) const;
+
+private:
+  const double cell_size_;
+
+  const std::vector<traffic_simulator_msgs::EntityStatus> * status_ = nullptr;
+
+  std::unordered_map<std::string, std::size_t> names_;
+
+  /**
+   * @note Pairs of the key of the cell of an entity and its index, sorted.
+   */
+  std::vector<std::pair<std::uint64_t, std::size_t>> cells_;
+
+  auto getCell(double coordinate) const -> std::int64_t;
+};
+}  // namespace simple_sensor_simulator
+
+#endif  // SIMPLE_SENSOR_SIMULATOR__SENSOR_SIMULATION__SPATIAL_INDEX_HPP_
@@ -22,10 +22,12 @@
 #include <geometry_msgs/msg/transform_stamped.hpp>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <rclcpp/rclcpp.hpp>
 #include <simple_sensor_simulator/sensor_simulation/lidar/lidar_sensor.hpp>
 #include <simple_sensor_simulator/sensor_simulation/lidar/raycaster.hpp>
 #include <simple_sensor_simulator/sensor_simulation/sensor_simulation.hpp>
+#include <simulation_interface/entity_status_delta.hpp>
 #include <simulation_interface/zmq_multi_server.hpp>
 #include <string>
 #include <thread>
@@ -128,7 +130,13 @@ private:
   double current_time_;
   rclcpp::Time current_ros_time_;
   bool initialized_;
-  std::vector<traffic_simulator_msgs::EntityStatus> entity_status_;
+  simulation_interface::EntityStatusDeltaDecoder entity_status_decoder_;
+  /**
+   * @note The sensor handlers are SHARED handlers of the server, so they may run concurrently with
+   * each other. sensor_sim_ synchronizes its own calls, and the entity status and current_time_
+   * are only written by EXCLUSIVE handlers, so this mutex only guards current_ros_time_.
+   */
+  std::mutex sensor_mutex_;
   zeromq::MultiServer server_;
 };
 }  // namespace simple_sensor_simulator
@@ -12,10 +12,15 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <quaternion_operation/quaternion_operation.h>
+
+#include <Eigen/Core>
 #include <algorithm>
+#include <array>
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
+#include <cmath>
 #include <memory>
 #include <simple_sensor_simulator/exception.hpp>
 #include <simple_sensor_simulator/sensor_simulation/detection_sensor/detection_sensor.hpp>
@@ -25,29 +30,105 @@
 
 namespace simple_sensor_simulator
 {
-const std::vector<std::string> DetectionSensorBase::getDetectedObjects(
-  const std::vector<traffic_simulator_msgs::EntityStatus> & status) const
+namespace
+{
+std::array<double, 36> makeCovariance(
+  const google::protobuf::RepeatedField<double> & values, double diagonal)
 {
-  std::vector<std::string> detected_objects;
-  const auto pose = getSensorPose(status);
-  for (const auto & s : status) {
-    double distance = std::hypot(
-      s.pose().position().x() - pose.position().x(), s.pose().position().y() - pose.position().y(),
-      s.pose().position().z() - pose.position().z());
-    if (s.name() != configuration_.entity() && distance <= configuration_.range()) {
-      detected_objects.emplace_back(s.name());
+  std::array<double, 36> covariance = {};
+  if (values.empty()) {
+    for (std::size_t i = 0; i < 6; ++i) {
+      covariance[i * 7] = diagonal;
     }
+  } else if (values.size() == 36) {
+    std::copy(values.begin(), values.end(), covariance.begin());
+  } else {
+    throw SimulationRuntimeError("covariance of detection sensor must have 36 elements.");
   }
+  return covariance;
+}
+}  // namespace
+
+DetectionSensorBase::DetectionSensorBase(
+  const double last_update_stamp,
+  const simulation_api_schema::DetectionSensorConfiguration & configuration)
+: last_update_stamp_(last_update_stamp),
+  configuration_(configuration),
+  pose_covariance_(makeCovariance(configuration.pose_covariance(), 1)),
+  twist_covariance_(makeCovariance(configuration.twist_covariance(), 0))
+{
+}
+
+auto DetectionSensorBase::getDetectedObjects(
+  const std::vector<traffic_simulator_msgs::EntityStatus> & status, const SpatialIndex & index,
+  const std::vector<std::string> & lidar_detected_entity, const Raycaster * occluder) const
+  -> std::vector<std::size_t>
+{
+  if (configuration_.filter_by_occlusion() && !occluder) {
+    throw SimulationRuntimeError(
+      "Detection sensor filtering by occlusion needs a lidar sensor attached to the same entity.");
+  }
+  const auto sensor_pose = getSensorPose(status, index);
+  geometry_msgs::msg::Pose pose;
+  simulation_interface::toMsg(sensor_pose, pose);
+  std::vector<std::size_t> detected_objects;
+  if (configuration_.filter_by_range()) {
+    index.findWithin(sensor_pose.position(), configuration_.range(), detected_objects);
+  } else {
+    for (const auto & name : lidar_detected_entity) {
+      if (const auto i = index.find(name)) {
+        detected_objects.emplace_back(i.get());
+      }
+    }
+    std::sort(detected_objects.begin(), detected_objects.end());
+  }
+  const Eigen::Matrix3d rotation = quaternion_operation::getRotationMatrix(pose.orientation);
+  const Eigen::Vector3d origin(pose.position.x, pose.position.y, pose.position.z);
+  const auto isCulled = [&](std::size_t i) {
+    const auto & s = status[i];
+    if (
+      s.name() == configuration_.entity() ||
+      s.type().type() == traffic_simulator_msgs::EntityType_Enum::EntityType_Enum_EGO) {
+      return true;
+    }
+    const Eigen::Vector3d position(
+      s.pose().position().x(), s.pose().position().y(), s.pose().position().z());
+    if (configuration_.horizontal_field_of_view() > 0) {
+      const Eigen::Vector3d local = rotation.transpose() * (position - origin);
+      const auto azimuth = std::atan2(local.y(), local.x());
+      if (std::abs(azimuth) > configuration_.horizontal_field_of_view() / 2) {
+        return true;
+      }
+    }
+    if (configuration_.filter_by_occlusion()) {
+      geometry_msgs::msg::Pose entity_pose;
+      simulation_interface::toMsg(s.pose(), entity_pose);
+      geometry_msgs::msg::Point center_point;
+      simulation_interface::toMsg(s.bounding_box().center(), center_point);
+      const Eigen::Vector3d center =
+        position + quaternion_operation::getRotationMatrix(entity_pose.orientation) *
+                     Eigen::Vector3d(center_point.x, center_point.y, center_point.z);
+      geometry_msgs::msg::Point target;
+      target.x = center.x();
+      target.y = center.y();
+      target.z = center.z();
+      return !occluder->isVisible(occluder->getOrigin().position, target, s.name());
+    }
+    return false;
+  };
+  detected_objects.erase(
+    std::remove_if(detected_objects.begin(), detected_objects.end(), isCulled),
+    detected_objects.end());
   return detected_objects;
 }
 
 geometry_msgs::Pose DetectionSensorBase::getSensorPose(
-  const std::vector<traffic_simulator_msgs::EntityStatus> & status) const
+  const std::vector<traffic_simulator_msgs::EntityStatus> & status,
+  const SpatialIndex & index) const
 {
-  for (const auto & s : status) {
-    if (
-      s.type().type() == traffic_simulator_msgs::EntityType::EGO &&
-      s.name() == configuration_.entity()) {
+  if (const auto i = index.find(configuration_.entity())) {
+    const auto & s = status[i.get()];
+    if (s.type().type() == traffic_simulator_msgs::EntityType::EGO) {
       return s.pose();
     }
   }
@@ -57,7 +138,8 @@ geometry_msgs::Pose DetectionSensorBase::getSensorPose(
 template <>
 void DetectionSensor<autoware_auto_perception_msgs::msg::PredictedObjects>::update(
   const double current_time, const std::vector<traffic_simulator_msgs::EntityStatus> & status,
-  const rclcpp::Time & stamp, const std::vector<std::string> & lidar_detected_entity)
+  const rclcpp::Time & stamp, const std::vector<std::string> & lidar_detected_entity,
+  const SpatialIndex & index, const Raycaster * occluder)
 {
   auto makeObjectClassification = [](const auto & label) {
     autoware_auto_perception_msgs::msg::ObjectClassification object_classification;
@@ -68,78 +150,65 @@ void DetectionSensor<autoware_auto_perception_msgs::msg::PredictedObjects>::upda
 
     return object_classification;
   };
-  std::vector<std::string> detected_objects;
-  if (configuration_.filter_by_range()) {
-    detected_objects = getDetectedObjects(status);
-  } else {
-    detected_objects = lidar_detected_entity;
-  }
   if (current_time - last_update_stamp_ - configuration_.update_duration() >= -0.002) {
     autoware_auto_perception_msgs::msg::PredictedObjects msg;
     msg.header.stamp = stamp;
     msg.header.frame_id = "map";
     last_update_stamp_ = current_time;
-    for (const auto & s : status) {
-      auto result = std::find(detected_objects.begin(), detected_objects.end(), s.name());
-      if (result != detected_objects.end()) {
-        autoware_auto_perception_msgs::msg::PredictedObject object;
-        bool is_ego = false;
-        if (s.type().type() == traffic_simulator_msgs::EntityType_Enum::EntityType_Enum_EGO) {
-          is_ego = true;
-        } else {
-          switch (s.subtype().value()) {
-            case traffic_simulator_msgs::EntitySubtype_Enum::EntitySubtype_Enum_UNKNOWN:
-              object.classification.push_back(makeObjectClassification(
-                autoware_auto_perception_msgs::msg::ObjectClassification::UNKNOWN));
-              break;
-            case traffic_simulator_msgs::EntitySubtype_Enum::EntitySubtype_Enum_CAR:
-              object.classification.push_back(makeObjectClassification(
-                autoware_auto_perception_msgs::msg::ObjectClassification::CAR));
-              break;
-            case traffic_simulator_msgs::EntitySubtype_Enum::EntitySubtype_Enum_TRUCK:
-              object.classification.push_back(makeObjectClassification(
-                autoware_auto_perception_msgs::msg::ObjectClassification::TRUCK));
-              break;
-            case traffic_simulator_msgs::EntitySubtype_Enum::EntitySubtype_Enum_BUS:
-              object.classification.push_back(makeObjectClassification(
-                autoware_auto_perception_msgs::msg::ObjectClassification::BUS));
-              break;
-            case traffic_simulator_msgs::EntitySubtype_Enum::EntitySubtype_Enum_TRAILER:
-              object.classification.push_back(makeObjectClassification(
-                autoware_auto_perception_msgs::msg::ObjectClassification::TRAILER));
-              break;
-            case traffic_simulator_msgs::EntitySubtype_Enum::EntitySubtype_Enum_MOTORCYCLE:
-              object.classification.push_back(makeObjectClassification(
-                autoware_auto_perception_msgs::msg::ObjectClassification::MOTORCYCLE));
-              break;
-            case traffic_simulator_msgs::EntitySubtype_Enum::EntitySubtype_Enum_BICYCLE:
-              object.classification.push_back(makeObjectClassification(
-                autoware_auto_perception_msgs::msg::ObjectClassification::BICYCLE));
-              break;
-            case traffic_simulator_msgs::EntitySubtype_Enum::EntitySubtype_Enum_PEDESTRIAN:
-              object.classification.push_back(makeObjectClassification(
-                autoware_auto_perception_msgs::msg::ObjectClassification::PEDESTRIAN));
-              break;
-            default:
-              object.classification.push_back(makeObjectClassification(
-                autoware_auto_perception_msgs::msg::ObjectClassification::UNKNOWN));
-              break;
-          }
-        }
-        if (not is_ego) {
-          simulation_interface::toMsg(s.bounding_box().dimensions(), object.shape.dimensions);
-          geometry_msgs::msg::Pose pose;
-          simulation_interface::toMsg(s.pose(), pose);
-          object.kinematics.initial_pose_with_covariance.pose = pose;
-          object.kinematics.initial_pose_with_covariance.covariance = {
-            1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0,
-            0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 1};
-          simulation_interface::toMsg(
-            s.action_status().twist(), object.kinematics.initial_twist_with_covariance.twist);
-          object.shape.type = object.shape.BOUNDING_BOX;
-          msg.objects.emplace_back(object);
-        }
+    const auto detected_objects =
+      getDetectedObjects(status, index, lidar_detected_entity, occluder);
+    msg.objects.reserve(detected_objects.size());
+    for (const auto i : detected_objects) {
+      const auto & s = status[i];
+      autoware_auto_perception_msgs::msg::PredictedObject object;
+      switch (s.subtype().value()) {
+        case traffic_simulator_msgs::EntitySubtype_Enum::EntitySubtype_Enum_UNKNOWN:
+          object.classification.push_back(makeObjectClassification(
+            autoware_auto_perception_msgs::msg::ObjectClassification::UNKNOWN));
+          break;
+        case traffic_simulator_msgs::EntitySubtype_Enum::EntitySubtype_Enum_CAR:
+          object.classification.push_back(makeObjectClassification(
+            autoware_auto_perception_msgs::msg::ObjectClassification::CAR));
+          break;
+        case traffic_simulator_msgs::EntitySubtype_Enum::EntitySubtype_Enum_TRUCK:
+          object.classification.push_back(makeObjectClassification(
+            autoware_auto_perception_msgs::msg::ObjectClassification::TRUCK));
+          break;
+        case traffic_simulator_msgs::EntitySubtype_Enum::EntitySubtype_Enum_BUS:
+          object.classification.push_back(makeObjectClassification(
+            autoware_auto_perception_msgs::msg::ObjectClassification::BUS));
+          break;
+        case traffic_simulator_msgs::EntitySubtype_Enum::EntitySubtype_Enum_TRAILER:
+          object.classification.push_back(makeObjectClassification(
+            autoware_auto_perception_msgs::msg::ObjectClassification::TRAILER));
+          break;
+        case traffic_simulator_msgs::EntitySubtype_Enum::EntitySubtype_Enum_MOTORCYCLE:
+          object.classification.push_back(makeObjectClassification(
+            autoware_auto_perception_msgs::msg::ObjectClassification::MOTORCYCLE));
+          break;
+        case traffic_simulator_msgs::EntitySubtype_Enum::EntitySubtype_Enum_BICYCLE:
+          object.classification.push_back(makeObjectClassification(
+            autoware_auto_perception_msgs::msg::ObjectClassification::BICYCLE));
+          break;
+        case traffic_simulator_msgs::EntitySubtype_Enum::EntitySubtype_Enum_PEDESTRIAN:
+          object.classification.push_back(makeObjectClassification(
+            autoware_auto_perception_msgs::msg::ObjectClassification::PEDESTRIAN));
+          break;
+        default:
+          object.classification.push_back(makeObjectClassification(
+            autoware_auto_perception_msgs::msg::ObjectClassification::UNKNOWN));
+          break;
       }
+      simulation_interface::toMsg(s.bounding_box().dimensions(), object.shape.dimensions);
+      geometry_msgs::msg::Pose pose;
+      simulation_interface::toMsg(s.pose(), pose);
+      object.kinematics.initial_pose_with_covariance.pose = pose;
+      object.kinematics.initial_pose_with_covariance.covariance = pose_covariance_;
+      simulation_interface::toMsg(
+        s.action_status().twist(), object.kinematics.initial_twist_with_covariance.twist);
+      object.kinematics.initial_twist_with_covariance.covariance = twist_covariance_;
+      object.shape.type = object.shape.BOUNDING_BOX;
+      msg.objects.emplace_back(object);
     }
     publisher_ptr_->publish(msg);
   }
@@ -14,7 +14,9 @@
 
 #include <quaternion_operation/quaternion_operation.h>
 
-#include <boost/optional.hpp>
+#include <Eigen/Core>
+#include <algorithm>
+#include <cstring>
 #include <memory>
 #include <simple_sensor_simulator/exception.hpp>
 #include <simple_sensor_simulator/sensor_simulation/lidar/lidar_sensor.hpp>
@@ -25,19 +27,87 @@
 
 namespace simple_sensor_simulator
 {
-template <>
-auto LidarSensor<sensor_msgs::msg::PointCloud2>::raycast(
-  const std::vector<traffic_simulator_msgs::EntityStatus> & status, const rclcpp::Time & stamp)
-  -> sensor_msgs::msg::PointCloud2
+namespace
+{
+/**
+ * @note Returns closer than this are dropped, so that a ray never hits the surface it starts on.
+ */
+constexpr double min_distance = 0.5;
+
+geometry_msgs::msg::Pose makeMountingPose(
+  const simulation_api_schema::LidarConfiguration & configuration)
+{
+  geometry_msgs::msg::Pose pose;
+  if (configuration.has_mounting_pose()) {
+    simulation_interface::toMsg(configuration.mounting_pose(), pose);
+  } else {
+    pose.position.z = 1.8;
+  }
+  return pose;
+}
+}  // namespace
+
+LidarSensorBase::LidarSensorBase(
+  const double last_update_stamp, const simulation_api_schema::LidarConfiguration & configuration)
+: last_update_stamp_(last_update_stamp),
+  configuration_(configuration),
+  mounting_pose_(makeMountingPose(configuration))
+{
+}
+
+auto LidarSensorBase::getSensorPose(const geometry_msgs::msg::Pose & entity_pose) const
+  -> geometry_msgs::msg::Pose
+{
+  const Eigen::Vector3d position(
+    mounting_pose_.position.x, mounting_pose_.position.y, mounting_pose_.position.z);
+  const Eigen::Vector3d offset =
+    quaternion_operation::getRotationMatrix(entity_pose.orientation) * position;
+  geometry_msgs::msg::Pose pose;
+  pose.position.x = entity_pose.position.x + offset.x();
+  pose.position.y = entity_pose.position.y + offset.y();
+  pose.position.z = entity_pose.position.z + offset.z();
+  pose.orientation = entity_pose.orientation * mounting_pose_.orientation;
+  return pose;
+}
+
+auto LidarSensorBase::toEntityFrame(sensor_msgs::msg::PointCloud2 & pointcloud) const -> void
 {
-  Raycaster raycaster;
-  boost::optional<geometry_msgs::msg::Pose> ego_pose;
+  using Point = Raycaster::Point;
+  const Eigen::Matrix3f rotation =
+    quaternion_operation::getRotationMatrix(mounting_pose_.orientation).cast<float>();
+  const Eigen::Vector3f translation(
+    mounting_pose_.position.x, mounting_pose_.position.y, mounting_pose_.position.z);
+  const auto size = pointcloud.data.size() / sizeof(Point);
+  for (std::size_t i = 0; i < size; ++i) {
+    Point point;
+    std::memcpy(&point, pointcloud.data.data() + i * sizeof(Point), sizeof(Point));
+    const Eigen::Vector3f position =
+      rotation * Eigen::Vector3f(point.x, point.y, point.z) + translation;
+    point.x = position.x();
+    point.y = position.y();
+    point.z = position.z();
+    std::memcpy(pointcloud.data.data() + i * sizeof(Point), &point, sizeof(Point));
+  }
+}
+
+auto LidarSensorBase::addPrimitives(
+  Raycaster & raycaster, const std::vector<traffic_simulator_msgs::EntityStatus> & status) const
+  -> geometry_msgs::msg::Pose
+{
+  const auto ego = std::find_if(status.begin(), status.end(), [this](const auto & s) {
+    return configuration_.entity() == s.name();
+  });
+  if (ego == status.end()) {
+    /**
+     * @note Checked before adding any primitive, otherwise the primitives would be left pending
+     * in the raycaster until the next scan.
+     */
+    throw simple_sensor_simulator::SimulationRuntimeError("failed to found ego vehicle");
+  }
+  geometry_msgs::msg::Pose ego_pose;
+  simulation_interface::toMsg(ego->pose(), ego_pose);
   for (const auto & s : status) {
-    if (configuration_.entity() == s.name()) {
-      geometry_msgs::msg::Pose pose;
-      simulation_interface::toMsg(s.pose(), pose);
-      ego_pose = pose;
-    } else {
+    if (configuration_.entity() != s.name()) {
       geometry_msgs::msg::Pose pose;
       simulation_interface::toMsg(s.pose(), pose);
       auto rotation = quaternion_operation::getRotationMatrix(pose.orientation);
@@ -53,16 +123,24 @@ auto LidarSensor<sensor_msgs::msg::PointCloud2>::raycast(
         s.bounding_box().dimensions().z(), pose);
     }
   }
-  if (ego_pose) {
-    std::vector<double> vertical_angles;
-    for (const auto v : configuration_.vertical_angles()) {
-      vertical_angles.emplace_back(v);
-    }
-    const auto pointcloud = raycaster.raycast(
-      "base_link", stamp, ego_pose.get(), configuration_.horizontal_resolution(), vertical_angles);
-    detected_objects_ = raycaster.getDetectedObject();
-    return pointcloud;
+  return getSensorPose(ego_pose);
+}
+
+template <>
+auto LidarSensor<sensor_msgs::msg::PointCloud2>::raycast(
+  const std::vector<traffic_simulator_msgs::EntityStatus> & status, const rclcpp::Time & stamp,
+  sensor_msgs::msg::PointCloud2 & pointcloud) -> void
+{
+  const auto origin = addPrimitives(raycaster_, status);
+  std::vector<double> vertical_angles;
+  for (const auto v : configuration_.vertical_angles()) {
+    vertical_angles.emplace_back(v);
   }
-  throw simple_sensor_simulator::SimulationRuntimeError("failed to found ego vehicle");
+  raycaster_.raycast(
+    pointcloud, "base_link", stamp, origin, configuration_.horizontal_resolution(),
+    vertical_angles, 0, 2 * M_PI, 100, min_distance);
+  noise_model_.apply(pointcloud);
+  toEntityFrame(pointcloud);
+  detected_objects_ = raycaster_.getDetectedObject();
 }
 }  // namespace simple_sensor_simulator
@@ -0,0 +1,119 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <simple_sensor_simulator/sensor_simulation/lidar/noise_model.hpp>
+#include <simple_sensor_simulator/sensor_simulation/lidar/raycaster.hpp>
+
+namespace simple_sensor_simulator
+{
+namespace
+{
+/**
+ * @note Finalizer of splitmix64, which maps consecutive integers to well distributed bits.
+ */
+std::uint64_t hash(std::uint64_t x)
+{
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  return x ^ (x >> 31);
+}
+
+/**
+ * @brief Returns the bits of the value from the offset as a number uniformly distributed in (0, 1).
+ */
+double toUniform(std::uint64_t bits, int offset, int size)
+{
+  return (((bits >> offset) & ((1ULL << size) - 1)) + 0.5) / (1ULL << size);
+}
+
+/**
+ * @brief Returns the quantile of the standard normal distribution at the probability.
+ * @note Rational approximation of Peter J. Acklam, with a relative error below 1.2e-9. Only the
+ * 5 % of the probabilities in the tails need a logarithm.
+ */
+double toNormal(double probability)
+{
+  constexpr double a[] = {-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                          1.383577518672690e+02,  -3.066479806614716e+01, 2.506628277459239e+00};
+  constexpr double b[] = {-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                          6.680131188771348e+01, -1.328068155288572e+01};
+  constexpr double c[] = {-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                          -2.549732539343734e+00, 4.374664141464968e+00,  2.938163982698783e+00};
+  constexpr double d[] = {7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                          3.754408661907416e+00};
+  constexpr double tail = 0.02425;
+  if (tail <= probability && probability <= 1 - tail) {
+    const auto q = probability - 0.5;
+    const auto r = q * q;
+    return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+           (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1);
+  }
+  const auto q = std::sqrt(-2 * std::log(std::min(probability, 1 - probability)));
+  const auto x = (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+                 ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+  return probability < tail ? x : -x;
+}
+}  // namespace
+
+NoiseModel::NoiseModel(const simulation_api_schema::LidarConfiguration & configuration)
+: range_noise_standard_deviation_(configuration.range_noise_standard_deviation()),
+  dropout_factor_(
+    configuration.dropout_range() > 0
+      ? configuration.dropout_probability() /
+          (configuration.dropout_range() * configuration.dropout_range())
+      : 0),
+  intensity_scale_(configuration.intensity_scale()),
+  seed_(hash(configuration.random_seed()))
+{
+}
+
+/**
+ * @note The 64 bits hashed for each return give a uniform number of 32 bits for the gaussian
+ * noise, drawn by the inverse of its cumulative distribution, and one of 32 bits for the dropout.
+ * Each return is written at the end of the returns kept so far and counted as kept if its dropout
+ * sample is above its dropout probability, so losing a return does not branch.
+ */
+void NoiseModel::apply(sensor_msgs::msg::PointCloud2 & pointcloud)
+{
+  using Point = Raycaster::Point;
+  const auto size = pointcloud.data.size() / sizeof(Point);
+  const auto data = pointcloud.data.data();
+  std::size_t kept = 0;
+  for (std::size_t i = 0; i < size; ++i) {
+    Point point;
+    std::memcpy(&point, data + i * sizeof(Point), sizeof(Point));
+    const auto bits = hash(seed_ + (returns_ + i) * 0x9E3779B97F4A7C15ULL);
+    const auto squared_range = point.x * point.x + point.y * point.y + point.z * point.z;
+    const auto range = std::sqrt(squared_range);
+    if (range_noise_standard_deviation_ > 0 && range > 0) {
+      const auto noise = range_noise_standard_deviation_ * toNormal(toUniform(bits, 32, 32));
+      const auto scale = std::max(range + static_cast<float>(noise), 0.0f) / range;
+      point.x = point.x * scale;
+      point.y = point.y * scale;
+      point.z = point.z * scale;
+    }
+    point.intensity = point.intensity * intensity_scale_;
+    std::memcpy(data + kept * sizeof(Point), &point, sizeof(Point));
+    kept = kept + (toUniform(bits, 0, 32) >= std::min(1.0f, dropout_factor_ * squared_range));
+  }
+  returns_ = returns_ + size;
+  pointcloud.data.resize(kept * sizeof(Point));
+  pointcloud.height = 1;
+  pointcloud.width = kept;
+  pointcloud.row_step = kept * sizeof(Point);
+}
+}  // namespace simple_sensor_simulator
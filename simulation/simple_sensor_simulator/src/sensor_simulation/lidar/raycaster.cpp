@@ -15,107 +15,410 @@
 #include <quaternion_operation/quaternion_operation.h>
 
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
 #include <iostream>
+#include <memory>
+#include <sensor_msgs/msg/point_field.hpp>
 #include <simple_sensor_simulator/sensor_simulation/lidar/lidar_sensor.hpp>
 #include <simple_sensor_simulator/sensor_simulation/lidar/raycaster.hpp>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
 namespace simple_sensor_simulator
 {
-Raycaster::Raycaster() : primitive_ptrs_(0), device_(nullptr), scene_(nullptr), engine_(seed_gen_())
+namespace
+{
+void setTransform(RTCGeometry geometry, const geometry_msgs::msg::Pose & pose)
+{
+  const auto rotation = quaternion_operation::getRotationMatrix(pose.orientation);
+  std::array<float, 12> transform;
+  for (int column = 0; column < 3; ++column) {
+    for (int row = 0; row < 3; ++row) {
+      transform[column * 3 + row] = rotation(row, column);
+    }
+  }
+  transform[9] = pose.position.x;
+  transform[10] = pose.position.y;
+  transform[11] = pose.position.z;
+  rtcSetGeometryTransform(geometry, 0, RTC_FORMAT_FLOAT3X4_COLUMN_MAJOR, transform.data());
+}
+
+using Point = Raycaster::Point;
+
+const std::vector<sensor_msgs::msg::PointField> & getPointFields()
+{
+  static const auto fields = []() {
+    std::vector<sensor_msgs::msg::PointField> fields;
+    const auto add = [&](const std::string & name, std::uint32_t offset) {
+      sensor_msgs::msg::PointField field;
+      field.name = name;
+      field.offset = offset;
+      field.datatype = sensor_msgs::msg::PointField::FLOAT32;
+      field.count = 1;
+      fields.emplace_back(field);
+    };
+    add("x", offsetof(Point, x));
+    add("y", offsetof(Point, y));
+    add("z", offsetof(Point, z));
+    add("intensity", offsetof(Point, intensity));
+    return fields;
+  }();
+  return fields;
+}
+
+bool equals(const std::vector<Vertex> & v0, const std::vector<Vertex> & v1)
+{
+  return std::equal(
+    v0.begin(), v0.end(), v1.begin(), v1.end(), [](const Vertex & a, const Vertex & b) {
+      return a.x == b.x && a.y == b.y && a.z == b.z;
+    });
+}
+}  // namespace
+
+Raycaster::Raycaster()
+: primitive_ptrs_(0),
+  device_(nullptr),
+  scene_(nullptr),
+  engine_(seed_gen_()),
+  thread_pool_(std::make_unique<simulation_interface::ThreadPool>())
 {
   device_ = rtcNewDevice(nullptr);
+  scene_ = rtcNewScene(device_);
+  rtcSetSceneFlags(scene_, RTC_SCENE_FLAG_DYNAMIC);
+  rtcSetSceneBuildQuality(scene_, RTC_BUILD_QUALITY_LOW);
 }
 
 Raycaster::Raycaster(std::string embree_config)
-: primitive_ptrs_(0), device_(nullptr), scene_(nullptr), engine_(seed_gen_())
+: primitive_ptrs_(0),
+  device_(nullptr),
+  scene_(nullptr),
+  engine_(seed_gen_()),
+  thread_pool_(std::make_unique<simulation_interface::ThreadPool>())
 {
   device_ = rtcNewDevice(embree_config.c_str());
+  scene_ = rtcNewScene(device_);
+  rtcSetSceneFlags(scene_, RTC_SCENE_FLAG_DYNAMIC);
+  rtcSetSceneBuildQuality(scene_, RTC_BUILD_QUALITY_LOW);
 }
 
-Raycaster::~Raycaster() { rtcReleaseDevice(device_); }
+Raycaster::~Raycaster()
+{
+  for (const auto & instance : instances_) {
+    releaseInstance(instance.second);
+  }
+  if (static_map_) {
+    releaseInstance(static_map_.get());
+  }
+  rtcReleaseScene(scene_);
+  rtcReleaseDevice(device_);
+}
 
 const sensor_msgs::msg::PointCloud2 Raycaster::raycast(
   std::string frame_id, const rclcpp::Time & stamp, geometry_msgs::msg::Pose origin,
   double horizontal_resolution, std::vector<double> vertical_angles, double horizontal_angle_start,
   double horizontal_angle_end, double max_distance, double min_distance)
 {
-  std::vector<geometry_msgs::msg::Quaternion> directions;
-  double horizontal_angle = horizontal_angle_start;
-  while (horizontal_angle <= (horizontal_angle_end)) {
-    horizontal_angle = horizontal_angle + horizontal_resolution;
-    for (const auto vertical_angle : vertical_angles) {
-      geometry_msgs::msg::Vector3 rpy;
-      rpy.x = 0;
-      rpy.y = vertical_angle;
-      rpy.z = horizontal_angle;
-      auto quat = quaternion_operation::convertEulerAngleToQuaternion(rpy);
-      directions.emplace_back(quat);
+  sensor_msgs::msg::PointCloud2 pointcloud;
+  raycast(
+    pointcloud, frame_id, stamp, origin, horizontal_resolution, vertical_angles,
+    horizontal_angle_start, horizontal_angle_end, max_distance, min_distance);
+  return pointcloud;
+}
+
+void Raycaster::raycast(
+  sensor_msgs::msg::PointCloud2 & pointcloud, const std::string & frame_id,
+  const rclcpp::Time & stamp, const geometry_msgs::msg::Pose & origin,
+  double horizontal_resolution, const std::vector<double> & vertical_angles,
+  double horizontal_angle_start, double horizontal_angle_end, double max_distance,
+  double min_distance)
+{
+  const Pattern pattern = {
+    horizontal_resolution, vertical_angles, horizontal_angle_start, horizontal_angle_end};
+  if (!pattern_ || !(pattern_.get() == pattern)) {
+    directions_.clear();
+    double horizontal_angle = horizontal_angle_start;
+    while (horizontal_angle <= (horizontal_angle_end)) {
+      horizontal_angle = horizontal_angle + horizontal_resolution;
+      for (const auto vertical_angle : vertical_angles) {
+        geometry_msgs::msg::Vector3 rpy;
+        rpy.x = 0;
+        rpy.y = vertical_angle;
+        rpy.z = horizontal_angle;
+        auto quat = quaternion_operation::convertEulerAngleToQuaternion(rpy);
+        directions_.emplace_back(
+          quaternion_operation::getRotationMatrix(quat) * Eigen::Vector3d(1.0, 0.0, 0.0));
+      }
     }
+    pattern_ = pattern;
   }
-  return raycast(frame_id, stamp, origin, directions, max_distance, min_distance);
+  castRays(pointcloud, origin, directions_, max_distance, min_distance);
+  pointcloud.header.frame_id = frame_id;
+  pointcloud.header.stamp = stamp;
 }
 
 const std::vector<std::string> & Raycaster::getDetectedObject() const { return detected_objects_; }
 
-const sensor_msgs::msg::PointCloud2 Raycaster::raycast(
-  std::string frame_id, const rclcpp::Time & stamp, geometry_msgs::msg::Pose origin,
-  std::vector<geometry_msgs::msg::Quaternion> directions, double max_distance, double min_distance)
+void Raycaster::commitScene(const geometry_msgs::msg::Pose & origin)
 {
-  detected_objects_ = {};
-  std::vector<unsigned int> detected_ids = {};
-  scene_ = rtcNewScene(device_);
-  pcl::PointCloud<pcl::PointXYZI>::Ptr cloud(new pcl::PointCloud<pcl::PointXYZI>());
-  for (auto & pair : primitive_ptrs_) {
-    auto id = pair.second->addToScene(device_, scene_);
-    geometry_ids_.insert({id, pair.first});
+  updateScene();
+  primitive_ptrs_.clear();
+  origin_ = origin;
+}
+
+const geometry_msgs::msg::Pose & Raycaster::getOrigin() const { return origin_; }
+
+bool Raycaster::isVisible(
+  const geometry_msgs::msg::Point & origin, const geometry_msgs::msg::Point & target,
+  const std::string & name) const
+{
+  const Eigen::Vector3d vector(target.x - origin.x, target.y - origin.y, target.z - origin.z);
+  const auto distance = vector.norm();
+  if (distance == 0) {
+    return true;
+  }
+  const Eigen::Vector3d direction = vector / distance;
+  RTCIntersectContext context;
+  rtcInitIntersectContext(&context);
+  RTCRayHit rayhit;
+  rayhit.ray.org_x = origin.x;
+  rayhit.ray.org_y = origin.y;
+  rayhit.ray.org_z = origin.z;
+  rayhit.ray.dir_x = direction[0];
+  rayhit.ray.dir_y = direction[1];
+  rayhit.ray.dir_z = direction[2];
+  rayhit.ray.tnear = 0.01;
+  rayhit.ray.tfar = distance;
+  rayhit.ray.time = 0;
+  rayhit.ray.mask = 0xFFFFFFFF;
+  rayhit.ray.id = 0;
+  rayhit.ray.flags = 0;
+  rayhit.hit.geomID = RTC_INVALID_GEOMETRY_ID;
+  rayhit.hit.instID[0] = RTC_INVALID_GEOMETRY_ID;
+  rtcIntersect1(scene_, &context, &rayhit);
+  if (rayhit.hit.geomID == RTC_INVALID_GEOMETRY_ID) {
+    return true;
+  }
+  const auto iter = instances_.find(name);
+  return iter != instances_.end() && rayhit.hit.instID[0] == iter->second.geometry_id;
+}
+
+void Raycaster::setStaticMap(const primitives::Primitive & static_map)
+{
+  if (static_map_) {
+    releaseInstance(static_map_.get());
+  }
+  static_map_ = makeInstance(static_map, RTC_BUILD_QUALITY_HIGH);
+  geometry_ids_.erase(static_map_->geometry_id);
+}
+
+auto Raycaster::makeInstance(const primitives::Primitive & primitive, RTCBuildQuality quality)
+  -> Instance
+{
+  Instance instance;
+  instance.type = primitive.type;
+  instance.scene = rtcNewScene(device_);
+  rtcSetSceneBuildQuality(instance.scene, quality);
+  primitive.addToLocalScene(device_, instance.scene);
+  rtcCommitScene(instance.scene);
+  instance.geometry = rtcNewGeometry(device_, RTC_GEOMETRY_TYPE_INSTANCE);
+  rtcSetGeometryInstancedScene(instance.geometry, instance.scene);
+  setTransform(instance.geometry, primitive.pose);
+  rtcCommitGeometry(instance.geometry);
+  instance.geometry_id = rtcAttachGeometry(scene_, instance.geometry);
+  setInstanceRotation(instance.geometry_id, primitive.pose.orientation);
+  return instance;
+}
+
+void Raycaster::setInstanceRotation(
+  unsigned int geometry_id, const geometry_msgs::msg::Quaternion & orientation)
+{
+  if (instance_rotations_.size() <= geometry_id) {
+    instance_rotations_.resize(geometry_id + 1, Eigen::Matrix3d::Identity());
+  }
+  instance_rotations_[geometry_id] = quaternion_operation::getRotationMatrix(orientation);
+}
+
+void Raycaster::releaseInstance(const Instance & instance)
+{
+  rtcDetachGeometry(scene_, instance.geometry_id);
+  rtcReleaseGeometry(instance.geometry);
+  rtcReleaseScene(instance.scene);
+  geometry_ids_.erase(instance.geometry_id);
+}
+
+void Raycaster::updateScene()
+{
+  for (auto iter = instances_.begin(); iter != instances_.end();) {
+    if (primitive_ptrs_.count(iter->first) == 0) {
+      releaseInstance(iter->second);
+      iter = instances_.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+  for (const auto & pair : primitive_ptrs_) {
+    const auto & primitive = *pair.second;
+    auto vertices = primitive.getLocalVertex();
+    auto iter = instances_.find(pair.first);
+    if (
+      iter != instances_.end() && iter->second.type == primitive.type &&
+      equals(iter->second.vertices, vertices)) {
+      setTransform(iter->second.geometry, primitive.pose);
+      rtcCommitGeometry(iter->second.geometry);
+      setInstanceRotation(iter->second.geometry_id, primitive.pose.orientation);
+      continue;
+    }
+    if (iter != instances_.end()) {
+      releaseInstance(iter->second);
+      instances_.erase(iter);
+    }
+    auto instance = makeInstance(primitive, RTC_BUILD_QUALITY_MEDIUM);
+    instance.vertices = std::move(vertices);
+    geometry_ids_.insert({instance.geometry_id, pair.first});
+    instances_.emplace(pair.first, std::move(instance));
   }
   rtcCommitScene(scene_);
+}
+
+void Raycaster::setThreadCount(std::size_t thread_count)
+{
+  if (thread_count != thread_pool_->size()) {
+    thread_pool_ = std::make_unique<simulation_interface::ThreadPool>(thread_count);
+  }
+}
+
+/**
+ * @note Rays are cast in packets of 16 along the direction table, and hits are appended in the
+ * order of the table, so the order of the points does not depend on the packet size.
+ */
+void Raycaster::castSector(
+  Sector & sector, std::uint8_t * data, const geometry_msgs::msg::Pose & origin,
+  const Eigen::Matrix3d & rotation, const std::vector<Eigen::Vector3d> & directions,
+  double max_distance, double min_distance)
+{
+  constexpr std::size_t packet_size = 16;
+  sector.point_count = 0;
+  sector.detected_ids.clear();
+  sector.detected_id_set.clear();
   RTCIntersectContext context;
   rtcInitIntersectContext(&context);
-  for (const auto & direction : directions) {
-    RTCRayHit rayhit;
-    rayhit.ray.org_x = origin.position.x;
-    rayhit.ray.org_y = origin.position.y;
-    rayhit.ray.org_z = origin.position.z;
-    rayhit.ray.tfar = max_distance;
-    rayhit.ray.tnear = min_distance;
-    rayhit.ray.flags = false;
-    const auto ray_direction = origin.orientation * direction;
-    const auto rotation_mat = quaternion_operation::getRotationMatrix(ray_direction);
-    const Eigen::Vector3d rotated_direction = rotation_mat * Eigen::Vector3d(1.0, 0.0, 0.0);
-    rayhit.ray.dir_x = rotated_direction[0];
-    rayhit.ray.dir_y = rotated_direction[1];
-    rayhit.ray.dir_z = rotated_direction[2];
-    rayhit.hit.geomID = RTC_INVALID_GEOMETRY_ID;
-    rtcIntersect1(scene_, &context, &rayhit);
-    if (rayhit.hit.geomID != RTC_INVALID_GEOMETRY_ID) {
-      double distance = rayhit.ray.tfar;
-      const Eigen::Vector3d vector = quaternion_operation::getRotationMatrix(direction) *
-                                     Eigen::Vector3d(1.0, 0.0, 0.0) * distance;
-      pcl::PointXYZI p;
-      {
-        p.x = vector[0];
-        p.y = vector[1];
-        p.z = vector[2];
+  context.flags = RTC_INTERSECT_CONTEXT_FLAG_COHERENT;
+  for (std::size_t offset = sector.begin; offset < sector.end; offset += packet_size) {
+    const auto size = std::min(packet_size, sector.end - offset);
+    alignas(64) int valid[packet_size];
+    RTCRayHit16 rayhit;
+    for (std::size_t i = 0; i < packet_size; ++i) {
+      valid[i] = i < size ? -1 : 0;
+      const Eigen::Vector3d rotated_direction =
+        rotation * directions[offset + std::min(i, size - 1)];
+      rayhit.ray.org_x[i] = origin.position.x;
+      rayhit.ray.org_y[i] = origin.position.y;
+      rayhit.ray.org_z[i] = origin.position.z;
+      rayhit.ray.dir_x[i] = rotated_direction[0];
+      rayhit.ray.dir_y[i] = rotated_direction[1];
+      rayhit.ray.dir_z[i] = rotated_direction[2];
+      rayhit.ray.tnear[i] = min_distance;
+      rayhit.ray.tfar[i] = max_distance;
+      rayhit.ray.time[i] = 0;
+      rayhit.ray.mask[i] = 0xFFFFFFFF;
+      rayhit.ray.id[i] = i;
+      rayhit.ray.flags[i] = 0;
+      rayhit.hit.geomID[i] = RTC_INVALID_GEOMETRY_ID;
+      rayhit.hit.instID[0][i] = RTC_INVALID_GEOMETRY_ID;
+    }
+    rtcIntersect16(valid, scene_, &context, &rayhit);
+    for (std::size_t i = 0; i < size; ++i) {
+      if (rayhit.hit.geomID[i] != RTC_INVALID_GEOMETRY_ID) {
+        double distance = rayhit.ray.tfar[i];
+        const Eigen::Vector3d vector = directions[offset + i] * distance;
+        const auto instanced = rayhit.hit.instID[0][i] != RTC_INVALID_GEOMETRY_ID;
+        const auto id = instanced ? rayhit.hit.instID[0][i] : rayhit.hit.geomID[i];
+        /**
+         * @note Embree returns the normal of an instanced surface in the frame of the instance.
+         */
+        Eigen::Vector3d normal(rayhit.hit.Ng_x[i], rayhit.hit.Ng_y[i], rayhit.hit.Ng_z[i]);
+        if (instanced) {
+          normal = instance_rotations_[id] * normal;
+        }
+        const Eigen::Vector3d direction(
+          rayhit.ray.dir_x[i], rayhit.ray.dir_y[i], rayhit.ray.dir_z[i]);
+        const Point point = {
+          static_cast<float>(vector[0]), static_cast<float>(vector[1]),
+          static_cast<float>(vector[2]),
+          static_cast<float>(std::abs(normal.normalized().dot(direction)))};
+        std::memcpy(
+          data + (sector.begin + sector.point_count) * sizeof(Point), &point, sizeof(Point));
+        ++sector.point_count;
+        if (sector.detected_id_set.insert(id).second) {
+          sector.detected_ids.emplace_back(id);
+        }
       }
-      cloud->emplace_back(p);
-      if (std::count(detected_ids.begin(), detected_ids.end(), rayhit.hit.geomID) == 0) {
-        detected_ids.emplace_back(rayhit.hit.geomID);
+    }
+  }
+}
+
+/**
+ * @note The direction table is split into contiguous sectors of azimuth, a few per thread so that
+ * a thread which got an empty part of the scene can take another one. The data of the pointcloud
+ * is sized for a hit on every ray, each sector writes its hits from the point of its first ray,
+ * and the sectors are then moved down in the order of the table to close the gaps. So the points
+ * and the detected objects are the same whatever the number of threads, and a scan cast by a
+ * single sector writes each point once and moves nothing.
+ */
+void Raycaster::castRays(
+  sensor_msgs::msg::PointCloud2 & pointcloud, const geometry_msgs::msg::Pose & origin,
+  const std::vector<Eigen::Vector3d> & directions, double max_distance, double min_distance)
+{
+  constexpr std::size_t packet_size = 16;
+  constexpr std::size_t sectors_per_thread = 4;
+  detected_objects_ = {};
+  commitScene(origin);
+  const Eigen::Matrix3d rotation = quaternion_operation::getRotationMatrix(origin.orientation);
+  const auto packets = (directions.size() + packet_size - 1) / packet_size;
+  const auto sector_count =
+    std::max<std::size_t>(1, std::min(packets, thread_pool_->size() * sectors_per_thread));
+  const auto packets_per_sector = (packets + sector_count - 1) / sector_count;
+  sectors_.resize(sector_count);
+  for (std::size_t i = 0; i < sector_count; ++i) {
+    sectors_[i].begin = std::min(directions.size(), i * packets_per_sector * packet_size);
+    sectors_[i].end = std::min(directions.size(), (i + 1) * packets_per_sector * packet_size);
+  }
+  pointcloud.data.resize(directions.size() * sizeof(Point));
+  const auto data = pointcloud.data.data();
+  thread_pool_->parallelFor(sector_count, [&](std::size_t i) {
+    castSector(sectors_[i], data, origin, rotation, directions, max_distance, min_distance);
+  });
+  std::size_t point_count = 0;
+  std::unordered_set<unsigned int> detected_id_set = {};
+  for (const auto & sector : sectors_) {
+    if (sector.begin != point_count && sector.point_count != 0) {
+      std::memmove(
+        data + point_count * sizeof(Point), data + sector.begin * sizeof(Point),
+        sector.point_count * sizeof(Point));
+    }
+    point_count += sector.point_count;
+    for (const auto & id : sector.detected_ids) {
+      const auto iter = geometry_ids_.find(id);
+      if (detected_id_set.insert(id).second && iter != geometry_ids_.end()) {
+        detected_objects_.emplace_back(iter->second);
       }
     }
   }
-  for (const auto & id : detected_ids) {
-    detected_objects_.emplace_back(geometry_ids_[id]);
+  pointcloud.data.resize(point_count * sizeof(Point));
+  if (pointcloud.fields != getPointFields()) {
+    pointcloud.fields = getPointFields();
   }
-  sensor_msgs::msg::PointCloud2 pointcloud_msg;
-  pcl::toROSMsg(*cloud, pointcloud_msg);
-  rtcReleaseScene(scene_);
-  pointcloud_msg.header.frame_id = frame_id;
-  pointcloud_msg.header.stamp = stamp;
-  return pointcloud_msg;
+  pointcloud.height = 1;
+  pointcloud.width = point_count;
+  pointcloud.is_bigendian = false;
+  pointcloud.point_step = sizeof(Point);
+  pointcloud.row_step = point_count * sizeof(Point);
+  pointcloud.is_dense = true;
 }
 }  // namespace simple_sensor_simulator
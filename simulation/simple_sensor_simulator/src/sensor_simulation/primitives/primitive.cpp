@@ -57,25 +57,40 @@ std::vector<Vertex> Primitive::getVertex() const { return transform(); }
 
 std::vector<Triangle> Primitive::getTriangles() const { return triangles_; }
 
-unsigned int Primitive::addToScene(RTCDevice device, RTCScene scene)
+std::vector<Vertex> Primitive::getLocalVertex() const { return vertices_; }
+
+namespace
+{
+unsigned int attachMesh(
+  RTCDevice device, RTCScene scene, const std::vector<Vertex> & source_vertices,
+  const std::vector<Triangle> & source_triangles)
 {
   RTCGeometry mesh = rtcNewGeometry(device, RTC_GEOMETRY_TYPE_TRIANGLE);
-  const auto transformed_vertices = transform();
   Vertex * vertices = static_cast<Vertex *>(rtcSetNewGeometryBuffer(
-    mesh, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3, sizeof(Vertex),
-    transformed_vertices.size()));
-  for (size_t i = 0; i < transformed_vertices.size(); i++) {
-    vertices[i] = transformed_vertices[i];
+    mesh, RTC_BUFFER_TYPE_VERTEX, 0, RTC_FORMAT_FLOAT3, sizeof(Vertex), source_vertices.size()));
+  for (size_t i = 0; i < source_vertices.size(); i++) {
+    vertices[i] = source_vertices[i];
   }
   Triangle * triangles = static_cast<Triangle *>(rtcSetNewGeometryBuffer(
-    mesh, RTC_BUFFER_TYPE_INDEX, 0, RTC_FORMAT_UINT3, sizeof(Triangle), triangles_.size()));
-  for (size_t i = 0; i < triangles_.size(); i++) {
-    triangles[i] = triangles_[i];
+    mesh, RTC_BUFFER_TYPE_INDEX, 0, RTC_FORMAT_UINT3, sizeof(Triangle), source_triangles.size()));
+  for (size_t i = 0; i < source_triangles.size(); i++) {
+    triangles[i] = source_triangles[i];
   }
   rtcCommitGeometry(mesh);
   unsigned int geometry_id = rtcAttachGeometry(scene, mesh);
   rtcReleaseGeometry(mesh);
   return geometry_id;
 }
+}  // namespace
+
+unsigned int Primitive::addToScene(RTCDevice device, RTCScene scene)
+{
+  return attachMesh(device, scene, transform(), triangles_);
+}
+
+unsigned int Primitive::addToLocalScene(RTCDevice device, RTCScene scene) const
+{
+  return attachMesh(device, scene, vertices_, triangles_);
+}
 }  // namespace primitives
 }  // namespace simple_sensor_simulator
@@ -0,0 +1,192 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <lanelet2_core/LaneletMap.h>
+#include <lanelet2_io/Io.h>
+
+#include <lanelet2_extension_psim/projection/mgrs_projector.hpp>
+#include <simple_sensor_simulator/exception.hpp>
+#include <simple_sensor_simulator/sensor_simulation/primitives/static_map.hpp>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace simple_sensor_simulator
+{
+namespace primitives
+{
+namespace
+{
+/**
+ * @brief Adds the vertices of the points of a map, once per point even if the point is shared by
+ * several lanelets or line strings.
+ */
+class VertexTable
+{
+public:
+  explicit VertexTable(std::vector<Vertex> & vertices) : vertices_(vertices) {}
+
+  auto operator()(const lanelet::ConstPoint3d & point) -> unsigned int
+  {
+    const auto iter = indices_.find(point.id());
+    if (iter != indices_.end()) {
+      return iter->second;
+    }
+    return indices_.emplace(point.id(), add(point.basicPoint())).first->second;
+  }
+
+  auto add(const lanelet::BasicPoint3d & point) -> unsigned int
+  {
+    Vertex vertex;
+    vertex.x = point.x();
+    vertex.y = point.y();
+    vertex.z = point.z();
+    vertices_.emplace_back(vertex);
+    return vertices_.size() - 1;
+  }
+
+private:
+  std::vector<Vertex> & vertices_;
+
+  std::unordered_map<lanelet::Id, unsigned int> indices_;
+};
+
+auto makeTriangle(unsigned int v0, unsigned int v1, unsigned int v2)
+{
+  Triangle triangle;
+  triangle.v0 = v0;
+  triangle.v1 = v1;
+  triangle.v2 = v2;
+  return triangle;
+}
+
+/**
+ * @brief Triangulates the strip between the left and right bounds of a lanelet.
+ * @note Walks both bounds at once and advances along the bound whose next diagonal is shorter, so
+ * that the triangles stay between the bounds even if they have different numbers of points.
+ */
+void addRoadSurface(
+  const lanelet::ConstLanelet & lanelet, VertexTable & vertex_table,
+  std::vector<Triangle> & triangles)
+{
+  const auto left = lanelet.leftBound3d();
+  const auto right = lanelet.rightBound3d();
+  if (left.empty() || right.empty() || left.size() + right.size() < 3) {
+    return;
+  }
+  std::size_t i = 0;
+  std::size_t j = 0;
+  while (i + 1 < left.size() || j + 1 < right.size()) {
+    const bool advance_left =
+      j + 1 == right.size() ||
+      (i + 1 < left.size() &&
+       (left[i + 1].basicPoint() - right[j].basicPoint()).squaredNorm() <
+         (right[j + 1].basicPoint() - left[i].basicPoint()).squaredNorm());
+    if (advance_left) {
+      triangles.emplace_back(
+        makeTriangle(vertex_table(left[i]), vertex_table(left[i + 1]), vertex_table(right[j])));
+      ++i;
+    } else {
+      triangles.emplace_back(
+        makeTriangle(vertex_table(left[i]), vertex_table(right[j + 1]), vertex_table(right[j])));
+      ++j;
+    }
+  }
+}
+
+/**
+ * @brief Extrudes a line string upward into a wall of the height.
+ */
+void addBarrier(
+  const lanelet::ConstLineString3d & line_string, double height, VertexTable & vertex_table,
+  std::vector<Triangle> & triangles)
+{
+  std::vector<unsigned int> top;
+  for (const auto & point : line_string) {
+    top.emplace_back(
+      vertex_table.add(point.basicPoint() + lanelet::BasicPoint3d(0, 0, height)));
+  }
+  for (std::size_t i = 0; i + 1 < line_string.size(); ++i) {
+    const auto bottom0 = vertex_table(line_string[i]);
+    const auto bottom1 = vertex_table(line_string[i + 1]);
+    triangles.emplace_back(makeTriangle(bottom0, bottom1, top[i]));
+    triangles.emplace_back(makeTriangle(bottom1, top[i + 1], top[i]));
+  }
+}
+}  // namespace
+
+StaticMap::StaticMap(const lanelet::LaneletMap & lanelet_map)
+: Primitive("StaticMap", geometry_msgs::msg::Pose())
+{
+  addLaneletMap(lanelet_map);
+}
+
+StaticMap::StaticMap(const std::string & lanelet2_map_path)
+: Primitive("StaticMap", geometry_msgs::msg::Pose())
+{
+  lanelet::projection::MGRSProjector projector;
+  lanelet::ErrorMessages errors;
+  const auto lanelet_map = lanelet::load(lanelet2_map_path, projector, &errors);
+  if (!errors.empty()) {
+    std::stringstream ss;
+    ss << "failed to load lanelet map " << lanelet2_map_path;
+    for (const auto & error : errors) {
+      ss << "\n" << error;
+    }
+    throw SimulationRuntimeError(ss.str().c_str());
+  }
+  addLaneletMap(*lanelet_map);
+}
+
+auto StaticMap::getBarrierHeight(const std::string & type, const std::string & subtype) -> double
+{
+  if (type == "curbstone") {
+    return subtype == "low" ? 0.1 : 0.2;
+  } else if (type == "road_border") {
+    return 0.15;
+  } else if (type == "guard_rail") {
+    return 0.8;
+  } else if (type == "fence") {
+    return 1.5;
+  } else if (type == "wall") {
+    return 3.0;
+  } else {
+    return 0;
+  }
+}
+
+/**
+ * @note Crosswalks are skipped because they lie on the road surface of the lanelets they cross.
+ */
+void StaticMap::addLaneletMap(const lanelet::LaneletMap & lanelet_map)
+{
+  VertexTable vertex_table(vertices_);
+  for (const auto & lanelet : lanelet_map.laneletLayer) {
+    const std::string subtype = lanelet.attributeOr(lanelet::AttributeName::Subtype, "");
+    if (subtype != "crosswalk") {
+      addRoadSurface(lanelet, vertex_table, triangles_);
+    }
+  }
+  for (const auto & line_string : lanelet_map.lineStringLayer) {
+    const auto height = getBarrierHeight(
+      line_string.attributeOr(lanelet::AttributeName::Type, ""),
+      line_string.attributeOr(lanelet::AttributeName::Subtype, ""));
+    if (height > 0) {
+      addBarrier(line_string, height, vertex_table, triangles_);
+    }
+  }
+}
+}  // namespace primitives
+}  // namespace simple_sensor_simulator
@@ -12,29 +12,167 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <exception>
 #include <memory>
+#include <mutex>
 #include <simple_sensor_simulator/sensor_simulation/sensor_simulation.hpp>
 #include <string>
 #include <vector>
 
 namespace simple_sensor_simulator
 {
+void SensorSimulation::loadStaticMap(const std::string & lanelet2_map_path)
+{
+  if (lanelet2_map_path != lanelet2_map_path_) {
+    static_map_ = lanelet2_map_path.empty()
+                    ? nullptr
+                    : std::make_shared<const primitives::StaticMap>(lanelet2_map_path);
+    lanelet2_map_path_ = lanelet2_map_path;
+  }
+}
+
+SensorSimulation::SensorSimulation(
+  std::size_t raycast_threads, bool use_loaned_messages, std::size_t sensor_update_threads,
+  bool async_sensor_update)
+: raycast_threads_(raycast_threads),
+  use_loaned_messages_(use_loaned_messages),
+  async_sensor_update_(async_sensor_update),
+  sensor_update_pool_(sensor_update_threads)
+{
+  if (async_sensor_update_) {
+    sensor_frame_thread_ = std::thread([this]() { runSensorFrames(); });
+  }
+}
+
+SensorSimulation::~SensorSimulation()
+{
+  if (sensor_frame_thread_.joinable()) {
+    waitForSensorFrame();
+    {
+      std::lock_guard<std::mutex> lock(sensor_frame_mutex_);
+      stopping_ = true;
+    }
+    sensor_frame_condition_.notify_all();
+    sensor_frame_thread_.join();
+  }
+}
+
 void SensorSimulation::updateSensorFrame(
   double current_time, const rclcpp::Time & current_ros_time,
   const std::vector<traffic_simulator_msgs::EntityStatus> & status)
 {
+  std::lock_guard<std::mutex> update_lock(update_mutex_);
+  waitForSensorFrame();
+  if (sensor_frame_error_) {
+    const auto error = sensor_frame_error_;
+    sensor_frame_error_ = nullptr;
+    std::rethrow_exception(error);
+  }
+  addAttachedSensors();
+  if (async_sensor_update_) {
+    sensor_frame_status_ = status;
+    {
+      std::lock_guard<std::mutex> lock(sensor_frame_mutex_);
+      sensor_frame_time_ = current_time;
+      sensor_frame_ros_time_ = current_ros_time;
+      sensor_frame_pending_ = true;
+    }
+    sensor_frame_condition_.notify_all();
+  } else {
+    updateSensors(current_time, current_ros_time, status);
+  }
+}
+
+void SensorSimulation::waitForSensorFrame()
+{
+  std::unique_lock<std::mutex> lock(sensor_frame_mutex_);
+  sensor_frame_condition_.wait(lock, [this]() { return !sensor_frame_pending_; });
+}
+
+void SensorSimulation::addAttachedSensors()
+{
+  std::lock_guard<std::mutex> lock(attach_mutex_);
+  for (auto & sensor : attached_lidar_sensors_) {
+    lidar_sensors_.push_back(std::move(sensor));
+  }
+  attached_lidar_sensors_.clear();
+  for (auto & sensor : attached_detection_sensors_) {
+    detection_sensors_.push_back(std::move(sensor));
+  }
+  attached_detection_sensors_.clear();
+}
+
+/**
+ * @note Runs on sensor_frame_thread_ for the lifetime of the simulation, so that a frame started in
+ * asynchronous mode does not pay for creating a thread.
+ */
+void SensorSimulation::runSensorFrames()
+{
+  std::unique_lock<std::mutex> lock(sensor_frame_mutex_);
+  while (true) {
+    sensor_frame_condition_.wait(lock, [this]() { return stopping_ || sensor_frame_pending_; });
+    if (stopping_) {
+      return;
+    }
+    const auto current_time = sensor_frame_time_;
+    const auto current_ros_time = sensor_frame_ros_time_;
+    lock.unlock();
+    std::exception_ptr error;
+    try {
+      updateSensors(current_time, current_ros_time, sensor_frame_status_);
+    } catch (...) {
+      error = std::current_exception();
+    }
+    lock.lock();
+    sensor_frame_error_ = error;
+    sensor_frame_pending_ = false;
+    sensor_frame_condition_.notify_all();
+  }
+}
+
+void SensorSimulation::updateSensors(
+  double current_time, const rclcpp::Time & current_ros_time,
+  const std::vector<traffic_simulator_msgs::EntityStatus> & status)
+{
+  sensor_update_pool_.parallelFor(lidar_sensors_.size(), [&](std::size_t i) {
+    lidar_sensors_[i]->update(current_time, status, current_ros_time);
+  });
+  /**
+   * @note Merged in the order the lidar sensors were attached, as if they were updated one by one.
+   */
   std::vector<std::string> lidar_detected_objects = {};
-  for (auto & sensor : lidar_sensors_) {
-    sensor->update(current_time, status, current_ros_time);
-    const auto objects = sensor->getDetectedObjects();
-    for (const auto & obj : objects) {
+  for (const auto & sensor : lidar_sensors_) {
+    for (const auto & obj : sensor->getDetectedObjects()) {
       if (std::count(lidar_detected_objects.begin(), lidar_detected_objects.end(), obj) == 0) {
         lidar_detected_objects.push_back(obj);
       }
     }
   }
-  for (auto & sensor : detection_sensors_) {
-    sensor->update(current_time, status, current_ros_time, lidar_detected_objects);
-  }
+  /**
+   * @note A lidar which did not scan in this frame still holds the entities of its last scan, so
+   * its scene is moved to this frame before a detection sensor tests occlusion in it.
+   */
+  sensor_update_pool_.parallelFor(lidar_sensors_.size(), [&](std::size_t i) {
+    const auto & lidar_sensor = lidar_sensors_[i];
+    if (
+      lidar_sensor->getLastUpdateStamp() != current_time &&
+      std::any_of(
+        detection_sensors_.begin(), detection_sensors_.end(), [&](const auto & sensor) {
+          return sensor->filterByOcclusion() && sensor->getEntity() == lidar_sensor->getEntity();
+        })) {
+      lidar_sensor->updateScene(status);
+    }
+  });
+  entity_index_.build(status);
+  sensor_update_pool_.parallelFor(detection_sensors_.size(), [&](std::size_t i) {
+    const auto & sensor = detection_sensors_[i];
+    const auto lidar_sensor = std::find_if(
+      lidar_sensors_.begin(), lidar_sensors_.end(),
+      [&](const auto & lidar) { return lidar->getEntity() == sensor->getEntity(); });
+    sensor->update(
+      current_time, status, current_ros_time, lidar_detected_objects, entity_index_,
+      lidar_sensor == lidar_sensors_.end() ? nullptr : &(*lidar_sensor)->getRaycaster());
+  });
 }
 }  // namespace simple_sensor_simulator
@@ -0,0 +1,106 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <simple_sensor_simulator/sensor_simulation/spatial_index.hpp>
+#include <string>
+#include <vector>
+
+namespace simple_sensor_simulator
+{
+namespace
+{
+std::uint64_t makeKey(std::int64_t x, std::int64_t y)
+{
+  return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(x)) << 32) |
+         static_cast<std::uint32_t>(y);
+}
+
+bool isWithin(
+  const traffic_simulator_msgs::EntityStatus & status, const geometry_msgs::Point & point,
+  double range)
+{
+  const auto x = status.pose().position().x() - point.x();
+  const auto y = status.pose().position().y() - point.y();
+  const auto z = status.pose().position().z() - point.z();
+  return x * x + y * y + z * z <= range * range;
+}
+}  // namespace
+
+SpatialIndex::SpatialIndex(double cell_size) : cell_size_(cell_size) {}
+
+auto SpatialIndex::getCell(double coordinate) const -> std::int64_t
+{
+  return static_cast<std::int64_t>(std::floor(coordinate / cell_size_));
+}
+
+void SpatialIndex::build(const std::vector<traffic_simulator_msgs::EntityStatus> & status)
+{
+  status_ = &status;
+  names_.clear();
+  cells_.clear();
+  for (std::size_t i = 0; i < status.size(); ++i) {
+    names_.emplace(status[i].name(), i);
+    cells_.emplace_back(
+      makeKey(getCell(status[i].pose().position().x()), getCell(status[i].pose().position().y())),
+      i);
+  }
+  std::sort(cells_.begin(), cells_.end());
+}
+
+auto SpatialIndex::find(const std::string & name) const -> boost::optional<std::size_t>
+{
+  const auto iter = names_.find(name);
+  if (iter == names_.end()) {
+    return boost::none;
+  }
+  return iter->second;
+}
+
+/**
+ * @note If the range overlaps more cells than there are entities, visiting the entities is
+ * cheaper than visiting the cells.
+ */
+void SpatialIndex::findWithin(
+  const geometry_msgs::Point & point, double range, std::vector<std::size_t> & indices) const
+{
+  indices.clear();
+  if (!status_ || range < 0) {
+    return;
+  }
+  const auto cells_per_side = 2 * range / cell_size_ + 2;
+  if (cells_per_side * cells_per_side > cells_.size()) {
+    for (std::size_t i = 0; i < status_->size(); ++i) {
+      if (isWithin((*status_)[i], point, range)) {
+        indices.emplace_back(i);
+      }
+    }
+    return;
+  }
+  for (auto x = getCell(point.x() - range); x <= getCell(point.x() + range); ++x) {
+    for (auto y = getCell(point.y() - range); y <= getCell(point.y() + range); ++y) {
+      const auto key = makeKey(x, y);
+      for (auto iter = std::lower_bound(
+             cells_.begin(), cells_.end(), std::make_pair(key, std::size_t(0)));
+           iter != cells_.end() && iter->first == key; ++iter) {
+        if (isWithin((*status_)[iter->second], point, range)) {
+          indices.emplace_back(iter->second);
+        }
+      }
+    }
+  }
+  std::sort(indices.begin(), indices.end());
+}
+}  // namespace simple_sensor_simulator
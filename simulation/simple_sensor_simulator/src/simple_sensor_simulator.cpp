@@ -14,9 +14,11 @@
 
 #include <quaternion_operation/quaternion_operation.h>
 
+#include <algorithm>
 #include <geometry_msgs/msg/pose_stamped.hpp>
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <rclcpp/rclcpp.hpp>
 #include <rclcpp_components/register_node_macro.hpp>
 #include <simple_sensor_simulator/exception.hpp>
@@ -30,9 +32,15 @@ namespace simple_sensor_simulator
 {
 ScenarioSimulator::ScenarioSimulator(const rclcpp::NodeOptions & options)
 : Node("simple_sensor_simulator", options),
-  sensor_sim_(),
+  sensor_sim_(
+    std::max<int>(declare_parameter<int>("raycast_threads", 1), 1),
+    declare_parameter<bool>("use_loaned_messages", false),
+    std::max<int>(declare_parameter<int>("sensor_update_threads", 1), 1),
+    declare_parameter<bool>("async_sensor_update", false)),
   server_(
-    simulation_interface::protocol, simulation_interface::HostName::ANY,
+    simulation_interface::toTransportProtocol(
+      declare_parameter<std::string>("transport_protocol", "tcp")),
+    simulation_interface::HostName::ANY,
     std::bind(&ScenarioSimulator::initialize, this, std::placeholders::_1, std::placeholders::_2),
     std::bind(&ScenarioSimulator::updateFrame, this, std::placeholders::_1, std::placeholders::_2),
     std::bind(
@@ -55,7 +63,8 @@ ScenarioSimulator::ScenarioSimulator(const rclcpp::NodeOptions & options)
       &ScenarioSimulator::attachDetectionSensor, this, std::placeholders::_1,
       std::placeholders::_2),
     std::bind(
-      &ScenarioSimulator::updateTrafficLights, this, std::placeholders::_1, std::placeholders::_2))
+      &ScenarioSimulator::updateTrafficLights, this, std::placeholders::_1, std::placeholders::_2),
+    simulation_interface::ServerMode::EVENT_DRIVEN)
 {
 }
 
@@ -74,6 +83,12 @@ void ScenarioSimulator::initialize(
   ego_vehicles_ = {};
   vehicles_ = {};
   pedestrians_ = {};
+  try {
+    sensor_sim_.loadStaticMap(req.lanelet2_map_path());
+  } catch (const SimulationRuntimeError & error) {
+    res.mutable_result()->set_success(false);
+    res.mutable_result()->set_description(error.what());
+  }
 }
 
 void ScenarioSimulator::updateFrame(
@@ -98,13 +113,16 @@ void ScenarioSimulator::updateEntityStatus(
   const simulation_api_schema::UpdateEntityStatusRequest & req,
   simulation_api_schema::UpdateEntityStatusResponse & res)
 {
-  entity_status_ = {};
-  for (const auto proto : req.status()) {
-    entity_status_.emplace_back(proto);
-  }
   res = simulation_api_schema::UpdateEntityStatusResponse();
+  // NOTE: A delta that does not apply leaves the last entity status as it is. It is not an error,
+  // the sequence number in the response tells the client to send a keyframe.
+  if (entity_status_decoder_.decode(req)) {
+    res.mutable_result()->set_description("");
+  } else {
+    res.mutable_result()->set_description("entity status delta was not applied, keyframe required");
+  }
   res.mutable_result()->set_success(true);
-  res.mutable_result()->set_description("");
+  res.set_status_sequence(entity_status_decoder_.sequence());
 }
 
 void ScenarioSimulator::spawnVehicleEntity(
@@ -213,8 +231,11 @@ void ScenarioSimulator::updateSensorFrame(
   }
   builtin_interfaces::msg::Time t;
   simulation_interface::toMsg(req.current_ros_time(), t);
-  current_ros_time_ = t;
-  sensor_sim_.updateSensorFrame(current_time_, current_ros_time_, entity_status_);
+  {
+    std::lock_guard<std::mutex> lock(sensor_mutex_);
+    current_ros_time_ = t;
+  }
+  sensor_sim_.updateSensorFrame(current_time_, t, entity_status_decoder_.getStatus());
   res = simulation_api_schema::UpdateSensorFrameResponse();
   res.mutable_result()->set_success(true);
 }
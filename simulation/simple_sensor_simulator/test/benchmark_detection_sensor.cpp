@@ -0,0 +1,150 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <simple_sensor_simulator/sensor_simulation/detection_sensor/detection_sensor.hpp>
+#include <simple_sensor_simulator/sensor_simulation/lidar/raycaster.hpp>
+#include <simple_sensor_simulator/sensor_simulation/spatial_index.hpp>
+#include <string>
+#include <vector>
+
+namespace
+{
+class Sensor : public simple_sensor_simulator::DetectionSensorBase
+{
+public:
+  explicit Sensor(const simulation_api_schema::DetectionSensorConfiguration & configuration)
+  : DetectionSensorBase(0, configuration)
+  {
+  }
+
+  using DetectionSensorBase::getDetectedObjects;
+
+  void update(
+    const double, const std::vector<traffic_simulator_msgs::EntityStatus> &, const rclcpp::Time &,
+    const std::vector<std::string> &, const simple_sensor_simulator::SpatialIndex &,
+    const simple_sensor_simulator::Raycaster *) override
+  {
+  }
+};
+
+/**
+ * @note The ego is at the origin and the other entities are spread over a square of 2 km, like
+ * the traffic of a whole town.
+ */
+std::vector<traffic_simulator_msgs::EntityStatus> makeStatus(std::size_t size)
+{
+  std::vector<traffic_simulator_msgs::EntityStatus> status(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    status[i].set_name(i == 0 ? "ego" : "npc" + std::to_string(i));
+    status[i].mutable_type()->set_type(
+      i == 0 ? traffic_simulator_msgs::EntityType::EGO
+             : traffic_simulator_msgs::EntityType::VEHICLE);
+    status[i].mutable_pose()->mutable_position()->set_x(
+      i == 0 ? 0 : std::fmod(i * 617.0, 2000.0) - 1000);
+    status[i].mutable_pose()->mutable_position()->set_y(
+      i == 0 ? 0 : std::fmod(i * 367.0, 2000.0) - 1000);
+    status[i].mutable_pose()->mutable_orientation()->set_w(1);
+    status[i].mutable_bounding_box()->mutable_center()->set_z(0.75);
+    status[i].mutable_bounding_box()->mutable_dimensions()->set_x(4.0);
+    status[i].mutable_bounding_box()->mutable_dimensions()->set_y(1.8);
+    status[i].mutable_bounding_box()->mutable_dimensions()->set_z(1.5);
+  }
+  return status;
+}
+
+simulation_api_schema::DetectionSensorConfiguration makeConfiguration(bool filter_by_occlusion)
+{
+  simulation_api_schema::DetectionSensorConfiguration configuration;
+  configuration.set_entity("ego");
+  configuration.set_range(300);
+  configuration.set_filter_by_range(true);
+  configuration.set_horizontal_field_of_view(M_PI);
+  configuration.set_filter_by_occlusion(filter_by_occlusion);
+  return configuration;
+}
+}  // namespace
+
+/**
+ * @brief Entities within the range of a sensor out of state.range(0), found by a linear scan as
+ * before the spatial index.
+ */
+static void FindWithinLinear(benchmark::State & state)
+{
+  const auto status = makeStatus(state.range(0));
+  for (auto _ : state) {
+    std::vector<std::string> names;
+    for (const auto & s : status) {
+      const auto distance = std::hypot(s.pose().position().x(), s.pose().position().y());
+      if (s.name() != "ego" && distance <= 300) {
+        names.emplace_back(s.name());
+      }
+    }
+    benchmark::DoNotOptimize(names);
+  }
+}
+BENCHMARK(FindWithinLinear)->Arg(100)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief Same as FindWithinLinear with the spatial index, including building it every frame.
+ */
+static void FindWithinIndex(benchmark::State & state)
+{
+  const auto status = makeStatus(state.range(0));
+  simple_sensor_simulator::SpatialIndex index;
+  std::vector<std::size_t> indices;
+  for (auto _ : state) {
+    index.build(status);
+    index.findWithin(status[0].pose().position(), 300, indices);
+    benchmark::DoNotOptimize(indices);
+  }
+}
+BENCHMARK(FindWithinIndex)->Arg(100)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief Culling of state.range(0) entities by range and field of view, and by occlusion in the
+ * scene of a lidar scan if state.range(1) is not 0.
+ */
+static void GetDetectedObjects(benchmark::State & state)
+{
+  const auto status = makeStatus(state.range(0));
+  simple_sensor_simulator::SpatialIndex index;
+  index.build(status);
+  simple_sensor_simulator::Raycaster raycaster;
+  for (std::size_t i = 1; i < status.size(); ++i) {
+    geometry_msgs::msg::Pose pose;
+    pose.position.x = status[i].pose().position().x();
+    pose.position.y = status[i].pose().position().y();
+    pose.position.z = 0.75;
+    raycaster.addPrimitive<simple_sensor_simulator::primitives::Box>(
+      status[i].name(), 4.0, 1.8, 1.5, pose);
+  }
+  geometry_msgs::msg::Pose origin;
+  origin.position.z = 1.5;
+  raycaster.raycast("base_link", rclcpp::Time(0, 0, RCL_ROS_TIME), origin, M_PI / 180.0, {0.0});
+  const Sensor sensor(makeConfiguration(state.range(1)));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(sensor.getDetectedObjects(status, index, {}, &raycaster));
+  }
+}
+BENCHMARK(GetDetectedObjects)
+  ->Args({1000, 0})
+  ->Args({1000, 1})
+  ->Args({10000, 0})
+  ->Args({10000, 1})
+  ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,239 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+#include <pcl_conversions/pcl_conversions.h>
+
+#include <ament_index_cpp/get_package_share_directory.hpp>
+#include <cmath>
+#include <memory>
+#include <simple_sensor_simulator/sensor_simulation/lidar/noise_model.hpp>
+#include <simple_sensor_simulator/sensor_simulation/lidar/raycaster.hpp>
+#include <simple_sensor_simulator/sensor_simulation/primitives/static_map.hpp>
+#include <string>
+#include <vector>
+
+namespace
+{
+std::vector<double> makeVerticalAngles(std::size_t channels, double lower, double upper)
+{
+  std::vector<double> vertical_angles;
+  for (std::size_t i = 0; i < channels; ++i) {
+    vertical_angles.emplace_back(lower + (upper - lower) * i / (channels - 1));
+  }
+  return vertical_angles;
+}
+
+/**
+ * @note Vehicles are placed on rings around the sensor and move a little every scan, like the
+ * entities of a scenario between two lidar frames.
+ */
+void addVehicles(
+  simple_sensor_simulator::Raycaster & raycaster, std::size_t size, double time,
+  const geometry_msgs::msg::Point & center = geometry_msgs::msg::Point())
+{
+  for (std::size_t i = 0; i < size; ++i) {
+    const double angle = 2 * M_PI * i / size;
+    const double radius = 10 + 5 * (i % 6);
+    geometry_msgs::msg::Pose pose;
+    pose.position.x = center.x + radius * std::cos(angle) + time;
+    pose.position.y = center.y + radius * std::sin(angle);
+    pose.position.z = center.z + 1.0;
+    raycaster.addPrimitive<simple_sensor_simulator::primitives::Box>(
+      "npc" + std::to_string(i), 4.0, 1.8, 1.5, pose);
+  }
+}
+
+const std::shared_ptr<const simple_sensor_simulator::primitives::StaticMap> & getSampleMap()
+{
+  static const auto static_map =
+    std::make_shared<const simple_sensor_simulator::primitives::StaticMap>(
+      ament_index_cpp::get_package_share_directory("kashiwanoha_map") + "/map/lanelet2_map.osm");
+  return static_map;
+}
+
+void raycast(
+  benchmark::State & state, const std::vector<double> & vertical_angles,
+  const std::shared_ptr<const simple_sensor_simulator::primitives::StaticMap> & static_map =
+    nullptr,
+  std::size_t thread_count = 1, bool reuse_message = true,
+  simple_sensor_simulator::NoiseModel * noise_model = nullptr)
+{
+  constexpr double horizontal_resolution = 0.2 * M_PI / 180.0;
+  simple_sensor_simulator::Raycaster raycaster;
+  raycaster.setThreadCount(thread_count);
+  const rclcpp::Time stamp(0, 0, RCL_ROS_TIME);
+  geometry_msgs::msg::Pose origin;
+  if (static_map) {
+    /**
+     * @note Above a point on the boundary of the first lanelet, so that the road is in sight.
+     */
+    const auto vertex = static_map->getVertex().front();
+    origin.position.x = vertex.x;
+    origin.position.y = vertex.y;
+    origin.position.z = vertex.z;
+    raycaster.setStaticMap(*static_map);
+  }
+  origin.position.z = origin.position.z + 1.5;
+  const auto rays_per_scan =
+    vertical_angles.size() * static_cast<std::size_t>(2 * M_PI / horizontal_resolution);
+  std::size_t rays = 0;
+  std::size_t points = 0;
+  std::size_t bytes = 0;
+  double time = 0;
+  sensor_msgs::msg::PointCloud2 pointcloud;
+  for (auto _ : state) {
+    addVehicles(raycaster, state.range(0), time, origin.position);
+    time = time + 0.01;
+    if (!reuse_message) {
+      pointcloud = sensor_msgs::msg::PointCloud2();
+    }
+    raycaster.raycast(
+      pointcloud, "base_link", stamp, origin, horizontal_resolution, vertical_angles);
+    if (noise_model) {
+      noise_model->apply(pointcloud);
+    }
+    benchmark::DoNotOptimize(pointcloud);
+    rays = rays + rays_per_scan;
+    points = points + pointcloud.width;
+    bytes = bytes + pointcloud.data.size();
+  }
+  state.counters["points_per_scan"] =
+    benchmark::Counter(static_cast<double>(points), benchmark::Counter::kAvgIterations);
+  state.counters["bytes_per_scan"] =
+    benchmark::Counter(static_cast<double>(bytes), benchmark::Counter::kAvgIterations);
+  state.counters["rays_per_second"] =
+    benchmark::Counter(static_cast<double>(rays), benchmark::Counter::kIsRate);
+}
+}  // namespace
+
+static void RaycastVLP16(benchmark::State & state)
+{
+  raycast(state, makeVerticalAngles(16, -15.0 * M_PI / 180.0, 15.0 * M_PI / 180.0));
+}
+BENCHMARK(RaycastVLP16)->Arg(10)->Arg(100)->Unit(benchmark::kMillisecond);
+
+static void Raycast128Channels(benchmark::State & state)
+{
+  raycast(state, makeVerticalAngles(128, -25.0 * M_PI / 180.0, 15.0 * M_PI / 180.0));
+}
+BENCHMARK(Raycast128Channels)->Arg(10)->Arg(100)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Scans of the sample map with its road surface in the scene.
+ */
+static void RaycastVLP16OnSampleMap(benchmark::State & state)
+{
+  raycast(state, makeVerticalAngles(16, -15.0 * M_PI / 180.0, 15.0 * M_PI / 180.0), getSampleMap());
+}
+BENCHMARK(RaycastVLP16OnSampleMap)->Arg(10)->Arg(100)->Unit(benchmark::kMillisecond);
+
+static void Raycast128ChannelsOnSampleMap(benchmark::State & state)
+{
+  raycast(
+    state, makeVerticalAngles(128, -25.0 * M_PI / 180.0, 15.0 * M_PI / 180.0), getSampleMap());
+}
+BENCHMARK(Raycast128ChannelsOnSampleMap)->Arg(10)->Arg(100)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Time to build the BVH of the static map of the sample map, paid once per lidar sensor.
+ */
+static void BuildSampleMap(benchmark::State & state)
+{
+  const auto & static_map = getSampleMap();
+  for (auto _ : state) {
+    simple_sensor_simulator::Raycaster raycaster;
+    raycaster.setStaticMap(*static_map);
+    benchmark::DoNotOptimize(raycaster);
+  }
+  state.counters["triangles"] = static_map->getTriangles().size();
+}
+BENCHMARK(BuildSampleMap)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Scans of 128 channels with state.range(0) vehicles around, cast by state.range(1) threads.
+ */
+static void Raycast128ChannelsScaling(benchmark::State & state)
+{
+  raycast(
+    state, makeVerticalAngles(128, -25.0 * M_PI / 180.0, 15.0 * M_PI / 180.0), getSampleMap(),
+    state.range(1));
+}
+BENCHMARK(Raycast128ChannelsScaling)
+  ->Args({100, 1})
+  ->Args({100, 2})
+  ->Args({100, 4})
+  ->Args({100, 8})
+  ->Unit(benchmark::kMillisecond)
+  ->UseRealTime();
+
+/**
+ * @brief Scans of 128 channels with state.range(0) vehicles around, into a new message every scan
+ * if state.range(1) is 0 and into the same message if it is 1.
+ */
+static void Raycast128ChannelsMessageReuse(benchmark::State & state)
+{
+  raycast(
+    state, makeVerticalAngles(128, -25.0 * M_PI / 180.0, 15.0 * M_PI / 180.0), getSampleMap(), 1,
+    state.range(1));
+}
+BENCHMARK(Raycast128ChannelsMessageReuse)
+  ->Args({100, 0})
+  ->Args({100, 1})
+  ->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Scans of 128 channels with state.range(0) vehicles around, with a noise model applied to
+ * each scan if state.range(1) is 1. The difference with the scans without it is the overhead of
+ * the noise model.
+ */
+static void Raycast128ChannelsNoise(benchmark::State & state)
+{
+  simulation_api_schema::LidarConfiguration configuration;
+  configuration.set_range_noise_standard_deviation(0.03);
+  configuration.set_dropout_probability(0.1);
+  configuration.set_dropout_range(100);
+  configuration.set_intensity_scale(255);
+  simple_sensor_simulator::NoiseModel noise_model(configuration);
+  raycast(
+    state, makeVerticalAngles(128, -25.0 * M_PI / 180.0, 15.0 * M_PI / 180.0), getSampleMap(), 1,
+    true, state.range(1) ? &noise_model : nullptr);
+}
+BENCHMARK(Raycast128ChannelsNoise)->Args({100, 0})->Args({100, 1})->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Assembly of a scan of state.range(0) points through a pcl::PointCloud<pcl::PointXYZI> and
+ * pcl::toROSMsg, as the raycaster did before it wrote its hits into the message. Its time and its
+ * bytes copied are saved on every scan now.
+ */
+static void AssembleThroughPcl(benchmark::State & state)
+{
+  pcl::PointCloud<pcl::PointXYZI>::VectorType hits(state.range(0));
+  std::size_t bytes = 0;
+  for (auto _ : state) {
+    pcl::PointCloud<pcl::PointXYZI> cloud;
+    cloud.points.insert(cloud.points.end(), hits.begin(), hits.end());
+    cloud.width = cloud.points.size();
+    cloud.height = 1;
+    sensor_msgs::msg::PointCloud2 pointcloud;
+    pcl::toROSMsg(cloud, pointcloud);
+    benchmark::DoNotOptimize(pointcloud);
+    bytes = bytes + cloud.points.size() * sizeof(pcl::PointXYZI) + pointcloud.data.size();
+  }
+  state.counters["bytes_copied_per_scan"] =
+    benchmark::Counter(static_cast<double>(bytes), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(AssembleThroughPcl)->Arg(30000)->Arg(200000)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
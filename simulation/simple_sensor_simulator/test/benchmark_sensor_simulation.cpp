@@ -0,0 +1,122 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <rclcpp/rclcpp.hpp>
+#include <simple_sensor_simulator/sensor_simulation/sensor_simulation.hpp>
+#include <string>
+#include <vector>
+
+namespace
+{
+std::vector<traffic_simulator_msgs::EntityStatus> makeStatus(std::size_t size, double time)
+{
+  std::vector<traffic_simulator_msgs::EntityStatus> status(size + 1);
+  for (std::size_t i = 0; i < status.size(); ++i) {
+    const double angle = 2 * M_PI * i / size;
+    const double radius = i == 0 ? 0 : 10 + 5 * (i % 6);
+    status[i].set_name(i == 0 ? "ego" : "npc" + std::to_string(i));
+    status[i].mutable_type()->set_type(
+      i == 0 ? traffic_simulator_msgs::EntityType::EGO
+             : traffic_simulator_msgs::EntityType::VEHICLE);
+    status[i].mutable_pose()->mutable_position()->set_x(radius * std::cos(angle) + time);
+    status[i].mutable_pose()->mutable_position()->set_y(radius * std::sin(angle));
+    status[i].mutable_pose()->mutable_orientation()->set_w(1);
+    status[i].mutable_bounding_box()->mutable_center()->set_z(0.75);
+    status[i].mutable_bounding_box()->mutable_dimensions()->set_x(4.0);
+    status[i].mutable_bounding_box()->mutable_dimensions()->set_y(1.8);
+    status[i].mutable_bounding_box()->mutable_dimensions()->set_z(1.5);
+  }
+  return status;
+}
+
+/**
+ * @note A 32 channel lidar, so that several of them make a typical sensor set of a vehicle.
+ */
+simulation_api_schema::LidarConfiguration makeLidarConfiguration()
+{
+  simulation_api_schema::LidarConfiguration configuration;
+  configuration.set_entity("ego");
+  configuration.set_architecture_type("awf/universe");
+  configuration.set_horizontal_resolution(0.2 * M_PI / 180.0);
+  for (int i = 0; i < 32; ++i) {
+    configuration.add_vertical_angles(-0.4 + 0.5 * i / 31);
+  }
+  configuration.set_scan_duration(0.1);
+  return configuration;
+}
+
+simulation_api_schema::DetectionSensorConfiguration makeDetectionSensorConfiguration()
+{
+  simulation_api_schema::DetectionSensorConfiguration configuration;
+  configuration.set_entity("ego");
+  configuration.set_architecture_type("awf/universe");
+  configuration.set_range(300);
+  configuration.set_update_duration(0.1);
+  return configuration;
+}
+}  // namespace
+
+/**
+ * @brief Time for which updateSensorFrame blocks the reply to the UpdateSensorFrame request, with
+ * state.range(0) lidar sensors and a detection sensor due every frame, state.range(1) sensor update
+ * threads, and in asynchronous mode if state.range(2) is not 0.
+ * @note In asynchronous mode, the wait for the previous frame is not timed, as if the frame of the
+ * traffic simulator between two sensor frames took at least as long as the scans.
+ */
+static void UpdateSensorFrame(benchmark::State & state)
+{
+  const auto node = std::make_shared<rclcpp::Node>("benchmark_sensor_simulation");
+  simple_sensor_simulator::SensorSimulation sensor_simulation(
+    1, false, state.range(1), state.range(2) != 0);
+  for (std::int64_t i = 0; i < state.range(0); ++i) {
+    sensor_simulation.attachLidarSensor(0, makeLidarConfiguration(), *node);
+  }
+  sensor_simulation.attachDetectionSensor(0, makeDetectionSensorConfiguration(), *node);
+  std::int64_t frame = 0;
+  for (auto _ : state) {
+    ++frame;
+    const auto status = makeStatus(100, 0.01 * frame);
+    sensor_simulation.updateSensorFrame(
+      0.1 * frame, rclcpp::Time(frame, 0, RCL_ROS_TIME), status);
+    state.PauseTiming();
+    sensor_simulation.waitForSensorFrame();
+    state.ResumeTiming();
+  }
+}
+BENCHMARK(UpdateSensorFrame)
+  ->Apply([](benchmark::internal::Benchmark * instance) {
+    for (const int async : {0, 1}) {
+      for (const int threads : {1, 2, 4}) {
+        for (const int lidars : {1, 2, 4}) {
+          instance->Args({lidars, threads, async});
+        }
+      }
+    }
+  })
+  ->Unit(benchmark::kMillisecond)
+  ->UseRealTime();
+
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  rclcpp::shutdown();
+  return 0;
+}
@@ -0,0 +1,293 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cmath>
+#include <simple_sensor_simulator/exception.hpp>
+#include <simple_sensor_simulator/sensor_simulation/detection_sensor/detection_sensor.hpp>
+#include <simple_sensor_simulator/sensor_simulation/lidar/raycaster.hpp>
+#include <simple_sensor_simulator/sensor_simulation/spatial_index.hpp>
+#include <string>
+#include <vector>
+
+namespace
+{
+/**
+ * @brief Exposes the culling of the detection sensor, without publishing anything.
+ */
+class Sensor : public simple_sensor_simulator::DetectionSensorBase
+{
+public:
+  explicit Sensor(const simulation_api_schema::DetectionSensorConfiguration & configuration)
+  : DetectionSensorBase(0, configuration)
+  {
+  }
+
+  using DetectionSensorBase::getDetectedObjects;
+  using DetectionSensorBase::pose_covariance_;
+  using DetectionSensorBase::twist_covariance_;
+
+  void update(
+    const double, const std::vector<traffic_simulator_msgs::EntityStatus> &, const rclcpp::Time &,
+    const std::vector<std::string> &, const simple_sensor_simulator::SpatialIndex &,
+    const simple_sensor_simulator::Raycaster *) override
+  {
+  }
+};
+
+traffic_simulator_msgs::EntityStatus makeStatus(
+  const std::string & name, double x, double y, double z = 0,
+  traffic_simulator_msgs::EntityType::Enum type = traffic_simulator_msgs::EntityType::VEHICLE)
+{
+  traffic_simulator_msgs::EntityStatus status;
+  status.set_name(name);
+  status.mutable_type()->set_type(type);
+  status.mutable_pose()->mutable_position()->set_x(x);
+  status.mutable_pose()->mutable_position()->set_y(y);
+  status.mutable_pose()->mutable_position()->set_z(z);
+  status.mutable_pose()->mutable_orientation()->set_w(1);
+  status.mutable_bounding_box()->mutable_center()->set_z(0.75);
+  status.mutable_bounding_box()->mutable_dimensions()->set_x(4.0);
+  status.mutable_bounding_box()->mutable_dimensions()->set_y(1.8);
+  status.mutable_bounding_box()->mutable_dimensions()->set_z(1.5);
+  return status;
+}
+
+simulation_api_schema::DetectionSensorConfiguration makeConfiguration(double range)
+{
+  simulation_api_schema::DetectionSensorConfiguration configuration;
+  configuration.set_entity("ego");
+  configuration.set_range(range);
+  configuration.set_filter_by_range(true);
+  configuration.set_architecture_type("awf/universe");
+  return configuration;
+}
+
+std::vector<std::string> getNames(
+  const std::vector<traffic_simulator_msgs::EntityStatus> & status,
+  const std::vector<std::size_t> & indices)
+{
+  std::vector<std::string> names;
+  for (const auto i : indices) {
+    names.emplace_back(status[i].name());
+  }
+  return names;
+}
+
+geometry_msgs::msg::Pose makePose(const geometry_msgs::Point & position)
+{
+  geometry_msgs::msg::Pose pose;
+  pose.position.x = position.x();
+  pose.position.y = position.y();
+  pose.position.z = position.z();
+  return pose;
+}
+
+geometry_msgs::Point makePoint(double x, double y, double z)
+{
+  geometry_msgs::Point point;
+  point.set_x(x);
+  point.set_y(y);
+  point.set_z(z);
+  return point;
+}
+
+/**
+ * @brief Adds the boxes of the entities but the ego, as a lidar sensor does before a scan.
+ */
+void addEntities(
+  simple_sensor_simulator::Raycaster & raycaster,
+  const std::vector<traffic_simulator_msgs::EntityStatus> & status)
+{
+  for (const auto & s : status) {
+    if (s.type().type() != traffic_simulator_msgs::EntityType::EGO) {
+      auto pose = makePose(s.pose().position());
+      pose.position.z += s.bounding_box().center().z();
+      raycaster.addPrimitive<simple_sensor_simulator::primitives::Box>(
+        s.name(), 4.0, 1.8, 1.5, pose);
+    }
+  }
+}
+}  // namespace
+
+/**
+ * @note The entities are spread over many cells, on their borders and at negative coordinates,
+ * and the ranges cover both the query by cell and the linear scan.
+ */
+TEST(SpatialIndex, SameAsLinearScan)
+{
+  std::vector<traffic_simulator_msgs::EntityStatus> status;
+  for (int i = 0; i < 500; ++i) {
+    status.emplace_back(makeStatus(
+      "npc" + std::to_string(i), 7.3 * (i % 40) - 140, 11.9 * (i / 40) - 60, 0.1 * (i % 7)));
+  }
+  status.emplace_back(makeStatus("border", 20, -20));
+  simple_sensor_simulator::SpatialIndex index;
+  index.build(status);
+  for (const double range : {0.0, 5.0, 20.0, 37.5, 120.0, 1000.0}) {
+    for (const auto & center : {status[0], status[123], status[499], status[500]}) {
+      std::vector<std::size_t> expected;
+      for (std::size_t i = 0; i < status.size(); ++i) {
+        const auto x = status[i].pose().position().x() - center.pose().position().x();
+        const auto y = status[i].pose().position().y() - center.pose().position().y();
+        const auto z = status[i].pose().position().z() - center.pose().position().z();
+        if (x * x + y * y + z * z <= range * range) {
+          expected.emplace_back(i);
+        }
+      }
+      std::vector<std::size_t> indices;
+      index.findWithin(center.pose().position(), range, indices);
+      EXPECT_EQ(indices, expected) << "range " << range << " around " << center.name();
+    }
+  }
+  EXPECT_EQ(index.find("npc42").get(), 42U);
+  EXPECT_FALSE(index.find("none"));
+}
+
+TEST(DetectionSensor, CullByRange)
+{
+  const std::vector<traffic_simulator_msgs::EntityStatus> status = {
+    makeStatus("far", 100, 0), makeStatus("ego", 0, 0, 0, traffic_simulator_msgs::EntityType::EGO),
+    makeStatus("near", 10, 5), makeStatus("behind", -20, 0)};
+  simple_sensor_simulator::SpatialIndex index;
+  index.build(status);
+  const Sensor sensor(makeConfiguration(50));
+  EXPECT_EQ(
+    getNames(status, sensor.getDetectedObjects(status, index, {}, nullptr)),
+    std::vector<std::string>({"near", "behind"}));
+}
+
+/**
+ * @note Without range filter the entities come from the lidar, in the order of the status.
+ */
+TEST(DetectionSensor, CullByLidar)
+{
+  const std::vector<traffic_simulator_msgs::EntityStatus> status = {
+    makeStatus("ego", 0, 0, 0, traffic_simulator_msgs::EntityType::EGO), makeStatus("a", 10, 0),
+    makeStatus("b", 20, 0), makeStatus("c", 30, 0)};
+  simple_sensor_simulator::SpatialIndex index;
+  index.build(status);
+  auto configuration = makeConfiguration(50);
+  configuration.set_filter_by_range(false);
+  const Sensor sensor(configuration);
+  EXPECT_EQ(
+    getNames(status, sensor.getDetectedObjects(status, index, {"c", "despawned", "a"}, nullptr)),
+    std::vector<std::string>({"a", "c"}));
+}
+
+TEST(DetectionSensor, CullByFieldOfView)
+{
+  auto ego = makeStatus("ego", 0, 0, 0, traffic_simulator_msgs::EntityType::EGO);
+  /**
+   * @note Facing the positive y axis.
+   */
+  ego.mutable_pose()->mutable_orientation()->set_z(std::sin(M_PI / 4));
+  ego.mutable_pose()->mutable_orientation()->set_w(std::cos(M_PI / 4));
+  const std::vector<traffic_simulator_msgs::EntityStatus> status = {
+    ego, makeStatus("front", 1, 20), makeStatus("right", 20, 0), makeStatus("back", 0, -20),
+    makeStatus("front_left", -10, 20)};
+  simple_sensor_simulator::SpatialIndex index;
+  index.build(status);
+  auto configuration = makeConfiguration(50);
+  configuration.set_horizontal_field_of_view(M_PI / 2);
+  const Sensor sensor(configuration);
+  EXPECT_EQ(
+    getNames(status, sensor.getDetectedObjects(status, index, {}, nullptr)),
+    std::vector<std::string>({"front", "front_left"}));
+}
+
+TEST(DetectionSensor, CullByOcclusion)
+{
+  const std::vector<traffic_simulator_msgs::EntityStatus> status = {
+    makeStatus("ego", 0, 0, 0, traffic_simulator_msgs::EntityType::EGO),
+    makeStatus("hidden", 30, 0), makeStatus("front", 10, 0), makeStatus("side", 10, 10)};
+  simple_sensor_simulator::SpatialIndex index;
+  index.build(status);
+  auto configuration = makeConfiguration(50);
+  configuration.set_filter_by_occlusion(true);
+  const Sensor sensor(configuration);
+  EXPECT_THROW(
+    sensor.getDetectedObjects(status, index, {}, nullptr),
+    simple_sensor_simulator::SimulationRuntimeError);
+  simple_sensor_simulator::Raycaster raycaster;
+  addEntities(raycaster, status);
+  /**
+   * @note The road runs through the origin of the ego, so a ray cast from there would hit it.
+   */
+  raycaster.addPrimitive<simple_sensor_simulator::primitives::Box>(
+    "road", 200.0, 200.0, 0.2, makePose(makePoint(0, 0, -0.1)));
+  raycaster.raycast(
+    "base_link", rclcpp::Time(0, 0, RCL_ROS_TIME), makePose(makePoint(0, 0, 1.8)), M_PI / 180.0,
+    {0.0});
+  EXPECT_EQ(
+    getNames(status, sensor.getDetectedObjects(status, index, {}, &raycaster)),
+    std::vector<std::string>({"front", "side"}));
+}
+
+/**
+ * @note The entity in front moved away after the last scan, so it must not hide the one behind it
+ * once the scene is updated.
+ */
+TEST(DetectionSensor, CullByOcclusionAfterSceneUpdate)
+{
+  std::vector<traffic_simulator_msgs::EntityStatus> status = {
+    makeStatus("ego", 0, 0, 0, traffic_simulator_msgs::EntityType::EGO),
+    makeStatus("hidden", 30, 0), makeStatus("front", 10, 0)};
+  auto configuration = makeConfiguration(50);
+  configuration.set_filter_by_occlusion(true);
+  const Sensor sensor(configuration);
+  simple_sensor_simulator::Raycaster raycaster;
+  addEntities(raycaster, status);
+  raycaster.raycast(
+    "base_link", rclcpp::Time(0, 0, RCL_ROS_TIME), makePose(makePoint(0, 0, 1.8)), M_PI / 180.0,
+    {0.0});
+  status[2].mutable_pose()->mutable_position()->set_y(20);
+  simple_sensor_simulator::SpatialIndex index;
+  index.build(status);
+  EXPECT_EQ(
+    getNames(status, sensor.getDetectedObjects(status, index, {}, &raycaster)),
+    std::vector<std::string>({"front"}));
+  addEntities(raycaster, status);
+  raycaster.commitScene(makePose(makePoint(0, 0, 1.8)));
+  EXPECT_EQ(
+    getNames(status, sensor.getDetectedObjects(status, index, {}, &raycaster)),
+    std::vector<std::string>({"hidden", "front"}));
+}
+
+TEST(DetectionSensor, Covariance)
+{
+  auto configuration = makeConfiguration(50);
+  const Sensor default_sensor(configuration);
+  std::array<double, 36> identity = {};
+  for (std::size_t i = 0; i < 6; ++i) {
+    identity[i * 7] = 1;
+  }
+  EXPECT_EQ(default_sensor.pose_covariance_, identity);
+  EXPECT_EQ(default_sensor.twist_covariance_, std::array<double, 36>());
+  for (int i = 0; i < 36; ++i) {
+    configuration.add_pose_covariance(0.1 * i);
+  }
+  const Sensor sensor(configuration);
+  EXPECT_DOUBLE_EQ(sensor.pose_covariance_[35], 3.5);
+  configuration.add_twist_covariance(1.0);
+  EXPECT_THROW(Sensor{configuration}, simple_sensor_simulator::SimulationRuntimeError);
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
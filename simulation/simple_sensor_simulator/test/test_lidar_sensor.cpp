@@ -0,0 +1,145 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <ament_index_cpp/get_package_share_directory.hpp>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <rclcpp/rclcpp.hpp>
+#include <simple_sensor_simulator/sensor_simulation/lidar/lidar_sensor.hpp>
+#include <simple_sensor_simulator/sensor_simulation/primitives/static_map.hpp>
+#include <string>
+#include <vector>
+
+namespace
+{
+using PointCloud2 = sensor_msgs::msg::PointCloud2;
+
+simulation_api_schema::LidarConfiguration makeConfiguration()
+{
+  simulation_api_schema::LidarConfiguration configuration;
+  configuration.set_entity("ego");
+  configuration.set_architecture_type("awf/universe");
+  configuration.set_horizontal_resolution(1.0 * M_PI / 180.0);
+  for (const double angle : {-0.3, -0.2, -0.1, 0.0, 0.1}) {
+    configuration.add_vertical_angles(angle);
+  }
+  configuration.set_scan_duration(0.1);
+  return configuration;
+}
+
+/**
+ * @brief Scans once through a lidar sensor attached to an entity standing on the road of the
+ * sample map, and returns the points in the frame of the entity.
+ */
+std::vector<simple_sensor_simulator::Raycaster::Point> scan(
+  const simulation_api_schema::LidarConfiguration & configuration)
+{
+  const auto static_map = std::make_shared<const simple_sensor_simulator::primitives::StaticMap>(
+    ament_index_cpp::get_package_share_directory("kashiwanoha_map") + "/map/lanelet2_map.osm");
+  /**
+   * @note On the centroid of the first triangle of the road surface, as the origin of an entity
+   * of the traffic simulator lies on the centerline of its lanelet.
+   */
+  const auto vertices = static_map->getVertex();
+  const auto triangle = static_map->getTriangles().front();
+  traffic_simulator_msgs::EntityStatus status;
+  status.set_name("ego");
+  status.mutable_type()->set_type(traffic_simulator_msgs::EntityType::EGO);
+  status.mutable_pose()->mutable_position()->set_x(
+    (vertices[triangle.v0].x + vertices[triangle.v1].x + vertices[triangle.v2].x) / 3);
+  status.mutable_pose()->mutable_position()->set_y(
+    (vertices[triangle.v0].y + vertices[triangle.v1].y + vertices[triangle.v2].y) / 3);
+  status.mutable_pose()->mutable_position()->set_z(
+    (vertices[triangle.v0].z + vertices[triangle.v1].z + vertices[triangle.v2].z) / 3);
+  status.mutable_pose()->mutable_orientation()->set_w(1);
+
+  auto node = std::make_shared<rclcpp::Node>("test_lidar_sensor");
+  std::vector<simple_sensor_simulator::Raycaster::Point> points;
+  bool received = false;
+  const auto subscription = node->create_subscription<PointCloud2>(
+    "test_lidar_sensor/pointcloud", 1, [&](const PointCloud2::SharedPtr message) {
+      points.resize(message->width);
+      std::memcpy(points.data(), message->data.data(), message->data.size());
+      received = true;
+    });
+  simple_sensor_simulator::LidarSensor<PointCloud2> sensor(
+    0, configuration, node->create_publisher<PointCloud2>("test_lidar_sensor/pointcloud", 1),
+    static_map);
+  sensor.update(0.1, {status}, rclcpp::Time(0, 0, RCL_ROS_TIME));
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (!received && std::chrono::steady_clock::now() < deadline) {
+    rclcpp::spin_some(node);
+  }
+  EXPECT_TRUE(received);
+  return points;
+}
+}  // namespace
+
+/**
+ * @note The origin of the entity lies on the road surface. Rays cast from it would hit the road at
+ * about zero range, or from below, instead of a few meters away from the vehicle.
+ */
+TEST(LidarSensor, ScanFromGroundLevelEntity)
+{
+  const auto points = scan(makeConfiguration());
+  ASSERT_FALSE(points.empty());
+  std::size_t road_points = 0;
+  for (const auto & point : points) {
+    const auto horizontal_distance = std::hypot(point.x, point.y);
+    const auto distance = std::hypot(horizontal_distance, point.z - 1.8);
+    EXPECT_GE(distance, 0.5 - 1e-3);
+    if (horizontal_distance < 10) {
+      EXPECT_GT(point.z, -0.3) << "hit the road from below at " << point.x << ", " << point.y;
+    }
+    if (std::abs(point.z) < 0.3) {
+      ++road_points;
+    }
+  }
+  EXPECT_GT(road_points, 0U);
+}
+
+/**
+ * @note Points are published in the frame of the entity, so a lidar mounted higher sees the road
+ * at the same height but farther away. The lowest beam of a lidar 3 m high reaches the road about
+ * 9.7 m away, against 5.8 m at the default height.
+ */
+TEST(LidarSensor, MountingPose)
+{
+  auto configuration = makeConfiguration();
+  configuration.mutable_mounting_pose()->mutable_position()->set_z(3.0);
+  configuration.mutable_mounting_pose()->mutable_orientation()->set_w(1);
+  const auto points = scan(configuration);
+  ASSERT_FALSE(points.empty());
+  std::size_t road_points = 0;
+  for (const auto & point : points) {
+    if (std::abs(point.z) < 0.3) {
+      EXPECT_GT(std::hypot(point.x, point.y), 8.0);
+      ++road_points;
+    }
+  }
+  EXPECT_GT(road_points, 0U);
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  rclcpp::init(argc, argv);
+  const auto result = RUN_ALL_TESTS();
+  rclcpp::shutdown();
+  return result;
+}
@@ -0,0 +1,173 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstring>
+#include <simple_sensor_simulator/sensor_simulation/lidar/noise_model.hpp>
+#include <simple_sensor_simulator/sensor_simulation/lidar/raycaster.hpp>
+#include <vector>
+
+namespace
+{
+using Point = simple_sensor_simulator::Raycaster::Point;
+
+/**
+ * @brief Returns a pointcloud of returns spread around the lidar, all at the same range and with
+ * the same incidence angle.
+ */
+sensor_msgs::msg::PointCloud2 makePointCloud(std::size_t size, float range, float cosine = 1)
+{
+  sensor_msgs::msg::PointCloud2 pointcloud;
+  pointcloud.height = 1;
+  pointcloud.width = size;
+  pointcloud.point_step = sizeof(Point);
+  pointcloud.row_step = size * sizeof(Point);
+  pointcloud.data.resize(size * sizeof(Point));
+  for (std::size_t i = 0; i < size; ++i) {
+    const float angle = 2 * M_PI * i / size;
+    const Point point = {range * std::cos(angle), range * std::sin(angle), 0, cosine};
+    std::memcpy(pointcloud.data.data() + i * sizeof(Point), &point, sizeof(Point));
+  }
+  return pointcloud;
+}
+
+std::vector<Point> getPoints(const sensor_msgs::msg::PointCloud2 & pointcloud)
+{
+  std::vector<Point> points(pointcloud.width);
+  std::memcpy(points.data(), pointcloud.data.data(), points.size() * sizeof(Point));
+  return points;
+}
+
+double getRange(const Point & point)
+{
+  return std::sqrt(point.x * point.x + point.y * point.y + point.z * point.z);
+}
+
+simulation_api_schema::LidarConfiguration makeConfiguration(
+  double range_noise_standard_deviation, double dropout_probability, double dropout_range,
+  double intensity_scale, std::uint32_t random_seed = 0)
+{
+  simulation_api_schema::LidarConfiguration configuration;
+  configuration.set_range_noise_standard_deviation(range_noise_standard_deviation);
+  configuration.set_dropout_probability(dropout_probability);
+  configuration.set_dropout_range(dropout_range);
+  configuration.set_intensity_scale(intensity_scale);
+  configuration.set_random_seed(random_seed);
+  return configuration;
+}
+}  // namespace
+
+TEST(NoiseModel, DisabledByDefault)
+{
+  const auto original = makePointCloud(1000, 20);
+  auto pointcloud = original;
+  simple_sensor_simulator::NoiseModel(simulation_api_schema::LidarConfiguration())
+    .apply(pointcloud);
+  ASSERT_EQ(pointcloud.width, original.width);
+  const auto points = getPoints(pointcloud);
+  const auto original_points = getPoints(original);
+  for (std::size_t i = 0; i < points.size(); ++i) {
+    EXPECT_EQ(points[i].x, original_points[i].x);
+    EXPECT_EQ(points[i].y, original_points[i].y);
+    EXPECT_EQ(points[i].z, original_points[i].z);
+    EXPECT_EQ(points[i].intensity, 0);
+  }
+}
+
+/**
+ * @note With 100000 samples, the standard error of the mean is 0.0003 m and the one of the
+ * standard deviation is 0.0002 m.
+ */
+TEST(NoiseModel, RangeNoiseIsGaussian)
+{
+  constexpr double standard_deviation = 0.1;
+  auto pointcloud = makePointCloud(100000, 20);
+  simple_sensor_simulator::NoiseModel(makeConfiguration(standard_deviation, 0, 0, 1))
+    .apply(pointcloud);
+  const auto points = getPoints(pointcloud);
+  ASSERT_EQ(points.size(), 100000U);
+  double sum = 0;
+  double squared_sum = 0;
+  std::size_t within_one_sigma = 0;
+  std::size_t within_two_sigma = 0;
+  for (const auto & point : points) {
+    const double error = getRange(point) - 20;
+    sum += error;
+    squared_sum += error * error;
+    within_one_sigma += std::abs(error) < standard_deviation;
+    within_two_sigma += std::abs(error) < 2 * standard_deviation;
+  }
+  const double mean = sum / points.size();
+  EXPECT_NEAR(mean, 0, 0.0015);
+  EXPECT_NEAR(std::sqrt(squared_sum / points.size() - mean * mean), standard_deviation, 0.001);
+  EXPECT_NEAR(static_cast<double>(within_one_sigma) / points.size(), 0.6827, 0.01);
+  EXPECT_NEAR(static_cast<double>(within_two_sigma) / points.size(), 0.9545, 0.005);
+}
+
+/**
+ * @note The dropout probability is 0.4 at 50 m, so 0.1 at 25 m and 1 beyond 79 m.
+ */
+TEST(NoiseModel, DropoutGrowsWithRange)
+{
+  const auto kept = [](float range) {
+    auto pointcloud = makePointCloud(100000, range);
+    simple_sensor_simulator::NoiseModel(makeConfiguration(0, 0.4, 50, 1)).apply(pointcloud);
+    EXPECT_EQ(pointcloud.data.size(), pointcloud.width * sizeof(Point));
+    EXPECT_EQ(pointcloud.row_step, pointcloud.width * sizeof(Point));
+    for (const auto & point : getPoints(pointcloud)) {
+      EXPECT_NEAR(getRange(point), range, 1e-3);
+    }
+    return static_cast<double>(pointcloud.width) / 100000;
+  };
+  EXPECT_NEAR(kept(25), 0.9, 0.005);
+  EXPECT_NEAR(kept(50), 0.6, 0.005);
+  EXPECT_EQ(kept(80), 0);
+}
+
+TEST(NoiseModel, IntensityFallsWithIncidenceAngle)
+{
+  for (const float cosine : {1.0f, 0.5f, 0.0f}) {
+    auto pointcloud = makePointCloud(100, 20, cosine);
+    simple_sensor_simulator::NoiseModel(makeConfiguration(0.1, 0.4, 50, 200)).apply(pointcloud);
+    for (const auto & point : getPoints(pointcloud)) {
+      EXPECT_FLOAT_EQ(point.intensity, 200 * cosine);
+    }
+  }
+}
+
+TEST(NoiseModel, Reproducible)
+{
+  const auto scan = [](std::uint32_t random_seed) {
+    simple_sensor_simulator::NoiseModel noise_model(
+      makeConfiguration(0.1, 0.4, 50, 1, random_seed));
+    std::vector<sensor_msgs::msg::PointCloud2> pointclouds;
+    for (int i = 0; i < 3; ++i) {
+      pointclouds.emplace_back(makePointCloud(1000, 40));
+      noise_model.apply(pointclouds.back());
+    }
+    return pointclouds;
+  };
+  const auto pointclouds = scan(1);
+  EXPECT_EQ(pointclouds, scan(1));
+  EXPECT_NE(pointclouds, scan(2));
+  EXPECT_NE(pointclouds[0], pointclouds[1]);
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,231 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <lanelet2_core/LaneletMap.h>
+#include <lanelet2_core/utility/Utilities.h>
+#include <pcl_conversions/pcl_conversions.h>
+
+#include <cmath>
+#include <simple_sensor_simulator/sensor_simulation/lidar/raycaster.hpp>
+#include <simple_sensor_simulator/sensor_simulation/primitives/static_map.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+lanelet::Point3d makePoint(double x, double y, double z = 0)
+{
+  return lanelet::Point3d(lanelet::utils::getId(), x, y, z);
+}
+
+/**
+ * @brief A straight lanelet 3.5 m wide and 40 m long along the x axis, with a wall on its left.
+ */
+simple_sensor_simulator::primitives::StaticMap makeStaticMap()
+{
+  lanelet::LaneletMap lanelet_map;
+  lanelet::LineString3d left(
+    lanelet::utils::getId(), {makePoint(-20, 1.75), makePoint(0, 1.75), makePoint(20, 1.75)});
+  lanelet::LineString3d right(
+    lanelet::utils::getId(), {makePoint(-20, -1.75), makePoint(20, -1.75)});
+  lanelet_map.add(lanelet::Lanelet(lanelet::utils::getId(), left, right));
+  lanelet::LineString3d wall(
+    lanelet::utils::getId(), {makePoint(-20, 5), makePoint(20, 5)},
+    lanelet::AttributeMap({{"type", "wall"}}));
+  lanelet_map.add(wall);
+  return simple_sensor_simulator::primitives::StaticMap(lanelet_map);
+}
+
+geometry_msgs::msg::Pose makePose(double x, double y, double z)
+{
+  geometry_msgs::msg::Pose pose;
+  pose.position.x = x;
+  pose.position.y = y;
+  pose.position.z = z;
+  return pose;
+}
+
+pcl::PointCloud<pcl::PointXYZI> raycast(simple_sensor_simulator::Raycaster & raycaster)
+{
+  const auto pointcloud = raycaster.raycast(
+    "base_link", rclcpp::Time(0, 0, RCL_ROS_TIME), makePose(0, 0, 1.5), 1.0 * M_PI / 180.0,
+    {-0.3, -0.1, 0.0, 0.1, 0.3});
+  pcl::PointCloud<pcl::PointXYZI> cloud;
+  pcl::fromROSMsg(pointcloud, cloud);
+  return cloud;
+}
+}  // namespace
+
+TEST(StaticMap, Triangulate)
+{
+  const auto static_map = makeStaticMap();
+  /**
+   * @note 5 points on the bounds of the lanelet, and 2 on the ground and 2 on the top of the wall.
+   */
+  EXPECT_EQ(static_map.getLocalVertex().size(), 9U);
+  EXPECT_EQ(static_map.getTriangles().size(), 3U + 2U);
+  for (const auto & triangle : static_map.getTriangles()) {
+    EXPECT_LT(triangle.v0, 9U);
+    EXPECT_LT(triangle.v1, 9U);
+    EXPECT_LT(triangle.v2, 9U);
+  }
+}
+
+TEST(StaticMap, BarrierHeight)
+{
+  using simple_sensor_simulator::primitives::StaticMap;
+  EXPECT_DOUBLE_EQ(StaticMap::getBarrierHeight("curbstone", "low"), 0.1);
+  EXPECT_DOUBLE_EQ(StaticMap::getBarrierHeight("curbstone", "high"), 0.2);
+  EXPECT_DOUBLE_EQ(StaticMap::getBarrierHeight("wall", ""), 3.0);
+  EXPECT_DOUBLE_EQ(StaticMap::getBarrierHeight("line_thin", "solid"), 0);
+}
+
+TEST(Raycaster, HitStaticMap)
+{
+  simple_sensor_simulator::Raycaster raycaster;
+  EXPECT_TRUE(raycast(raycaster).empty());
+  raycaster.setStaticMap(makeStaticMap());
+  const auto cloud = raycast(raycaster);
+  std::size_t road_points = 0;
+  std::size_t wall_points = 0;
+  for (const auto & point : cloud) {
+    if (std::abs(point.z + 1.5) < 1e-3) {
+      ++road_points;
+    } else if (std::abs(point.y - 5) < 1e-3) {
+      ++wall_points;
+    }
+  }
+  EXPECT_GT(road_points, 0U);
+  EXPECT_GT(wall_points, 0U);
+  EXPECT_EQ(road_points + wall_points, cloud.size());
+  EXPECT_TRUE(raycaster.getDetectedObject().empty());
+}
+
+TEST(Raycaster, StaticMapIsNotDetected)
+{
+  simple_sensor_simulator::Raycaster raycaster;
+  raycaster.setStaticMap(makeStaticMap());
+  raycaster.addPrimitive<simple_sensor_simulator::primitives::Box>(
+    "npc", 4.0, 1.8, 1.5, makePose(-8, 0, 0.75));
+  raycast(raycaster);
+  EXPECT_EQ(raycaster.getDetectedObject(), std::vector<std::string>({"npc"}));
+}
+
+/**
+ * @note The same scene must give the same points in the same order, whether it is scanned again
+ * by the same raycaster or by another one built from scratch.
+ */
+TEST(Raycaster, Deterministic)
+{
+  const auto static_map = makeStaticMap();
+  const auto scan = [&](simple_sensor_simulator::Raycaster & raycaster) {
+    raycaster.addPrimitive<simple_sensor_simulator::primitives::Box>(
+      "npc0", 4.0, 1.8, 1.5, makePose(-8, 0, 0.75));
+    raycaster.addPrimitive<simple_sensor_simulator::primitives::Box>(
+      "npc1", 4.0, 1.8, 1.5, makePose(10, -1, 0.75));
+    return raycaster.raycast(
+      "base_link", rclcpp::Time(0, 0, RCL_ROS_TIME), makePose(0, 0, 1.5), 0.5 * M_PI / 180.0,
+      {-0.3, -0.2, -0.1, 0.0, 0.1});
+  };
+  simple_sensor_simulator::Raycaster raycaster;
+  raycaster.setStaticMap(static_map);
+  const auto first = scan(raycaster);
+  const auto second = scan(raycaster);
+  simple_sensor_simulator::Raycaster other_raycaster;
+  other_raycaster.setStaticMap(static_map);
+  const auto third = scan(other_raycaster);
+  EXPECT_GT(first.width, 0U);
+  EXPECT_EQ(first.data, second.data);
+  EXPECT_EQ(first.data, third.data);
+  EXPECT_EQ(raycaster.getDetectedObject(), other_raycaster.getDetectedObject());
+}
+
+/**
+ * @note The entities are spread around the sensor, so that with more threads they fall into
+ * sectors cast concurrently, and the points must still come in the order of a serial scan.
+ */
+TEST(Raycaster, SameResultWithAnyThreadCount)
+{
+  const auto static_map = makeStaticMap();
+  const auto scan = [&](std::size_t thread_count) {
+    simple_sensor_simulator::Raycaster raycaster;
+    raycaster.setStaticMap(static_map);
+    raycaster.setThreadCount(thread_count);
+    std::vector<sensor_msgs::msg::PointCloud2> pointclouds;
+    for (int frame = 0; frame < 3; ++frame) {
+      for (int i = 0; i < 8; ++i) {
+        raycaster.addPrimitive<simple_sensor_simulator::primitives::Box>(
+          "npc" + std::to_string(i), 4.0, 1.8, 1.5,
+          makePose(10 * std::cos(i * M_PI / 4) + frame, 10 * std::sin(i * M_PI / 4), 0.75));
+      }
+      pointclouds.emplace_back(raycaster.raycast(
+        "base_link", rclcpp::Time(0, 0, RCL_ROS_TIME), makePose(0, 0, 1.5), 0.2 * M_PI / 180.0,
+        {-0.3, -0.2, -0.1, 0.0, 0.1, 0.2}));
+    }
+    return std::make_pair(pointclouds, raycaster.getDetectedObject());
+  };
+  const auto serial = scan(1);
+  EXPECT_EQ(serial.second.size(), 8U);
+  for (const std::size_t thread_count : {2, 3, 4, 8, 16}) {
+    const auto parallel = scan(thread_count);
+    ASSERT_EQ(parallel.first.size(), serial.first.size());
+    for (std::size_t frame = 0; frame < serial.first.size(); ++frame) {
+      EXPECT_EQ(parallel.first[frame].data, serial.first[frame].data)
+        << "frame " << frame << " differs with " << thread_count << " threads.";
+    }
+    EXPECT_EQ(parallel.second, serial.second);
+  }
+}
+
+/**
+ * @note The second scan has fewer points than the first one, so the message must be shrunk and
+ * must not keep any point of the first scan.
+ */
+TEST(Raycaster, ReuseMessage)
+{
+  const auto scan = [](simple_sensor_simulator::Raycaster & raycaster, double x) {
+    raycaster.addPrimitive<simple_sensor_simulator::primitives::Box>(
+      "npc", 4.0, 1.8, 1.5, makePose(x, 0, 1.0));
+  };
+  simple_sensor_simulator::Raycaster raycaster;
+  simple_sensor_simulator::Raycaster other_raycaster;
+  sensor_msgs::msg::PointCloud2 pointcloud;
+  for (const double x : {5.0, 50.0}) {
+    scan(raycaster, x);
+    raycaster.raycast(
+      pointcloud, "base_link", rclcpp::Time(0, 0, RCL_ROS_TIME), makePose(0, 0, 1.5),
+      1.0 * M_PI / 180.0, {-0.1, 0.0, 0.1});
+    scan(other_raycaster, x);
+    const auto expected = other_raycaster.raycast(
+      "base_link", rclcpp::Time(0, 0, RCL_ROS_TIME), makePose(0, 0, 1.5), 1.0 * M_PI / 180.0,
+      {-0.1, 0.0, 0.1});
+    EXPECT_GT(pointcloud.width, 0U);
+    EXPECT_EQ(pointcloud, expected);
+    EXPECT_EQ(pointcloud.point_step, 16U);
+    EXPECT_EQ(pointcloud.data.size(), pointcloud.width * pointcloud.point_step);
+    pcl::PointCloud<pcl::PointXYZI> cloud;
+    pcl::fromROSMsg(pointcloud, cloud);
+    for (const auto & point : cloud) {
+      EXPECT_NEAR(point.x, x - 2.0, 1e-3);
+    }
+  }
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,378 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <rclcpp/rclcpp.hpp>
+#include <simple_sensor_simulator/exception.hpp>
+#include <simple_sensor_simulator/sensor_simulation/lidar/raycaster.hpp>
+#include <simple_sensor_simulator/sensor_simulation/sensor_simulation.hpp>
+#include <string>
+#include <vector>
+
+namespace
+{
+using PointCloud2 = sensor_msgs::msg::PointCloud2;
+using PredictedObjects = autoware_auto_perception_msgs::msg::PredictedObjects;
+
+traffic_simulator_msgs::EntityStatus makeStatus(
+  const std::string & name, double x, double y,
+  traffic_simulator_msgs::EntityType::Enum type = traffic_simulator_msgs::EntityType::VEHICLE)
+{
+  traffic_simulator_msgs::EntityStatus status;
+  status.set_name(name);
+  status.mutable_type()->set_type(type);
+  status.mutable_pose()->mutable_position()->set_x(x);
+  status.mutable_pose()->mutable_position()->set_y(y);
+  status.mutable_pose()->mutable_orientation()->set_w(1);
+  status.mutable_bounding_box()->mutable_center()->set_z(0.75);
+  status.mutable_bounding_box()->mutable_dimensions()->set_x(4.0);
+  status.mutable_bounding_box()->mutable_dimensions()->set_y(1.8);
+  status.mutable_bounding_box()->mutable_dimensions()->set_z(1.5);
+  return status;
+}
+
+/**
+ * @note The vehicles move around the ego every frame, and some of them leave the sight of the
+ * lidars, so that the detected objects change from frame to frame.
+ */
+std::vector<traffic_simulator_msgs::EntityStatus> makeFrame(int frame)
+{
+  std::vector<traffic_simulator_msgs::EntityStatus> status = {
+    makeStatus("ego", 0, 0, traffic_simulator_msgs::EntityType::EGO)};
+  for (int i = 0; i < 8; ++i) {
+    const double angle = i * M_PI / 4 + 0.1 * frame;
+    const double radius = 10 + 20 * ((i + frame) % 4);
+    status.emplace_back(
+      makeStatus("npc" + std::to_string(i), radius * std::cos(angle), radius * std::sin(angle)));
+  }
+  return status;
+}
+
+simulation_api_schema::LidarConfiguration makeLidarConfiguration(const std::string & entity)
+{
+  simulation_api_schema::LidarConfiguration configuration;
+  configuration.set_entity(entity);
+  configuration.set_architecture_type("awf/universe");
+  configuration.set_horizontal_resolution(0.5 * M_PI / 180.0);
+  for (const double angle : {-0.2, -0.1, 0.0, 0.1}) {
+    configuration.add_vertical_angles(angle);
+  }
+  configuration.set_scan_duration(0.1);
+  return configuration;
+}
+
+/**
+ * @note Scans with a fine resolution, so that its frame takes much longer than copying the status
+ * or attaching a sensor.
+ */
+simulation_api_schema::LidarConfiguration makeSlowLidarConfiguration(const std::string & entity)
+{
+  auto configuration = makeLidarConfiguration(entity);
+  configuration.set_horizontal_resolution(0.01 * M_PI / 180.0);
+  configuration.clear_vertical_angles();
+  for (int i = 0; i < 32; ++i) {
+    configuration.add_vertical_angles(-0.3 + 0.01 * i);
+  }
+  return configuration;
+}
+
+/**
+ * @note Reports only the entities hit by the lidars, so its messages change if it runs before
+ * the lidars of the same frame.
+ */
+simulation_api_schema::DetectionSensorConfiguration makeDetectionSensorConfiguration()
+{
+  simulation_api_schema::DetectionSensorConfiguration configuration;
+  configuration.set_entity("ego");
+  configuration.set_architecture_type("awf/universe");
+  configuration.set_range(300);
+  configuration.set_update_duration(0.1);
+  configuration.set_filter_by_range(false);
+  return configuration;
+}
+
+/**
+ * @brief Messages published in one frame. Pointclouds of lidars sharing the topic arrive in any
+ * order, so they are sorted.
+ */
+struct Frame
+{
+  std::vector<std::vector<std::uint8_t>> pointclouds;
+  std::vector<std::vector<double>> objects;
+  bool operator==(const Frame & other) const
+  {
+    return pointclouds == other.pointclouds && objects == other.objects;
+  }
+};
+
+std::vector<Frame> simulate(std::size_t sensor_update_threads, bool async_sensor_update)
+{
+  auto node = std::make_shared<rclcpp::Node>("test_sensor_simulation");
+  Frame frame;
+  const auto pointcloud_subscription = node->create_subscription<PointCloud2>(
+    "/perception/obstacle_segmentation/pointcloud", 10,
+    [&](const PointCloud2::SharedPtr message) { frame.pointclouds.push_back(message->data); });
+  const auto objects_subscription = node->create_subscription<PredictedObjects>(
+    "/perception/object_recognition/objects", 10, [&](const PredictedObjects::SharedPtr message) {
+      for (const auto & object : message->objects) {
+        const auto & position = object.kinematics.initial_pose_with_covariance.pose.position;
+        frame.objects.push_back({position.x, position.y, position.z});
+      }
+    });
+  simple_sensor_simulator::SensorSimulation sensor_simulation(
+    1, false, sensor_update_threads, async_sensor_update);
+  for (const auto & entity : {"ego", "npc0", "npc3"}) {
+    sensor_simulation.attachLidarSensor(0, makeLidarConfiguration(entity), *node);
+  }
+  sensor_simulation.attachDetectionSensor(0, makeDetectionSensorConfiguration(), *node);
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(node);
+  std::vector<Frame> frames;
+  for (int i = 0; i < 5; ++i) {
+    frame = Frame();
+    sensor_simulation.updateSensorFrame(
+      0.1 * (i + 1), rclcpp::Time(i, 0, RCL_ROS_TIME), makeFrame(i));
+    sensor_simulation.waitForSensorFrame();
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (frame.pointclouds.size() < 3 && std::chrono::steady_clock::now() < deadline) {
+      executor.spin_some(std::chrono::milliseconds(10));
+    }
+    executor.spin_some(std::chrono::milliseconds(100));
+    std::sort(frame.pointclouds.begin(), frame.pointclouds.end());
+    frames.push_back(frame);
+  }
+  return frames;
+}
+}  // namespace
+
+/**
+ * @note Every frame must give the same messages as updating the sensors one by one on the calling
+ * thread, whatever the number of threads and whether the sensors run in the background.
+ */
+TEST(SensorSimulation, SameMessagesWithAnyThreadCount)
+{
+  const auto serial = simulate(1, false);
+  ASSERT_EQ(serial.size(), 5U);
+  for (const auto & frame : serial) {
+    EXPECT_EQ(frame.pointclouds.size(), 3U);
+    EXPECT_FALSE(frame.objects.empty());
+  }
+  EXPECT_EQ(simulate(4, false), serial);
+  EXPECT_EQ(simulate(1, true), serial);
+  EXPECT_EQ(simulate(4, true), serial);
+}
+
+/**
+ * @note The detection sensor publishes the entities hit by the lidars in the same frame, which are
+ * found here by scanning each frame again, so the lidars must be updated before it.
+ */
+TEST(SensorSimulation, LidarBeforeDetection)
+{
+  for (const bool async_sensor_update : {false, true}) {
+    const auto frames = simulate(4, async_sensor_update);
+    ASSERT_EQ(frames.size(), 5U);
+    for (std::size_t i = 0; i < frames.size(); ++i) {
+      const auto status = makeFrame(i);
+      std::vector<std::string> detected_objects;
+      for (const auto & entity : {"ego", "npc0", "npc3"}) {
+        simple_sensor_simulator::Raycaster raycaster;
+        geometry_msgs::msg::Pose origin;
+        for (const auto & s : status) {
+          geometry_msgs::msg::Pose pose;
+          pose.position.x = s.pose().position().x();
+          pose.position.y = s.pose().position().y();
+          if (s.name() == entity) {
+            /**
+             * @note At the default mounting height of a lidar.
+             */
+            origin = pose;
+            origin.position.z = 1.8;
+          } else {
+            pose.position.z = s.bounding_box().center().z();
+            raycaster.addPrimitive<simple_sensor_simulator::primitives::Box>(
+              s.name(), 4.0, 1.8, 1.5, pose);
+          }
+        }
+        std::vector<double> vertical_angles;
+        for (const auto angle : makeLidarConfiguration(entity).vertical_angles()) {
+          vertical_angles.push_back(angle);
+        }
+        raycaster.raycast(
+          "base_link", rclcpp::Time(0, 0, RCL_ROS_TIME), origin, 0.5 * M_PI / 180.0,
+          vertical_angles, 0, 2 * M_PI, 100, 0.5);
+        for (const auto & name : raycaster.getDetectedObject()) {
+          detected_objects.push_back(name);
+        }
+      }
+      std::vector<std::vector<double>> expected;
+      for (const auto & s : status) {
+        if (
+          s.name() != "ego" &&
+          std::count(detected_objects.begin(), detected_objects.end(), s.name()) != 0) {
+          const auto & position = s.pose().position();
+          expected.push_back({position.x(), position.y(), position.z()});
+        }
+      }
+      EXPECT_FALSE(expected.empty());
+      EXPECT_EQ(frames[i].objects, expected) << "frame " << i;
+    }
+  }
+}
+
+/**
+ * @note In asynchronous mode, an error of the sensors is thrown by the next updateSensorFrame
+ * instead of the call of the frame which raised it. Attaching a sensor in between still attaches
+ * it.
+ */
+TEST(SensorSimulation, AsyncErrorIsRethrown)
+{
+  auto node = std::make_shared<rclcpp::Node>("test_sensor_simulation");
+  std::size_t pointclouds = 0;
+  const auto pointcloud_subscription = node->create_subscription<PointCloud2>(
+    "/perception/obstacle_segmentation/pointcloud", 10,
+    [&](const PointCloud2::SharedPtr) { ++pointclouds; });
+  simple_sensor_simulator::SensorSimulation sensor_simulation(1, false, 2, true);
+  sensor_simulation.attachLidarSensor(0, makeLidarConfiguration("missing"), *node);
+  EXPECT_NO_THROW(
+    sensor_simulation.updateSensorFrame(0.1, rclcpp::Time(0, 0, RCL_ROS_TIME), makeFrame(0)));
+  EXPECT_NO_THROW(sensor_simulation.waitForSensorFrame());
+  EXPECT_NO_THROW(sensor_simulation.attachLidarSensor(0, makeLidarConfiguration("ego"), *node));
+  EXPECT_THROW(
+    sensor_simulation.updateSensorFrame(0.2, rclcpp::Time(0, 0, RCL_ROS_TIME), makeFrame(1)),
+    simple_sensor_simulator::SimulationRuntimeError);
+  /**
+   * @note The sensor which failed is still attached, so every frame fails once it is done, but the
+   * lidar attached after the error scans in each of them.
+   */
+  EXPECT_NO_THROW(
+    sensor_simulation.updateSensorFrame(0.3, rclcpp::Time(0, 0, RCL_ROS_TIME), makeFrame(2)));
+  sensor_simulation.waitForSensorFrame();
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(node);
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (pointclouds == 0 && std::chrono::steady_clock::now() < deadline) {
+    executor.spin_some(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(pointclouds, 1U);
+}
+
+/**
+ * @note In asynchronous mode, updateSensorFrame must return before the scan is done.
+ */
+TEST(SensorSimulation, AsyncUpdateDoesNotBlock)
+{
+  auto node = std::make_shared<rclcpp::Node>("test_sensor_simulation");
+  simple_sensor_simulator::SensorSimulation sensor_simulation(1, false, 1, true);
+  sensor_simulation.attachLidarSensor(0, makeSlowLidarConfiguration("ego"), *node);
+  using Clock = std::chrono::steady_clock;
+  const auto start = Clock::now();
+  sensor_simulation.updateSensorFrame(0.1, rclcpp::Time(0, 0, RCL_ROS_TIME), makeFrame(0));
+  const auto returned = Clock::now();
+  sensor_simulation.waitForSensorFrame();
+  const auto done = Clock::now();
+  EXPECT_LT((returned - start) * 10, done - start);
+}
+
+/**
+ * @note The sensor handlers of the simulator run concurrently, so a sensor may be attached while a
+ * frame is updated. It must not wait for the frame, and is updated from the next frame on.
+ */
+TEST(SensorSimulation, AttachDuringFrame)
+{
+  auto node = std::make_shared<rclcpp::Node>("test_sensor_simulation");
+  std::size_t objects = 0;
+  const auto objects_subscription = node->create_subscription<PredictedObjects>(
+    "/perception/object_recognition/objects", 10,
+    [&](const PredictedObjects::SharedPtr) { ++objects; });
+  simple_sensor_simulator::SensorSimulation sensor_simulation(1, false, 1, true);
+  sensor_simulation.attachLidarSensor(0, makeSlowLidarConfiguration("ego"), *node);
+  using Clock = std::chrono::steady_clock;
+  const auto start = Clock::now();
+  sensor_simulation.updateSensorFrame(0.1, rclcpp::Time(0, 0, RCL_ROS_TIME), makeFrame(0));
+  sensor_simulation.attachDetectionSensor(0, makeDetectionSensorConfiguration(), *node);
+  const auto attached = Clock::now();
+  sensor_simulation.waitForSensorFrame();
+  const auto done = Clock::now();
+  EXPECT_LT((attached - start) * 10, done - start);
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(node);
+  executor.spin_some(std::chrono::milliseconds(100));
+  EXPECT_EQ(objects, 0U);
+  sensor_simulation.updateSensorFrame(0.2, rclcpp::Time(0, 0, RCL_ROS_TIME), makeFrame(1));
+  sensor_simulation.waitForSensorFrame();
+  const auto deadline = Clock::now() + std::chrono::seconds(10);
+  while (objects == 0 && Clock::now() < deadline) {
+    executor.spin_some(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(objects, 1U);
+}
+
+/**
+ * @note The lidar scans once a second, so it does not scan in these frames, and the entity in
+ * front moves away in the second one. It must not hide the entity behind it any more.
+ */
+TEST(SensorSimulation, OcclusionInCurrentFrame)
+{
+  auto node = std::make_shared<rclcpp::Node>("test_sensor_simulation");
+  std::vector<std::string> names;
+  const auto objects_subscription = node->create_subscription<PredictedObjects>(
+    "/perception/object_recognition/objects", 10, [&](const PredictedObjects::SharedPtr message) {
+      for (const auto & object : message->objects) {
+        names.push_back(
+          std::abs(object.kinematics.initial_pose_with_covariance.pose.position.x - 30) < 1e-3
+            ? "hidden"
+            : "front");
+      }
+    });
+  simple_sensor_simulator::SensorSimulation sensor_simulation;
+  auto lidar_configuration = makeLidarConfiguration("ego");
+  lidar_configuration.set_scan_duration(1.0);
+  sensor_simulation.attachLidarSensor(0, lidar_configuration, *node);
+  auto detection_configuration = makeDetectionSensorConfiguration();
+  detection_configuration.set_range(100);
+  detection_configuration.set_filter_by_range(true);
+  detection_configuration.set_filter_by_occlusion(true);
+  sensor_simulation.attachDetectionSensor(0, detection_configuration, *node);
+  rclcpp::executors::SingleThreadedExecutor executor;
+  executor.add_node(node);
+  const auto update = [&](double time, double front_y) {
+    names.clear();
+    sensor_simulation.updateSensorFrame(
+      time, rclcpp::Time(0, 0, RCL_ROS_TIME),
+      {makeStatus("ego", 0, 0, traffic_simulator_msgs::EntityType::EGO),
+       makeStatus("hidden", 30, 0), makeStatus("front", 10, front_y)});
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (names.empty() && std::chrono::steady_clock::now() < deadline) {
+      executor.spin_some(std::chrono::milliseconds(10));
+    }
+    return names;
+  };
+  EXPECT_EQ(update(0.1, 0), std::vector<std::string>({"front"}));
+  EXPECT_EQ(update(0.2, 20), std::vector<std::string>({"hidden", "front"}));
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  rclcpp::init(argc, argv);
+  const auto result = RUN_ALL_TESTS();
+  rclcpp::shutdown();
+  return result;
+}
@@ -19,16 +19,35 @@
 
 namespace simulation_interface
 {
-enum class TransportProtocol { TCP /*, UDP*/ };
+/**
+ * @note IPC and SHARED_MEMORY are for a client and a server on the same host. The server binds
+ * both an ipc:// and a tcp:// endpoint for each socket, so remote clients still reach it over
+ * TCP. SHARED_MEMORY is IPC with the large payloads passed through a SharedMemorySegment.
+ */
+enum class TransportProtocol { TCP, IPC, SHARED_MEMORY /*, UDP*/ };
 
 std::string enumToString(const TransportProtocol & protocol);
 
+/**
+ * @brief Converts "tcp", "ipc" or "shared_memory", as given by a parameter, to the protocol.
+ */
+TransportProtocol toTransportProtocol(const std::string & protocol);
+
 enum class HostName { LOCALHOST, ANY };
 
 std::string enumToString(const HostName & hostname);
 
 const TransportProtocol protocol = TransportProtocol::TCP;
 
+/**
+ * @brief How zeromq::MultiServer waits for requests.
+ * @note POLLING polls all the sockets from one thread with a 1 ms timeout and handles the requests
+ * in turn. EVENT_DRIVEN waits on each socket in a thread of its own without a timeout, so requests
+ * are received, parsed and answered concurrently. In both modes the handlers never run
+ * concurrently, see zeromq::MultiServer.
+ */
+enum class ServerMode { POLLING, EVENT_DRIVEN };
+
 namespace ports
 {
 const unsigned int initialize = 5555;
@@ -42,10 +61,20 @@ const unsigned int update_entity_status = 5562;
 const unsigned int attach_lidar_sensor = 5563;
 const unsigned int attach_detection_sensor = 5564;
 const unsigned int update_traffic_lights = 5565;
+const unsigned int simulate_frame = 5566;
 }  // namespace ports
 
 std::string getEndPoint(
   const TransportProtocol & protocol, const HostName & hostname, const unsigned int & port);
+
+/**
+ * @brief Returns the protocol a client should use to reach the server.
+ * @note IPC and SHARED_MEMORY fall back to TCP if the server is not on this host, or if nothing
+ * is listening on its ipc:// endpoint yet, e.g. because the server only binds tcp:// or has not
+ * started. The client then works as with TCP, only slower.
+ */
+TransportProtocol resolveTransportProtocol(
+  const TransportProtocol & protocol, const HostName & hostname);
 }  // namespace simulation_interface
 
 #endif  // SIMULATION_INTERFACE__CONSTANTS_HPP_
@@ -151,6 +151,18 @@ void toProto(
 void toMsg(
   const traffic_simulator_msgs::EntityStatus & proto,
   traffic_simulator_msgs::msg::EntityStatus & status);
+void toProto(
+  const traffic_simulator_msgs::msg::EntityStatus & status,
+  traffic_simulator_msgs::EntityStaticStatus & proto);
+void toMsg(
+  const traffic_simulator_msgs::EntityStaticStatus & proto,
+  traffic_simulator_msgs::msg::EntityStatus & status);
+void toProto(
+  const traffic_simulator_msgs::msg::EntityStatus & status,
+  traffic_simulator_msgs::EntityDynamicStatus & proto);
+void toMsg(
+  const traffic_simulator_msgs::EntityDynamicStatus & proto,
+  traffic_simulator_msgs::msg::EntityStatus & status);
 void toProto(
   const builtin_interfaces::msg::Duration & duration, builtin_interfaces::Duration & proto);
 void toMsg(
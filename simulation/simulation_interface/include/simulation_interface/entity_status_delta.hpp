@@ -0,0 +1,97 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SIMULATION_INTERFACE__ENTITY_STATUS_DELTA_HPP_
+#define SIMULATION_INTERFACE__ENTITY_STATUS_DELTA_HPP_
+
+#include <simulation_api_schema.pb.h>
+#include <traffic_simulator_msgs.pb.h>
+
+#include <cstdint>
+#include <string>
+#include <traffic_simulator_msgs/msg/entity_status.hpp>
+#include <unordered_map>
+#include <vector>
+
+namespace simulation_interface
+{
+/**
+ * @brief Encodes the entity status of each frame as the difference from the previous frame.
+ * @note Static fields (type, subtype, name and bounding box) are sent when an entity first appears
+ * or when they change. Dynamic fields are sent only for entities whose action status, pose or
+ * lanelet pose changed. The time of each entity is sent only if it differs from the time of the
+ * frame, so that the decoder gives the same time as the full entity status. The encoder assumes
+ * every delta it returns is applied by the decoder; if the decoder reports another sequence number,
+ * call reset so that the next delta is a keyframe.
+ */
+class EntityStatusDeltaEncoder
+{
+public:
+  auto encode(const std::vector<traffic_simulator_msgs::msg::EntityStatus> & status, double time)
+    -> simulation_api_schema::EntityStatusDelta;
+
+  auto reset() -> void;
+
+  auto sequence() const noexcept { return sequence_; }
+
+private:
+  struct Entry
+  {
+    std::uint32_t id;
+    traffic_simulator_msgs::msg::EntityStatus status;
+  };
+
+  std::unordered_map<std::string, Entry> entries_;
+
+  std::uint32_t next_id_ = 0;
+
+  std::uint64_t sequence_ = 0;
+
+  bool keyframe_ = true;
+};
+
+/**
+ * @brief Rebuilds the entity status from the deltas of EntityStatusDeltaEncoder.
+ */
+class EntityStatusDeltaDecoder
+{
+public:
+  /**
+   * @brief Applies the entity status of the request, either the full list or the delta.
+   * @return false if the delta does not apply to the current entity status. Nothing is changed in
+   * that case and the sender is expected to send a keyframe.
+   */
+  auto decode(const simulation_api_schema::UpdateEntityStatusRequest & request) -> bool;
+
+  auto decode(const simulation_api_schema::EntityStatusDelta & delta) -> bool;
+
+  auto sequence() const noexcept { return sequence_; }
+
+  auto getStatus() const noexcept -> const std::vector<traffic_simulator_msgs::EntityStatus> &
+  {
+    return status_;
+  }
+
+private:
+  std::vector<traffic_simulator_msgs::EntityStatus> status_;
+
+  std::vector<std::uint32_t> ids_;
+
+  std::unordered_map<std::uint32_t, std::size_t> indices_;
+
+  std::uint64_t sequence_ = 0;
+};
+}  // namespace simulation_interface
+
+#endif  // SIMULATION_INTERFACE__ENTITY_STATUS_DELTA_HPP_
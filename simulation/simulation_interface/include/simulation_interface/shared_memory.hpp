@@ -0,0 +1,104 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SIMULATION_INTERFACE__SHARED_MEMORY_HPP_
+#define SIMULATION_INTERFACE__SHARED_MEMORY_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+namespace simulation_interface
+{
+/**
+ * @brief POSIX shared memory segment mapped into this process.
+ * @note The client of the SHARED_MEMORY transport creates one segment and passes the payloads of
+ * large requests in its first half, and the server passes the payloads of large responses in its
+ * second half. A REQ socket waits for the response before it sends the next request, and a
+ * client is used by one thread at a time, so there is never more than one payload in each half
+ * and the segment needs no other synchronization than the messages themselves.
+ */
+class SharedMemorySegment
+{
+public:
+  /**
+   * @brief Creates a segment of the size, which is removed when this object is destroyed.
+   */
+  SharedMemorySegment(const std::string & name, std::size_t size);
+
+  /**
+   * @brief Maps an existing segment created by another object, possibly in another process.
+   */
+  explicit SharedMemorySegment(const std::string & name);
+
+  SharedMemorySegment(const SharedMemorySegment &) = delete;
+
+  SharedMemorySegment & operator=(const SharedMemorySegment &) = delete;
+
+  ~SharedMemorySegment();
+
+  auto name() const noexcept -> const std::string & { return name_; }
+
+  auto size() const noexcept { return size_; }
+
+  auto data() noexcept { return data_; }
+
+  auto data() const noexcept -> const char * { return data_; }
+
+  /**
+   * @brief Returns the offset and the size of the half of the segment for requests.
+   */
+  auto requestArea() const noexcept -> std::pair<std::size_t, std::size_t>;
+
+  /**
+   * @brief Returns the offset and the size of the half of the segment for responses.
+   */
+  auto responseArea() const noexcept -> std::pair<std::size_t, std::size_t>;
+
+  /**
+   * @brief Returns a name of a new segment, unique among the processes of this host.
+   */
+  static auto makeUniqueName() -> std::string;
+
+  /**
+   * @brief Returns true if the name was made by makeUniqueName.
+   * @note The server only maps segments with these names.
+   */
+  static auto isValidName(const std::string & name) -> bool;
+
+private:
+  const std::string name_;
+
+  const bool owner_;
+
+  std::size_t size_;
+
+  char * data_;
+};
+
+/**
+ * @brief Payloads smaller than this are sent in the ZeroMQ message even with the SHARED_MEMORY
+ * transport, copying them is cheaper than the extra message frames.
+ */
+constexpr std::size_t shared_memory_threshold = 16 * 1024;
+
+/**
+ * @brief Size of the segment of each client. Payloads larger than its half are sent in the ZeroMQ
+ * message. Pages are allocated only when they are written.
+ */
+constexpr std::size_t shared_memory_segment_size = 64 * 1024 * 1024;
+}  // namespace simulation_interface
+
+#endif  // SIMULATION_INTERFACE__SHARED_MEMORY_HPP_
@@ -0,0 +1,78 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SIMULATION_INTERFACE__THREAD_POOL_HPP_
+#define SIMULATION_INTERFACE__THREAD_POOL_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace simulation_interface
+{
+/**
+ * @brief Threads which stay alive between calls of parallelFor, so that work split per frame does
+ * not pay for creating threads every frame.
+ * @note parallelFor must not be called by several threads at once, nor from one of its calls.
+ */
+class ThreadPool
+{
+public:
+  /**
+   * @brief Creates a pool which runs the calls on the given number of threads, including the one
+   * calling parallelFor. With 0 or 1, everything runs on the calling thread.
+   */
+  explicit ThreadPool(std::size_t size = 1);
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool & operator=(const ThreadPool &) = delete;
+  ~ThreadPool();
+
+  auto size() const noexcept -> std::size_t { return workers_.size() + 1; }
+
+  /**
+   * @brief Calls the function with each index in [0, count) and returns when all calls returned.
+   * @param on_calling_thread Called on the calling thread, while the workers already take indices,
+   * before the calling thread takes indices too. For work which must not leave this thread.
+   * @note The calls run in no particular order, so the function should write its results to a
+   * slot of the index. If some calls throw, the exception of on_calling_thread, or else of the
+   * smallest index, is rethrown.
+   */
+  void parallelFor(
+    std::size_t count, const std::function<void(std::size_t)> & function,
+    const std::function<void()> & on_calling_thread = nullptr);
+
+private:
+  void work();
+  void run();
+
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable job_condition_;
+  std::condition_variable done_condition_;
+  const std::function<void(std::size_t)> * function_ = nullptr;
+  std::size_t count_ = 0;
+  std::atomic<std::size_t> next_index_{0};
+  std::size_t generation_ = 0;
+  std::size_t busy_workers_ = 0;
+  bool stopping_ = false;
+  std::vector<std::exception_ptr> errors_;
+};
+}  // namespace simulation_interface
+
+#endif  // SIMULATION_INTERFACE__THREAD_POOL_HPP_
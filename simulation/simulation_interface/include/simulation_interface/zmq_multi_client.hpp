@@ -23,6 +23,7 @@
 #include <rclcpp/rclcpp.hpp>
 #include <scenario_simulator_exception/exception.hpp>
 #include <simulation_interface/constants.hpp>
+#include <simulation_interface/shared_memory.hpp>
 #include <string>
 #include <thread>
 #include <zmqpp/zmqpp.hpp>
@@ -70,11 +71,18 @@ public:
   void call(
     const simulation_api_schema::UpdateTrafficLightsRequest & req,
     simulation_api_schema::UpdateTrafficLightsResponse & res);
+  void call(
+    const simulation_api_schema::SimulateFrameRequest & req,
+    simulation_api_schema::SimulateFrameResponse & res);
 
   const simulation_interface::TransportProtocol protocol;
   const simulation_interface::HostName hostname;
 
 private:
+  template <typename Request, typename Response>
+  void exchange(zmqpp::socket & socket, const Request & req, Response & res);
+
+  std::unique_ptr<simulation_interface::SharedMemorySegment> shared_memory_;
   zmqpp::context context_;
   const zmqpp::socket_type type_;
   zmqpp::socket socket_initialize_;
@@ -88,6 +96,7 @@ private:
   zmqpp::socket socket_attach_lidar_sensor_;
   zmqpp::socket socket_attach_detection_sensor_;
   zmqpp::socket socket_update_traffic_lights_;
+  zmqpp::socket socket_simulate_frame_;
 };
 }  // namespace zeromq
 
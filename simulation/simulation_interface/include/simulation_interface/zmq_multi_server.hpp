@@ -17,16 +17,35 @@
 
 #include <simulation_api_schema.pb.h>
 
+#include <atomic>
 #include <functional>
+#include <memory>
+#include <mutex>
 #include <rclcpp/rclcpp.hpp>
 #include <scenario_simulator_exception/exception.hpp>
+#include <shared_mutex>
 #include <simulation_interface/constants.hpp>
+#include <simulation_interface/shared_memory.hpp>
 #include <string>
 #include <thread>
+#include <unordered_map>
+#include <vector>
 #include <zmqpp/zmqpp.hpp>
 
 namespace zeromq
 {
+/**
+ * @note In the POLLING mode the handlers are called one at a time. In the EVENT_DRIVEN mode the
+ * handlers are sorted in two classes, see Access. A shared handler runs concurrently with the
+ * other shared handlers, but never with an exclusive one, so an exclusive handler sees everything
+ * the handlers which returned before it did, and the shared handlers see the entities, the frame
+ * and the spawned objects stay as they are while they run. Shared handlers must be safe to call
+ * concurrently with each other; the state they write is theirs to lock.
+ *
+ * Requests on one socket are handled in the order they are received, and a client which waits
+ * for each response, like MultiClient, sees its requests handled in the order it sent them.
+ * Receiving, parsing, serializing and sending always run concurrently in the EVENT_DRIVEN mode.
+ */
 class MultiServer
 {
 public:
@@ -76,12 +95,44 @@ public:
     std::function<void(
       const simulation_api_schema::UpdateTrafficLightsRequest &,
       simulation_api_schema::UpdateTrafficLightsResponse &)>
-      update_traffic_lights_func);
+      update_traffic_lights_func,
+    const simulation_interface::ServerMode & mode = simulation_interface::ServerMode::POLLING);
   ~MultiServer();
 
 private:
+  /**
+   * @brief How a handler is serialized with the others in the EVENT_DRIVEN mode.
+   * @note EXCLUSIVE handlers write the entities, the frame or the spawned objects: initialize,
+   * update_frame, update_entity_status, spawn and despawn, update_traffic_lights and the combined
+   * simulate_frame. SHARED handlers only read them and publish sensor data or configure sensors:
+   * update_sensor_frame, attach_lidar_sensor and attach_detection_sensor.
+   */
+  enum class Access { EXCLUSIVE, SHARED };
   void poll();
   void start_poll();
+  /**
+   * @brief Starts a thread which waits for requests on the socket and answers them with the
+   * handler, until the server is destroyed.
+   */
+  template <typename Request, typename Response>
+  void startWorker(
+    zmqpp::socket & socket, const std::function<void(const Request &, Response &)> & handler,
+    const Access access = Access::EXCLUSIVE);
+  /**
+   * @brief Receives a request on the socket and sends the response of the handler, through the
+   * shared memory of the client if it sent the request with the SHARED_MEMORY transport.
+   */
+  template <typename Request, typename Response, typename Handler>
+  void reply(zmqpp::socket & socket, Handler && handler);
+  auto getSharedMemorySegment(const std::string & name)
+    -> std::shared_ptr<simulation_interface::SharedMemorySegment>;
+  /**
+   * @note Handled with the same functions as the separate requests, so servers do not need to
+   * implement SimulateFrame themselves.
+   */
+  void simulateFrame(
+    const simulation_api_schema::SimulateFrameRequest & req,
+    simulation_api_schema::SimulateFrameResponse & res);
   std::thread thread_;
   const zmqpp::context context_;
   const zmqpp::socket_type type_;
@@ -140,6 +191,21 @@ private:
     const simulation_api_schema::UpdateTrafficLightsRequest &,
     simulation_api_schema::UpdateTrafficLightsResponse &)>
     update_traffic_lights_func_;
+  zmqpp::socket simulate_frame_sock_;
+  std::atomic<bool> polling_;
+  /**
+   * @note Held exclusively by the EXCLUSIVE handlers and shared by the SHARED ones.
+   */
+  std::shared_timed_mutex handler_mutex_;
+  /**
+   * @note Each worker waits on its socket and on the other end of one of these inproc pairs, so
+   * the destructor can wake it up.
+   */
+  std::vector<std::unique_ptr<zmqpp::socket>> stop_socks_;
+  std::vector<std::thread> workers_;
+  std::mutex shared_memory_mutex_;
+  std::unordered_map<std::string, std::shared_ptr<simulation_interface::SharedMemorySegment>>
+    shared_memory_segments_;
 };
 }  // namespace zeromq
 
@@ -12,17 +12,71 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstring>
 #include <scenario_simulator_exception/exception.hpp>
 #include <simulation_interface/constants.hpp>
 #include <string>
 
 namespace simulation_interface
 {
+namespace
+{
+std::string getIpcPath(const unsigned int & port)
+{
+  return "/tmp/simulation_interface_" + std::to_string(port);
+}
+
+/**
+ * @brief Returns true if a server accepts connections on the unix domain socket of the path.
+ * @note The socket file is left behind if the server is killed, so its existence is not enough.
+ */
+bool isListening(const std::string & path)
+{
+  sockaddr_un address;
+  if (path.size() >= sizeof(address.sun_path)) {
+    return false;
+  }
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+  const auto descriptor = ::socket(AF_UNIX, SOCK_STREAM, 0);
+  if (descriptor < 0) {
+    return false;
+  }
+  const auto connected =
+    ::connect(descriptor, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) == 0;
+  ::close(descriptor);
+  return connected;
+}
+}  // namespace
+
 std::string getEndPoint(
   const TransportProtocol & protocol, const HostName & hostname, const unsigned int & port)
 {
-  return simulation_interface::enumToString(protocol) + "://" +
-         simulation_interface::enumToString(hostname) + ":" + std::to_string(port);
+  switch (protocol) {
+    case TransportProtocol::IPC:
+    case TransportProtocol::SHARED_MEMORY:
+      return "ipc://" + getIpcPath(port);
+    default:
+      return simulation_interface::enumToString(protocol) + "://" +
+             simulation_interface::enumToString(hostname) + ":" + std::to_string(port);
+  }
+}
+
+TransportProtocol resolveTransportProtocol(
+  const TransportProtocol & protocol, const HostName & hostname)
+{
+  if (
+    protocol == TransportProtocol::TCP || hostname != HostName::LOCALHOST ||
+    !isListening(getIpcPath(ports::initialize))) {
+    return TransportProtocol::TCP;
+  } else {
+    return protocol;
+  }
 }
 
 std::string enumToString(const TransportProtocol & protocol)
@@ -30,12 +84,28 @@ std::string enumToString(const TransportProtocol & protocol)
   switch (protocol) {
     case TransportProtocol::TCP:
       return "tcp";
+    case TransportProtocol::IPC:
+      return "ipc";
+    case TransportProtocol::SHARED_MEMORY:
+      return "shared_memory";
       /*
     case TransportProtocol::UDP:
       return "udp";              
       */
   }
-  THROW_SIMULATION_ERROR("Protocol should be TCP.");  // LCOV_EXCL_LINE
+  THROW_SIMULATION_ERROR("Protocol should be TCP, IPC or SHARED_MEMORY.");  // LCOV_EXCL_LINE
+}
+
+TransportProtocol toTransportProtocol(const std::string & protocol)
+{
+  for (const auto candidate :
+       {TransportProtocol::TCP, TransportProtocol::IPC, TransportProtocol::SHARED_MEMORY}) {
+    if (protocol == enumToString(candidate)) {
+      return candidate;
+    }
+  }
+  THROW_SEMANTIC_ERROR(
+    "Unknown transport protocol ", protocol, ", it should be tcp, ipc or shared_memory.");
 }
 
 std::string enumToString(const HostName & hostname)
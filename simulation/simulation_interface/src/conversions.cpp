@@ -427,6 +427,46 @@ void toMsg(
   status.lanelet_pose_valid = proto.lanelet_pose_valid();
 }
 
+void toProto(
+  const traffic_simulator_msgs::msg::EntityStatus & status,
+  traffic_simulator_msgs::EntityStaticStatus & proto)
+{
+  toProto(status.type, *proto.mutable_type());
+  toProto(status.subtype, *proto.mutable_subtype());
+  proto.set_name(status.name);
+  toProto(status.bounding_box, *proto.mutable_bounding_box());
+}
+
+void toMsg(
+  const traffic_simulator_msgs::EntityStaticStatus & proto,
+  traffic_simulator_msgs::msg::EntityStatus & status)
+{
+  toMsg(proto.type(), status.type);
+  toMsg(proto.subtype(), status.subtype);
+  status.name = proto.name();
+  toMsg(proto.bounding_box(), status.bounding_box);
+}
+
+void toProto(
+  const traffic_simulator_msgs::msg::EntityStatus & status,
+  traffic_simulator_msgs::EntityDynamicStatus & proto)
+{
+  toProto(status.action_status, *proto.mutable_action_status());
+  toProto(status.pose, *proto.mutable_pose());
+  toProto(status.lanelet_pose, *proto.mutable_lanelet_pose());
+  proto.set_lanelet_pose_valid(status.lanelet_pose_valid);
+}
+
+void toMsg(
+  const traffic_simulator_msgs::EntityDynamicStatus & proto,
+  traffic_simulator_msgs::msg::EntityStatus & status)
+{
+  toMsg(proto.action_status(), status.action_status);
+  toMsg(proto.pose(), status.pose);
+  toMsg(proto.lanelet_pose(), status.lanelet_pose);
+  status.lanelet_pose_valid = proto.lanelet_pose_valid();
+}
+
 void toProto(
   const builtin_interfaces::msg::Duration & duration, builtin_interfaces::Duration & proto)
 {
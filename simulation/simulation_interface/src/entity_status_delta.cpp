@@ -0,0 +1,176 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <simulation_interface/conversions.hpp>
+#include <simulation_interface/entity_status_delta.hpp>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace simulation_interface
+{
+auto EntityStatusDeltaEncoder::encode(
+  const std::vector<traffic_simulator_msgs::msg::EntityStatus> & status, double time)
+  -> simulation_api_schema::EntityStatusDelta
+{
+  simulation_api_schema::EntityStatusDelta delta;
+  delta.set_sequence(++sequence_);
+  delta.set_base_sequence(keyframe_ ? 0 : sequence_ - 1);
+  delta.set_time(time);
+  if (keyframe_) {
+    entries_.clear();
+    next_id_ = 0;
+  }
+  std::unordered_set<std::string> names;
+  for (const auto & each : status) {
+    names.insert(each.name);
+  }
+  std::vector<std::uint32_t> despawned;
+  for (auto iter = entries_.begin(); iter != entries_.end();) {
+    if (names.count(iter->first) == 0) {
+      despawned.emplace_back(iter->second.id);
+      iter = entries_.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+  std::sort(despawned.begin(), despawned.end());
+  for (const auto id : despawned) {
+    delta.add_despawned(id);
+  }
+  for (const auto & each : status) {
+    auto iter = entries_.find(each.name);
+    const bool spawned = iter == entries_.end();
+    if (spawned) {
+      iter = entries_.emplace(each.name, Entry{next_id_++, each}).first;
+    }
+    const auto & last = iter->second.status;
+    if (
+      spawned or last.type != each.type or last.subtype != each.subtype or
+      last.bounding_box != each.bounding_box) {
+      auto proto = delta.add_spawned();
+      proto->set_id(iter->second.id);
+      toProto(each, *proto);
+    }
+    if (
+      spawned or last.action_status != each.action_status or last.pose != each.pose or
+      last.lanelet_pose != each.lanelet_pose or
+      last.lanelet_pose_valid != each.lanelet_pose_valid) {
+      auto proto = delta.add_updated();
+      proto->set_id(iter->second.id);
+      toProto(each, *proto);
+    }
+    if (each.time != time) {
+      (*delta.mutable_times())[iter->second.id] = each.time;
+    }
+    iter->second.status = each;
+  }
+  keyframe_ = false;
+  return delta;
+}
+
+auto EntityStatusDeltaEncoder::reset() -> void { keyframe_ = true; }
+
+auto EntityStatusDeltaDecoder::decode(
+  const simulation_api_schema::UpdateEntityStatusRequest & request) -> bool
+{
+  if (request.has_status_delta()) {
+    return decode(request.status_delta());
+  } else {
+    status_.assign(request.status().begin(), request.status().end());
+    ids_.clear();
+    indices_.clear();
+    sequence_ = 0;
+    return true;
+  }
+}
+
+auto EntityStatusDeltaDecoder::decode(const simulation_api_schema::EntityStatusDelta & delta)
+  -> bool
+{
+  const bool keyframe = delta.base_sequence() == 0;
+  if (not keyframe and (delta.base_sequence() != sequence_ or ids_.size() != status_.size())) {
+    return false;
+  }
+  std::unordered_set<std::uint32_t> spawned;
+  for (const auto & each : delta.spawned()) {
+    spawned.insert(each.id());
+  }
+  const std::unordered_set<std::uint32_t> despawned(
+    delta.despawned().begin(), delta.despawned().end());
+  const auto exists = [&](std::uint32_t id) {
+    return spawned.count(id) != 0 or
+           (not keyframe and indices_.count(id) != 0 and despawned.count(id) == 0);
+  };
+  for (const auto & each : delta.updated()) {
+    if (not exists(each.id())) {
+      return false;
+    }
+  }
+  for (const auto & each : delta.times()) {
+    if (not exists(each.first)) {
+      return false;
+    }
+  }
+  if (keyframe) {
+    status_.clear();
+    ids_.clear();
+    indices_.clear();
+  } else if (not despawned.empty()) {
+    std::vector<traffic_simulator_msgs::EntityStatus> status;
+    std::vector<std::uint32_t> ids;
+    for (std::size_t i = 0; i < status_.size(); ++i) {
+      if (despawned.count(ids_[i]) == 0) {
+        status.emplace_back(std::move(status_[i]));
+        ids.emplace_back(ids_[i]);
+      }
+    }
+    status_ = std::move(status);
+    ids_ = std::move(ids);
+    indices_.clear();
+    for (std::size_t i = 0; i < ids_.size(); ++i) {
+      indices_.emplace(ids_[i], i);
+    }
+  }
+  for (const auto & each : delta.spawned()) {
+    auto iter = indices_.find(each.id());
+    if (iter == indices_.end()) {
+      iter = indices_.emplace(each.id(), status_.size()).first;
+      status_.emplace_back();
+      ids_.emplace_back(each.id());
+    }
+    auto & status = status_[iter->second];
+    *status.mutable_type() = each.type();
+    *status.mutable_subtype() = each.subtype();
+    status.set_name(each.name());
+    *status.mutable_bounding_box() = each.bounding_box();
+  }
+  for (const auto & each : delta.updated()) {
+    auto & status = status_[indices_.at(each.id())];
+    *status.mutable_action_status() = each.action_status();
+    *status.mutable_pose() = each.pose();
+    *status.mutable_lanelet_pose() = each.lanelet_pose();
+    status.set_lanelet_pose_valid(each.lanelet_pose_valid());
+  }
+  for (auto & status : status_) {
+    status.set_time(delta.time());
+  }
+  for (const auto & each : delta.times()) {
+    status_[indices_.at(each.first)].set_time(each.second);
+  }
+  sequence_ = delta.sequence();
+  return true;
+}
+}  // namespace simulation_interface
@@ -0,0 +1,113 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <scenario_simulator_exception/exception.hpp>
+#include <simulation_interface/shared_memory.hpp>
+#include <string>
+#include <utility>
+
+namespace simulation_interface
+{
+namespace
+{
+const std::string prefix = "/simulation_interface_";
+
+auto map(const std::string & name, int descriptor, std::size_t size) -> char *
+{
+  const auto data = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+  ::close(descriptor);
+  if (data == MAP_FAILED) {
+    THROW_SIMULATION_ERROR("failed to map shared memory ", name, ": ", std::strerror(errno));
+  }
+  return static_cast<char *>(data);
+}
+}  // namespace
+
+SharedMemorySegment::SharedMemorySegment(const std::string & name, std::size_t size)
+: name_(name), owner_(true), size_(size)
+{
+  const auto descriptor = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+  if (descriptor < 0) {
+    THROW_SIMULATION_ERROR("failed to create shared memory ", name, ": ", std::strerror(errno));
+  }
+  if (::ftruncate(descriptor, size) != 0) {
+    const auto error = errno;
+    ::close(descriptor);
+    ::shm_unlink(name.c_str());
+    THROW_SIMULATION_ERROR("failed to resize shared memory ", name, ": ", std::strerror(error));
+  }
+  try {
+    data_ = map(name, descriptor, size);
+  } catch (...) {
+    ::shm_unlink(name.c_str());
+    throw;
+  }
+}
+
+SharedMemorySegment::SharedMemorySegment(const std::string & name) : name_(name), owner_(false)
+{
+  const auto descriptor = ::shm_open(name.c_str(), O_RDWR, 0);
+  if (descriptor < 0) {
+    THROW_SIMULATION_ERROR("failed to open shared memory ", name, ": ", std::strerror(errno));
+  }
+  struct stat status;
+  if (::fstat(descriptor, &status) != 0) {
+    const auto error = errno;
+    ::close(descriptor);
+    THROW_SIMULATION_ERROR("failed to open shared memory ", name, ": ", std::strerror(error));
+  }
+  size_ = status.st_size;
+  data_ = map(name, descriptor, size_);
+}
+
+SharedMemorySegment::~SharedMemorySegment()
+{
+  ::munmap(data_, size_);
+  if (owner_) {
+    ::shm_unlink(name_.c_str());
+  }
+}
+
+auto SharedMemorySegment::requestArea() const noexcept -> std::pair<std::size_t, std::size_t>
+{
+  return std::make_pair(0, size_ / 2);
+}
+
+auto SharedMemorySegment::responseArea() const noexcept -> std::pair<std::size_t, std::size_t>
+{
+  return std::make_pair(size_ / 2, size_ - size_ / 2);
+}
+
+auto SharedMemorySegment::makeUniqueName() -> std::string
+{
+  static std::atomic<std::uint64_t> count{0};
+  return prefix + std::to_string(::getpid()) + "_" + std::to_string(count++) + "_" +
+         std::to_string(std::chrono::steady_clock::now().time_since_epoch().count());
+}
+
+auto SharedMemorySegment::isValidName(const std::string & name) -> bool
+{
+  return name.size() > prefix.size() && name.compare(0, prefix.size(), prefix) == 0 &&
+         name.find('/', 1) == std::string::npos;
+}
+}  // namespace simulation_interface
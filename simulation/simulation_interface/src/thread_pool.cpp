@@ -0,0 +1,132 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <simulation_interface/thread_pool.hpp>
+#include <vector>
+
+namespace simulation_interface
+{
+ThreadPool::ThreadPool(std::size_t size)
+{
+  for (std::size_t i = 1; i < size; ++i) {
+    workers_.emplace_back([this]() { work(); });
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  job_condition_.notify_all();
+  for (auto & worker : workers_) {
+    worker.join();
+  }
+}
+
+void ThreadPool::parallelFor(
+  std::size_t count, const std::function<void(std::size_t)> & function,
+  const std::function<void()> & on_calling_thread)
+{
+  /**
+   * @note A single index only runs on a worker if it can overlap with on_calling_thread.
+   */
+  if (workers_.empty() || count == 0 || (count == 1 && !on_calling_thread)) {
+    if (on_calling_thread) {
+      on_calling_thread();
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+      function(i);
+    }
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    function_ = &function;
+    count_ = count;
+    next_index_ = 0;
+    errors_.assign(count, nullptr);
+    busy_workers_ = workers_.size();
+    ++generation_;
+  }
+  job_condition_.notify_all();
+  /**
+   * @note The workers must be waited for before leaving, even if on_calling_thread throws, since
+   * they refer to the function.
+   */
+  std::exception_ptr calling_thread_error;
+  if (on_calling_thread) {
+    try {
+      on_calling_thread();
+    } catch (...) {
+      calling_thread_error = std::current_exception();
+    }
+  }
+  run();
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_condition_.wait(lock, [this]() { return busy_workers_ == 0; });
+    function_ = nullptr;
+  }
+  if (calling_thread_error) {
+    std::rethrow_exception(calling_thread_error);
+  }
+  for (const auto & error : errors_) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+}
+
+/**
+ * @note Every worker takes part in every call of parallelFor, even if there is nothing left to do
+ * when it wakes up, so that parallelFor can wait for all of them before the next call.
+ */
+void ThreadPool::work()
+{
+  std::size_t generation = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      job_condition_.wait(lock, [&]() { return stopping_ || generation_ != generation; });
+      if (stopping_) {
+        return;
+      }
+      generation = generation_;
+    }
+    run();
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (--busy_workers_ == 0) {
+        done_condition_.notify_one();
+      }
+    }
+  }
+}
+
+void ThreadPool::run()
+{
+  for (auto index = next_index_++; index < count_; index = next_index_++) {
+    try {
+      (*function_)(index);
+    } catch (...) {
+      errors_[index] = std::current_exception();
+    }
+  }
+}
+}  // namespace simulation_interface
@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstdint>
+#include <memory>
 #include <simulation_interface/conversions.hpp>
 #include <simulation_interface/zmq_multi_client.hpp>
 #include <string>
@@ -20,8 +22,14 @@ namespace zeromq
 MultiClient::MultiClient(
   const simulation_interface::TransportProtocol & protocol,
   const simulation_interface::HostName & hostname)
-: protocol(protocol),
+: protocol(simulation_interface::resolveTransportProtocol(protocol, hostname)),
   hostname(hostname),
+  shared_memory_(
+    this->protocol == simulation_interface::TransportProtocol::SHARED_MEMORY
+      ? std::make_unique<simulation_interface::SharedMemorySegment>(
+          simulation_interface::SharedMemorySegment::makeUniqueName(),
+          simulation_interface::shared_memory_segment_size)
+      : nullptr),
   context_(zmqpp::context()),
   type_(zmqpp::socket_type::request),
   socket_initialize_(context_, type_),
@@ -34,30 +42,24 @@ MultiClient::MultiClient(
   socket_update_entity_status_(context_, type_),
   socket_attach_lidar_sensor_(context_, type_),
   socket_attach_detection_sensor_(context_, type_),
-  socket_update_traffic_lights_(context_, type_)
-{
-  socket_initialize_.connect(
-    simulation_interface::getEndPoint(protocol, hostname, simulation_interface::ports::initialize));
-  socket_update_frame_.connect(simulation_interface::getEndPoint(
-    protocol, hostname, simulation_interface::ports::update_frame));
-  socket_update_sensor_frame_.connect(simulation_interface::getEndPoint(
-    protocol, hostname, simulation_interface::ports::update_sensor_frame));
-  socket_spawn_vehicle_entity_.connect(simulation_interface::getEndPoint(
-    protocol, hostname, simulation_interface::ports::spawn_vehicle_entity));
-  socket_spawn_pedestrian_entity_.connect(simulation_interface::getEndPoint(
-    protocol, hostname, simulation_interface::ports::spawn_pedestrian_entity));
-  socket_spawn_misc_object_entity_.connect(simulation_interface::getEndPoint(
-    protocol, hostname, simulation_interface::ports::spawn_misc_object_entity));
-  socket_despawn_entity_.connect(simulation_interface::getEndPoint(
-    protocol, hostname, simulation_interface::ports::despawn_entity));
-  socket_update_entity_status_.connect(simulation_interface::getEndPoint(
-    protocol, hostname, simulation_interface::ports::update_entity_status));
-  socket_attach_lidar_sensor_.connect(simulation_interface::getEndPoint(
-    protocol, hostname, simulation_interface::ports::attach_lidar_sensor));
-  socket_attach_detection_sensor_.connect(simulation_interface::getEndPoint(
-    protocol, hostname, simulation_interface::ports::attach_detection_sensor));
-  socket_update_traffic_lights_.connect(simulation_interface::getEndPoint(
-    protocol, hostname, simulation_interface::ports::update_traffic_lights));
+  socket_update_traffic_lights_(context_, type_),
+  socket_simulate_frame_(context_, type_)
+{
+  const auto connect = [this](zmqpp::socket & socket, unsigned int port) {
+    socket.connect(simulation_interface::getEndPoint(this->protocol, this->hostname, port));
+  };
+  connect(socket_initialize_, simulation_interface::ports::initialize);
+  connect(socket_update_frame_, simulation_interface::ports::update_frame);
+  connect(socket_update_sensor_frame_, simulation_interface::ports::update_sensor_frame);
+  connect(socket_spawn_vehicle_entity_, simulation_interface::ports::spawn_vehicle_entity);
+  connect(socket_spawn_pedestrian_entity_, simulation_interface::ports::spawn_pedestrian_entity);
+  connect(socket_spawn_misc_object_entity_, simulation_interface::ports::spawn_misc_object_entity);
+  connect(socket_despawn_entity_, simulation_interface::ports::despawn_entity);
+  connect(socket_update_entity_status_, simulation_interface::ports::update_entity_status);
+  connect(socket_attach_lidar_sensor_, simulation_interface::ports::attach_lidar_sensor);
+  connect(socket_attach_detection_sensor_, simulation_interface::ports::attach_detection_sensor);
+  connect(socket_update_traffic_lights_, simulation_interface::ports::update_traffic_lights);
+  connect(socket_simulate_frame_, simulation_interface::ports::simulate_frame);
 }
 
 MultiClient::~MultiClient()
@@ -73,116 +75,120 @@ MultiClient::~MultiClient()
   socket_attach_lidar_sensor_.close();
   socket_attach_detection_sensor_.close();
   socket_update_traffic_lights_.close();
+  socket_simulate_frame_.close();
+}
+
+template <typename Request, typename Response>
+void MultiClient::exchange(zmqpp::socket & socket, const Request & req, Response & res)
+{
+  /**
+   * @note The framing of the SHARED_MEMORY transport is described in MultiServer::reply. The
+   * segment is always named, so that the server can put a large response in it even if the
+   * request was small.
+   */
+  if (!shared_memory_) {
+    zmqpp::message message = toZMQ(req);
+    socket.send(message);
+  } else {
+    const auto size = req.ByteSizeLong();
+    const auto area = shared_memory_->requestArea();
+    zmqpp::message message;
+    if (size < simulation_interface::shared_memory_threshold || size > area.second) {
+      std::string serialized_str;
+      req.SerializeToString(&serialized_str);
+      message << serialized_str << shared_memory_->name() << static_cast<std::uint64_t>(0);
+    } else {
+      req.SerializeToArray(shared_memory_->data() + area.first, size);
+      message << std::string() << shared_memory_->name() << static_cast<std::uint64_t>(size);
+    }
+    socket.send(message);
+  }
+  zmqpp::message buffer;
+  socket.receive(buffer);
+  if (buffer.parts() == 2 && shared_memory_) {
+    std::uint64_t size = 0;
+    buffer.get(size, 1);
+    const auto area = shared_memory_->responseArea();
+    if (size > area.second) {
+      THROW_SIMULATION_ERROR("response of ", size, " bytes overflows shared memory");
+    }
+    res = Response();
+    res.ParseFromArray(shared_memory_->data() + area.first, size);
+  } else {
+    res = toProto<Response>(buffer);
+  }
 }
 
 void MultiClient::call(
   const simulation_api_schema::InitializeRequest & req,
   simulation_api_schema::InitializeResponse & res)
 {
-  zmqpp::message message = toZMQ(req);
-  socket_initialize_.send(message);
-  zmqpp::message buffer;
-  socket_initialize_.receive(buffer);
-  res = toProto<simulation_api_schema::InitializeResponse>(buffer);
+  exchange(socket_initialize_, req, res);
 }
 void MultiClient::call(
   const simulation_api_schema::UpdateFrameRequest & req,
   simulation_api_schema::UpdateFrameResponse & res)
 {
-  zmqpp::message message = toZMQ(req);
-  socket_update_frame_.send(message);
-  zmqpp::message buffer;
-  socket_update_frame_.receive(buffer);
-  res = toProto<simulation_api_schema::UpdateFrameResponse>(buffer);
+  exchange(socket_update_frame_, req, res);
 }
 void MultiClient::call(
   const simulation_api_schema::UpdateSensorFrameRequest & req,
   simulation_api_schema::UpdateSensorFrameResponse & res)
 {
-  zmqpp::message message = toZMQ(req);
-  socket_update_sensor_frame_.send(message);
-  zmqpp::message buffer;
-  socket_update_sensor_frame_.receive(buffer);
-  res = toProto<simulation_api_schema::UpdateSensorFrameResponse>(buffer);
+  exchange(socket_update_sensor_frame_, req, res);
 }
 void MultiClient::call(
   const simulation_api_schema::SpawnVehicleEntityRequest & req,
   simulation_api_schema::SpawnVehicleEntityResponse & res)
 {
-  zmqpp::message message = toZMQ(req);
-  socket_spawn_vehicle_entity_.send(message);
-  zmqpp::message buffer;
-  socket_spawn_vehicle_entity_.receive(buffer);
-  res = toProto<simulation_api_schema::SpawnVehicleEntityResponse>(buffer);
+  exchange(socket_spawn_vehicle_entity_, req, res);
 }
 void MultiClient::call(
   const simulation_api_schema::SpawnPedestrianEntityRequest & req,
   simulation_api_schema::SpawnPedestrianEntityResponse & res)
 {
-  zmqpp::message message = toZMQ(req);
-  socket_spawn_pedestrian_entity_.send(message);
-  zmqpp::message buffer;
-  socket_spawn_pedestrian_entity_.receive(buffer);
-  res = toProto<simulation_api_schema::SpawnPedestrianEntityResponse>(buffer);
+  exchange(socket_spawn_pedestrian_entity_, req, res);
 }
 void MultiClient::call(
   const simulation_api_schema::SpawnMiscObjectEntityRequest & req,
   simulation_api_schema::SpawnMiscObjectEntityResponse & res)
 {
-  zmqpp::message message = toZMQ(req);
-  socket_spawn_misc_object_entity_.send(message);
-  zmqpp::message buffer;
-  socket_spawn_misc_object_entity_.receive(buffer);
-  res = toProto<simulation_api_schema::SpawnMiscObjectEntityResponse>(buffer);
+  exchange(socket_spawn_misc_object_entity_, req, res);
 }
 void MultiClient::call(
   const simulation_api_schema::DespawnEntityRequest & req,
   simulation_api_schema::DespawnEntityResponse & res)
 {
-  zmqpp::message message = toZMQ(req);
-  socket_despawn_entity_.send(message);
-  zmqpp::message buffer;
-  socket_despawn_entity_.receive(buffer);
-  res = toProto<simulation_api_schema::DespawnEntityResponse>(buffer);
+  exchange(socket_despawn_entity_, req, res);
 }
 void MultiClient::call(
   const simulation_api_schema::UpdateEntityStatusRequest & req,
   simulation_api_schema::UpdateEntityStatusResponse & res)
 {
-  zmqpp::message message = toZMQ(req);
-  socket_update_entity_status_.send(message);
-  zmqpp::message buffer;
-  socket_update_entity_status_.receive(buffer);
-  res = toProto<simulation_api_schema::UpdateEntityStatusResponse>(buffer);
+  exchange(socket_update_entity_status_, req, res);
 }
 void MultiClient::call(
   const simulation_api_schema::AttachLidarSensorRequest & req,
   simulation_api_schema::AttachLidarSensorResponse & res)
 {
-  zmqpp::message message = toZMQ(req);
-  socket_attach_lidar_sensor_.send(message);
-  zmqpp::message buffer;
-  socket_attach_lidar_sensor_.receive(buffer);
-  res = toProto<simulation_api_schema::AttachLidarSensorResponse>(buffer);
+  exchange(socket_attach_lidar_sensor_, req, res);
 }
 void MultiClient::call(
   const simulation_api_schema::AttachDetectionSensorRequest & req,
   simulation_api_schema::AttachDetectionSensorResponse & res)
 {
-  zmqpp::message message = toZMQ(req);
-  socket_attach_detection_sensor_.send(message);
-  zmqpp::message buffer;
-  socket_attach_detection_sensor_.receive(buffer);
-  res = toProto<simulation_api_schema::AttachDetectionSensorResponse>(buffer);
+  exchange(socket_attach_detection_sensor_, req, res);
 }
 void MultiClient::call(
   const simulation_api_schema::UpdateTrafficLightsRequest & req,
   simulation_api_schema::UpdateTrafficLightsResponse & res)
 {
-  zmqpp::message message = toZMQ(req);
-  socket_update_traffic_lights_.send(message);
-  zmqpp::message buffer;
-  socket_update_traffic_lights_.receive(buffer);
-  res = toProto<simulation_api_schema::UpdateTrafficLightsResponse>(buffer);
+  exchange(socket_update_traffic_lights_, req, res);
+}
+void MultiClient::call(
+  const simulation_api_schema::SimulateFrameRequest & req,
+  simulation_api_schema::SimulateFrameResponse & res)
+{
+  exchange(socket_simulate_frame_, req, res);
 }
 }  // namespace zeromq
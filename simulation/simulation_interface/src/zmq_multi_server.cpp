@@ -12,6 +12,11 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <scenario_simulator_exception/exception.hpp>
+#include <shared_mutex>
 #include <simulation_interface/conversions.hpp>
 #include <simulation_interface/zmq_multi_server.hpp>
 #include <string>
@@ -63,7 +68,8 @@ MultiServer::MultiServer(
   std::function<void(
     const simulation_api_schema::UpdateTrafficLightsRequest &,
     simulation_api_schema::UpdateTrafficLightsResponse &)>
-    update_traffic_lights_func)
+    update_traffic_lights_func,
+  const simulation_interface::ServerMode & mode)
 : context_(zmqpp::context()),
   type_(zmqpp::socket_type::reply),
   initialize_sock_(context_, type_),
@@ -87,150 +93,283 @@ MultiServer::MultiServer(
   attach_detection_sensor_sock_(context_, type_),
   attach_detection_sensor_func_(attach_detection_sensor_func),
   update_traffic_lights_sock_(context_, type_),
-  update_traffic_lights_func_(update_traffic_lights_func)
+  update_traffic_lights_func_(update_traffic_lights_func),
+  simulate_frame_sock_(context_, type_),
+  polling_(mode == simulation_interface::ServerMode::POLLING)
 {
-  initialize_sock_.bind(
-    simulation_interface::getEndPoint(protocol, hostname, simulation_interface::ports::initialize));
-  update_entity_status_sock_.bind(simulation_interface::getEndPoint(
-    protocol, hostname, simulation_interface::ports::update_entity_status));
-  update_frame_sock_.bind(simulation_interface::getEndPoint(
-    protocol, hostname, simulation_interface::ports::update_frame));
-  spawn_vehicle_entity_sock_.bind(simulation_interface::getEndPoint(
-    protocol, hostname, simulation_interface::ports::spawn_vehicle_entity));
-  spawn_pedestrian_entity_sock_.bind(simulation_interface::getEndPoint(
-    protocol, hostname, simulation_interface::ports::spawn_pedestrian_entity));
-  spawn_misc_object_entity_sock_.bind(simulation_interface::getEndPoint(
-    protocol, hostname, simulation_interface::ports::spawn_misc_object_entity));
-  despawn_entity_sock_.bind(simulation_interface::getEndPoint(
-    protocol, hostname, simulation_interface::ports::despawn_entity));
-  update_sensor_frame_sock_.bind(simulation_interface::getEndPoint(
-    protocol, hostname, simulation_interface::ports::update_sensor_frame));
-  attach_lidar_sensor_sock_.bind(simulation_interface::getEndPoint(
-    protocol, hostname, simulation_interface::ports::attach_lidar_sensor));
-  attach_detection_sensor_sock_.bind(simulation_interface::getEndPoint(
-    protocol, hostname, simulation_interface::ports::attach_detection_sensor));
-  update_traffic_lights_sock_.bind(simulation_interface::getEndPoint(
-    protocol, hostname, simulation_interface::ports::update_traffic_lights));
-  poller_.add(initialize_sock_);
-  poller_.add(update_frame_sock_);
-  poller_.add(update_sensor_frame_sock_);
-  poller_.add(spawn_vehicle_entity_sock_);
-  poller_.add(spawn_pedestrian_entity_sock_);
-  poller_.add(spawn_misc_object_entity_sock_);
-  poller_.add(despawn_entity_sock_);
-  poller_.add(update_entity_status_sock_);
-  poller_.add(attach_lidar_sensor_sock_);
-  poller_.add(attach_detection_sensor_sock_);
-  poller_.add(update_traffic_lights_sock_);
-  thread_ = std::thread(&MultiServer::start_poll, this);
+  /**
+   * @note Local transports bind an ipc:// endpoint in addition to the tcp:// one, so clients on
+   * other hosts and clients which fall back to TCP still reach the server.
+   */
+  const auto bind = [&](zmqpp::socket & socket, unsigned int port) {
+    socket.bind(simulation_interface::getEndPoint(
+      simulation_interface::TransportProtocol::TCP, hostname, port));
+    if (protocol != simulation_interface::TransportProtocol::TCP) {
+      socket.bind(simulation_interface::getEndPoint(protocol, hostname, port));
+    }
+  };
+  bind(initialize_sock_, simulation_interface::ports::initialize);
+  bind(update_entity_status_sock_, simulation_interface::ports::update_entity_status);
+  bind(update_frame_sock_, simulation_interface::ports::update_frame);
+  bind(spawn_vehicle_entity_sock_, simulation_interface::ports::spawn_vehicle_entity);
+  bind(spawn_pedestrian_entity_sock_, simulation_interface::ports::spawn_pedestrian_entity);
+  bind(spawn_misc_object_entity_sock_, simulation_interface::ports::spawn_misc_object_entity);
+  bind(despawn_entity_sock_, simulation_interface::ports::despawn_entity);
+  bind(update_sensor_frame_sock_, simulation_interface::ports::update_sensor_frame);
+  bind(attach_lidar_sensor_sock_, simulation_interface::ports::attach_lidar_sensor);
+  bind(attach_detection_sensor_sock_, simulation_interface::ports::attach_detection_sensor);
+  bind(update_traffic_lights_sock_, simulation_interface::ports::update_traffic_lights);
+  bind(simulate_frame_sock_, simulation_interface::ports::simulate_frame);
+  if (mode == simulation_interface::ServerMode::POLLING) {
+    poller_.add(initialize_sock_);
+    poller_.add(update_frame_sock_);
+    poller_.add(update_sensor_frame_sock_);
+    poller_.add(spawn_vehicle_entity_sock_);
+    poller_.add(spawn_pedestrian_entity_sock_);
+    poller_.add(spawn_misc_object_entity_sock_);
+    poller_.add(despawn_entity_sock_);
+    poller_.add(update_entity_status_sock_);
+    poller_.add(attach_lidar_sensor_sock_);
+    poller_.add(attach_detection_sensor_sock_);
+    poller_.add(update_traffic_lights_sock_);
+    poller_.add(simulate_frame_sock_);
+    thread_ = std::thread(&MultiServer::start_poll, this);
+  } else {
+    startWorker(initialize_sock_, initialize_func_);
+    startWorker(update_frame_sock_, update_frame_func_);
+    startWorker(update_sensor_frame_sock_, update_sensor_frame_func_, Access::SHARED);
+    startWorker(spawn_vehicle_entity_sock_, spawn_vehicle_entity_func_);
+    startWorker(spawn_pedestrian_entity_sock_, spawn_pedestrian_entity_func_);
+    startWorker(spawn_misc_object_entity_sock_, spawn_misc_object_entity_func_);
+    startWorker(despawn_entity_sock_, despawn_entity_func_);
+    startWorker(update_entity_status_sock_, update_entity_status_func_);
+    startWorker(attach_lidar_sensor_sock_, attach_lidar_sensor_func_, Access::SHARED);
+    startWorker(attach_detection_sensor_sock_, attach_detection_sensor_func_, Access::SHARED);
+    startWorker(update_traffic_lights_sock_, update_traffic_lights_func_);
+    startWorker(
+      simulate_frame_sock_,
+      std::function<void(
+        const simulation_api_schema::SimulateFrameRequest &,
+        simulation_api_schema::SimulateFrameResponse &)>(
+        [this](const auto & req, auto & res) { simulateFrame(req, res); }));
+  }
 }
 
-MultiServer::~MultiServer() { thread_.join(); }
+MultiServer::~MultiServer()
+{
+  polling_ = false;
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  for (auto & stop_sock : stop_socks_) {
+    stop_sock->send(std::string("stop"));
+  }
+  for (auto & worker : workers_) {
+    worker.join();
+  }
+}
+
+template <typename Request, typename Response>
+void MultiServer::startWorker(
+  zmqpp::socket & socket, const std::function<void(const Request &, Response &)> & handler,
+  const Access access)
+{
+  const auto endpoint = "inproc://stop_" + std::to_string(stop_socks_.size());
+  stop_socks_.emplace_back(std::make_unique<zmqpp::socket>(context_, zmqpp::socket_type::pair));
+  stop_socks_.back()->bind(endpoint);
+  auto stop_sock = std::make_shared<zmqpp::socket>(context_, zmqpp::socket_type::pair);
+  stop_sock->connect(endpoint);
+  workers_.emplace_back([this, &socket, handler, access, stop_sock]() {
+    zmqpp::poller poller;
+    poller.add(socket);
+    poller.add(*stop_sock);
+    while (true) {
+      /**
+       * @note poll returns false without any input only if it is interrupted by a signal.
+       */
+      if (!poller.poll(zmqpp::poller::wait_forever)) {
+        continue;
+      }
+      if (poller.has_input(*stop_sock)) {
+        return;
+      }
+      if (poller.has_input(socket)) {
+        reply<Request, Response>(socket, [&](const Request & req, Response & res) {
+          if (access == Access::SHARED) {
+            std::shared_lock<std::shared_timed_mutex> lock(handler_mutex_);
+            handler(req, res);
+          } else {
+            std::lock_guard<std::shared_timed_mutex> lock(handler_mutex_);
+            handler(req, res);
+          }
+        });
+      }
+    }
+  });
+}
+
+template <typename Request, typename Response, typename Handler>
+void MultiServer::reply(zmqpp::socket & socket, Handler && handler)
+{
+  zmqpp::message request;
+  socket.receive(request);
+  Response response;
+  /**
+   * @note With the SHARED_MEMORY transport, a request has three parts: the payload, the name of
+   * the segment of the client and the size of the payload in its request area, which is 0 if the
+   * payload is in the first part. The response has two parts, an empty one and the size of the
+   * payload in the response area, if it is in the segment.
+   */
+  if (request.parts() != 3) {
+    handler(toProto<Request>(request), response);
+    auto msg = toZMQ(response);
+    socket.send(msg);
+    return;
+  }
+  std::string name;
+  request.get(name, 1);
+  std::uint64_t size = 0;
+  request.get(size, 2);
+  std::shared_ptr<simulation_interface::SharedMemorySegment> segment;
+  try {
+    segment = getSharedMemorySegment(name);
+    Request req;
+    if (size == 0) {
+      req.ParseFromString(request.get(0));
+    } else if (size <= segment->requestArea().second) {
+      req.ParseFromArray(segment->data() + segment->requestArea().first, size);
+    } else {
+      THROW_SIMULATION_ERROR("request of ", size, " bytes overflows shared memory ", name);
+    }
+    handler(req, response);
+  } catch (const common::SimulationError & error) {
+    response = Response();
+    response.mutable_result()->set_success(false);
+    response.mutable_result()->set_description(error.what());
+    auto msg = toZMQ(response);
+    socket.send(msg);
+    return;
+  }
+  const auto response_size = response.ByteSizeLong();
+  const auto area = segment->responseArea();
+  if (
+    response_size < simulation_interface::shared_memory_threshold ||
+    response_size > area.second) {
+    auto msg = toZMQ(response);
+    socket.send(msg);
+  } else {
+    response.SerializeToArray(segment->data() + area.first, response_size);
+    zmqpp::message msg;
+    msg << std::string() << static_cast<std::uint64_t>(response_size);
+    socket.send(msg);
+  }
+}
+
+auto MultiServer::getSharedMemorySegment(const std::string & name)
+  -> std::shared_ptr<simulation_interface::SharedMemorySegment>
+{
+  if (!simulation_interface::SharedMemorySegment::isValidName(name)) {
+    THROW_SIMULATION_ERROR("invalid shared memory name ", name);
+  }
+  std::lock_guard<std::mutex> lock(shared_memory_mutex_);
+  auto iter = shared_memory_segments_.find(name);
+  if (iter == shared_memory_segments_.end()) {
+    /**
+     * @note Clients do not tell the server when they are destroyed, so the segments are forgotten
+     * from time to time to unmap the ones of the destroyed clients. The segments being used are
+     * kept alive by the workers and mapped again by the next request.
+     */
+    if (shared_memory_segments_.size() >= 16) {
+      shared_memory_segments_.clear();
+    }
+    iter = shared_memory_segments_
+             .emplace(name, std::make_shared<simulation_interface::SharedMemorySegment>(name))
+             .first;
+  }
+  return iter->second;
+}
 
 void MultiServer::poll()
 {
   constexpr long timeout_ms = 1L;
   poller_.poll(timeout_ms);
+  using namespace simulation_api_schema;
   if (poller_.has_input(initialize_sock_)) {
-    zmqpp::message request;
-    initialize_sock_.receive(request);
-    simulation_api_schema::InitializeResponse response;
-    initialize_func_(toProto<simulation_api_schema::InitializeRequest>(request), response);
-    auto msg = toZMQ(response);
-    initialize_sock_.send(msg);
+    reply<InitializeRequest, InitializeResponse>(initialize_sock_, initialize_func_);
   }
   if (poller_.has_input(update_frame_sock_)) {
-    zmqpp::message request;
-    update_frame_sock_.receive(request);
-    simulation_api_schema::UpdateFrameResponse response;
-    update_frame_func_(toProto<simulation_api_schema::UpdateFrameRequest>(request), response);
-    auto msg = toZMQ(response);
-    update_frame_sock_.send(msg);
+    reply<UpdateFrameRequest, UpdateFrameResponse>(update_frame_sock_, update_frame_func_);
   }
   if (poller_.has_input(update_sensor_frame_sock_)) {
-    zmqpp::message request;
-    update_sensor_frame_sock_.receive(request);
-    simulation_api_schema::UpdateSensorFrameResponse response;
-    update_sensor_frame_func_(
-      toProto<simulation_api_schema::UpdateSensorFrameRequest>(request), response);
-    auto msg = toZMQ(response);
-    update_sensor_frame_sock_.send(msg);
+    reply<UpdateSensorFrameRequest, UpdateSensorFrameResponse>(
+      update_sensor_frame_sock_, update_sensor_frame_func_);
   }
   if (poller_.has_input(spawn_vehicle_entity_sock_)) {
-    zmqpp::message request;
-    spawn_vehicle_entity_sock_.receive(request);
-    simulation_api_schema::SpawnVehicleEntityResponse response;
-    spawn_vehicle_entity_func_(
-      toProto<simulation_api_schema::SpawnVehicleEntityRequest>(request), response);
-    auto msg = toZMQ(response);
-    spawn_vehicle_entity_sock_.send(msg);
+    reply<SpawnVehicleEntityRequest, SpawnVehicleEntityResponse>(
+      spawn_vehicle_entity_sock_, spawn_vehicle_entity_func_);
   }
   if (poller_.has_input(spawn_pedestrian_entity_sock_)) {
-    zmqpp::message request;
-    spawn_pedestrian_entity_sock_.receive(request);
-    simulation_api_schema::SpawnPedestrianEntityResponse response;
-    spawn_pedestrian_entity_func_(
-      toProto<simulation_api_schema::SpawnPedestrianEntityRequest>(request), response);
-    auto msg = toZMQ(response);
-    spawn_pedestrian_entity_sock_.send(msg);
+    reply<SpawnPedestrianEntityRequest, SpawnPedestrianEntityResponse>(
+      spawn_pedestrian_entity_sock_, spawn_pedestrian_entity_func_);
   }
   if (poller_.has_input(spawn_misc_object_entity_sock_)) {
-    zmqpp::message request;
-    spawn_misc_object_entity_sock_.receive(request);
-    simulation_api_schema::SpawnMiscObjectEntityResponse response;
-    spawn_misc_object_entity_func_(
-      toProto<simulation_api_schema::SpawnMiscObjectEntityRequest>(request), response);
-    auto msg = toZMQ(response);
-    spawn_misc_object_entity_sock_.send(msg);
+    reply<SpawnMiscObjectEntityRequest, SpawnMiscObjectEntityResponse>(
+      spawn_misc_object_entity_sock_, spawn_misc_object_entity_func_);
   }
   if (poller_.has_input(despawn_entity_sock_)) {
-    zmqpp::message request;
-    despawn_entity_sock_.receive(request);
-    simulation_api_schema::DespawnEntityResponse response;
-    despawn_entity_func_(toProto<simulation_api_schema::DespawnEntityRequest>(request), response);
-    auto msg = toZMQ(response);
-    despawn_entity_sock_.send(msg);
+    reply<DespawnEntityRequest, DespawnEntityResponse>(despawn_entity_sock_, despawn_entity_func_);
   }
   if (poller_.has_input(update_entity_status_sock_)) {
-    zmqpp::message request;
-    update_entity_status_sock_.receive(request);
-    simulation_api_schema::UpdateEntityStatusResponse response;
-    update_entity_status_func_(
-      toProto<simulation_api_schema::UpdateEntityStatusRequest>(request), response);
-    auto msg = toZMQ(response);
-    update_entity_status_sock_.send(msg);
+    reply<UpdateEntityStatusRequest, UpdateEntityStatusResponse>(
+      update_entity_status_sock_, update_entity_status_func_);
   }
   if (poller_.has_input(attach_lidar_sensor_sock_)) {
-    zmqpp::message request;
-    attach_lidar_sensor_sock_.receive(request);
-    simulation_api_schema::AttachLidarSensorResponse response;
-    attach_lidar_sensor_func_(
-      toProto<simulation_api_schema::AttachLidarSensorRequest>(request), response);
-    auto msg = toZMQ(response);
-    attach_lidar_sensor_sock_.send(msg);
+    reply<AttachLidarSensorRequest, AttachLidarSensorResponse>(
+      attach_lidar_sensor_sock_, attach_lidar_sensor_func_);
   }
   if (poller_.has_input(attach_detection_sensor_sock_)) {
-    zmqpp::message request;
-    attach_detection_sensor_sock_.receive(request);
-    simulation_api_schema::AttachDetectionSensorResponse response;
-    attach_detection_sensor_func_(
-      toProto<simulation_api_schema::AttachDetectionSensorRequest>(request), response);
-    auto msg = toZMQ(response);
-    attach_detection_sensor_sock_.send(msg);
+    reply<AttachDetectionSensorRequest, AttachDetectionSensorResponse>(
+      attach_detection_sensor_sock_, attach_detection_sensor_func_);
   }
   if (poller_.has_input(update_traffic_lights_sock_)) {
-    zmqpp::message request;
-    update_traffic_lights_sock_.receive(request);
-    simulation_api_schema::UpdateTrafficLightsResponse response;
-    update_traffic_lights_func_(
-      toProto<simulation_api_schema::UpdateTrafficLightsRequest>(request), response);
-    auto msg = toZMQ(response);
-    update_traffic_lights_sock_.send(msg);
+    reply<UpdateTrafficLightsRequest, UpdateTrafficLightsResponse>(
+      update_traffic_lights_sock_, update_traffic_lights_func_);
+  }
+  if (poller_.has_input(simulate_frame_sock_)) {
+    reply<SimulateFrameRequest, SimulateFrameResponse>(
+      simulate_frame_sock_, [this](const auto & req, auto & res) { simulateFrame(req, res); });
+  }
+}
+
+void MultiServer::simulateFrame(
+  const simulation_api_schema::SimulateFrameRequest & req,
+  simulation_api_schema::SimulateFrameResponse & res)
+{
+  res = simulation_api_schema::SimulateFrameResponse();
+  const auto fail = [&res](const simulation_api_schema::Result & result) {
+    *res.mutable_result() = result;
+    res.mutable_result()->set_success(false);
+  };
+  update_frame_func_(req.update_frame(), *res.mutable_update_frame());
+  if (!res.update_frame().result().success()) {
+    return fail(res.update_frame().result());
+  }
+  update_entity_status_func_(req.update_entity_status(), *res.mutable_update_entity_status());
+  if (!res.update_entity_status().result().success()) {
+    return fail(res.update_entity_status().result());
+  }
+  if (req.has_update_traffic_lights()) {
+    update_traffic_lights_func_(req.update_traffic_lights(), *res.mutable_update_traffic_lights());
+  }
+  update_sensor_frame_func_(req.update_sensor_frame(), *res.mutable_update_sensor_frame());
+  if (!res.update_sensor_frame().result().success()) {
+    return fail(res.update_sensor_frame().result());
   }
+  res.mutable_result()->set_success(true);
 }
 void MultiServer::start_poll()
 {
-  while (rclcpp::ok()) {
+  while (rclcpp::ok() && polling_) {
     poll();
   }
 }
@@ -0,0 +1,135 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <simulation_interface/conversions.hpp>
+#include <simulation_interface/entity_status_delta.hpp>
+#include <string>
+#include <vector>
+
+namespace
+{
+/**
+ * @note One entity out of four is parked, so its dynamic fields do not change between frames.
+ */
+std::vector<traffic_simulator_msgs::msg::EntityStatus> makeStatuses(std::size_t size)
+{
+  std::vector<traffic_simulator_msgs::msg::EntityStatus> statuses;
+  for (std::size_t i = 0; i < size; ++i) {
+    traffic_simulator_msgs::msg::EntityStatus status;
+    status.type.type = status.type.VEHICLE;
+    status.subtype.value = status.subtype.CAR;
+    status.name = "npc" + std::to_string(i);
+    status.bounding_box.dimensions.x = 4.0;
+    status.bounding_box.dimensions.y = 1.8;
+    status.bounding_box.dimensions.z = 1.5;
+    status.action_status.current_action = i % 4 == 0 ? "parked" : "follow_lane";
+    status.action_status.twist.linear.x = i % 4 == 0 ? 0 : 10;
+    status.pose.position.x = i;
+    status.pose.orientation.w = 1;
+    status.lanelet_pose.lanelet_id = 34513;
+    status.lanelet_pose.s = i;
+    status.lanelet_pose_valid = true;
+    statuses.emplace_back(status);
+  }
+  return statuses;
+}
+
+void step(std::vector<traffic_simulator_msgs::msg::EntityStatus> & statuses, double time)
+{
+  for (auto & status : statuses) {
+    status.time = time;
+    status.pose.position.x += status.action_status.twist.linear.x * 0.05;
+    status.lanelet_pose.s += status.action_status.twist.linear.x * 0.05;
+  }
+}
+}  // namespace
+
+/**
+ * @brief Encoding and serializing the full entity status of every entity each frame.
+ */
+static void FullEntityStatusPerFrame(benchmark::State & state)
+{
+  auto statuses = makeStatuses(state.range(0));
+  double time = 0;
+  std::size_t bytes = 0;
+  std::string buffer;
+  for (auto _ : state) {
+    step(statuses, time += 0.05);
+    simulation_api_schema::UpdateEntityStatusRequest req;
+    for (const auto & status : statuses) {
+      simulation_interface::toProto(status, *req.add_status());
+    }
+    req.SerializeToString(&buffer);
+    bytes += buffer.size();
+  }
+  state.counters["bytes_per_frame"] =
+    benchmark::Counter(bytes, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(FullEntityStatusPerFrame)->Arg(10)->Arg(100)->Arg(500);
+
+/**
+ * @brief Encoding and serializing only the delta from the previous frame.
+ */
+static void EntityStatusDeltaPerFrame(benchmark::State & state)
+{
+  auto statuses = makeStatuses(state.range(0));
+  simulation_interface::EntityStatusDeltaEncoder encoder;
+  double time = 0;
+  encoder.encode(statuses, time);
+  std::size_t bytes = 0;
+  std::string buffer;
+  for (auto _ : state) {
+    step(statuses, time += 0.05);
+    simulation_api_schema::UpdateEntityStatusRequest req;
+    *req.mutable_status_delta() = encoder.encode(statuses, time);
+    req.SerializeToString(&buffer);
+    bytes += buffer.size();
+  }
+  state.counters["bytes_per_frame"] =
+    benchmark::Counter(bytes, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(EntityStatusDeltaPerFrame)->Arg(10)->Arg(100)->Arg(500);
+
+/**
+ * @brief Parsing and applying the delta on the sensor simulator side.
+ */
+static void EntityStatusDeltaDecodePerFrame(benchmark::State & state)
+{
+  auto statuses = makeStatuses(state.range(0));
+  simulation_interface::EntityStatusDeltaEncoder encoder;
+  simulation_interface::EntityStatusDeltaDecoder decoder;
+  double time = 0;
+  decoder.decode(encoder.encode(statuses, time));
+  std::string buffer;
+  for (auto _ : state) {
+    state.PauseTiming();
+    step(statuses, time += 0.05);
+    simulation_api_schema::UpdateEntityStatusRequest req;
+    *req.mutable_status_delta() = encoder.encode(statuses, time);
+    req.SerializeToString(&buffer);
+    state.ResumeTiming();
+    simulation_api_schema::UpdateEntityStatusRequest received;
+    received.ParseFromString(buffer);
+    if (not decoder.decode(received)) {
+      state.SkipWithError("delta was rejected");
+      break;
+    }
+    benchmark::DoNotOptimize(decoder.getStatus().data());
+  }
+}
+BENCHMARK(EntityStatusDeltaDecodePerFrame)->Arg(10)->Arg(100)->Arg(500);
+
+BENCHMARK_MAIN();
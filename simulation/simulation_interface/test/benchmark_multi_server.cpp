@@ -0,0 +1,103 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <rclcpp/rclcpp.hpp>
+#include <simulation_interface/zmq_multi_client.hpp>
+#include <simulation_interface/zmq_multi_server.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+template <typename Request, typename Response>
+void succeed(const Request &, Response & res)
+{
+  res = Response();
+  res.mutable_result()->set_success(true);
+}
+
+std::unique_ptr<zeromq::MultiServer> makeServer(std::int64_t mode)
+{
+  using namespace simulation_api_schema;
+  return std::make_unique<zeromq::MultiServer>(
+    simulation_interface::protocol, simulation_interface::HostName::ANY,
+    succeed<InitializeRequest, InitializeResponse>,
+    succeed<UpdateFrameRequest, UpdateFrameResponse>,
+    succeed<UpdateSensorFrameRequest, UpdateSensorFrameResponse>,
+    succeed<SpawnVehicleEntityRequest, SpawnVehicleEntityResponse>,
+    succeed<SpawnPedestrianEntityRequest, SpawnPedestrianEntityResponse>,
+    succeed<SpawnMiscObjectEntityRequest, SpawnMiscObjectEntityResponse>,
+    succeed<DespawnEntityRequest, DespawnEntityResponse>,
+    succeed<UpdateEntityStatusRequest, UpdateEntityStatusResponse>,
+    succeed<AttachLidarSensorRequest, AttachLidarSensorResponse>,
+    succeed<AttachDetectionSensorRequest, AttachDetectionSensorResponse>,
+    succeed<UpdateTrafficLightsRequest, UpdateTrafficLightsResponse>,
+    mode ? simulation_interface::ServerMode::EVENT_DRIVEN
+         : simulation_interface::ServerMode::POLLING);
+}
+}  // namespace
+
+/**
+ * @brief Round trip of an empty UpdateFrame request. The server polls if state.range(0) is 0 and
+ * is event driven if it is 1.
+ */
+static void RoundTrip(benchmark::State & state)
+{
+  const auto server = makeServer(state.range(0));
+  zeromq::MultiClient client(
+    simulation_interface::protocol, simulation_interface::HostName::LOCALHOST);
+  const simulation_api_schema::UpdateFrameRequest req;
+  for (auto _ : state) {
+    simulation_api_schema::UpdateFrameResponse res;
+    client.call(req, res);
+    benchmark::DoNotOptimize(res);
+  }
+}
+BENCHMARK(RoundTrip)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief Round trips of UpdateEntityStatus and UpdateSensorFrame requests sent at the same time
+ * by two clients, like an entity update and a sensor update that do not depend on each other.
+ */
+static void ConcurrentRoundTrips(benchmark::State & state)
+{
+  const auto server = makeServer(state.range(0));
+  zeromq::MultiClient entity_client(
+    simulation_interface::protocol, simulation_interface::HostName::LOCALHOST);
+  zeromq::MultiClient sensor_client(
+    simulation_interface::protocol, simulation_interface::HostName::LOCALHOST);
+  for (auto _ : state) {
+    std::thread sensor_thread([&]() {
+      simulation_api_schema::UpdateSensorFrameResponse res;
+      sensor_client.call(simulation_api_schema::UpdateSensorFrameRequest(), res);
+    });
+    simulation_api_schema::UpdateEntityStatusResponse res;
+    entity_client.call(simulation_api_schema::UpdateEntityStatusRequest(), res);
+    sensor_thread.join();
+  }
+}
+BENCHMARK(ConcurrentRoundTrips)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  rclcpp::shutdown();
+  return 0;
+}
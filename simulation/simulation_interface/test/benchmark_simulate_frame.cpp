@@ -0,0 +1,157 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <rclcpp/rclcpp.hpp>
+#include <simulation_interface/zmq_multi_client.hpp>
+#include <simulation_interface/zmq_multi_server.hpp>
+#include <string>
+
+namespace
+{
+template <typename Request, typename Response>
+void succeed(const Request &, Response & res)
+{
+  res = Response();
+  res.mutable_result()->set_success(true);
+}
+
+/**
+ * @note Like the simple sensor simulator, the server only stores the entity status and answers
+ * without any sensor output, so the benchmark measures the transport and serialization only.
+ */
+std::unique_ptr<zeromq::MultiServer> makeServer()
+{
+  using namespace simulation_api_schema;
+  return std::make_unique<zeromq::MultiServer>(
+    simulation_interface::protocol, simulation_interface::HostName::ANY,
+    succeed<InitializeRequest, InitializeResponse>,
+    succeed<UpdateFrameRequest, UpdateFrameResponse>,
+    succeed<UpdateSensorFrameRequest, UpdateSensorFrameResponse>,
+    succeed<SpawnVehicleEntityRequest, SpawnVehicleEntityResponse>,
+    succeed<SpawnPedestrianEntityRequest, SpawnPedestrianEntityResponse>,
+    succeed<SpawnMiscObjectEntityRequest, SpawnMiscObjectEntityResponse>,
+    succeed<DespawnEntityRequest, DespawnEntityResponse>,
+    [](const UpdateEntityStatusRequest & req, UpdateEntityStatusResponse & res) {
+      res = UpdateEntityStatusResponse();
+      for (const auto & status : req.status()) {
+        auto updated_status = res.add_status();
+        updated_status->set_name(status.name());
+        *updated_status->mutable_pose() = status.pose();
+        *updated_status->mutable_action_status() = status.action_status();
+      }
+      res.mutable_result()->set_success(true);
+    },
+    succeed<AttachLidarSensorRequest, AttachLidarSensorResponse>,
+    succeed<AttachDetectionSensorRequest, AttachDetectionSensorResponse>,
+    succeed<UpdateTrafficLightsRequest, UpdateTrafficLightsResponse>);
+}
+
+simulation_api_schema::UpdateEntityStatusRequest makeUpdateEntityStatusRequest(std::size_t size)
+{
+  simulation_api_schema::UpdateEntityStatusRequest req;
+  for (std::size_t i = 0; i < size; ++i) {
+    auto status = req.add_status();
+    status->set_name("npc" + std::to_string(i));
+    status->set_time(1.0);
+    status->mutable_pose()->mutable_position()->set_x(i);
+    status->mutable_pose()->mutable_orientation()->set_w(1.0);
+    status->mutable_action_status()->set_current_action("follow_lane");
+    status->mutable_action_status()->mutable_twist()->mutable_linear()->set_x(10.0);
+    status->mutable_lanelet_pose()->set_lanelet_id(34513);
+    status->mutable_lanelet_pose()->set_s(i);
+    status->set_lanelet_pose_valid(true);
+  }
+  req.set_ego_entity_status_before_update_is_empty(true);
+  return req;
+}
+
+simulation_api_schema::UpdateTrafficLightsRequest makeUpdateTrafficLightsRequest()
+{
+  simulation_api_schema::UpdateTrafficLightsRequest req;
+  auto state = req.add_states();
+  state->set_id(34802);
+  state->add_lamp_states()->set_type(simulation_api_schema::TrafficLightState::LampState::RED);
+  return req;
+}
+}  // namespace
+
+/**
+ * @brief One frame of API::updateFrame with four round trips.
+ */
+static void SeparateFrameRequests(benchmark::State & state)
+{
+  zeromq::MultiClient client(
+    simulation_interface::protocol, simulation_interface::HostName::LOCALHOST);
+  const auto update_entity_status = makeUpdateEntityStatusRequest(state.range(0));
+  const auto update_traffic_lights = makeUpdateTrafficLightsRequest();
+  double time = 0;
+  for (auto _ : state) {
+    simulation_api_schema::UpdateFrameRequest update_frame;
+    update_frame.set_current_time(time);
+    simulation_api_schema::UpdateFrameResponse update_frame_response;
+    client.call(update_frame, update_frame_response);
+    simulation_api_schema::UpdateEntityStatusResponse update_entity_status_response;
+    client.call(update_entity_status, update_entity_status_response);
+    simulation_api_schema::UpdateTrafficLightsResponse update_traffic_lights_response;
+    client.call(update_traffic_lights, update_traffic_lights_response);
+    simulation_api_schema::UpdateSensorFrameRequest update_sensor_frame;
+    update_sensor_frame.set_current_time(time = time + 0.05);
+    simulation_api_schema::UpdateSensorFrameResponse update_sensor_frame_response;
+    client.call(update_sensor_frame, update_sensor_frame_response);
+    benchmark::DoNotOptimize(update_entity_status_response);
+  }
+}
+BENCHMARK(SeparateFrameRequests)->Arg(10)->Arg(100)->Arg(500)->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief One frame of API::updateFrame with a single SimulateFrame round trip.
+ */
+static void SimulateFrameRequest(benchmark::State & state)
+{
+  zeromq::MultiClient client(
+    simulation_interface::protocol, simulation_interface::HostName::LOCALHOST);
+  const auto update_entity_status = makeUpdateEntityStatusRequest(state.range(0));
+  const auto update_traffic_lights = makeUpdateTrafficLightsRequest();
+  double time = 0;
+  for (auto _ : state) {
+    simulation_api_schema::SimulateFrameRequest req;
+    req.mutable_update_frame()->set_current_time(time);
+    *req.mutable_update_entity_status() = update_entity_status;
+    *req.mutable_update_traffic_lights() = update_traffic_lights;
+    req.mutable_update_sensor_frame()->set_current_time(time = time + 0.05);
+    simulation_api_schema::SimulateFrameResponse res;
+    client.call(req, res);
+    benchmark::DoNotOptimize(res);
+  }
+}
+BENCHMARK(SimulateFrameRequest)->Arg(10)->Arg(100)->Arg(500)->Unit(benchmark::kMicrosecond);
+
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  {
+    const auto server = makeServer();
+    benchmark::Initialize(&argc, argv);
+    benchmark::RunSpecifiedBenchmarks();
+    /**
+     * @note The server polls until rclcpp is shut down, so shutdown has to come before it is
+     * destroyed.
+     */
+    rclcpp::shutdown();
+  }
+  return 0;
+}
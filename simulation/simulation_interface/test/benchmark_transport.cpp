@@ -0,0 +1,133 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <rclcpp/rclcpp.hpp>
+#include <simulation_interface/zmq_multi_client.hpp>
+#include <simulation_interface/zmq_multi_server.hpp>
+#include <string>
+
+namespace
+{
+template <typename Request, typename Response>
+void succeed(const Request &, Response & res)
+{
+  res = Response();
+  res.mutable_result()->set_success(true);
+}
+
+/**
+ * @brief Answers with as many entities as the request, like the sensor/dynamics simulator
+ * answering an UpdateEntityStatus request of the traffic simulator.
+ */
+void echo(
+  const simulation_api_schema::UpdateEntityStatusRequest & req,
+  simulation_api_schema::UpdateEntityStatusResponse & res)
+{
+  res = simulation_api_schema::UpdateEntityStatusResponse();
+  for (const auto & status : req.status()) {
+    auto updated = res.add_status();
+    updated->set_name(status.name());
+    *updated->mutable_pose() = status.pose();
+    *updated->mutable_action_status() = status.action_status();
+  }
+  res.mutable_result()->set_success(true);
+}
+
+auto toTransportProtocol(std::int64_t value)
+{
+  return static_cast<simulation_interface::TransportProtocol>(value);
+}
+
+std::unique_ptr<zeromq::MultiServer> makeServer(
+  const simulation_interface::TransportProtocol & protocol)
+{
+  using namespace simulation_api_schema;
+  return std::make_unique<zeromq::MultiServer>(
+    protocol, simulation_interface::HostName::ANY, succeed<InitializeRequest, InitializeResponse>,
+    succeed<UpdateFrameRequest, UpdateFrameResponse>,
+    succeed<UpdateSensorFrameRequest, UpdateSensorFrameResponse>,
+    succeed<SpawnVehicleEntityRequest, SpawnVehicleEntityResponse>,
+    succeed<SpawnPedestrianEntityRequest, SpawnPedestrianEntityResponse>,
+    succeed<SpawnMiscObjectEntityRequest, SpawnMiscObjectEntityResponse>,
+    succeed<DespawnEntityRequest, DespawnEntityResponse>, echo,
+    succeed<AttachLidarSensorRequest, AttachLidarSensorResponse>,
+    succeed<AttachDetectionSensorRequest, AttachDetectionSensorResponse>,
+    succeed<UpdateTrafficLightsRequest, UpdateTrafficLightsResponse>,
+    simulation_interface::ServerMode::EVENT_DRIVEN);
+}
+
+simulation_api_schema::UpdateEntityStatusRequest makeRequest(std::int64_t entity_count)
+{
+  simulation_api_schema::UpdateEntityStatusRequest req;
+  for (std::int64_t i = 0; i < entity_count; ++i) {
+    auto status = req.add_status();
+    status->set_name("entity" + std::to_string(i));
+    status->mutable_pose()->mutable_position()->set_x(i);
+    status->mutable_pose()->mutable_orientation()->set_w(1);
+    status->mutable_action_status()->mutable_twist()->mutable_linear()->set_x(0.1 * i);
+    status->mutable_bounding_box()->mutable_dimensions()->set_x(4.5);
+    status->mutable_bounding_box()->mutable_dimensions()->set_y(2.1);
+    status->mutable_bounding_box()->mutable_dimensions()->set_z(1.8);
+  }
+  return req;
+}
+}  // namespace
+
+/**
+ * @brief Round trip of an UpdateEntityStatus request with state.range(1) entities over the
+ * transport state.range(0), 0 for TCP, 1 for IPC and 2 for SHARED_MEMORY. The time per iteration
+ * is the latency and the bytes per second is the throughput of the request and the response.
+ */
+static void UpdateEntityStatusRoundTrip(benchmark::State & state)
+{
+  const auto protocol = toTransportProtocol(state.range(0));
+  const auto server = makeServer(protocol);
+  zeromq::MultiClient client(protocol, simulation_interface::HostName::LOCALHOST);
+  if (client.protocol != protocol) {
+    state.SkipWithError("transport is not available");
+    return;
+  }
+  const auto req = makeRequest(state.range(1));
+  simulation_api_schema::UpdateEntityStatusResponse first_res;
+  client.call(req, first_res);
+  const auto bytes_per_round_trip = req.ByteSizeLong() + first_res.ByteSizeLong();
+  for (auto _ : state) {
+    simulation_api_schema::UpdateEntityStatusResponse res;
+    client.call(req, res);
+    benchmark::DoNotOptimize(res);
+  }
+  state.SetBytesProcessed(state.iterations() * bytes_per_round_trip);
+  state.SetLabel(simulation_interface::enumToString(protocol));
+}
+BENCHMARK(UpdateEntityStatusRoundTrip)
+  ->Apply([](benchmark::internal::Benchmark * instance) {
+    for (int protocol = 0; protocol < 3; ++protocol) {
+      for (int entity_count : {1, 100, 1000, 10000}) {
+        instance->Args({protocol, entity_count});
+      }
+    }
+  })
+  ->Unit(benchmark::kMicrosecond);
+
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  rclcpp::shutdown();
+  return 0;
+}
@@ -341,6 +341,61 @@ TEST(Conversion, EntityStatus)
   EXPECT_ENTITY_STATUS_EQ(status, proto);
 }
 
+TEST(Conversion, EntityStaticStatus)
+{
+  traffic_simulator_msgs::EntityStaticStatus proto;
+  traffic_simulator_msgs::msg::EntityStatus status;
+  status.type.type = status.type.VEHICLE;
+  status.subtype.value = status.subtype.CAR;
+  status.name = "test";
+  status.bounding_box.center.x = 1.0;
+  status.bounding_box.dimensions.x = 12.3;
+  status.bounding_box.dimensions.y = 3.9;
+  status.bounding_box.dimensions.z = 4.0;
+  status.pose.position.x = 4.0;
+  simulation_interface::toProto(status, proto);
+  EXPECT_EQ(proto.type().type(), traffic_simulator_msgs::EntityType_Enum::EntityType_Enum_VEHICLE);
+  EXPECT_EQ(
+    proto.subtype().value(), traffic_simulator_msgs::EntitySubtype_Enum::EntitySubtype_Enum_CAR);
+  EXPECT_STREQ(status.name.c_str(), proto.name().c_str());
+  EXPECT_BOUNDING_BOX_EQ(status.bounding_box, proto.bounding_box());
+  status = traffic_simulator_msgs::msg::EntityStatus();
+  simulation_interface::toMsg(proto, status);
+  EXPECT_EQ(status.type.type, traffic_simulator_msgs::msg::EntityType::VEHICLE);
+  EXPECT_EQ(status.subtype.value, traffic_simulator_msgs::msg::EntitySubtype::CAR);
+  EXPECT_STREQ(status.name.c_str(), proto.name().c_str());
+  EXPECT_BOUNDING_BOX_EQ(status.bounding_box, proto.bounding_box());
+  EXPECT_DOUBLE_EQ(status.pose.position.x, 0);
+}
+
+TEST(Conversion, EntityDynamicStatus)
+{
+  traffic_simulator_msgs::EntityDynamicStatus proto;
+  traffic_simulator_msgs::msg::EntityStatus status;
+  status.name = "test";
+  status.action_status.current_action = "test";
+  status.action_status.twist.linear.x = 1.0;
+  status.action_status.accel.angular.z = 98;
+  status.pose.position.x = 4.0;
+  status.pose.orientation.w = 10.2;
+  status.lanelet_pose.lanelet_id = 23;
+  status.lanelet_pose.s = 1.0;
+  status.lanelet_pose_valid = false;
+  simulation_interface::toProto(status, proto);
+  EXPECT_ACTION_STATUS_EQ(status.action_status, proto.action_status());
+  EXPECT_POSE_EQ(status.pose, proto.pose());
+  EXPECT_LANELET_POSE_EQ(status.lanelet_pose, proto.lanelet_pose());
+  EXPECT_EQ(status.lanelet_pose_valid, proto.lanelet_pose_valid());
+  status = traffic_simulator_msgs::msg::EntityStatus();
+  status.name = "kept";
+  simulation_interface::toMsg(proto, status);
+  EXPECT_ACTION_STATUS_EQ(status.action_status, proto.action_status());
+  EXPECT_POSE_EQ(status.pose, proto.pose());
+  EXPECT_LANELET_POSE_EQ(status.lanelet_pose, proto.lanelet_pose());
+  EXPECT_FALSE(status.lanelet_pose_valid);
+  EXPECT_STREQ(status.name.c_str(), "kept");
+}
+
 TEST(Conversion, Time)
 {
   builtin_interfaces::Time proto;
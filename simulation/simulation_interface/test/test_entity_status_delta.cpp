@@ -0,0 +1,196 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <simulation_interface/conversions.hpp>
+#include <simulation_interface/entity_status_delta.hpp>
+#include <string>
+#include <vector>
+
+#include "expect_equal_macros.hpp"
+
+namespace
+{
+traffic_simulator_msgs::msg::EntityStatus makeStatus(const std::string & name, double x)
+{
+  traffic_simulator_msgs::msg::EntityStatus status;
+  status.type.type = status.type.VEHICLE;
+  status.subtype.value = status.subtype.CAR;
+  status.time = 1.5;
+  status.name = name;
+  status.bounding_box.dimensions.x = 4.0;
+  status.action_status.current_action = "follow_lane";
+  status.action_status.twist.linear.x = 10;
+  status.pose.position.x = x;
+  status.pose.orientation.w = 1;
+  status.lanelet_pose.lanelet_id = 34513;
+  status.lanelet_pose.s = x;
+  return status;
+}
+
+/**
+ * @note Compares the decoded entity status with the statuses given to the encoder, in order.
+ */
+void expectDecoded(
+  const simulation_interface::EntityStatusDeltaDecoder & decoder,
+  const std::vector<traffic_simulator_msgs::msg::EntityStatus> & expected)
+{
+  ASSERT_EQ(decoder.getStatus().size(), expected.size());
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_ENTITY_STATUS_EQ(expected[i], decoder.getStatus()[i]);
+    EXPECT_EQ(
+      static_cast<int>(expected[i].type.type),
+      static_cast<int>(decoder.getStatus()[i].type().type()));
+  }
+}
+}  // namespace
+
+TEST(EntityStatusDelta, Keyframe)
+{
+  simulation_interface::EntityStatusDeltaEncoder encoder;
+  simulation_interface::EntityStatusDeltaDecoder decoder;
+  const std::vector<traffic_simulator_msgs::msg::EntityStatus> status = {
+    makeStatus("ego", 0), makeStatus("npc", 10)};
+  const auto delta = encoder.encode(status, 1.5);
+  EXPECT_EQ(delta.sequence(), static_cast<std::uint64_t>(1));
+  EXPECT_EQ(delta.base_sequence(), static_cast<std::uint64_t>(0));
+  EXPECT_EQ(delta.spawned_size(), 2);
+  EXPECT_EQ(delta.updated_size(), 2);
+  EXPECT_EQ(delta.despawned_size(), 0);
+  ASSERT_TRUE(decoder.decode(delta));
+  EXPECT_EQ(decoder.sequence(), delta.sequence());
+  expectDecoded(decoder, status);
+}
+
+TEST(EntityStatusDelta, OnlyChangedEntities)
+{
+  simulation_interface::EntityStatusDeltaEncoder encoder;
+  simulation_interface::EntityStatusDeltaDecoder decoder;
+  std::vector<traffic_simulator_msgs::msg::EntityStatus> status = {
+    makeStatus("ego", 0), makeStatus("npc", 10), makeStatus("parked", 20)};
+  ASSERT_TRUE(decoder.decode(encoder.encode(status, 1.5)));
+  status[1].pose.position.x = 11;
+  status[1].lanelet_pose.s = 11;
+  for (auto & each : status) {
+    each.time = 1.55;
+  }
+  const auto delta = encoder.encode(status, 1.55);
+  EXPECT_EQ(delta.base_sequence(), static_cast<std::uint64_t>(1));
+  EXPECT_EQ(delta.spawned_size(), 0);
+  ASSERT_EQ(delta.updated_size(), 1);
+  ASSERT_TRUE(decoder.decode(delta));
+  expectDecoded(decoder, status);
+}
+
+TEST(EntityStatusDelta, SpawnAndDespawn)
+{
+  simulation_interface::EntityStatusDeltaEncoder encoder;
+  simulation_interface::EntityStatusDeltaDecoder decoder;
+  std::vector<traffic_simulator_msgs::msg::EntityStatus> status = {
+    makeStatus("ego", 0), makeStatus("npc", 10), makeStatus("parked", 20)};
+  ASSERT_TRUE(decoder.decode(encoder.encode(status, 1.5)));
+  status.erase(status.begin() + 1);
+  status.emplace_back(makeStatus("pedestrian", 30));
+  const auto delta = encoder.encode(status, 1.5);
+  EXPECT_EQ(delta.despawned_size(), 1);
+  EXPECT_EQ(delta.spawned_size(), 1);
+  EXPECT_EQ(delta.updated_size(), 1);
+  ASSERT_TRUE(decoder.decode(delta));
+  expectDecoded(decoder, status);
+}
+
+TEST(EntityStatusDelta, StaticFieldChanged)
+{
+  simulation_interface::EntityStatusDeltaEncoder encoder;
+  simulation_interface::EntityStatusDeltaDecoder decoder;
+  std::vector<traffic_simulator_msgs::msg::EntityStatus> status = {makeStatus("npc", 10)};
+  ASSERT_TRUE(decoder.decode(encoder.encode(status, 1.5)));
+  status[0].bounding_box.dimensions.x = 12;
+  const auto delta = encoder.encode(status, 1.5);
+  EXPECT_EQ(delta.spawned_size(), 1);
+  EXPECT_EQ(delta.updated_size(), 0);
+  ASSERT_TRUE(decoder.decode(delta));
+  expectDecoded(decoder, status);
+}
+
+TEST(EntityStatusDelta, RejectMismatchedBase)
+{
+  simulation_interface::EntityStatusDeltaEncoder encoder;
+  simulation_interface::EntityStatusDeltaDecoder decoder;
+  std::vector<traffic_simulator_msgs::msg::EntityStatus> status = {makeStatus("npc", 10)};
+  ASSERT_TRUE(decoder.decode(encoder.encode(status, 1.5)));
+  status[0].pose.position.x = 11;
+  encoder.encode(status, 1.55);  // lost on the way
+  status[0].pose.position.x = 12;
+  EXPECT_FALSE(decoder.decode(encoder.encode(status, 1.6)));
+  EXPECT_EQ(decoder.sequence(), static_cast<std::uint64_t>(1));
+  EXPECT_DOUBLE_EQ(decoder.getStatus()[0].pose().position().x(), 10);
+  encoder.reset();
+  const auto keyframe = encoder.encode(status, 1.6);
+  EXPECT_EQ(keyframe.base_sequence(), static_cast<std::uint64_t>(0));
+  ASSERT_TRUE(decoder.decode(keyframe));
+  EXPECT_EQ(decoder.sequence(), encoder.sequence());
+  expectDecoded(decoder, status);
+}
+
+TEST(EntityStatusDelta, TimeOfEachEntity)
+{
+  simulation_interface::EntityStatusDeltaEncoder encoder;
+  simulation_interface::EntityStatusDeltaDecoder decoder;
+  std::vector<traffic_simulator_msgs::msg::EntityStatus> status = {
+    makeStatus("ego", 0), makeStatus("npc", 10)};
+  status[0].time = 1.55;
+  const auto keyframe = encoder.encode(status, 1.5);
+  EXPECT_EQ(keyframe.times_size(), 1);
+  ASSERT_TRUE(decoder.decode(keyframe));
+  expectDecoded(decoder, status);
+  status[0].time = 1.6;
+  status[1].time = 1.55;
+  const auto delta = encoder.encode(status, 1.6);
+  EXPECT_EQ(delta.updated_size(), 0);
+  EXPECT_EQ(delta.times_size(), 1);
+  ASSERT_TRUE(decoder.decode(delta));
+  expectDecoded(decoder, status);
+  simulation_interface::EntityStatusDeltaDecoder full_decoder;
+  simulation_api_schema::UpdateEntityStatusRequest req;
+  for (const auto & each : status) {
+    simulation_interface::toProto(each, *req.add_status());
+  }
+  ASSERT_TRUE(full_decoder.decode(req));
+  ASSERT_EQ(full_decoder.getStatus().size(), decoder.getStatus().size());
+  for (std::size_t i = 0; i < status.size(); ++i) {
+    EXPECT_DOUBLE_EQ(full_decoder.getStatus()[i].time(), decoder.getStatus()[i].time());
+  }
+}
+
+TEST(EntityStatusDelta, FullRequest)
+{
+  simulation_interface::EntityStatusDeltaEncoder encoder;
+  simulation_interface::EntityStatusDeltaDecoder decoder;
+  const std::vector<traffic_simulator_msgs::msg::EntityStatus> status = {makeStatus("npc", 10)};
+  ASSERT_TRUE(decoder.decode(encoder.encode(status, 1.5)));
+  simulation_api_schema::UpdateEntityStatusRequest req;
+  simulation_interface::toProto(makeStatus("ego", 0), *req.add_status());
+  ASSERT_TRUE(decoder.decode(req));
+  EXPECT_EQ(decoder.sequence(), static_cast<std::uint64_t>(0));
+  expectDecoded(decoder, {makeStatus("ego", 0)});
+  EXPECT_FALSE(decoder.decode(encoder.encode(status, 1.55)));
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
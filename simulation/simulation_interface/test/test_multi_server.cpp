@@ -0,0 +1,277 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <rclcpp/rclcpp.hpp>
+#include <simulation_interface/zmq_multi_client.hpp>
+#include <simulation_interface/zmq_multi_server.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+/**
+ * @brief Records the handled requests, and whether a handler ever ran at the same time as an
+ * exclusive one, or as another shared one.
+ */
+class Recorder
+{
+public:
+  template <typename Request, typename Response>
+  auto handler(const std::string & name, bool shared = false)
+  {
+    return [this, name, shared](const Request &, Response & res) {
+      if (shared) {
+        ++active_;
+        if (exclusive_ > 0) {
+          overlapped_ = true;
+        }
+        if (++shared_ > 1) {
+          shared_overlapped_ = true;
+        }
+        /**
+         * @note Waits for another shared handler, so that the test does not depend on timing.
+         */
+        const auto deadline = std::chrono::steady_clock::now() + shared_wait_;
+        while (!shared_overlapped_ && std::chrono::steady_clock::now() < deadline) {
+          std::this_thread::yield();
+        }
+      } else {
+        ++exclusive_;
+        if (++active_ > 1) {
+          overlapped_ = true;
+        }
+      }
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        names_.emplace_back(name);
+      }
+      res = Response();
+      res.mutable_result()->set_success(true);
+      --(shared ? shared_ : exclusive_);
+      --active_;
+    };
+  }
+
+  auto names()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return names_;
+  }
+
+  auto overlapped() const { return overlapped_.load(); }
+
+  auto sharedOverlapped() const { return shared_overlapped_.load(); }
+
+  void waitForSharedHandlers(std::chrono::milliseconds wait) { shared_wait_ = wait; }
+
+private:
+  std::atomic<int> active_{0};
+
+  std::atomic<int> exclusive_{0};
+
+  std::atomic<int> shared_{0};
+
+  std::atomic<bool> overlapped_{false};
+
+  std::atomic<bool> shared_overlapped_{false};
+
+  std::chrono::milliseconds shared_wait_{0};
+
+  std::mutex mutex_;
+
+  std::vector<std::string> names_;
+};
+
+std::unique_ptr<zeromq::MultiServer> makeServer(
+  Recorder & recorder, simulation_interface::ServerMode mode)
+{
+  using namespace simulation_api_schema;
+  return std::make_unique<zeromq::MultiServer>(
+    simulation_interface::protocol, simulation_interface::HostName::ANY,
+    recorder.handler<InitializeRequest, InitializeResponse>("initialize"),
+    recorder.handler<UpdateFrameRequest, UpdateFrameResponse>("update_frame"),
+    recorder.handler<UpdateSensorFrameRequest, UpdateSensorFrameResponse>(
+      "update_sensor_frame", true),
+    recorder.handler<SpawnVehicleEntityRequest, SpawnVehicleEntityResponse>("spawn_vehicle"),
+    recorder.handler<SpawnPedestrianEntityRequest, SpawnPedestrianEntityResponse>(
+      "spawn_pedestrian"),
+    recorder.handler<SpawnMiscObjectEntityRequest, SpawnMiscObjectEntityResponse>(
+      "spawn_misc_object"),
+    recorder.handler<DespawnEntityRequest, DespawnEntityResponse>("despawn"),
+    recorder.handler<UpdateEntityStatusRequest, UpdateEntityStatusResponse>(
+      "update_entity_status"),
+    recorder.handler<AttachLidarSensorRequest, AttachLidarSensorResponse>("attach_lidar", true),
+    recorder.handler<AttachDetectionSensorRequest, AttachDetectionSensorResponse>(
+      "attach_detection", true),
+    recorder.handler<UpdateTrafficLightsRequest, UpdateTrafficLightsResponse>(
+      "update_traffic_lights"),
+    mode);
+}
+
+/**
+ * @brief Sends the requests of a scenario, from spawning an entity to despawning it.
+ */
+void callScenario(zeromq::MultiClient & client)
+{
+  using namespace simulation_api_schema;
+  InitializeResponse initialize;
+  client.call(InitializeRequest(), initialize);
+  EXPECT_TRUE(initialize.result().success());
+  SpawnVehicleEntityResponse spawn;
+  client.call(SpawnVehicleEntityRequest(), spawn);
+  EXPECT_TRUE(spawn.result().success());
+  AttachLidarSensorResponse attach;
+  client.call(AttachLidarSensorRequest(), attach);
+  EXPECT_TRUE(attach.result().success());
+  SimulateFrameRequest simulate_frame_request;
+  simulate_frame_request.mutable_update_traffic_lights();
+  SimulateFrameResponse simulate_frame;
+  client.call(simulate_frame_request, simulate_frame);
+  EXPECT_TRUE(simulate_frame.result().success());
+  DespawnEntityResponse despawn;
+  client.call(DespawnEntityRequest(), despawn);
+  EXPECT_TRUE(despawn.result().success());
+}
+
+const std::vector<std::string> scenario = {
+  "initialize",           "spawn_vehicle",         "attach_lidar",        "update_frame",
+  "update_entity_status", "update_traffic_lights", "update_sensor_frame", "despawn"};
+}  // namespace
+
+TEST(MultiServer, EventDrivenKeepsOrderOfClient)
+{
+  Recorder recorder;
+  const auto server = makeServer(recorder, simulation_interface::ServerMode::EVENT_DRIVEN);
+  zeromq::MultiClient client(
+    simulation_interface::protocol, simulation_interface::HostName::LOCALHOST);
+  callScenario(client);
+  EXPECT_EQ(recorder.names(), scenario);
+}
+
+TEST(MultiServer, PollingKeepsOrderOfClient)
+{
+  Recorder recorder;
+  const auto server = makeServer(recorder, simulation_interface::ServerMode::POLLING);
+  zeromq::MultiClient client(
+    simulation_interface::protocol, simulation_interface::HostName::LOCALHOST);
+  callScenario(client);
+  EXPECT_EQ(recorder.names(), scenario);
+}
+
+/**
+ * @note The clients call different sockets at the same time, so the workers of the sockets
+ * receive concurrently, but an exclusive handler must still run alone.
+ */
+TEST(MultiServer, EventDrivenSerializesExclusiveHandlers)
+{
+  Recorder recorder;
+  const auto server = makeServer(recorder, simulation_interface::ServerMode::EVENT_DRIVEN);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([]() {
+      zeromq::MultiClient client(
+        simulation_interface::protocol, simulation_interface::HostName::LOCALHOST);
+      for (int j = 0; j < 20; ++j) {
+        callScenario(client);
+      }
+    });
+  }
+  for (auto & thread : threads) {
+    thread.join();
+  }
+  EXPECT_FALSE(recorder.overlapped());
+  EXPECT_EQ(recorder.names().size(), 4 * 20 * scenario.size());
+}
+
+/**
+ * @note Sensor handlers of different sockets run at the same time, but never with an exclusive
+ * handler called in between.
+ */
+TEST(MultiServer, EventDrivenRunsSharedHandlersConcurrently)
+{
+  Recorder recorder;
+  recorder.waitForSharedHandlers(std::chrono::seconds(1));
+  const auto server = makeServer(recorder, simulation_interface::ServerMode::EVENT_DRIVEN);
+  std::vector<std::thread> threads;
+  threads.emplace_back([]() {
+    zeromq::MultiClient client(
+      simulation_interface::protocol, simulation_interface::HostName::LOCALHOST);
+    simulation_api_schema::UpdateSensorFrameResponse res;
+    client.call(simulation_api_schema::UpdateSensorFrameRequest(), res);
+    EXPECT_TRUE(res.result().success());
+  });
+  threads.emplace_back([]() {
+    zeromq::MultiClient client(
+      simulation_interface::protocol, simulation_interface::HostName::LOCALHOST);
+    simulation_api_schema::AttachLidarSensorResponse res;
+    client.call(simulation_api_schema::AttachLidarSensorRequest(), res);
+    EXPECT_TRUE(res.result().success());
+  });
+  threads.emplace_back([]() {
+    zeromq::MultiClient client(
+      simulation_interface::protocol, simulation_interface::HostName::LOCALHOST);
+    for (int i = 0; i < 20; ++i) {
+      simulation_api_schema::UpdateEntityStatusResponse res;
+      client.call(simulation_api_schema::UpdateEntityStatusRequest(), res);
+      EXPECT_TRUE(res.result().success());
+    }
+  });
+  for (auto & thread : threads) {
+    thread.join();
+  }
+  EXPECT_TRUE(recorder.sharedOverlapped());
+  EXPECT_FALSE(recorder.overlapped());
+  EXPECT_EQ(recorder.names().size(), 22U);
+}
+
+/**
+ * @note The event driven server waits without a timeout, so it has to be woken up to be
+ * destroyed while rclcpp is still running.
+ */
+TEST(MultiServer, DestroyWhileRunning)
+{
+  for (int i = 0; i < 3; ++i) {
+    Recorder recorder;
+    const auto start = std::chrono::steady_clock::now();
+    {
+      const auto server = makeServer(
+        recorder, i % 2 ? simulation_interface::ServerMode::POLLING
+                        : simulation_interface::ServerMode::EVENT_DRIVEN);
+      zeromq::MultiClient client(
+        simulation_interface::protocol, simulation_interface::HostName::LOCALHOST);
+      simulation_api_schema::UpdateFrameResponse res;
+      client.call(simulation_api_schema::UpdateFrameRequest(), res);
+      EXPECT_TRUE(res.result().success());
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+    EXPECT_TRUE(rclcpp::ok());
+  }
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  rclcpp::init(argc, argv);
+  const auto result = RUN_ALL_TESTS();
+  rclcpp::shutdown();
+  return result;
+}
@@ -0,0 +1,100 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <simulation_interface/thread_pool.hpp>
+#include <vector>
+
+TEST(ThreadPool, CallsEachIndexOnce)
+{
+  for (const std::size_t size : {0, 1, 2, 4, 8}) {
+    simulation_interface::ThreadPool pool(size);
+    EXPECT_EQ(pool.size(), std::max<std::size_t>(size, 1));
+    for (int repeat = 0; repeat < 100; ++repeat) {
+      std::vector<int> calls(37, 0);
+      pool.parallelFor(calls.size(), [&](std::size_t i) { ++calls[i]; });
+      EXPECT_EQ(calls, std::vector<int>(calls.size(), 1));
+    }
+    pool.parallelFor(0, [](std::size_t) { FAIL(); });
+  }
+}
+
+TEST(ThreadPool, RunsConcurrently)
+{
+  simulation_interface::ThreadPool pool(4);
+  std::atomic<int> waiting{0};
+  pool.parallelFor(4, [&](std::size_t) {
+    ++waiting;
+    while (waiting < 4) {
+      std::this_thread::yield();
+    }
+  });
+  EXPECT_EQ(waiting, 4);
+}
+
+/**
+ * @note on_calling_thread is meant for work which must not leave the calling thread, so it must run
+ * there, whether the pool has workers or not.
+ */
+TEST(ThreadPool, RunsOnCallingThread)
+{
+  for (const std::size_t size : {1, 4}) {
+    simulation_interface::ThreadPool pool(size);
+    std::thread::id calling_thread_id;
+    std::vector<int> calls(16, 0);
+    pool.parallelFor(
+      calls.size(), [&](std::size_t i) { ++calls[i]; },
+      [&]() { calling_thread_id = std::this_thread::get_id(); });
+    EXPECT_EQ(calling_thread_id, std::this_thread::get_id());
+    EXPECT_EQ(calls, std::vector<int>(calls.size(), 1));
+  }
+}
+
+TEST(ThreadPool, RethrowsErrorOfSmallestIndex)
+{
+  simulation_interface::ThreadPool pool(4);
+  try {
+    pool.parallelFor(16, [](std::size_t i) {
+      if (i == 5 || i == 11) {
+        throw std::runtime_error(std::to_string(i));
+      }
+    });
+    FAIL();
+  } catch (const std::runtime_error & error) {
+    EXPECT_STREQ(error.what(), "5");
+  }
+  try {
+    pool.parallelFor(
+      16, [](std::size_t) { throw std::runtime_error("index"); },
+      []() { throw std::runtime_error("calling thread"); });
+    FAIL();
+  } catch (const std::runtime_error & error) {
+    EXPECT_STREQ(error.what(), "calling thread");
+  }
+  std::vector<int> calls(8, 0);
+  pool.parallelFor(calls.size(), [&](std::size_t i) { ++calls[i]; });
+  EXPECT_EQ(calls, std::vector<int>(calls.size(), 1));
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
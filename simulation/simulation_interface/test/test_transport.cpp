@@ -0,0 +1,257 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <memory>
+#include <rclcpp/rclcpp.hpp>
+#include <scenario_simulator_exception/exception.hpp>
+#include <simulation_interface/shared_memory.hpp>
+#include <simulation_interface/zmq_multi_client.hpp>
+#include <simulation_interface/zmq_multi_server.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+template <typename Request, typename Response>
+void succeed(const Request &, Response & res)
+{
+  res = Response();
+  res.mutable_result()->set_success(true);
+}
+
+/**
+ * @brief Answers an UpdateEntityStatus request with the poses of all its entities, so that large
+ * requests get large responses.
+ */
+void echo(
+  const simulation_api_schema::UpdateEntityStatusRequest & req,
+  simulation_api_schema::UpdateEntityStatusResponse & res)
+{
+  res = simulation_api_schema::UpdateEntityStatusResponse();
+  for (const auto & status : req.status()) {
+    auto updated = res.add_status();
+    updated->set_name(status.name());
+    *updated->mutable_pose() = status.pose();
+    *updated->mutable_action_status() = status.action_status();
+  }
+  res.mutable_result()->set_success(true);
+}
+
+std::unique_ptr<zeromq::MultiServer> makeServer(
+  const simulation_interface::TransportProtocol & protocol,
+  const simulation_interface::ServerMode & mode = simulation_interface::ServerMode::EVENT_DRIVEN)
+{
+  using namespace simulation_api_schema;
+  return std::make_unique<zeromq::MultiServer>(
+    protocol, simulation_interface::HostName::ANY, succeed<InitializeRequest, InitializeResponse>,
+    succeed<UpdateFrameRequest, UpdateFrameResponse>,
+    succeed<UpdateSensorFrameRequest, UpdateSensorFrameResponse>,
+    succeed<SpawnVehicleEntityRequest, SpawnVehicleEntityResponse>,
+    succeed<SpawnPedestrianEntityRequest, SpawnPedestrianEntityResponse>,
+    succeed<SpawnMiscObjectEntityRequest, SpawnMiscObjectEntityResponse>,
+    succeed<DespawnEntityRequest, DespawnEntityResponse>, echo,
+    succeed<AttachLidarSensorRequest, AttachLidarSensorResponse>,
+    succeed<AttachDetectionSensorRequest, AttachDetectionSensorResponse>,
+    succeed<UpdateTrafficLightsRequest, UpdateTrafficLightsResponse>, mode);
+}
+
+simulation_api_schema::UpdateEntityStatusRequest makeRequest(std::size_t entity_count)
+{
+  simulation_api_schema::UpdateEntityStatusRequest req;
+  for (std::size_t i = 0; i < entity_count; ++i) {
+    auto status = req.add_status();
+    status->set_name("entity" + std::to_string(i));
+    status->mutable_pose()->mutable_position()->set_x(i);
+    status->mutable_pose()->mutable_position()->set_y(-0.5 * i);
+    status->mutable_pose()->mutable_orientation()->set_w(1);
+    status->mutable_action_status()->mutable_twist()->mutable_linear()->set_x(0.1 * i);
+    status->mutable_bounding_box()->mutable_dimensions()->set_x(4.5);
+    status->mutable_bounding_box()->mutable_dimensions()->set_y(2.1);
+    status->mutable_bounding_box()->mutable_dimensions()->set_z(1.8);
+  }
+  return req;
+}
+
+void expectEcho(
+  const simulation_api_schema::UpdateEntityStatusRequest & req,
+  const simulation_api_schema::UpdateEntityStatusResponse & res)
+{
+  EXPECT_TRUE(res.result().success());
+  ASSERT_EQ(res.status_size(), req.status_size());
+  for (int i = 0; i < req.status_size(); ++i) {
+    EXPECT_EQ(res.status(i).name(), req.status(i).name());
+    EXPECT_DOUBLE_EQ(res.status(i).pose().position().x(), req.status(i).pose().position().x());
+    EXPECT_DOUBLE_EQ(res.status(i).pose().position().y(), req.status(i).pose().position().y());
+    EXPECT_DOUBLE_EQ(
+      res.status(i).action_status().twist().linear().x(),
+      req.status(i).action_status().twist().linear().x());
+  }
+}
+}  // namespace
+
+class Transport : public testing::TestWithParam<simulation_interface::TransportProtocol>
+{
+};
+
+TEST_P(Transport, SmallPayload)
+{
+  const auto server = makeServer(GetParam());
+  zeromq::MultiClient client(GetParam(), simulation_interface::HostName::LOCALHOST);
+  EXPECT_EQ(client.protocol, GetParam());
+  const auto req = makeRequest(1);
+  simulation_api_schema::UpdateEntityStatusResponse res;
+  client.call(req, res);
+  expectEcho(req, res);
+}
+
+/**
+ * @note 500 entities are far above the shared memory threshold, so the SHARED_MEMORY transport
+ * passes both the request and the response through the segment.
+ */
+TEST_P(Transport, LargePayload)
+{
+  const auto server = makeServer(GetParam());
+  zeromq::MultiClient client(GetParam(), simulation_interface::HostName::LOCALHOST);
+  const auto req = makeRequest(500);
+  ASSERT_GT(req.ByteSizeLong(), simulation_interface::shared_memory_threshold);
+  for (int i = 0; i < 3; ++i) {
+    simulation_api_schema::UpdateEntityStatusResponse res;
+    client.call(req, res);
+    expectEcho(req, res);
+  }
+}
+
+/**
+ * @note Alternates small and large payloads, so that a stale payload left in the segment would be
+ * read as the response of a small request.
+ */
+TEST_P(Transport, AlternatingPayloads)
+{
+  const auto server = makeServer(GetParam(), simulation_interface::ServerMode::POLLING);
+  zeromq::MultiClient client(GetParam(), simulation_interface::HostName::LOCALHOST);
+  for (std::size_t entity_count : {500, 0, 2, 700, 1}) {
+    const auto req = makeRequest(entity_count);
+    simulation_api_schema::UpdateEntityStatusResponse res;
+    client.call(req, res);
+    expectEcho(req, res);
+  }
+}
+
+TEST_P(Transport, ConcurrentClients)
+{
+  const auto server = makeServer(GetParam());
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([i, protocol = GetParam()]() {
+      zeromq::MultiClient client(protocol, simulation_interface::HostName::LOCALHOST);
+      const auto req = makeRequest(100 * (i + 1));
+      for (int j = 0; j < 10; ++j) {
+        simulation_api_schema::UpdateEntityStatusResponse res;
+        client.call(req, res);
+        expectEcho(req, res);
+      }
+    });
+  }
+  for (auto & thread : threads) {
+    thread.join();
+  }
+}
+
+/**
+ * @note A TCP server does not bind the ipc:// endpoint, so clients asking for local transports
+ * fall back to TCP instead of waiting forever.
+ */
+TEST_P(Transport, FallBackToTcp)
+{
+  const auto server = makeServer(simulation_interface::TransportProtocol::TCP);
+  zeromq::MultiClient client(GetParam(), simulation_interface::HostName::LOCALHOST);
+  EXPECT_EQ(client.protocol, simulation_interface::TransportProtocol::TCP);
+  const auto req = makeRequest(500);
+  simulation_api_schema::UpdateEntityStatusResponse res;
+  client.call(req, res);
+  expectEcho(req, res);
+}
+
+INSTANTIATE_TEST_CASE_P(
+  Protocols, Transport,
+  testing::Values(
+    simulation_interface::TransportProtocol::TCP, simulation_interface::TransportProtocol::IPC,
+    simulation_interface::TransportProtocol::SHARED_MEMORY));
+
+TEST(TransportProtocol, RemoteHostUsesTcp)
+{
+  EXPECT_EQ(
+    simulation_interface::resolveTransportProtocol(
+      simulation_interface::TransportProtocol::SHARED_MEMORY, simulation_interface::HostName::ANY),
+    simulation_interface::TransportProtocol::TCP);
+}
+
+TEST(TransportProtocol, ToTransportProtocol)
+{
+  EXPECT_EQ(
+    simulation_interface::toTransportProtocol("tcp"), simulation_interface::TransportProtocol::TCP);
+  EXPECT_EQ(
+    simulation_interface::toTransportProtocol("ipc"), simulation_interface::TransportProtocol::IPC);
+  EXPECT_EQ(
+    simulation_interface::toTransportProtocol("shared_memory"),
+    simulation_interface::TransportProtocol::SHARED_MEMORY);
+  EXPECT_THROW(simulation_interface::toTransportProtocol("udp"), common::SemanticError);
+}
+
+TEST(SharedMemorySegment, SharedBetweenMappings)
+{
+  const auto name = simulation_interface::SharedMemorySegment::makeUniqueName();
+  EXPECT_TRUE(simulation_interface::SharedMemorySegment::isValidName(name));
+  simulation_interface::SharedMemorySegment owner(name, 4096);
+  {
+    simulation_interface::SharedMemorySegment mapping(name);
+    EXPECT_EQ(mapping.size(), owner.size());
+    std::strcpy(mapping.data() + mapping.responseArea().first, "response");
+    std::strcpy(owner.data() + owner.requestArea().first, "request");
+    EXPECT_STREQ(owner.data() + owner.responseArea().first, "response");
+    EXPECT_STREQ(mapping.data() + mapping.requestArea().first, "request");
+  }
+  EXPECT_STREQ(owner.data() + owner.responseArea().first, "response");
+  EXPECT_GE(owner.responseArea().first, owner.requestArea().first + owner.requestArea().second);
+  EXPECT_LE(owner.responseArea().first + owner.responseArea().second, owner.size());
+}
+
+TEST(SharedMemorySegment, RemovedByOwner)
+{
+  const auto name = simulation_interface::SharedMemorySegment::makeUniqueName();
+  { simulation_interface::SharedMemorySegment owner(name, 4096); }
+  EXPECT_THROW(simulation_interface::SharedMemorySegment mapping(name), common::SimulationError);
+}
+
+TEST(SharedMemorySegment, InvalidNames)
+{
+  EXPECT_FALSE(simulation_interface::SharedMemorySegment::isValidName(""));
+  EXPECT_FALSE(simulation_interface::SharedMemorySegment::isValidName("/dev/shm/other"));
+  EXPECT_FALSE(simulation_interface::SharedMemorySegment::isValidName("/other"));
+  EXPECT_FALSE(
+    simulation_interface::SharedMemorySegment::isValidName("/simulation_interface_../other"));
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  rclcpp::init(argc, argv);
+  const auto result = RUN_ALL_TESTS();
+  rclcpp::shutdown();
+  return result;
+}
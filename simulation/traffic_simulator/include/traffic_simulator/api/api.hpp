@@ -24,6 +24,7 @@
 #include <memory>
 #include <rclcpp/rclcpp.hpp>
 #include <rosgraph_msgs/msg/clock.hpp>
+#include <simulation_interface/entity_status_delta.hpp>
 #include <simulation_interface/zmq_multi_client.hpp>
 #include <stdexcept>
 #include <string>
@@ -74,7 +75,7 @@ public:
       rclcpp::PublisherOptionsWithAllocator<AllocatorT>())),
     debug_marker_pub_(rclcpp::create_publisher<visualization_msgs::msg::MarkerArray>(
       node, "debug_marker", rclcpp::QoS(100), rclcpp::PublisherOptionsWithAllocator<AllocatorT>())),
-    zeromq_client_(simulation_interface::protocol, simulation_interface::HostName::LOCALHOST)
+    zeromq_client_(configuration.transport_protocol, simulation_interface::HostName::LOCALHOST)
   {
     metrics_manager_.setEntityManager(entity_manager_ptr_);
     setVerbose(configuration.verbose);
@@ -222,6 +223,14 @@ private:
   bool updateSensorFrame();
   bool updateEntityStatusInSim();
   bool updateTrafficLightsInSim();
+  bool simulateFrameInSim();
+
+  auto makeUpdateSensorFrameRequest(double current_time, const rclcpp::Time & current_ros_time)
+    const -> simulation_api_schema::UpdateSensorFrameRequest;
+  auto makeUpdateEntityStatusRequest(double current_time)
+    -> simulation_api_schema::UpdateEntityStatusRequest;
+  auto makeUpdateTrafficLightsRequest() const -> simulation_api_schema::UpdateTrafficLightsRequest;
+  void applyUpdateEntityStatusResponse(const simulation_api_schema::UpdateEntityStatusResponse &);
 
   const Configuration configuration;
 
@@ -238,6 +247,8 @@ private:
   traffic_simulator::SimulationClock clock_;
 
   zeromq::MultiClient zeromq_client_;
+
+  simulation_interface::EntityStatusDeltaEncoder entity_status_encoder_;
 };
 }  // namespace traffic_simulator
 
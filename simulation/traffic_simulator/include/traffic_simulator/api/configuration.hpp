@@ -22,6 +22,7 @@
 #include <boost/range/iterator_range.hpp>
 #include <iomanip>
 #include <scenario_simulator_exception/exception.hpp>
+#include <simulation_interface/constants.hpp>
 #include <string>
 
 namespace traffic_simulator
@@ -63,6 +64,87 @@ struct Configuration
 
   Pathname metrics_log_path = "/tmp/metrics.json";
 
+  /* ---- NOTE -----------------------------------------------------------------
+   *
+   *  Directory to store lanelet maps that were already projected and had their
+   *  fine centerlines generated. The entries are keyed by the content hash of
+   *  the .osm file, so it is safe to share this directory between maps. If
+   *  empty, the map is parsed from the .osm file on every launch.
+   *
+   * ------------------------------------------------------------------------ */
+  Pathname precompiled_map_path = "";
+
+  /* ---- NOTE -----------------------------------------------------------------
+   *
+   *  Maximum number of routes, lanelet center points and lanelet lengths each
+   *  kept in the caches of HdMapUtils. The least recently used entries are
+   *  computed again from the map when they are needed after being evicted. If
+   *  0, the caches grow until the simulation ends.
+   *
+   * ------------------------------------------------------------------------ */
+  std::size_t hdmap_cache_capacity = 0;
+
+  /* ---- NOTE -----------------------------------------------------------------
+   *
+   *  Maximum distance in meters along the lanes between two lanelets whose
+   *  shortest route is computed when the map is loaded. Routes and
+   *  longitudinal distances between closer lanelets are then looked up
+   *  instead of searched in the routing graph. Loading the map takes longer
+   *  and more memory as this distance grows. If 0, every route is searched
+   *  when it is first needed.
+   *
+   * ------------------------------------------------------------------------ */
+  double route_table_horizon = 0;
+
+  /* ---- NOTE -----------------------------------------------------------------
+   *
+   *  Number of threads used to update the behavior of entities other than the
+   *  ego. With 1, entities are updated one by one on the calling thread. Each
+   *  entity reads only the snapshot of the other entities taken before the
+   *  update and writes only its own status, so the result of a frame does not
+   *  depend on this value. Behavior plugins must be safe to tick
+   *  concurrently to use more than one thread.
+   *
+   * ------------------------------------------------------------------------ */
+  std::size_t npc_update_threads = 1;
+
+  /* ---- NOTE -----------------------------------------------------------------
+   *
+   *  If true, each frame is sent to the sensor simulator as one SimulateFrame
+   *  request instead of the four requests UpdateFrame, UpdateEntityStatus,
+   *  UpdateTrafficLights and UpdateSensorFrame. The sensor simulator must be
+   *  built with the same simulation_interface to answer it, so this is
+   *  disabled by default.
+   *
+   * ------------------------------------------------------------------------ */
+  bool combine_frame_requests = false;
+
+  /* ---- NOTE -----------------------------------------------------------------
+   *
+   *  If true, the entity status is sent to the sensor simulator as the
+   *  difference from the previous frame. Type, subtype, name and bounding box
+   *  are sent only when an entity spawns or they change, and the action
+   *  status, pose and lanelet pose only for entities that changed. When the
+   *  sensor simulator answers with another sequence number than the one sent,
+   *  the whole entity status is sent again. Sensor simulators built with an
+   *  older simulation_interface ignore the difference, so this is disabled by
+   *  default.
+   *
+   * ------------------------------------------------------------------------ */
+  bool entity_status_delta = false;
+
+  /* ---- NOTE -----------------------------------------------------------------
+   *
+   *  Transport used to talk to the sensor simulator. IPC uses Unix domain
+   *  sockets instead of TCP, and SHARED_MEMORY additionally passes large
+   *  payloads through a shared memory segment. Both require the sensor
+   *  simulator to run on the same host with the same transport; otherwise
+   *  TCP is used.
+   *
+   * ------------------------------------------------------------------------ */
+  simulation_interface::TransportProtocol transport_protocol =
+    simulation_interface::TransportProtocol::TCP;
+
   Pathname rviz_config_path =  //
     ament_index_cpp::get_package_share_directory("traffic_simulator") +
     "/config/scenario_simulator_v2.rviz";
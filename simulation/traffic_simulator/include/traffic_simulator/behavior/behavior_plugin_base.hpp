@@ -16,8 +16,11 @@
 #define TRAFFIC_SIMULATOR__BEHAVIOR__BEHAVIOR_PLUGIN_BASE_HPP_
 
 #include <boost/optional.hpp>
+#include <memory>
 #include <string>
 #include <traffic_simulator/data_type/data_types.hpp>
+#include <traffic_simulator/entity/entity_spatial_index.hpp>
+#include <traffic_simulator/entity/entity_status_store.hpp>
 #include <traffic_simulator/hdmap_utils/hdmap_utils.hpp>
 #include <traffic_simulator/traffic_lights/traffic_light_manager.hpp>
 #include <traffic_simulator_msgs/msg/driver_model.hpp>
@@ -41,9 +44,14 @@ public:
   virtual const std::string & getCurrentAction() const = 0;
 
   typedef std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityType> EntityTypeDict;
-  typedef std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityStatus>
-    EntityStatusDict;
+  typedef traffic_simulator::entity::EntityStatusView EntityStatusView;
 
+  /**
+   * @note Every action node reads its inputs from the blackboard in every tick, and the blackboard
+   * returns copies. Values which allocate when copied (containers, messages with strings) are
+   * therefore exchanged as shared immutable snapshots, so the nodes only share them. A snapshot
+   * must not be modified after it is set; set a new one instead.
+   */
 #define DEFINE_GETTER_SETTER(NAME, KEY, TYPE)     \
   virtual TYPE get##NAME() = 0;                   \
   virtual void set##NAME(const TYPE & value) = 0; \
@@ -53,22 +61,23 @@ public:
   DEFINE_GETTER_SETTER(CurrentTime, "current_time", double)
   DEFINE_GETTER_SETTER(DebugMarker, "debug_marker", std::vector<visualization_msgs::msg::Marker>)
   DEFINE_GETTER_SETTER(DriverModel, "driver_model", traffic_simulator_msgs::msg::DriverModel)
-  DEFINE_GETTER_SETTER(EntityStatus, "entity_status", traffic_simulator_msgs::msg::EntityStatus)
-  DEFINE_GETTER_SETTER(EntityTypeList, "entity_type_list", EntityTypeDict)
+  DEFINE_GETTER_SETTER(EntitySpatialIndex, "entity_spatial_index", std::shared_ptr<const traffic_simulator::entity::EntitySpatialIndex>)
+  DEFINE_GETTER_SETTER(EntityStatus, "entity_status", std::shared_ptr<const traffic_simulator_msgs::msg::EntityStatus>)
+  DEFINE_GETTER_SETTER(EntityTypeList, "entity_type_list", std::shared_ptr<const EntityTypeDict>)
   DEFINE_GETTER_SETTER(GoalPoses, "goal_poses", std::vector<geometry_msgs::msg::Pose>)
   DEFINE_GETTER_SETTER(HdMapUtils, "hdmap_utils", std::shared_ptr<hdmap_utils::HdMapUtils>)
   DEFINE_GETTER_SETTER(Obstacle, "obstacle", boost::optional<traffic_simulator_msgs::msg::Obstacle>)
-  DEFINE_GETTER_SETTER(OtherEntityStatus, "other_entity_status", EntityStatusDict)
-  DEFINE_GETTER_SETTER(PedestrianParameters, "pedestrian_parameters", traffic_simulator_msgs::msg::PedestrianParameters)
+  DEFINE_GETTER_SETTER(OtherEntityStatus, "other_entity_status", EntityStatusView)
+  DEFINE_GETTER_SETTER(PedestrianParameters, "pedestrian_parameters", std::shared_ptr<const traffic_simulator_msgs::msg::PedestrianParameters>)
   DEFINE_GETTER_SETTER(Request, "request", std::string)
-  DEFINE_GETTER_SETTER(RouteLanelets, "route_lanelets", std::vector<std::int64_t>)
+  DEFINE_GETTER_SETTER(RouteLanelets, "route_lanelets", std::shared_ptr<const std::vector<std::int64_t>>)
   DEFINE_GETTER_SETTER(ReferenceTrajectory, "reference_trajectory", std::shared_ptr<traffic_simulator::math::CatmullRomSpline>)
   DEFINE_GETTER_SETTER(StepTime, "step_time", double)
   DEFINE_GETTER_SETTER(TargetSpeed, "target_speed", boost::optional<double>)
   DEFINE_GETTER_SETTER(LaneChangeParameters, "lane_change_parameters", traffic_simulator::lane_change::Parameter)
   DEFINE_GETTER_SETTER(TrafficLightManager, "traffic_light_manager", std::shared_ptr<traffic_simulator::TrafficLightManagerBase>)
   DEFINE_GETTER_SETTER(UpdatedStatus, "updated_status", traffic_simulator_msgs::msg::EntityStatus)
-  DEFINE_GETTER_SETTER(VehicleParameters, "vehicle_parameters", traffic_simulator_msgs::msg::VehicleParameters)
+  DEFINE_GETTER_SETTER(VehicleParameters, "vehicle_parameters", std::shared_ptr<const traffic_simulator_msgs::msg::VehicleParameters>)
   DEFINE_GETTER_SETTER(Waypoints, "waypoints", traffic_simulator_msgs::msg::WaypointsArray)
   // clang-format on
 #undef DEFINE_GETTER_SETTER
@@ -17,8 +17,8 @@
 
 #include <boost/optional.hpp>
 #include <traffic_simulator/data_type/data_types.hpp>
+#include <traffic_simulator/entity/entity_status_store.hpp>
 #include <traffic_simulator_msgs/msg/entity_status.hpp>
-#include <unordered_map>
 
 namespace traffic_simulator
 {
@@ -29,17 +29,14 @@ class TargetSpeedPlanner
 public:
   void requestSpeedChange(double target_speed, bool continuous);
   void requestSpeedChange(const speed_change::RelativeTargetSpeed & target_speed, bool continuous);
-  void update(
-    double current_speed,
-    const std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityStatus> &
-      other_status);
+  void update(double current_speed, const entity::EntityStatusView & other_status);
   boost::optional<double> getTargetSpeed() const;
 
 private:
   boost::optional<double> target_speed_;
   boost::optional<speed_change::RelativeTargetSpeed> relative_target_speed_;
   bool continuous_;
-  std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityStatus> other_status_;
+  entity::EntityStatusView other_status_;
 };
 }  // namespace behavior
 }  // namespace traffic_simulator
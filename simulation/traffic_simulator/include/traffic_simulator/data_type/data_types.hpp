@@ -22,6 +22,11 @@
 
 namespace traffic_simulator
 {
+namespace entity
+{
+class EntityStatusView;
+}  // namespace entity
+
 namespace speed_change
 {
 enum class Transition {
@@ -53,9 +58,7 @@ struct RelativeTargetSpeed
   RelativeTargetSpeed(
     const std::string & reference_entity_name, RelativeTargetSpeed::Type type, double value);
   RelativeTargetSpeed(const RelativeTargetSpeed & other);
-  double getAbsoluteValue(
-    const std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityStatus> & other_status)
-    const;
+  double getAbsoluteValue(const entity::EntityStatusView & other_status) const;
   RelativeTargetSpeed & operator=(const RelativeTargetSpeed & val);
   const std::string reference_entity_name;
   const Type type;
@@ -22,6 +22,8 @@
 #include <queue>
 #include <string>
 #include <traffic_simulator/data_type/data_types.hpp>
+#include <traffic_simulator/entity/entity_spatial_index.hpp>
+#include <traffic_simulator/entity/entity_status_store.hpp>
 #include <traffic_simulator/hdmap_utils/hdmap_utils.hpp>
 #include <traffic_simulator/traffic_lights/traffic_light_manager.hpp>
 #include <traffic_simulator_msgs/msg/bounding_box.hpp>
@@ -104,7 +106,8 @@ public:
   virtual void setDecelerationLimit(double deceleration);
 
   /*   */ void setEntityTypeList(
-    const std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityType> &
+    const std::shared_ptr<
+      const std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityType>> &
       entity_type_list)
   {
     entity_type_list_ = entity_type_list;
@@ -115,8 +118,7 @@ public:
     hdmap_utils_ptr_ = ptr;
   }
 
-  /*   */ void setOtherStatus(
-    const std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityStatus> & status);
+  /*   */ void setOtherStatus(const std::shared_ptr<const EntitySpatialIndex> & index);
 
   virtual auto setStatus(const traffic_simulator_msgs::msg::EntityStatus & status) -> bool;
 
@@ -206,8 +208,10 @@ protected:
   bool verbose_;
   bool visibility_;
 
-  std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityStatus> other_status_;
-  std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityType> entity_type_list_;
+  EntityStatusView other_status_;
+  std::shared_ptr<const EntitySpatialIndex> entity_spatial_index_;
+  std::shared_ptr<const std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityType>>
+    entity_type_list_;
 
   boost::optional<double> linear_jerk_;
   boost::optional<double> stand_still_duration_;
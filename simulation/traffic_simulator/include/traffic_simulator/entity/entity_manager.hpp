@@ -26,12 +26,15 @@
 #include <rclcpp/node_interfaces/node_topics_interface.hpp>
 #include <rclcpp/rclcpp.hpp>
 #include <scenario_simulator_exception/exception.hpp>
+#include <simulation_interface/thread_pool.hpp>
 #include <stdexcept>
 #include <string>
 #include <traffic_simulator/api/configuration.hpp>
 #include <traffic_simulator/data_type/data_types.hpp>
 #include <traffic_simulator/entity/ego_entity.hpp>
 #include <traffic_simulator/entity/entity_base.hpp>
+#include <traffic_simulator/entity/entity_spatial_index.hpp>
+#include <traffic_simulator/entity/entity_status_store.hpp>
 #include <traffic_simulator/entity/misc_object_entity.hpp>
 #include <traffic_simulator/entity/pedestrian_entity.hpp>
 #include <traffic_simulator/entity/vehicle_entity.hpp>
@@ -77,6 +80,19 @@ class EntityManager
 
   std::unordered_map<std::string, std::unique_ptr<traffic_simulator::entity::EntityBase>> entities_;
 
+  /**
+   * @note Snapshot of the status of all entities shared with every entity as a read-only view.
+   * It is rebuilt at the beginning and at the end of each update.
+   */
+  std::shared_ptr<const EntityStatusStore> entity_status_store_;
+
+  /**
+   * @note Spatial index of entity_status_store_, rebuilt with it and shared the same way.
+   */
+  std::shared_ptr<const EntitySpatialIndex> entity_spatial_index_;
+
+  std::uint64_t entity_status_frame_ = 0;
+
   double step_time_;
 
   double current_time_;
@@ -94,6 +110,12 @@ class EntityManager
 
   const std::shared_ptr<TrafficLightManagerBase> traffic_light_manager_ptr_;
 
+  /**
+   * @note Created once with Configuration::npc_update_threads threads, including the one calling
+   * update, and reused every frame by updateNpcLogic.
+   */
+  simulation_interface::ThreadPool npc_update_pool_;
+
   using LaneletPose = traffic_simulator_msgs::msg::LaneletPose;
 
 public:
@@ -145,9 +167,11 @@ public:
       node, "lanelet/marker", LaneletMarkerQoS(),
       rclcpp::PublisherOptionsWithAllocator<AllocatorT>())),
     hdmap_utils_ptr_(std::make_shared<hdmap_utils::HdMapUtils>(
-      configuration.lanelet2_map_path(), getOrigin(*node))),
+      configuration.lanelet2_map_path(), getOrigin(*node), configuration.precompiled_map_path,
+      configuration.hdmap_cache_capacity, configuration.route_table_horizon)),
     markers_raw_(hdmap_utils_ptr_->generateMarker()),
-    traffic_light_manager_ptr_(makeTrafficLightManager(hdmap_utils_ptr_, node))
+    traffic_light_manager_ptr_(makeTrafficLightManager(hdmap_utils_ptr_, node)),
+    npc_update_pool_(configuration.npc_update_threads)
   {
     updateHdmapMarker();
   }
@@ -253,7 +277,18 @@ public:
 
   traffic_simulator_msgs::msg::EntityStatus updateNpcLogic(
     const std::string & name,
-    const std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityType> & type_list);
+    const std::shared_ptr<
+      const std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityType>> & type_list);
+
+  /**
+   * @brief Updates the given entities and returns their statuses in the same order. Entities other
+   * than the ego are updated by the threads of npc_update_pool_.
+   */
+  auto updateNpcLogic(
+    const std::vector<std::string> & names,
+    const std::shared_ptr<
+      const std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityType>> & type_list)
+    -> std::vector<traffic_simulator_msgs::msg::EntityStatus>;
 
   void broadcastEntityTransform();
 
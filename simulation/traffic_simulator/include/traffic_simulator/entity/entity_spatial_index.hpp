@@ -0,0 +1,114 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TRAFFIC_SIMULATOR__ENTITY__ENTITY_SPATIAL_INDEX_HPP_
+#define TRAFFIC_SIMULATOR__ENTITY__ENTITY_SPATIAL_INDEX_HPP_
+
+#include <cstdint>
+#include <memory>
+#include <traffic_simulator/entity/entity_status_store.hpp>
+#include <unordered_map>
+#include <vector>
+
+namespace traffic_simulator
+{
+namespace entity
+{
+/**
+ * @brief Uniform grid of the 2D footprints of all entities in an EntityStatusStore, and the
+ * entities on each lanelet.
+ * @note The index is built once per snapshot by the EntityManager and shared read-only like the
+ * snapshot itself. The footprint of an entity is the axis-aligned box of its bounding box placed at
+ * its pose, extended to contain its position.
+ */
+class EntitySpatialIndex
+{
+public:
+  explicit EntitySpatialIndex(
+    const std::shared_ptr<const EntityStatusStore> & store, double cell_size = 10.0);
+
+  auto store() const noexcept -> const std::shared_ptr<const EntityStatusStore> & { return store_; }
+
+  auto frame() const noexcept -> std::uint64_t { return store_ ? store_->frame() : 0; }
+
+  /**
+   * @brief Returns the indices into the store of the entities whose footprint overlaps the box, in
+   * ascending order.
+   */
+  auto query(double min_x, double min_y, double max_x, double max_y) const
+    -> std::vector<std::size_t>;
+
+  /**
+   * @brief Returns the indices into the store of the entities whose lanelet pose is on the lanelet,
+   * in ascending order.
+   * @note Entities with an invalid lanelet pose are included like in the linear scans over the
+   * snapshot they replace; check EntityStatusStore::laneletPoseValid if it matters.
+   */
+  auto getEntitiesOnLanelet(std::int64_t lanelet_id) const -> const std::vector<std::size_t> &;
+
+private:
+  struct Box
+  {
+    double min_x;
+    double min_y;
+    double max_x;
+    double max_y;
+  };
+
+  struct CellRange
+  {
+    std::int64_t min_x;
+    std::int64_t min_y;
+    std::int64_t max_x;
+    std::int64_t max_y;
+  };
+
+  auto getCellX(double x) const -> std::int64_t;
+
+  auto getCellY(double y) const -> std::int64_t;
+
+  std::shared_ptr<const EntityStatusStore> store_;
+
+  double cell_size_;
+
+  Box bounds_;
+
+  std::int64_t columns_ = 0;
+
+  std::int64_t rows_ = 0;
+
+  std::vector<Box> footprints_;
+
+  std::vector<CellRange> cell_ranges_;
+
+  /**
+   * @note Cells are stored row by row in compressed form: the entities in the cell c are
+   * cell_entities_[cell_offsets_[c]] to cell_entities_[cell_offsets_[c + 1] - 1].
+   */
+  std::vector<std::size_t> cell_offsets_;
+
+  std::vector<std::size_t> cell_entities_;
+
+  /**
+   * @note Entities spanning too many cells or with a non-finite footprint are not inserted into the
+   * grid and always tested.
+   */
+  std::vector<std::size_t> oversized_;
+
+  std::unordered_map<std::int64_t, std::vector<std::size_t>> lanelets_;
+};
+}  // namespace entity
+}  // namespace traffic_simulator
+
+#endif  // TRAFFIC_SIMULATOR__ENTITY__ENTITY_SPATIAL_INDEX_HPP_
@@ -0,0 +1,209 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TRAFFIC_SIMULATOR__ENTITY__ENTITY_STATUS_STORE_HPP_
+#define TRAFFIC_SIMULATOR__ENTITY__ENTITY_STATUS_STORE_HPP_
+
+#include <boost/optional.hpp>
+#include <cstdint>
+#include <geometry_msgs/msg/accel.hpp>
+#include <geometry_msgs/msg/point.hpp>
+#include <geometry_msgs/msg/pose.hpp>
+#include <geometry_msgs/msg/twist.hpp>
+#include <memory>
+#include <string>
+#include <traffic_simulator_msgs/msg/bounding_box.hpp>
+#include <traffic_simulator_msgs/msg/entity_status.hpp>
+#include <traffic_simulator_msgs/msg/lanelet_pose.hpp>
+#include <unordered_map>
+#include <vector>
+
+namespace traffic_simulator
+{
+namespace entity
+{
+/**
+ * @brief Structure-of-arrays snapshot of the status of all entities in one frame.
+ * @note The store is filled once by the EntityManager and then shared as
+ * std::shared_ptr<const EntityStatusStore>, so a snapshot never changes after it was handed out.
+ * The next frame builds a new snapshot with a larger frame number.
+ */
+class EntityStatusStore
+{
+public:
+  explicit EntityStatusStore(std::uint64_t frame = 0);
+
+  void emplace(const traffic_simulator_msgs::msg::EntityStatus & status);
+
+  void reserve(std::size_t size);
+
+  auto find(const std::string & name) const -> boost::optional<std::size_t>;
+
+  auto frame() const noexcept { return frame_; }
+
+  auto size() const noexcept { return names_.size(); }
+
+  auto getName(std::size_t index) const -> const std::string & { return names_[index]; }
+
+  auto getPose(std::size_t index) const -> const geometry_msgs::msg::Pose &
+  {
+    return poses_[index];
+  }
+
+  auto getTwist(std::size_t index) const -> const geometry_msgs::msg::Twist &
+  {
+    return twists_[index];
+  }
+
+  auto getAccel(std::size_t index) const -> const geometry_msgs::msg::Accel &
+  {
+    return accels_[index];
+  }
+
+  auto getLaneletPose(std::size_t index) const -> const traffic_simulator_msgs::msg::LaneletPose &
+  {
+    return lanelet_poses_[index];
+  }
+
+  auto laneletPoseValid(std::size_t index) const -> bool { return lanelet_pose_valid_[index]; }
+
+  auto getBoundingBox(std::size_t index) const -> const traffic_simulator_msgs::msg::BoundingBox &
+  {
+    return bounding_boxes_[index];
+  }
+
+  /**
+   * @brief Assembles the full EntityStatus message of the entity. Prefer the accessors above in
+   * hot loops, they do not copy.
+   */
+  auto getStatus(std::size_t index) const -> traffic_simulator_msgs::msg::EntityStatus;
+
+private:
+  std::uint64_t frame_;
+
+  std::vector<std::string> names_;
+  std::vector<geometry_msgs::msg::Pose> poses_;
+  std::vector<geometry_msgs::msg::Twist> twists_;
+  std::vector<geometry_msgs::msg::Accel> accels_;
+  std::vector<traffic_simulator_msgs::msg::LaneletPose> lanelet_poses_;
+  std::vector<std::uint8_t> lanelet_pose_valid_;
+  std::vector<traffic_simulator_msgs::msg::BoundingBox> bounding_boxes_;
+
+  /**
+   * @note Fields that are rarely read are kept together to keep the arrays above dense.
+   */
+  struct Attributes
+  {
+    traffic_simulator_msgs::msg::EntityType type;
+    traffic_simulator_msgs::msg::EntitySubtype subtype;
+    double time;
+    std::string current_action;
+  };
+  std::vector<Attributes> attributes_;
+
+  std::unordered_map<std::string, std::size_t> indices_;
+};
+
+class EntitySpatialIndex;
+
+/**
+ * @brief Read-only view of an EntityStatusStore seen from one entity. The entity itself and the
+ * entities farther than the range are not visible. Copying a view is cheap, it only shares the
+ * snapshot and the list of visible indices.
+ */
+class EntityStatusView
+{
+public:
+  EntityStatusView() = default;
+
+  EntityStatusView(
+    const std::shared_ptr<const EntityStatusStore> & store, const std::string & self_name,
+    const geometry_msgs::msg::Point & self_position, double range);
+
+  /**
+   * @brief Same view as above, but only the entities near the position in the index are tested.
+   */
+  EntityStatusView(
+    const std::shared_ptr<const EntitySpatialIndex> & index, const std::string & self_name,
+    const geometry_msgs::msg::Point & self_position, double range);
+
+  auto empty() const noexcept { return size() == 0; }
+
+  auto size() const noexcept -> std::size_t { return indices_ ? indices_->size() : 0; }
+
+  auto frame() const noexcept -> std::uint64_t { return store_ ? store_->frame() : 0; }
+
+  /**
+   * @brief Returns the position of the named entity in this view.
+   */
+  auto find(const std::string & name) const -> boost::optional<std::size_t>;
+
+  /**
+   * @brief Returns the position in this view of the entity at the index of the store.
+   */
+  auto findIndex(std::size_t index) const -> boost::optional<std::size_t>;
+
+  auto contains(const std::string & name) const -> bool { return static_cast<bool>(find(name)); }
+
+  auto getName(std::size_t i) const -> const std::string & { return store_->getName(at(i)); }
+
+  auto getPose(std::size_t i) const -> const geometry_msgs::msg::Pose &
+  {
+    return store_->getPose(at(i));
+  }
+
+  auto getTwist(std::size_t i) const -> const geometry_msgs::msg::Twist &
+  {
+    return store_->getTwist(at(i));
+  }
+
+  auto getAccel(std::size_t i) const -> const geometry_msgs::msg::Accel &
+  {
+    return store_->getAccel(at(i));
+  }
+
+  auto getLaneletPose(std::size_t i) const -> const traffic_simulator_msgs::msg::LaneletPose &
+  {
+    return store_->getLaneletPose(at(i));
+  }
+
+  auto laneletPoseValid(std::size_t i) const -> bool { return store_->laneletPoseValid(at(i)); }
+
+  auto getBoundingBox(std::size_t i) const -> const traffic_simulator_msgs::msg::BoundingBox &
+  {
+    return store_->getBoundingBox(at(i));
+  }
+
+  auto getStatus(std::size_t i) const -> traffic_simulator_msgs::msg::EntityStatus
+  {
+    return store_->getStatus(at(i));
+  }
+
+  auto getStatus(const std::string & name) const
+    -> boost::optional<traffic_simulator_msgs::msg::EntityStatus>;
+
+private:
+  auto at(std::size_t i) const -> std::size_t { return (*indices_)[i]; }
+
+  std::shared_ptr<const EntityStatusStore> store_;
+
+  /**
+   * @note Indices into the store, sorted in ascending order.
+   */
+  std::shared_ptr<const std::vector<std::size_t>> indices_;
+};
+}  // namespace entity
+}  // namespace traffic_simulator
+
+#endif  // TRAFFIC_SIMULATOR__ENTITY__ENTITY_STATUS_STORE_HPP_
@@ -15,122 +15,182 @@
 #ifndef TRAFFIC_SIMULATOR__HDMAP_UTILS__CACHE_HPP_
 #define TRAFFIC_SIMULATOR__HDMAP_UTILS__CACHE_HPP_
 
-#include <boost/optional.hpp>
+#include <cstdint>
+#include <functional>
 #include <geometry_msgs/msg/point.hpp>
+#include <list>
+#include <memory>
 #include <mutex>
-#include <scenario_simulator_exception/exception.hpp>
 #include <traffic_simulator/math/catmull_rom_spline.hpp>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace hdmap_utils
 {
-class RouteCache
+struct CacheStatistics
+{
+  std::uint64_t hits = 0;
+
+  std::uint64_t misses = 0;
+
+  std::uint64_t evictions = 0;
+
+  std::size_t size = 0;
+};
+
+/**
+ * @brief Thread-safe map from keys to values computed on demand, split into shards which are
+ * locked independently.
+ * @note The caches of HdMapUtils are shared by all entities, which may be updated concurrently (see
+ * Configuration::npc_update_threads). Values are immutable and handed out as shared pointers, so
+ * a hit only takes the lock of one shard to copy a pointer, and an evicted value stays valid for
+ * the callers still holding it. Values are computed without holding any lock. When several threads
+ * miss the same key at once, all of them compute it but the value of the first one is kept, so
+ * every thread observes the same value afterwards. A hit also updates the statistics and, if the
+ * cache is bounded, moves the key to the front of the LRU list, so every access writes to the
+ * shard. The shards therefore use an exclusive std::mutex rather than std::shared_timed_mutex,
+ * which would need its exclusive lock for those writes anyway and costs more than the lookup it
+ * protects.
+ */
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class ShardedCache
 {
 public:
-  bool exists(std::int64_t from, std::int64_t to)
+  using ValuePtr = std::shared_ptr<const Value>;
+
+  /**
+   * @param capacity Maximum number of values kept. The least recently used values are evicted
+   * when it is exceeded. If 0, values are never evicted.
+   */
+  explicit ShardedCache(std::size_t capacity = 0, std::size_t shard_count = 16)
+  : shards_(shard_count == 0 ? 1 : shard_count),
+    shard_capacity_(capacity == 0 ? 0 : (capacity + shards_.size() - 1) / shards_.size())
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    std::pair<std::int64_t, std::int64_t> key;
-    key.first = from;
-    key.second = to;
-    if (data_.find(key) == data_.end()) {
-      return false;
-    }
-    return true;
   }
-  std::vector<std::int64_t> getRoute(std::int64_t from, std::int64_t to)
+
+  /**
+   * @brief Returns the value of the key, computing it with compute() if it is not cached.
+   * @note If compute() throws, nothing is cached and the exception is propagated.
+   */
+  template <typename Compute>
+  auto getOrCompute(const Key & key, Compute && compute) -> ValuePtr
   {
-    if (!exists(from, to)) {
-      THROW_SIMULATION_ERROR(
-        "route from : ", from, " to : ", to, " does not exists on route cache.");
+    auto & shard = getShard(key);
+    {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      if (const auto value = shard.find(key, shard_capacity_ != 0)) {
+        ++shard.statistics.hits;
+        return value;
+      }
+      ++shard.statistics.misses;
     }
-    std::lock_guard<std::mutex> lock(mutex_);
-    const auto ret = data_.at({from, to});
-    return ret;
-  }
-  void appendData(std::int64_t from, std::int64_t to, const std::vector<std::int64_t> & route)
-  {
-    std::lock_guard<std::mutex> lock(mutex_);
-    data_[{from, to}] = route;
+    auto value = std::make_shared<const Value>(compute());
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (const auto cached = shard.find(key, shard_capacity_ != 0)) {
+      return cached;
+    }
+    shard.entries.emplace_front(key, value);
+    shard.index.emplace(key, shard.entries.begin());
+    if (shard_capacity_ != 0 && shard.entries.size() > shard_capacity_) {
+      shard.index.erase(shard.entries.back().first);
+      shard.entries.pop_back();
+      ++shard.statistics.evictions;
+    }
+    return value;
   }
 
-private:
-  std::unordered_map<std::pair<std::int64_t, std::int64_t>, std::vector<std::int64_t>> data_;
-  std::mutex mutex_;
-};
-
-class CenterPointsCache
-{
-public:
-  bool exists(std::int64_t lanelet_id)
+  /**
+   * @brief Returns the value of the key, or nullptr if it is not cached.
+   */
+  auto find(const Key & key) -> ValuePtr
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (data_.find(lanelet_id) == data_.end()) {
-      return false;
-    }
-    return true;
+    auto & shard = getShard(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.find(key, shard_capacity_ != 0);
   }
-  std::vector<geometry_msgs::msg::Point> getCenterPoints(std::int64_t lanelet_id)
+
+  auto statistics() const -> CacheStatistics
   {
-    if (!exists(lanelet_id)) {
-      THROW_SIMULATION_ERROR("center point of : ", lanelet_id, " does not exists on route cache.");
+    CacheStatistics result;
+    for (const auto & shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      result.hits += shard.statistics.hits;
+      result.misses += shard.statistics.misses;
+      result.evictions += shard.statistics.evictions;
+      result.size += shard.entries.size();
     }
-    std::lock_guard<std::mutex> lock(mutex_);
-    return data_.at(lanelet_id);
+    return result;
   }
-  std::shared_ptr<traffic_simulator::math::CatmullRomSpline> getCenterPointsSpline(
-    std::int64_t lanelet_id)
+
+private:
+  struct Shard
   {
-    if (!exists(lanelet_id)) {
-      THROW_SIMULATION_ERROR("center point of : ", lanelet_id, " does not exists on route cache.");
+    using Entries = std::list<std::pair<Key, ValuePtr>>;
+
+    mutable std::mutex mutex;
+
+    Entries entries;  // NOTE: Most recently used first.
+
+    std::unordered_map<Key, typename Entries::iterator, Hash> index;
+
+    CacheStatistics statistics;
+
+    auto find(const Key & key, bool touch) -> ValuePtr
+    {
+      const auto iter = index.find(key);
+      if (iter == index.end()) {
+        return nullptr;
+      } else {
+        if (touch) {
+          entries.splice(entries.begin(), entries, iter->second);
+        }
+        return iter->second->second;
+      }
     }
-    std::lock_guard<std::mutex> lock(mutex_);
-    return splines_[lanelet_id];
-  }
-  void appendData(std::int64_t lanelet_id, const std::vector<geometry_msgs::msg::Point> & route)
+  };
+
+  auto getShard(const Key & key) -> Shard &
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    data_[lanelet_id] = route;
-    splines_[lanelet_id] = std::make_shared<traffic_simulator::math::CatmullRomSpline>(route);
+    /**
+     * @note std::hash of integers is the identity, so the hash is mixed before taking the modulo
+     * not to put consecutive lanelet ids with a common stride into the same shard.
+     */
+    const std::uint64_t hash = static_cast<std::uint64_t>(Hash()(key)) * 0x9E3779B97F4A7C15ULL;
+    return shards_[(hash >> 32) % shards_.size()];
   }
 
-private:
-  std::unordered_map<std::int64_t, std::vector<geometry_msgs::msg::Point>> data_;
-  std::unordered_map<std::int64_t, std::shared_ptr<traffic_simulator::math::CatmullRomSpline>>
-    splines_;
-  std::mutex mutex_;
+  std::vector<Shard> shards_;
+
+  const std::size_t shard_capacity_;
 };
 
-class LaneletLengthCache
+struct LaneletIdPairHash
 {
-public:
-  bool exists(std::int64_t lanelet_id)
-  {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (data_.find(lanelet_id) == data_.end()) {
-      return false;
-    }
-    return true;
-  }
-  double getLength(std::int64_t lanelet_id)
+  auto operator()(const std::pair<std::int64_t, std::int64_t> & ids) const -> std::size_t
   {
-    if (!exists(lanelet_id)) {
-      THROW_SIMULATION_ERROR("length of : ", lanelet_id, " does not exists on route cache.");
-    }
-    std::lock_guard<std::mutex> lock(mutex_);
-    return data_[lanelet_id];
+    return std::hash<std::int64_t>()(ids.first) * 31 + std::hash<std::int64_t>()(ids.second);
   }
-  void appendData(std::int64_t lanelet_id, double length)
+};
+
+using RouteCache =
+  ShardedCache<std::pair<std::int64_t, std::int64_t>, std::vector<std::int64_t>, LaneletIdPairHash>;
+
+struct CenterPoints
+{
+  explicit CenterPoints(const std::vector<geometry_msgs::msg::Point> & points)
+  : points(points), spline(points)
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    data_[lanelet_id] = length;
   }
 
-private:
-  std::unordered_map<std::int64_t, double> data_;
-  std::mutex mutex_;
+  const std::vector<geometry_msgs::msg::Point> points;
+
+  const traffic_simulator::math::CatmullRomSpline spline;
 };
+
+using CenterPointsCache = ShardedCache<std::int64_t, CenterPoints>;
+
+using LaneletLengthCache = ShardedCache<std::int64_t, double>;
 }  // namespace hdmap_utils
 
 #endif  // TRAFFIC_SIMULATOR__HDMAP_UTILS__CACHE_HPP_
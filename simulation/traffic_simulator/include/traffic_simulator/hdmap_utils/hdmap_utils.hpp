@@ -43,6 +43,7 @@
 #include <string>
 #include <traffic_simulator/data_type/data_types.hpp>
 #include <traffic_simulator/hdmap_utils/cache.hpp>
+#include <traffic_simulator/hdmap_utils/route_table.hpp>
 #include <traffic_simulator/math/hermite_curve.hpp>
 #include <traffic_simulator/traffic_lights/traffic_light_state.hpp>
 #include <traffic_simulator_msgs/msg/bounding_box.hpp>
@@ -59,7 +60,18 @@ enum class LaneletType { LANE, CROSSWALK };
 class HdMapUtils
 {
 public:
-  explicit HdMapUtils(const boost::filesystem::path &, const geographic_msgs::msg::GeoPoint &);
+  /**
+   * @param precompiled_map_directory Directory of the precompiled map cache. If it is empty, the
+   * map is always loaded from the .osm file.
+   * @param cache_capacity Maximum number of routes, center points and lanelet lengths each kept in
+   * memory. If 0, they are kept until the HdMapUtils is destroyed.
+   * @param route_table_horizon Maximum distance between the lanelets whose shortest routes are
+   * computed when the map is loaded (see RouteTable). If 0, no route is computed in advance.
+   */
+  explicit HdMapUtils(
+    const boost::filesystem::path &, const geographic_msgs::msg::GeoPoint &,
+    const boost::filesystem::path & precompiled_map_directory = "",
+    std::size_t cache_capacity = 0, double route_table_horizon = 0);
 
   const autoware_auto_mapping_msgs::msg::HADMapBin toMapBin();
   void insertMarkerArray(
@@ -95,6 +107,9 @@ public:
   boost::optional<double> getDistanceToStopLine(
     const std::vector<std::int64_t> & route_lanelets,
     const std::vector<geometry_msgs::msg::Point> & waypoints);
+  boost::optional<double> getDistanceToStopLine(
+    const std::vector<std::int64_t> & route_lanelets,
+    const traffic_simulator::math::CatmullRomSpline & spline);
   double getLaneletLength(std::int64_t lanelet_id);
   bool isInLanelet(std::int64_t lanelet_id, double s);
   boost::optional<double> getLongitudinalDistance(
@@ -111,7 +126,7 @@ public:
   std::vector<std::int64_t> getPreviousLanelets(std::int64_t lanelet_id, double distance = 100);
   std::vector<geometry_msgs::msg::Point> getCenterPoints(std::int64_t lanelet_id);
   std::vector<geometry_msgs::msg::Point> getCenterPoints(std::vector<std::int64_t> lanelet_ids);
-  std::shared_ptr<traffic_simulator::math::CatmullRomSpline> getCenterPointsSpline(
+  std::shared_ptr<const traffic_simulator::math::CatmullRomSpline> getCenterPointsSpline(
     std::int64_t lanelet_id);
   std::vector<geometry_msgs::msg::Point> clipTrajectoryFromLaneletIds(
     std::int64_t lanelet_id, double s, std::vector<std::int64_t> lanelet_ids,
@@ -157,15 +172,31 @@ public:
   const boost::optional<double> getDistanceToTrafficLightStopLine(
     const std::vector<geometry_msgs::msg::Point> & waypoints,
     const std::int64_t & traffic_light_id) const;
+  const boost::optional<double> getDistanceToTrafficLightStopLine(
+    const traffic_simulator::math::CatmullRomSpline & spline,
+    const std::int64_t & traffic_light_id) const;
   const boost::optional<double> getDistanceToTrafficLightStopLine(
     const std::vector<std::int64_t> & route_lanelets,
     const std::vector<geometry_msgs::msg::Point> & waypoints) const;
+  const boost::optional<double> getDistanceToTrafficLightStopLine(
+    const std::vector<std::int64_t> & route_lanelets,
+    const traffic_simulator::math::CatmullRomSpline & spline) const;
   const std::vector<std::int64_t> getTrafficLightIdsOnPath(
     const std::vector<std::int64_t> & route_lanelets) const;
   traffic_simulator_msgs::msg::LaneletPose getAlongLaneletPose(
     const traffic_simulator_msgs::msg::LaneletPose & from_pose, double along);
   auto isTrafficRelationId(const std::int64_t) const -> bool;
   auto getTrafficLight(const std::int64_t) const -> lanelet::TrafficLight::Ptr;
+  auto getRouteCacheStatistics() const -> CacheStatistics { return route_cache_.statistics(); }
+  auto getCenterPointsCacheStatistics() const -> CacheStatistics
+  {
+    return center_points_cache_.statistics();
+  }
+  auto getLaneletLengthCacheStatistics() const -> CacheStatistics
+  {
+    return lanelet_length_cache_.statistics();
+  }
+  auto getRouteTable() const noexcept -> const RouteTable * { return route_table_.get(); }
 
 private:
   traffic_simulator::math::HermiteCurve getLaneChangeTrajectory(
@@ -173,9 +204,11 @@ private:
     const traffic_simulator_msgs::msg::LaneletPose & to_pose,
     const traffic_simulator::lane_change::TrajectoryShape trajectory_shape,
     double tangent_vector_size = 100);
+  std::shared_ptr<const CenterPoints> getCenterPointsEntry(std::int64_t lanelet_id);
   RouteCache route_cache_;
   CenterPointsCache center_points_cache_;
   LaneletLengthCache lanelet_length_cache_;
+  std::unique_ptr<const RouteTable> route_table_;
   std::vector<lanelet::AutowareTrafficLightConstPtr> getTrafficLights(
     const std::int64_t traffic_light_id) const;
   std::vector<std::pair<double, lanelet::Lanelet>> excludeSubtypeLanelets(
@@ -189,6 +222,7 @@ private:
   std::vector<lanelet::ConstLineString3d> getStopLinesOnPath(std::vector<std::int64_t> lanelet_ids);
   geometry_msgs::msg::Vector3 getVectorFromPose(geometry_msgs::msg::Pose pose, double magnitude);
   void mapCallback(const autoware_auto_mapping_msgs::msg::HADMapBin & msg);
+  lanelet::LaneletMapPtr loadLaneletMap(const boost::filesystem::path & lanelet2_map_path) const;
   lanelet::LaneletMapPtr lanelet_map_ptr_;
   lanelet::routing::RoutingGraphConstPtr vehicle_routing_graph_ptr_;
   lanelet::traffic_rules::TrafficRulesPtr traffic_rules_vehicle_ptr_;
@@ -0,0 +1,59 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TRAFFIC_SIMULATOR__HDMAP_UTILS__PRECOMPILED_MAP_HPP_
+#define TRAFFIC_SIMULATOR__HDMAP_UTILS__PRECOMPILED_MAP_HPP_
+
+#include <lanelet2_core/LaneletMap.h>
+
+#include <boost/filesystem.hpp>
+#include <string>
+
+namespace hdmap_utils
+{
+/**
+ * @brief On-disk cache of lanelet maps that were already projected and had their fine centerlines
+ * generated. Entries are keyed by the content hash of the source .osm file, so editing a map
+ * invalidates its entry automatically.
+ */
+class PrecompiledMapCache
+{
+public:
+  explicit PrecompiledMapCache(const boost::filesystem::path & directory);
+
+  /**
+   * @brief Returns the BLAKE2b hash of the file contents as a hexadecimal string.
+   */
+  static auto hash(const boost::filesystem::path & lanelet2_map_path) -> std::string;
+
+  /**
+   * @brief Memory-maps the cache entry of the given hash and deserializes it.
+   * @return nullptr if there is no entry or the entry is broken / written by another version.
+   */
+  auto load(const std::string & hash) const -> lanelet::LaneletMapPtr;
+
+  /**
+   * @brief Serializes the map into the cache. The entry is written to a temporary file and renamed,
+   * so concurrent simulator launches never see a partially written entry.
+   */
+  void save(const std::string & hash, const lanelet::LaneletMap & map) const;
+
+  auto entryPath(const std::string & hash) const -> boost::filesystem::path;
+
+private:
+  const boost::filesystem::path directory_;
+};
+}  // namespace hdmap_utils
+
+#endif  // TRAFFIC_SIMULATOR__HDMAP_UTILS__PRECOMPILED_MAP_HPP_
@@ -0,0 +1,101 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TRAFFIC_SIMULATOR__HDMAP_UTILS__ROUTE_TABLE_HPP_
+#define TRAFFIC_SIMULATOR__HDMAP_UTILS__ROUTE_TABLE_HPP_
+
+#include <boost/optional.hpp>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace hdmap_utils
+{
+/**
+ * @brief Shortest routes between all pairs of lanelets which are close to each other along the
+ * lanes, computed once when the map is loaded.
+ * @note The distance between two lanelets is the total length of the lanelets between them,
+ * excluding both of them, like the routes of the vehicle routing graph which minimize it. Pairs
+ * farther than the horizon are not stored, and have to be searched in the routing graph.
+ */
+class RouteTable
+{
+public:
+  struct Lanelet
+  {
+    std::int64_t id;
+
+    double length;
+
+    std::vector<std::int64_t> following_lanelet_ids;
+  };
+
+  /**
+   * @param horizon Maximum distance between the lanelets of the pairs stored in the table.
+   */
+  explicit RouteTable(const std::vector<Lanelet> & lanelets, double horizon);
+
+  auto horizon() const noexcept -> double { return horizon_; }
+
+  /**
+   * @brief Returns the number of pairs of lanelets stored in the table.
+   */
+  auto size() const noexcept -> std::size_t { return entries_.size(); }
+
+  /**
+   * @brief Returns the total length of the lanelets between the two lanelets on the shortest
+   * route, or none if the pair is not in the table.
+   */
+  auto getDistance(std::int64_t from_lanelet_id, std::int64_t to_lanelet_id) const
+    -> boost::optional<double>;
+
+  /**
+   * @brief Returns the lanelets of the shortest route, both ends included, or an empty route if
+   * the pair is not in the table.
+   */
+  auto getRoute(std::int64_t from_lanelet_id, std::int64_t to_lanelet_id) const
+    -> std::vector<std::int64_t>;
+
+private:
+  struct Entry
+  {
+    std::size_t to;
+
+    std::size_t next;
+
+    double distance;
+  };
+
+  auto find(std::int64_t from_lanelet_id, std::int64_t to_lanelet_id) const -> const Entry *;
+
+  auto find(std::size_t from, std::size_t to) const -> const Entry *;
+
+  double horizon_;
+
+  std::vector<std::int64_t> ids_;
+
+  std::unordered_map<std::int64_t, std::size_t> indices_;
+
+  /**
+   * @note Entries are stored by lanelet of departure in compressed form, sorted by lanelet of
+   * arrival: the entries from the lanelet i are entries_[offsets_[i]] to
+   * entries_[offsets_[i + 1] - 1].
+   */
+  std::vector<std::size_t> offsets_;
+
+  std::vector<Entry> entries_;
+};
+}  // namespace hdmap_utils
+
+#endif  // TRAFFIC_SIMULATOR__HDMAP_UTILS__ROUTE_TABLE_HPP_
@@ -40,7 +40,7 @@ public:
   const std::vector<geometry_msgs::msg::Point> getTrajectory(
     double start_s, double end_s, double resolution, double offset = 0.0) const;
   boost::optional<double> getSValue(
-    const geometry_msgs::msg::Pose & pose, double threshold_distance = 3.0);
+    const geometry_msgs::msg::Pose & pose, double threshold_distance = 3.0) const;
   double getSquaredDistanceIn2D(const geometry_msgs::msg::Point & point, double s) const;
   geometry_msgs::msg::Vector3 getSquaredDistanceVector(
     const geometry_msgs::msg::Point & point, double s) const;
@@ -50,12 +50,27 @@ public:
   boost::optional<double> getCollisionPointIn2D(
     const std::vector<geometry_msgs::msg::Point> & polygon, bool search_backward = false,
     bool close_start_end = true) const;
+  /**
+   * @brief get the collision point of the spline with each of the polygons.
+   * @return same as getCollisionPointIn2D for each polygon, in the order of the polygons.
+   */
+  std::vector<boost::optional<double>> getCollisionPointsIn2D(
+    const std::vector<std::vector<geometry_msgs::msg::Point>> & polygons,
+    bool search_backward = false, bool close_start_end = true) const;
+  /**
+   * @brief get the axis-aligned box in the x-y plane which contains the whole spline.
+   * @return minimum and maximum corner of the box, with z of 0.
+   */
+  const std::pair<geometry_msgs::msg::Point, geometry_msgs::msg::Point> & get2DBoundingBox() const
+  {
+    return bounding_box_;
+  }
   const geometry_msgs::msg::Point getRightBoundsPoint(
     double width, double s, double z_offset = 0) const;
   const geometry_msgs::msg::Point getLeftBoundsPoint(
     double width, double s, double z_offset = 0) const;
   const std::vector<geometry_msgs::msg::Point> getPolygon(
-    double width, size_t num_points = 30, double z_offset = 0);
+    double width, size_t num_points = 30, double z_offset = 0) const;
 
 private:
   const std::vector<geometry_msgs::msg::Point> getRightBounds(
@@ -66,8 +81,26 @@ private:
   std::pair<size_t, double> getCurveIndexAndS(double s) const;
   bool checkConnection() const;
   bool equals(geometry_msgs::msg::Point p0, geometry_msgs::msg::Point p1) const;
+  /**
+   * @brief check if the curve may cross the line segment between point0 and point1.
+   * @note False only if the bounding box of the curve does not overlap the one of the segment, so
+   * the curve is skipped without solving the cubic equation for its collision point.
+   */
+  bool mayCollideIn2D(
+    size_t curve_index, const geometry_msgs::msg::Point & point0,
+    const geometry_msgs::msg::Point & point1) const;
+  boost::optional<double> getCollisionPointIn2D(
+    const std::vector<geometry_msgs::msg::Point> & polygon,
+    const std::pair<geometry_msgs::msg::Point, geometry_msgs::msg::Point> & polygon_bounding_box,
+    bool search_backward, bool close_start_end) const;
+  boost::optional<double> getCollisionPointIn2D(
+    size_t curve_index, const std::vector<geometry_msgs::msg::Point> & polygon,
+    bool search_backward, bool close_start_end) const;
   std::vector<HermiteCurve> curves_;
+  std::vector<std::pair<geometry_msgs::msg::Point, geometry_msgs::msg::Point>> bounding_boxes_;
+  std::pair<geometry_msgs::msg::Point, geometry_msgs::msg::Point> bounding_box_;
   std::vector<double> length_list_;
+  std::vector<double> accumulated_length_list_;
   std::vector<double> maximum_2d_curvatures_;
   double total_length_;
   const std::vector<geometry_msgs::msg::Point> control_points;
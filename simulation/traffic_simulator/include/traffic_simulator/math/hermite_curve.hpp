@@ -23,6 +23,7 @@
 #include <geometry_msgs/msg/pose.hpp>
 #include <geometry_msgs/msg/vector3.hpp>
 #include <traffic_simulator/math/polynomial_solver.hpp>
+#include <utility>
 #include <vector>
 
 namespace traffic_simulator
@@ -56,6 +57,15 @@ public:
   double getMaximum2DCurvature() const;
   double getLength(size_t num_points) const;
   double getLength() const { return length_; }
+  /**
+   * @brief get arc length of the curve from parameter 0 to t by Gauss-Legendre quadrature.
+   */
+  double getArcLength(double t) const;
+  /**
+   * @brief get curve parameter t whose arc length from the start of the curve is arc_length.
+   * @note The lookups with autoscale use it to map s to the curve parameter.
+   */
+  double getParameter(double arc_length) const;
   boost::optional<double> getSValue(
     const geometry_msgs::msg::Pose & pose, double threshold_distance = 3.0,
     bool autoscale = false) const;
@@ -69,9 +79,19 @@ public:
   boost::optional<double> getCollisionPointIn2D(
     const std::vector<geometry_msgs::msg::Point> & polygon, bool search_backward = false,
     bool close_start_end = true) const;
+  /**
+   * @brief get the axis-aligned box in the x-y plane which contains the whole curve.
+   * @return minimum and maximum corner of the box, with z of 0.
+   * @note The box is the one of the Bezier control points of the curve, so it contains the curve
+   * without solving for its extrema, but may be slightly larger than the curve.
+   */
+  std::pair<geometry_msgs::msg::Point, geometry_msgs::msg::Point> get2DBoundingBox() const;
 
 private:
   std::pair<double, double> get2DMinMaxCurvatureValue() const;
+  double getSpeed(double t) const;
+  std::vector<double> getSpeedExtrema() const;
+  std::vector<double> speed_extrema_;
   double length_;
 };
 }  // namespace math
@@ -15,32 +15,64 @@
 #ifndef TRAFFIC_SIMULATOR__MATH__POLYNOMIAL_SOLVER_HPP_
 #define TRAFFIC_SIMULATOR__MATH__POLYNOMIAL_SOLVER_HPP_
 
-#include <vector>
+#include <array>
+#include <cstddef>
 
 namespace traffic_simulator
 {
 namespace math
 {
+/**
+ * @brief Real roots of a polynomial of degree 3 or less.
+ * @note The roots are stored in the object itself, so solving an equation does not allocate. It
+ * can be iterated like a std::vector<double>.
+ */
+class PolynomialRoots
+{
+public:
+  using value_type = double;
+  using const_iterator = const double *;
+
+  auto begin() const noexcept -> const_iterator { return roots_.data(); }
+  auto end() const noexcept -> const_iterator { return roots_.data() + size_; }
+  auto size() const noexcept -> std::size_t { return size_; }
+  auto empty() const noexcept -> bool { return size_ == 0; }
+  auto operator[](std::size_t index) const -> double { return roots_[index]; }
+  void emplace_back(double root) { roots_[size_++] = root; }
+
+private:
+  std::array<double, 3> roots_;
+  std::size_t size_ = 0;
+};
+
 class PolynomialSolver
 {
 public:
+  /**
+   * @param newton_iterations Number of Newton steps applied to each root of a cubic equation found
+   * in closed form. Each step is kept only if it reduces the residual.
+   */
+  explicit PolynomialSolver(std::size_t newton_iterations = 1)
+  : newton_iterations_(newton_iterations)
+  {
+  }
   /**
  * @brief solve linear equation a*x + b = 0
  *
  * @param a
  * @param b
- * @return std::vector<double> real root of the quadratic functions (from 0 to 1)
+ * @return PolynomialRoots real root of the linear functions (from 0 to 1)
  */
-  std::vector<double> solveLinearEquation(
+  PolynomialRoots solveLinearEquation(
     double a, double b, double min_value = 0, double max_value = 1) const;
   /**
  * @brief solve quadratic equation a*x^2 + b*x + c = 0
  *
  * @param a
  * @param b
- * @return std::vector<double> real root of the quadratic functions (from 0 to 1)
+ * @return PolynomialRoots real root of the quadratic functions (from 0 to 1)
  */
-  std::vector<double> solveQuadraticEquation(
+  PolynomialRoots solveQuadraticEquation(
     double a, double b, double c, double min_value = 0, double max_value = 1) const;
   /**
  * @brief solve cubic function a*t^3 + b*t^2 + c*t + d = 0
@@ -49,9 +81,9 @@ public:
  * @param b
  * @param c
  * @param d
- * @return std::vector<double> real root of the cubic functions (from 0 to 1)
+ * @return PolynomialRoots real root of the cubic functions (from 0 to 1)
  */
-  std::vector<double> solveCubicEquation(
+  PolynomialRoots solveCubicEquation(
     double a, double b, double c, double d, double min_value = 0, double max_value = 1) const;
   /**
  * @brief calculate result of cubic function a*t^3 + b*t^2 + c*t + d
@@ -97,9 +129,14 @@ private:
            if return value is 2, 2 real roots: x[0], x[1],
            if return value is 1, 1 real root : x[0], x[1] ± i*x[2],
  */
-  int solveP3(std::vector<double> & x, double a, double b, double c) const;
+  int solveP3(std::array<double, 3> & x, double a, double b, double c) const;
+  /**
+   * @brief apply the Newton steps to a root of the cubic function a*t^3 + b*t^2 + c*t + d.
+   */
+  double polishCubicEquationRoot(double a, double b, double c, double d, double solution) const;
   double _root3(double x) const;
   double root3(double x) const;
+  std::size_t newton_iterations_;
 };
 }  // namespace math
 }  // namespace traffic_simulator
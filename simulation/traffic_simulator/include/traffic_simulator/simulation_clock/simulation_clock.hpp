@@ -30,9 +30,16 @@ public:
   double getStepTime() const { return step_time_; }
   const rclcpp::Time getCurrentRosTime();
   const rosgraph_msgs::msg::Clock getCurrentRosTimeAsMsg();
+  /**
+   * @brief Returns the times getCurrentSimulationTime and getCurrentRosTime will return after the
+   * next update, without updating the clock.
+   */
+  double getNextSimulationTime() const { return current_simulation_time_ + step_time_; }
+  const rclcpp::Time getNextRosTime();
   const bool use_raw_clock;
 
 private:
+  const rclcpp::Time toRosTime(double simulation_time);
   rclcpp::Duration step_time_duration_;
   rclcpp::Time time_on_initialize_;
   double current_simulation_time_;
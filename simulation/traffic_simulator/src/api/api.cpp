@@ -22,6 +22,7 @@
 #include <stdexcept>
 #include <string>
 #include <traffic_simulator/api/api.hpp>
+#include <vector>
 
 namespace traffic_simulator
 {
@@ -279,6 +280,7 @@ bool API::initialize(double realtime_factor, double step_time)
     simulation_api_schema::InitializeRequest req;
     req.set_step_time(step_time);
     req.set_realtime_factor(realtime_factor);
+    req.set_lanelet2_map_path(configuration.lanelet2_map_path().string());
     simulation_api_schema::InitializeResponse res;
     zeromq_client_.call(req, res);
     return res.result().success();
@@ -324,41 +326,57 @@ bool API::attachLidarSensor(const std::string & entity_name, const helper::Lidar
     lidar_type, entity_name, getParameter<std::string>("architecture_type", "awf/universe")));
 }
 
+auto API::makeUpdateSensorFrameRequest(
+  double current_time, const rclcpp::Time & current_ros_time) const
+  -> simulation_api_schema::UpdateSensorFrameRequest
+{
+  simulation_api_schema::UpdateSensorFrameRequest req;
+  req.set_current_time(current_time);
+  simulation_interface::toProto(
+    static_cast<builtin_interfaces::msg::Time>(current_ros_time), *req.mutable_current_ros_time());
+  return req;
+}
+
 bool API::updateSensorFrame()
 {
   if (configuration.standalone_mode) {
     return true;
   } else {
-    simulation_api_schema::UpdateSensorFrameRequest req;
-    req.set_current_time(clock_.getCurrentSimulationTime());
-    simulation_interface::toProto(
-      clock_.getCurrentRosTimeAsMsg().clock, *req.mutable_current_ros_time());
     simulation_api_schema::UpdateSensorFrameResponse res;
-    zeromq_client_.call(req, res);
+    zeromq_client_.call(
+      makeUpdateSensorFrameRequest(clock_.getCurrentSimulationTime(), clock_.getCurrentRosTime()),
+      res);
     return res.result().success();
   }
 }
 
-bool API::updateTrafficLightsInSim()
+auto API::makeUpdateTrafficLightsRequest() const
+  -> simulation_api_schema::UpdateTrafficLightsRequest
 {
   simulation_api_schema::UpdateTrafficLightsRequest req;
+  auto ids = entity_manager_ptr_->getTrafficLightIds();
+  for (auto id : ids) {
+    simulation_api_schema::TrafficLightState state;
+    auto traffic_light = entity_manager_ptr_->getTrafficLightInstance(id);
+    simulation_interface::toProto(
+      static_cast<autoware_auto_perception_msgs::msg::TrafficSignal>(traffic_light), state);
+    *req.add_states() = state;
+  }
+  return req;
+}
+
+bool API::updateTrafficLightsInSim()
+{
   simulation_api_schema::UpdateTrafficLightsResponse res;
   if (entity_manager_ptr_->trafficLightsChanged()) {
-    auto ids = entity_manager_ptr_->getTrafficLightIds();
-    for (auto id : ids) {
-      simulation_api_schema::TrafficLightState state;
-      auto traffic_light = entity_manager_ptr_->getTrafficLightInstance(id);
-      simulation_interface::toProto(
-        static_cast<autoware_auto_perception_msgs::msg::TrafficSignal>(traffic_light), state);
-      *req.add_states() = state;
-    }
-    zeromq_client_.call(req, res);
+    zeromq_client_.call(makeUpdateTrafficLightsRequest(), res);
   }
   // TODO handle response
   return res.result().success();
 }
 
-bool API::updateEntityStatusInSim()
+auto API::makeUpdateEntityStatusRequest(double current_time)
+  -> simulation_api_schema::UpdateEntityStatusRequest
 {
   simulation_api_schema::UpdateEntityStatusRequest req;
   if (entity_manager_ptr_->getNumberOfEgo() != 0) {
@@ -376,17 +394,35 @@ bool API::updateEntityStatusInSim()
     }
   }
   const auto names = entity_manager_ptr_->getEntityNames();
-  for (const auto name : names) {
-    auto status = entity_manager_ptr_->getEntityStatus(name);
-    if (status) {
-      traffic_simulator_msgs::EntityStatus proto;
-      status.get().name = name;
-      simulation_interface::toProto(status.get(), proto);
-      *req.add_status() = proto;
+  if (configuration.entity_status_delta) {
+    std::vector<traffic_simulator_msgs::msg::EntityStatus> statuses;
+    statuses.reserve(names.size());
+    for (const auto name : names) {
+      auto status = entity_manager_ptr_->getEntityStatus(name);
+      if (status) {
+        status.get().name = name;
+        statuses.emplace_back(status.get());
+      }
+    }
+    *req.mutable_status_delta() =
+      entity_status_encoder_.encode(statuses, current_time);
+  } else {
+    for (const auto name : names) {
+      auto status = entity_manager_ptr_->getEntityStatus(name);
+      if (status) {
+        traffic_simulator_msgs::EntityStatus proto;
+        status.get().name = name;
+        simulation_interface::toProto(status.get(), proto);
+        *req.add_status() = proto;
+      }
     }
   }
-  simulation_api_schema::UpdateEntityStatusResponse res;
-  zeromq_client_.call(req, res);
+  return req;
+}
+
+void API::applyUpdateEntityStatusResponse(
+  const simulation_api_schema::UpdateEntityStatusResponse & res)
+{
   for (const auto status : res.status()) {
     auto entity_status = entity_manager_ptr_->getEntityStatus(status.name());
     if (!entity_status) {
@@ -410,6 +446,74 @@ bool API::updateEntityStatusInSim()
     simulation_interface::toMsg(status.action_status().accel(), status_msg.action_status.accel);
     entity_manager_ptr_->setEntityStatus(status.name(), status_msg);
   }
+}
+
+/**
+ * @note If the sensor simulator did not apply the delta (for example, because it was restarted or
+ * a request was lost), the whole entity status is sent again as a keyframe.
+ */
+bool API::updateEntityStatusInSim()
+{
+  simulation_api_schema::UpdateEntityStatusResponse res;
+  zeromq_client_.call(makeUpdateEntityStatusRequest(clock_.getCurrentSimulationTime()), res);
+  if (
+    configuration.entity_status_delta and
+    res.status_sequence() != entity_status_encoder_.sequence()) {
+    entity_status_encoder_.reset();
+    zeromq_client_.call(makeUpdateEntityStatusRequest(clock_.getCurrentSimulationTime()), res);
+  }
+  applyUpdateEntityStatusResponse(res);
+  return res.result().success();
+}
+
+/**
+ * @note Same requests as the separate calls in API::updateFrame, sent in one round trip. The entity
+ * status and the sensor frame are requested with the time the clock will have after this frame, as
+ * they are sent after the clock was updated in the separate calls. The clock is only updated once
+ * the sensor simulator has updated its frame.
+ *
+ * If the sensor simulator did not apply the entity status delta, the whole entity status is sent
+ * again as a keyframe like API::updateEntityStatusInSim. The sensors of this frame have already
+ * seen the last status the sensor simulator had applied.
+ */
+bool API::simulateFrameInSim()
+{
+  const auto next_simulation_time = clock_.getNextSimulationTime();
+  const auto next_ros_time = clock_.getNextRosTime();
+  simulation_api_schema::SimulateFrameRequest req;
+  req.mutable_update_frame()->set_current_time(clock_.getCurrentSimulationTime());
+  simulation_interface::toProto(
+    clock_.getCurrentRosTimeAsMsg().clock, *req.mutable_update_frame()->mutable_current_ros_time());
+  *req.mutable_update_entity_status() = makeUpdateEntityStatusRequest(next_simulation_time);
+  if (entity_manager_ptr_->trafficLightsChanged()) {
+    *req.mutable_update_traffic_lights() = makeUpdateTrafficLightsRequest();
+  }
+  *req.mutable_update_sensor_frame() =
+    makeUpdateSensorFrameRequest(next_simulation_time, next_ros_time);
+  simulation_api_schema::SimulateFrameResponse res;
+  zeromq_client_.call(req, res);
+  if (!res.update_frame().result().success()) {
+    return false;
+  }
+  entity_manager_ptr_->broadcastEntityTransform();
+  clock_.update();
+  clock_pub_->publish(clock_.getCurrentRosTimeAsMsg());
+  debug_marker_pub_->publish(entity_manager_ptr_->makeDebugMarker());
+  metrics_manager_.calculate();
+  if (
+    configuration.entity_status_delta and
+    res.update_entity_status().status_sequence() != entity_status_encoder_.sequence()) {
+    entity_status_encoder_.reset();
+    simulation_api_schema::UpdateEntityStatusResponse keyframe_res;
+    zeromq_client_.call(
+      makeUpdateEntityStatusRequest(clock_.getCurrentSimulationTime()), keyframe_res);
+    applyUpdateEntityStatusResponse(keyframe_res);
+    if (!keyframe_res.result().success()) {
+      return false;
+    }
+  } else {
+    applyUpdateEntityStatusResponse(res.update_entity_status());
+  }
   return res.result().success();
 }
 
@@ -419,7 +523,9 @@ bool API::updateFrame()
   entity_manager_ptr_->update(clock_.getCurrentSimulationTime(), clock_.getStepTime());
   traffic_controller_ptr_->execute();
 
-  if (not configuration.standalone_mode) {
+  if (not configuration.standalone_mode and configuration.combine_frame_requests) {
+    return simulateFrameInSim();
+  } else if (not configuration.standalone_mode) {
     simulation_api_schema::UpdateFrameRequest req;
     req.set_current_time(clock_.getCurrentSimulationTime());
     simulation_interface::toProto(
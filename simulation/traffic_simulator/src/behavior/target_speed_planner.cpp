@@ -34,9 +34,7 @@ void TargetSpeedPlanner::requestSpeedChange(
   target_speed_ = boost::none;
 }
 
-void TargetSpeedPlanner::update(
-  double current_speed,
-  const std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityStatus> & other_status)
+void TargetSpeedPlanner::update(double current_speed, const entity::EntityStatusView & other_status)
 {
   other_status_ = other_status;
   if (!continuous_ && target_speed_) {
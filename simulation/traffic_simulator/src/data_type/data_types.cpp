@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <traffic_simulator/data_type/data_types.hpp>
+#include <traffic_simulator/entity/entity_status_store.hpp>
 
 namespace traffic_simulator
 {
@@ -33,11 +34,10 @@ RelativeTargetSpeed::RelativeTargetSpeed(const RelativeTargetSpeed & other)
 {
 }
 
-double RelativeTargetSpeed::getAbsoluteValue(
-  const std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityStatus> & other_status)
-  const
+double RelativeTargetSpeed::getAbsoluteValue(const entity::EntityStatusView & other_status) const
 {
-  if (other_status.find(reference_entity_name) == other_status.end()) {
+  const auto reference = other_status.find(reference_entity_name);
+  if (!reference) {
     THROW_SEMANTIC_ERROR(
       "reference entity name : ", reference_entity_name,
       " is invalid. Please check entity : ", reference_entity_name,
@@ -46,12 +46,10 @@ double RelativeTargetSpeed::getAbsoluteValue(
   double target_speed = 0;
   switch (type) {
     case Type::DELTA:
-      target_speed =
-        other_status.find(reference_entity_name)->second.action_status.twist.linear.x + value;
+      target_speed = other_status.getTwist(reference.get()).linear.x + value;
       break;
     case Type::FACTOR:
-      target_speed =
-        other_status.find(reference_entity_name)->second.action_status.twist.linear.x * value;
+      target_speed = other_status.getTwist(reference.get()).linear.x * value;
       break;
   }
   return target_speed;
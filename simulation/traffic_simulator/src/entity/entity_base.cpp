@@ -106,17 +106,18 @@ void EntityBase::requestLaneChange(
     }
     reference_lanelet_id = getStatus().lanelet_pose.lanelet_id;
   } else {
-    if (other_status_.find(target.entity_name) == other_status_.end()) {
+    const auto other = other_status_.find(target.entity_name);
+    if (!other) {
       THROW_SEMANTIC_ERROR(
         "Target entity : ", target.entity_name, " does not exist. Please check ",
         target.entity_name, " exists.");
     }
-    if (!other_status_.at(target.entity_name).lanelet_pose_valid) {
+    if (!other_status_.laneletPoseValid(other.get())) {
       THROW_SEMANTIC_ERROR(
         "Target entity does not assigned to lanelet. Please check Target entity name : ",
         target.entity_name, " exists on lane.");
     }
-    reference_lanelet_id = other_status_.at(target.entity_name).lanelet_pose.lanelet_id;
+    reference_lanelet_id = other_status_.getLaneletPose(other.get()).lanelet_id;
   }
   const auto lane_change_target_id = hdmap_utils_ptr_->getLaneChangeableLaneletId(
     reference_lanelet_id, target.direction, target.shift);
@@ -162,22 +163,13 @@ void EntityBase::updateEntityStatusTimestamp(const double current_time)
   }
 }
 
-void EntityBase::setOtherStatus(
-  const std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityStatus> & status)
+void EntityBase::setOtherStatus(const std::shared_ptr<const EntitySpatialIndex> & index)
 {
-  other_status_.clear();
+  entity_spatial_index_ = index;
   if (status_) {
-    for (const auto & each : status) {
-      if (each.first != name) {
-        const auto p0 = each.second.pose.position;
-        const auto p1 = status_.get().pose.position;
-        double distance =
-          std::sqrt(std::pow(p0.x - p1.x, 2) + std::pow(p0.y - p1.y, 2) + std::pow(p0.z - p1.z, 2));
-        if (distance < 30) {
-          other_status_.insert(each);
-        }
-      }
-    }
+    other_status_ = EntityStatusView(index, name, status_.get().pose.position, 30);
+  } else {
+    other_status_ = EntityStatusView();
   }
 }
 
@@ -12,7 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <cstdint>
+#include <exception>
 #include <limits>
 #include <memory>
 #include <queue>
@@ -631,19 +633,71 @@ auto EntityManager::toMapPose(const traffic_simulator_msgs::msg::LaneletPose & l
 
 traffic_simulator_msgs::msg::EntityStatus EntityManager::updateNpcLogic(
   const std::string & name,
-  const std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityType> & type_list)
+  const std::shared_ptr<
+    const std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityType>> & type_list)
 {
   if (configuration.verbose) {
     std::cout << "update " << name << " behavior" << std::endl;
   }
-  entities_[name]->setEntityTypeList(type_list);
-  entities_[name]->onUpdate(current_time_, step_time_);
-  if (entities_[name]->statusSet()) {
-    return entities_[name]->getStatus();
+  /**
+   * @note entities_.at is used instead of operator[] because this function may be called from
+   * several threads at once.
+   */
+  const auto & entity = entities_.at(name);
+  entity->setEntityTypeList(type_list);
+  entity->onUpdate(current_time_, step_time_);
+  if (entity->statusSet()) {
+    return entity->getStatus();
   }
   THROW_SIMULATION_ERROR("status of entity ", name, "is empty");
 }
 
+auto EntityManager::updateNpcLogic(
+  const std::vector<std::string> & names,
+  const std::shared_ptr<
+    const std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityType>> & type_list)
+  -> std::vector<traffic_simulator_msgs::msg::EntityStatus>
+{
+  std::vector<traffic_simulator_msgs::msg::EntityStatus> statuses(names.size());
+  if (npc_update_pool_.size() <= 1 || names.size() <= 1) {
+    for (std::size_t i = 0; i < names.size(); ++i) {
+      statuses[i] = updateNpcLogic(names[i], type_list);
+    }
+    return statuses;
+  }
+  /**
+   * @note The ego entity drives Autoware, so it is always updated on the calling thread. Errors are
+   * collected per entity and the first one in the order of names is rethrown, so the same error is
+   * reported regardless of the number of threads.
+   */
+  std::vector<std::exception_ptr> errors(names.size());
+  std::vector<std::size_t> npc_indices;
+  std::vector<std::size_t> ego_indices;
+  for (std::size_t i = 0; i < names.size(); ++i) {
+    (isEgo(names[i]) ? ego_indices : npc_indices).emplace_back(i);
+  }
+  const auto update = [&](std::size_t i) {
+    try {
+      statuses[i] = updateNpcLogic(names[i], type_list);
+    } catch (...) {
+      errors[i] = std::current_exception();
+    }
+  };
+  npc_update_pool_.parallelFor(
+    npc_indices.size(), [&](std::size_t n) { update(npc_indices[n]); },
+    [&]() {
+      for (const auto i : ego_indices) {
+        update(i);
+      }
+    });
+  for (const auto & error : errors) {
+    if (error) {
+      std::rethrow_exception(error);
+    }
+  }
+  return statuses;
+}
+
 void EntityManager::update(const double current_time, const double step_time)
 {
   std::chrono::system_clock::time_point start, end;
@@ -661,27 +715,47 @@ void EntityManager::update(const double current_time, const double step_time)
     traffic_light_manager_ptr_->update(step_time_);
   }
   setVerbose(configuration.verbose);
-  auto type_list = getEntityTypeList();
-  std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityStatus> all_status;
+  const auto type_list = std::make_shared<
+    const std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityType>>(
+    getEntityTypeList());
   const std::vector<std::string> entity_names = getEntityNames();
-  for (const auto & entity_name : entity_names) {
-    if (entities_[entity_name]->statusSet()) {
-      all_status.emplace(entity_name, entities_[entity_name]->getStatus());
+  {
+    auto store = std::make_shared<EntityStatusStore>(++entity_status_frame_);
+    store->reserve(entity_names.size());
+    for (const auto & entity_name : entity_names) {
+      if (entities_[entity_name]->statusSet()) {
+        store->emplace(entities_[entity_name]->getStatus());
+      }
     }
+    entity_status_store_ = store;
+    entity_spatial_index_ = std::make_shared<const EntitySpatialIndex>(store);
   }
   for (auto it = entities_.begin(); it != entities_.end(); it++) {
-    it->second->setOtherStatus(all_status);
-  }
-  all_status.clear();
-  for (const auto & entity_name : entity_names) {
-    if (entities_[entity_name]->statusSet()) {
-      auto status = updateNpcLogic(entity_name, type_list);
-      status.bounding_box = getBoundingBox(entity_name);
-      all_status.emplace(entity_name, status);
+    it->second->setOtherStatus(entity_spatial_index_);
+  }
+  std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityStatus> all_status;
+  {
+    std::vector<std::string> updated_entity_names;
+    for (const auto & entity_name : entity_names) {
+      if (entities_[entity_name]->statusSet()) {
+        updated_entity_names.emplace_back(entity_name);
+      }
+    }
+    auto statuses = updateNpcLogic(updated_entity_names, type_list);
+    auto store = std::make_shared<EntityStatusStore>(++entity_status_frame_);
+    store->reserve(updated_entity_names.size());
+    for (std::size_t i = 0; i < updated_entity_names.size(); ++i) {
+      auto & status = statuses[i];
+      status.name = updated_entity_names[i];
+      status.bounding_box = getBoundingBox(updated_entity_names[i]);
+      store->emplace(status);
+      all_status.emplace(updated_entity_names[i], status);
     }
+    entity_status_store_ = store;
+    entity_spatial_index_ = std::make_shared<const EntitySpatialIndex>(store);
   }
   for (auto it = entities_.begin(); it != entities_.end(); it++) {
-    it->second->setOtherStatus(all_status);
+    it->second->setOtherStatus(entity_spatial_index_);
   }
   auto entity_type_list = getEntityTypeList();
   traffic_simulator_msgs::msg::EntityStatusWithTrajectoryArray status_array_msg;
@@ -0,0 +1,217 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <scenario_simulator_exception/exception.hpp>
+#include <traffic_simulator/entity/entity_spatial_index.hpp>
+#include <vector>
+
+namespace traffic_simulator
+{
+namespace entity
+{
+namespace
+{
+constexpr std::int64_t max_cells_per_entity = 64;
+
+/**
+ * @note Axis-aligned box of the bounding box rotated and translated by the pose. The box contains
+ * all eight corners, so it contains the polygon of math::getPointsFromBbox placed at the pose too.
+ */
+template <typename Box>
+Box getFootprint(
+  const geometry_msgs::msg::Pose & pose, const traffic_simulator_msgs::msg::BoundingBox & bbox)
+{
+  const auto & q = pose.orientation;
+  const double r00 = 1 - 2 * (q.y * q.y + q.z * q.z);
+  const double r01 = 2 * (q.x * q.y - q.z * q.w);
+  const double r02 = 2 * (q.x * q.z + q.y * q.w);
+  const double r10 = 2 * (q.x * q.y + q.z * q.w);
+  const double r11 = 1 - 2 * (q.x * q.x + q.z * q.z);
+  const double r12 = 2 * (q.y * q.z - q.x * q.w);
+  const auto & c = bbox.center;
+  const double hx = bbox.dimensions.x * 0.5;
+  const double hy = bbox.dimensions.y * 0.5;
+  const double hz = bbox.dimensions.z * 0.5;
+  const double x = pose.position.x + r00 * c.x + r01 * c.y + r02 * c.z;
+  const double y = pose.position.y + r10 * c.x + r11 * c.y + r12 * c.z;
+  const double ex = std::abs(r00) * hx + std::abs(r01) * hy + std::abs(r02) * hz;
+  const double ey = std::abs(r10) * hx + std::abs(r11) * hy + std::abs(r12) * hz;
+  return {
+    std::min(x - ex, pose.position.x), std::min(y - ey, pose.position.y),
+    std::max(x + ex, pose.position.x), std::max(y + ey, pose.position.y)};
+}
+}  // namespace
+
+EntitySpatialIndex::EntitySpatialIndex(
+  const std::shared_ptr<const EntityStatusStore> & store, double cell_size)
+: store_(store), cell_size_(cell_size), bounds_({0, 0, 0, 0})
+{
+  if (!(cell_size_ > 0)) {
+    THROW_SIMULATION_ERROR("cell size of the entity spatial index must be positive.");
+  }
+  if (!store_) {
+    return;
+  }
+  footprints_.reserve(store_->size());
+  std::vector<std::size_t> gridded;
+  gridded.reserve(store_->size());
+  bounds_ = {
+    std::numeric_limits<double>::max(), std::numeric_limits<double>::max(),
+    std::numeric_limits<double>::lowest(), std::numeric_limits<double>::lowest()};
+  for (std::size_t index = 0; index < store_->size(); ++index) {
+    const auto box = getFootprint<Box>(store_->getPose(index), store_->getBoundingBox(index));
+    footprints_.emplace_back(box);
+    if (
+      std::isfinite(box.min_x) && std::isfinite(box.min_y) && std::isfinite(box.max_x) &&
+      std::isfinite(box.max_y)) {
+      gridded.emplace_back(index);
+      bounds_.min_x = std::min(bounds_.min_x, box.min_x);
+      bounds_.min_y = std::min(bounds_.min_y, box.min_y);
+      bounds_.max_x = std::max(bounds_.max_x, box.max_x);
+      bounds_.max_y = std::max(bounds_.max_y, box.max_y);
+    } else {
+      oversized_.emplace_back(index);
+    }
+  }
+  if (!gridded.empty()) {
+    /**
+     * @note If the entities are spread over a large area, the cells are enlarged so that the grid
+     * does not have much more cells than there are entities.
+     */
+    const auto max_cells = static_cast<double>(4 * gridded.size() + 64);
+    while ((std::floor((bounds_.max_x - bounds_.min_x) / cell_size_) + 1) *
+             (std::floor((bounds_.max_y - bounds_.min_y) / cell_size_) + 1) >
+           max_cells) {
+      cell_size_ *= 2;
+    }
+    columns_ = getCellX(bounds_.max_x) + 1;
+    rows_ = getCellY(bounds_.max_y) + 1;
+  }
+  cell_ranges_.resize(store_->size());
+  cell_offsets_.assign(columns_ * rows_ + 1, 0);
+  auto entities = gridded.begin();
+  for (const auto index : gridded) {
+    const auto & box = footprints_[index];
+    const CellRange range = {
+      getCellX(box.min_x), getCellY(box.min_y), getCellX(box.max_x), getCellY(box.max_y)};
+    cell_ranges_[index] = range;
+    if ((range.max_x - range.min_x + 1) * (range.max_y - range.min_y + 1) > max_cells_per_entity) {
+      oversized_.emplace_back(index);
+      continue;
+    }
+    *entities++ = index;
+    for (auto y = range.min_y; y <= range.max_y; ++y) {
+      for (auto x = range.min_x; x <= range.max_x; ++x) {
+        ++cell_offsets_[y * columns_ + x + 1];
+      }
+    }
+  }
+  gridded.erase(entities, gridded.end());
+  std::sort(oversized_.begin(), oversized_.end());
+  for (std::size_t cell = 1; cell < cell_offsets_.size(); ++cell) {
+    cell_offsets_[cell] += cell_offsets_[cell - 1];
+  }
+  cell_entities_.resize(cell_offsets_.back());
+  auto cursors = cell_offsets_;
+  for (const auto index : gridded) {
+    const auto & range = cell_ranges_[index];
+    for (auto y = range.min_y; y <= range.max_y; ++y) {
+      for (auto x = range.min_x; x <= range.max_x; ++x) {
+        cell_entities_[cursors[y * columns_ + x]++] = index;
+      }
+    }
+  }
+  for (std::size_t index = 0; index < store_->size(); ++index) {
+    lanelets_[store_->getLaneletPose(index).lanelet_id].emplace_back(index);
+  }
+}
+
+auto EntitySpatialIndex::getCellX(double x) const -> std::int64_t
+{
+  return static_cast<std::int64_t>(std::floor((x - bounds_.min_x) / cell_size_));
+}
+
+auto EntitySpatialIndex::getCellY(double y) const -> std::int64_t
+{
+  return static_cast<std::int64_t>(std::floor((y - bounds_.min_y) / cell_size_));
+}
+
+auto EntitySpatialIndex::query(double min_x, double min_y, double max_x, double max_y) const
+  -> std::vector<std::size_t>
+{
+  std::vector<std::size_t> candidates;
+  const auto overlaps = [&](std::size_t index) {
+    const auto & box = footprints_[index];
+    return box.min_x <= max_x && min_x <= box.max_x && box.min_y <= max_y && min_y <= box.max_y;
+  };
+  if (
+    columns_ > 0 && bounds_.min_x <= max_x && min_x <= bounds_.max_x && bounds_.min_y <= max_y &&
+    min_y <= bounds_.max_y) {
+    const auto cell_min_x = std::max<std::int64_t>(getCellX(std::max(min_x, bounds_.min_x)), 0);
+    const auto cell_min_y = std::max<std::int64_t>(getCellY(std::max(min_y, bounds_.min_y)), 0);
+    const auto cell_max_x = std::min(getCellX(std::min(max_x, bounds_.max_x)), columns_ - 1);
+    const auto cell_max_y = std::min(getCellY(std::min(max_y, bounds_.max_y)), rows_ - 1);
+    /**
+     * @note Walking the cells costs more than testing every footprint if the box covers many cells
+     * compared to the number of entities, which happens with few entities.
+     */
+    if ((cell_max_x - cell_min_x + 1) * (cell_max_y - cell_min_y + 1) * 4 >
+        static_cast<std::int64_t>(footprints_.size())) {
+      for (std::size_t index = 0; index < footprints_.size(); ++index) {
+        if (overlaps(index)) {
+          candidates.emplace_back(index);
+        }
+      }
+      return candidates;
+    }
+    for (auto y = cell_min_y; y <= cell_max_y; ++y) {
+      for (auto x = cell_min_x; x <= cell_max_x; ++x) {
+        const auto cell = y * columns_ + x;
+        for (auto i = cell_offsets_[cell]; i < cell_offsets_[cell + 1]; ++i) {
+          const auto index = cell_entities_[i];
+          const auto & range = cell_ranges_[index];
+          /**
+           * @note An entity in several cells is reported only from the first of them in the query.
+           */
+          if (
+            x == std::max(range.min_x, cell_min_x) && y == std::max(range.min_y, cell_min_y) &&
+            overlaps(index)) {
+            candidates.emplace_back(index);
+          }
+        }
+      }
+    }
+  }
+  for (const auto index : oversized_) {
+    if (overlaps(index)) {
+      candidates.emplace_back(index);
+    }
+  }
+  std::sort(candidates.begin(), candidates.end());
+  return candidates;
+}
+
+auto EntitySpatialIndex::getEntitiesOnLanelet(std::int64_t lanelet_id) const
+  -> const std::vector<std::size_t> &
+{
+  static const std::vector<std::size_t> none;
+  const auto iter = lanelets_.find(lanelet_id);
+  return iter == lanelets_.end() ? none : iter->second;
+}
+}  // namespace entity
+}  // namespace traffic_simulator
@@ -0,0 +1,165 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <memory>
+#include <scenario_simulator_exception/exception.hpp>
+#include <string>
+#include <traffic_simulator/entity/entity_spatial_index.hpp>
+#include <traffic_simulator/entity/entity_status_store.hpp>
+#include <vector>
+
+namespace traffic_simulator
+{
+namespace entity
+{
+EntityStatusStore::EntityStatusStore(std::uint64_t frame) : frame_(frame) {}
+
+void EntityStatusStore::reserve(std::size_t size)
+{
+  names_.reserve(size);
+  poses_.reserve(size);
+  twists_.reserve(size);
+  accels_.reserve(size);
+  lanelet_poses_.reserve(size);
+  lanelet_pose_valid_.reserve(size);
+  bounding_boxes_.reserve(size);
+  attributes_.reserve(size);
+  indices_.reserve(size);
+}
+
+void EntityStatusStore::emplace(const traffic_simulator_msgs::msg::EntityStatus & status)
+{
+  if (!indices_.emplace(status.name, names_.size()).second) {
+    THROW_SIMULATION_ERROR("entity : ", status.name, " is already stored in this frame.");
+  }
+  names_.emplace_back(status.name);
+  poses_.emplace_back(status.pose);
+  twists_.emplace_back(status.action_status.twist);
+  accels_.emplace_back(status.action_status.accel);
+  lanelet_poses_.emplace_back(status.lanelet_pose);
+  lanelet_pose_valid_.emplace_back(status.lanelet_pose_valid);
+  bounding_boxes_.emplace_back(status.bounding_box);
+  attributes_.push_back(
+    {status.type, status.subtype, status.time, status.action_status.current_action});
+}
+
+auto EntityStatusStore::find(const std::string & name) const -> boost::optional<std::size_t>
+{
+  const auto iter = indices_.find(name);
+  if (iter == indices_.end()) {
+    return boost::none;
+  }
+  return iter->second;
+}
+
+auto EntityStatusStore::getStatus(std::size_t index) const
+  -> traffic_simulator_msgs::msg::EntityStatus
+{
+  traffic_simulator_msgs::msg::EntityStatus status;
+  status.type = attributes_[index].type;
+  status.subtype = attributes_[index].subtype;
+  status.time = attributes_[index].time;
+  status.name = names_[index];
+  status.bounding_box = bounding_boxes_[index];
+  status.action_status.current_action = attributes_[index].current_action;
+  status.action_status.twist = twists_[index];
+  status.action_status.accel = accels_[index];
+  status.pose = poses_[index];
+  status.lanelet_pose = lanelet_poses_[index];
+  status.lanelet_pose_valid = lanelet_pose_valid_[index];
+  return status;
+}
+
+EntityStatusView::EntityStatusView(
+  const std::shared_ptr<const EntityStatusStore> & store, const std::string & self_name,
+  const geometry_msgs::msg::Point & self_position, double range)
+: store_(store)
+{
+  auto indices = std::make_shared<std::vector<std::size_t>>();
+  if (store_) {
+    const double squared_range = range * range;
+    for (std::size_t index = 0; index < store_->size(); ++index) {
+      if (store_->getName(index) != self_name) {
+        const auto & p = store_->getPose(index).position;
+        const double dx = p.x - self_position.x;
+        const double dy = p.y - self_position.y;
+        const double dz = p.z - self_position.z;
+        if (dx * dx + dy * dy + dz * dz < squared_range) {
+          indices->emplace_back(index);
+        }
+      }
+    }
+  }
+  indices_ = indices;
+}
+
+EntityStatusView::EntityStatusView(
+  const std::shared_ptr<const EntitySpatialIndex> & index, const std::string & self_name,
+  const geometry_msgs::msg::Point & self_position, double range)
+: store_(index ? index->store() : nullptr)
+{
+  auto indices = std::make_shared<std::vector<std::size_t>>();
+  if (store_) {
+    const double squared_range = range * range;
+    for (const auto i : index->query(
+           self_position.x - range, self_position.y - range, self_position.x + range,
+           self_position.y + range)) {
+      if (store_->getName(i) != self_name) {
+        const auto & p = store_->getPose(i).position;
+        const double dx = p.x - self_position.x;
+        const double dy = p.y - self_position.y;
+        const double dz = p.z - self_position.z;
+        if (dx * dx + dy * dy + dz * dz < squared_range) {
+          indices->emplace_back(i);
+        }
+      }
+    }
+  }
+  indices_ = indices;
+}
+
+auto EntityStatusView::find(const std::string & name) const -> boost::optional<std::size_t>
+{
+  if (!store_) {
+    return boost::none;
+  }
+  if (const auto index = store_->find(name)) {
+    return findIndex(index.get());
+  }
+  return boost::none;
+}
+
+auto EntityStatusView::findIndex(std::size_t index) const -> boost::optional<std::size_t>
+{
+  if (!indices_) {
+    return boost::none;
+  }
+  const auto iter = std::lower_bound(indices_->begin(), indices_->end(), index);
+  if (iter != indices_->end() && *iter == index) {
+    return static_cast<std::size_t>(std::distance(indices_->begin(), iter));
+  }
+  return boost::none;
+}
+
+auto EntityStatusView::getStatus(const std::string & name) const
+  -> boost::optional<traffic_simulator_msgs::msg::EntityStatus>
+{
+  if (const auto i = find(name)) {
+    return getStatus(i.get());
+  }
+  return boost::none;
+}
+}  // namespace entity
+}  // namespace traffic_simulator
@@ -36,7 +36,8 @@ PedestrianEntity::PedestrianEntity(
 {
   entity_type_.type = traffic_simulator_msgs::msg::EntityType::PEDESTRIAN;
   behavior_plugin_ptr_->configure(rclcpp::get_logger(name));
-  behavior_plugin_ptr_->setPedestrianParameters(parameters);
+  behavior_plugin_ptr_->setPedestrianParameters(
+    std::make_shared<const traffic_simulator_msgs::msg::PedestrianParameters>(parameters));
   behavior_plugin_ptr_->setDebugMarker({});
   behavior_plugin_ptr_->setDriverModel(traffic_simulator_msgs::msg::DriverModel());
 }
@@ -156,16 +157,17 @@ void PedestrianEntity::onUpdate(double current_time, double step_time)
     updateEntityStatusTimestamp(current_time);
   } else {
     behavior_plugin_ptr_->setOtherEntityStatus(other_status_);
+    behavior_plugin_ptr_->setEntitySpatialIndex(entity_spatial_index_);
     behavior_plugin_ptr_->setEntityTypeList(entity_type_list_);
-    behavior_plugin_ptr_->setEntityStatus(status_.get());
+    behavior_plugin_ptr_->setEntityStatus(
+      std::make_shared<const traffic_simulator_msgs::msg::EntityStatus>(status_.get()));
     target_speed_planner_.update(status_->action_status.twist.linear.x, other_status_);
     behavior_plugin_ptr_->setTargetSpeed(target_speed_planner_.getTargetSpeed());
     if (status_->lanelet_pose_valid) {
-      auto route = route_planner_ptr_->getRouteLanelets(status_->lanelet_pose);
-      behavior_plugin_ptr_->setRouteLanelets(route);
+      behavior_plugin_ptr_->setRouteLanelets(std::make_shared<const std::vector<std::int64_t>>(
+        route_planner_ptr_->getRouteLanelets(status_->lanelet_pose)));
     } else {
-      std::vector<std::int64_t> empty = {};
-      behavior_plugin_ptr_->setRouteLanelets(empty);
+      behavior_plugin_ptr_->setRouteLanelets(std::make_shared<const std::vector<std::int64_t>>());
     }
     behavior_plugin_ptr_->update(current_time, step_time);
     auto status_updated = behavior_plugin_ptr_->getUpdatedStatus();
@@ -37,7 +37,8 @@ VehicleEntity::VehicleEntity(
 {
   entity_type_.type = traffic_simulator_msgs::msg::EntityType::VEHICLE;
   behavior_plugin_ptr_->configure(rclcpp::get_logger(name));
-  behavior_plugin_ptr_->setVehicleParameters(parameters);
+  behavior_plugin_ptr_->setVehicleParameters(
+    std::make_shared<const traffic_simulator_msgs::msg::VehicleParameters>(parameters));
   behavior_plugin_ptr_->setDebugMarker({});
   behavior_plugin_ptr_->setDriverModel(traffic_simulator_msgs::msg::DriverModel());
 }
@@ -136,8 +137,10 @@ void VehicleEntity::onUpdate(double current_time, double step_time)
     updateEntityStatusTimestamp(current_time);
   } else {
     behavior_plugin_ptr_->setOtherEntityStatus(other_status_);
+    behavior_plugin_ptr_->setEntitySpatialIndex(entity_spatial_index_);
     behavior_plugin_ptr_->setEntityTypeList(entity_type_list_);
-    behavior_plugin_ptr_->setEntityStatus(status_.get());
+    behavior_plugin_ptr_->setEntityStatus(
+      std::make_shared<const traffic_simulator_msgs::msg::EntityStatus>(status_.get()));
     target_speed_planner_.update(status_->action_status.twist.linear.x, other_status_);
     behavior_plugin_ptr_->setTargetSpeed(target_speed_planner_.getTargetSpeed());
 
@@ -145,7 +148,8 @@ void VehicleEntity::onUpdate(double current_time, double step_time)
     if (status_->lanelet_pose_valid) {
       route_lanelets = route_planner_ptr_->getRouteLanelets(status_->lanelet_pose);
     }
-    behavior_plugin_ptr_->setRouteLanelets(route_lanelets);
+    behavior_plugin_ptr_->setRouteLanelets(
+      std::make_shared<const std::vector<std::int64_t>>(route_lanelets));
 
     // recalculate spline only when input data changes
     if (previous_route_lanelets_ != route_lanelets) {
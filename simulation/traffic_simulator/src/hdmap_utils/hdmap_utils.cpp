@@ -39,6 +39,7 @@
 #include <string>
 #include <traffic_simulator/color_utils/color_utils.hpp>
 #include <traffic_simulator/hdmap_utils/hdmap_utils.hpp>
+#include <traffic_simulator/hdmap_utils/precompiled_map.hpp>
 #include <traffic_simulator/helper/helper.hpp>
 #include <traffic_simulator/math/catmull_rom_spline.hpp>
 #include <traffic_simulator/math/hermite_curve.hpp>
@@ -51,13 +52,57 @@
 namespace hdmap_utils
 {
 HdMapUtils::HdMapUtils(
-  const boost::filesystem::path & lanelet2_map_path, const geographic_msgs::msg::GeoPoint &)
+  const boost::filesystem::path & lanelet2_map_path, const geographic_msgs::msg::GeoPoint &,
+  const boost::filesystem::path & precompiled_map_directory, std::size_t cache_capacity,
+  double route_table_horizon)
+: route_cache_(cache_capacity),
+  center_points_cache_(cache_capacity),
+  lanelet_length_cache_(cache_capacity)
+{
+  if (precompiled_map_directory.empty()) {
+    lanelet_map_ptr_ = loadLaneletMap(lanelet2_map_path);
+    overwriteLaneletsCenterline();
+  } else {
+    const PrecompiledMapCache cache(precompiled_map_directory);
+    const auto hash = PrecompiledMapCache::hash(lanelet2_map_path);
+    lanelet_map_ptr_ = cache.load(hash);
+    if (!lanelet_map_ptr_) {
+      lanelet_map_ptr_ = loadLaneletMap(lanelet2_map_path);
+      overwriteLaneletsCenterline();
+      cache.save(hash, *lanelet_map_ptr_);
+    }
+  }
+  traffic_rules_vehicle_ptr_ = lanelet::traffic_rules::TrafficRulesFactory::create(
+    lanelet::Locations::Germany, lanelet::Participants::Vehicle);
+  vehicle_routing_graph_ptr_ =
+    lanelet::routing::RoutingGraph::build(*lanelet_map_ptr_, *traffic_rules_vehicle_ptr_);
+  traffic_rules_pedestrian_ptr_ = lanelet::traffic_rules::TrafficRulesFactory::create(
+    lanelet::Locations::Germany, lanelet::Participants::Pedestrian);
+  pedestrian_routing_graph_ptr_ =
+    lanelet::routing::RoutingGraph::build(*lanelet_map_ptr_, *traffic_rules_pedestrian_ptr_);
+  std::vector<lanelet::routing::RoutingGraphConstPtr> all_graphs;
+  all_graphs.push_back(vehicle_routing_graph_ptr_);
+  all_graphs.push_back(pedestrian_routing_graph_ptr_);
+  if (route_table_horizon > 0) {
+    std::vector<RouteTable::Lanelet> lanelets;
+    for (const auto & lanelet : lanelet_map_ptr_->laneletLayer) {
+      lanelets.push_back({
+        lanelet.id(), lanelet::utils::getLaneletLength2d(lanelet),
+        getNextLaneletIds(lanelet.id())});
+    }
+    route_table_ = std::make_unique<const RouteTable>(lanelets, route_table_horizon);
+  }
+}
+
+lanelet::LaneletMapPtr HdMapUtils::loadLaneletMap(
+  const boost::filesystem::path & lanelet2_map_path) const
 {
   lanelet::projection::MGRSProjector projector;
 
   lanelet::ErrorMessages errors;
 
-  lanelet_map_ptr_ = lanelet::load(lanelet2_map_path.string(), projector, &errors);
+  lanelet::LaneletMapPtr lanelet_map_ptr =
+    lanelet::load(lanelet2_map_path.string(), projector, &errors);
 
   if (not errors.empty()) {
     std::stringstream ss;
@@ -68,18 +113,7 @@ HdMapUtils::HdMapUtils(
     }
     THROW_SIMULATION_ERROR("Failed to load lanelet map (", ss.str(), ")");
   }
-  overwriteLaneletsCenterline();
-  traffic_rules_vehicle_ptr_ = lanelet::traffic_rules::TrafficRulesFactory::create(
-    lanelet::Locations::Germany, lanelet::Participants::Vehicle);
-  vehicle_routing_graph_ptr_ =
-    lanelet::routing::RoutingGraph::build(*lanelet_map_ptr_, *traffic_rules_vehicle_ptr_);
-  traffic_rules_pedestrian_ptr_ = lanelet::traffic_rules::TrafficRulesFactory::create(
-    lanelet::Locations::Germany, lanelet::Participants::Pedestrian);
-  pedestrian_routing_graph_ptr_ =
-    lanelet::routing::RoutingGraph::build(*lanelet_map_ptr_, *traffic_rules_pedestrian_ptr_);
-  std::vector<lanelet::routing::RoutingGraphConstPtr> all_graphs;
-  all_graphs.push_back(vehicle_routing_graph_ptr_);
-  all_graphs.push_back(pedestrian_routing_graph_ptr_);
+  return lanelet_map_ptr;
 }
 
 const std::vector<std::int64_t> HdMapUtils::getLaneletIds()
@@ -659,35 +693,38 @@ std::vector<std::int64_t> HdMapUtils::getFollowingLanelets(
 std::vector<std::int64_t> HdMapUtils::getRoute(
   std::int64_t from_lanelet_id, std::int64_t to_lanelet_id)
 {
-  if (route_cache_.exists(from_lanelet_id, to_lanelet_id)) {
-    return route_cache_.getRoute(from_lanelet_id, to_lanelet_id);
-  }
-  std::vector<std::int64_t> ret;
-  const auto lanelet = lanelet_map_ptr_->laneletLayer.get(from_lanelet_id);
-  const auto to_lanelet = lanelet_map_ptr_->laneletLayer.get(to_lanelet_id);
-  lanelet::Optional<lanelet::routing::Route> route =
-    vehicle_routing_graph_ptr_->getRoute(lanelet, to_lanelet, 0, false);
-  if (!route) {
-    route_cache_.appendData(from_lanelet_id, to_lanelet_id, ret);
-    return ret;
+  if (route_table_ && from_lanelet_id != to_lanelet_id) {
+    auto route = route_table_->getRoute(from_lanelet_id, to_lanelet_id);
+    if (!route.empty()) {
+      return route;
+    }
   }
-  lanelet::routing::LaneletPath shortest_path = route->shortestPath();
-  if (shortest_path.empty()) {
-    route_cache_.appendData(from_lanelet_id, to_lanelet_id, ret);
+  return *route_cache_.getOrCompute({from_lanelet_id, to_lanelet_id}, [&]() {
+    std::vector<std::int64_t> ret;
+    const auto lanelet = lanelet_map_ptr_->laneletLayer.get(from_lanelet_id);
+    const auto to_lanelet = lanelet_map_ptr_->laneletLayer.get(to_lanelet_id);
+    lanelet::Optional<lanelet::routing::Route> route =
+      vehicle_routing_graph_ptr_->getRoute(lanelet, to_lanelet, 0, false);
+    if (!route) {
+      return ret;
+    }
+    lanelet::routing::LaneletPath shortest_path = route->shortestPath();
+    if (shortest_path.empty()) {
+      return ret;
+    }
+    for (auto lane_itr = shortest_path.begin(); lane_itr != shortest_path.end(); lane_itr++) {
+      ret.push_back(lane_itr->id());
+    }
     return ret;
-  }
-  for (auto lane_itr = shortest_path.begin(); lane_itr != shortest_path.end(); lane_itr++) {
-    ret.push_back(lane_itr->id());
-  }
-  route_cache_.appendData(from_lanelet_id, to_lanelet_id, ret);
-  return ret;
+  });
 }
 
-std::shared_ptr<traffic_simulator::math::CatmullRomSpline> HdMapUtils::getCenterPointsSpline(
+std::shared_ptr<const traffic_simulator::math::CatmullRomSpline> HdMapUtils::getCenterPointsSpline(
   std::int64_t lanelet_id)
 {
-  getCenterPoints(lanelet_id);
-  return center_points_cache_.getCenterPointsSpline(lanelet_id);
+  const auto center_points = getCenterPointsEntry(lanelet_id);
+  return std::shared_ptr<const traffic_simulator::math::CatmullRomSpline>(
+    center_points, &center_points->spline);
 }
 
 std::vector<geometry_msgs::msg::Point> HdMapUtils::getCenterPoints(
@@ -698,8 +735,9 @@ std::vector<geometry_msgs::msg::Point> HdMapUtils::getCenterPoints(
     return ret;
   }
   for (const auto lanelet_id : lanelet_ids) {
-    std::vector<geometry_msgs::msg::Point> center_points = getCenterPoints(lanelet_id);
-    std::copy(center_points.begin(), center_points.end(), std::back_inserter(ret));
+    const auto center_points = getCenterPointsEntry(lanelet_id);
+    std::copy(
+      center_points->points.begin(), center_points->points.end(), std::back_inserter(ret));
   }
   ret.erase(std::unique(ret.begin(), ret.end()), ret.end());
   return ret;
@@ -707,50 +745,49 @@ std::vector<geometry_msgs::msg::Point> HdMapUtils::getCenterPoints(
 
 std::vector<geometry_msgs::msg::Point> HdMapUtils::getCenterPoints(std::int64_t lanelet_id)
 {
-  std::vector<geometry_msgs::msg::Point> ret;
+  return getCenterPointsEntry(lanelet_id)->points;
+}
+
+std::shared_ptr<const CenterPoints> HdMapUtils::getCenterPointsEntry(std::int64_t lanelet_id)
+{
   if (!lanelet_map_ptr_) {
     THROW_SIMULATION_ERROR("lanelet map is null pointer");
   }
   if (lanelet_map_ptr_->laneletLayer.empty()) {
     THROW_SIMULATION_ERROR("lanelet layer is empty");
   }
-  if (center_points_cache_.exists(lanelet_id)) {
-    return center_points_cache_.getCenterPoints(lanelet_id);
-  }
-
-  const auto lanelet = lanelet_map_ptr_->laneletLayer.get(lanelet_id);
-  const auto centerline = lanelet.centerline();
-  for (const auto & point : centerline) {
-    geometry_msgs::msg::Point p;
-    p.x = point.x();
-    p.y = point.y();
-    p.z = point.z();
-    ret.push_back(p);
-  }
-  if (static_cast<int>(ret.size()) == 2) {
-    const auto p0 = ret[0];
-    const auto p2 = ret[1];
-    geometry_msgs::msg::Point p1;
-    p1.x = (p0.x + p2.x) * 0.5;
-    p1.y = (p0.y + p2.y) * 0.5;
-    p1.z = (p0.z + p2.z) * 0.5;
-    ret.clear();
-    ret.push_back(p0);
-    ret.push_back(p1);
-    ret.push_back(p2);
-  }
-  center_points_cache_.appendData(lanelet_id, ret);
-  return ret;
+  return center_points_cache_.getOrCompute(lanelet_id, [&]() {
+    std::vector<geometry_msgs::msg::Point> ret;
+    const auto lanelet = lanelet_map_ptr_->laneletLayer.get(lanelet_id);
+    const auto centerline = lanelet.centerline();
+    for (const auto & point : centerline) {
+      geometry_msgs::msg::Point p;
+      p.x = point.x();
+      p.y = point.y();
+      p.z = point.z();
+      ret.push_back(p);
+    }
+    if (static_cast<int>(ret.size()) == 2) {
+      const auto p0 = ret[0];
+      const auto p2 = ret[1];
+      geometry_msgs::msg::Point p1;
+      p1.x = (p0.x + p2.x) * 0.5;
+      p1.y = (p0.y + p2.y) * 0.5;
+      p1.z = (p0.z + p2.z) * 0.5;
+      ret.clear();
+      ret.push_back(p0);
+      ret.push_back(p1);
+      ret.push_back(p2);
+    }
+    return CenterPoints(ret);
+  });
 }
 
 double HdMapUtils::getLaneletLength(std::int64_t lanelet_id)
 {
-  if (lanelet_length_cache_.exists(lanelet_id)) {
-    return lanelet_length_cache_.getLength(lanelet_id);
-  }
-  double ret = lanelet::utils::getLaneletLength2d(lanelet_map_ptr_->laneletLayer.get(lanelet_id));
-  lanelet_length_cache_.appendData(lanelet_id, ret);
-  return ret;
+  return *lanelet_length_cache_.getOrCompute(lanelet_id, [&]() {
+    return lanelet::utils::getLaneletLength2d(lanelet_map_ptr_->laneletLayer.get(lanelet_id));
+  });
 }
 
 std::vector<std::int64_t> HdMapUtils::getPreviousLaneletIds(std::int64_t lanelet_id) const
@@ -1142,6 +1179,11 @@ boost::optional<double> HdMapUtils::getLongitudinalDistance(
       return to_s - from_s;
     }
   }
+  if (route_table_) {
+    if (const auto distance = route_table_->getDistance(from_lanelet_id, to_lanelet_id)) {
+      return getLaneletLength(from_lanelet_id) - from_s + distance.get() + to_s;
+    }
+  }
   const auto route = getRoute(from_lanelet_id, to_lanelet_id);
   if (route.empty()) {
     return boost::none;
@@ -1440,6 +1482,18 @@ const std::vector<std::int64_t> HdMapUtils::getTrafficLightIdsOnPath(
 const boost::optional<double> HdMapUtils::getDistanceToTrafficLightStopLine(
   const std::vector<std::int64_t> & route_lanelets,
   const std::vector<geometry_msgs::msg::Point> & waypoints) const
+{
+  // NOTE: The spline is not built without traffic lights on the path, as it was not before.
+  if (waypoints.empty() || getTrafficLightIdsOnPath(route_lanelets).empty()) {
+    return boost::none;
+  }
+  return getDistanceToTrafficLightStopLine(
+    route_lanelets, traffic_simulator::math::CatmullRomSpline(waypoints));
+}
+
+const boost::optional<double> HdMapUtils::getDistanceToTrafficLightStopLine(
+  const std::vector<std::int64_t> & route_lanelets,
+  const traffic_simulator::math::CatmullRomSpline & spline) const
 {
   auto traffic_light_ids = getTrafficLightIdsOnPath(route_lanelets);
   if (traffic_light_ids.size() == 0) {
@@ -1447,7 +1501,7 @@ const boost::optional<double> HdMapUtils::getDistanceToTrafficLightStopLine(
   }
   std::set<double> collision_points;
   for (const auto id : traffic_light_ids) {
-    const auto collision_point = getDistanceToTrafficLightStopLine(waypoints, id);
+    const auto collision_point = getDistanceToTrafficLightStopLine(spline, id);
     if (collision_point) {
       collision_points.insert(collision_point.get());
     }
@@ -1465,10 +1519,16 @@ const boost::optional<double> HdMapUtils::getDistanceToTrafficLightStopLine(
   if (waypoints.empty()) {
     return boost::none;
   }
-  traffic_simulator::math::CatmullRomSpline spline(waypoints);
-  const auto stop_lines = getTrafficLightStopLinesPoints(traffic_light_id);
-  for (const auto & stop_line : stop_lines) {
-    const auto collision_point = spline.getCollisionPointIn2D(stop_line);
+  return getDistanceToTrafficLightStopLine(
+    traffic_simulator::math::CatmullRomSpline(waypoints), traffic_light_id);
+}
+
+const boost::optional<double> HdMapUtils::getDistanceToTrafficLightStopLine(
+  const traffic_simulator::math::CatmullRomSpline & spline,
+  const std::int64_t & traffic_light_id) const
+{
+  for (const auto & collision_point :
+       spline.getCollisionPointsIn2D(getTrafficLightStopLinesPoints(traffic_light_id))) {
     if (collision_point) {
       return collision_point;
     }
@@ -1483,13 +1543,17 @@ boost::optional<double> HdMapUtils::getDistanceToStopLine(
   if (waypoints.empty()) {
     return boost::none;
   }
+  return getDistanceToStopLine(
+    route_lanelets, traffic_simulator::math::CatmullRomSpline(waypoints));
+}
+
+boost::optional<double> HdMapUtils::getDistanceToStopLine(
+  const std::vector<std::int64_t> & route_lanelets,
+  const traffic_simulator::math::CatmullRomSpline & spline)
+{
   std::set<double> collision_points;
-  if (waypoints.empty()) {
-    return boost::none;
-  }
-  traffic_simulator::math::CatmullRomSpline spline(waypoints);
-  const auto stop_lines = getStopLinesOnPath({route_lanelets});
-  for (const auto & stop_line : stop_lines) {
+  std::vector<std::vector<geometry_msgs::msg::Point>> stop_lines_points;
+  for (const auto & stop_line : getStopLinesOnPath({route_lanelets})) {
     std::vector<geometry_msgs::msg::Point> stop_line_points;
     for (const auto & point : stop_line) {
       geometry_msgs::msg::Point p;
@@ -1498,7 +1562,9 @@ boost::optional<double> HdMapUtils::getDistanceToStopLine(
       p.z = point.z();
       stop_line_points.emplace_back(p);
     }
-    const auto collision_point = spline.getCollisionPointIn2D(stop_line_points);
+    stop_lines_points.emplace_back(stop_line_points);
+  }
+  for (const auto & collision_point : spline.getCollisionPointsIn2D(stop_lines_points)) {
     if (collision_point) {
       collision_points.insert(collision_point.get());
     }
@@ -0,0 +1,127 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <lanelet2_core/utility/Utilities.h>
+#include <lanelet2_io/io_handlers/Serialize.h>
+#include <sodium.h>
+
+#include <array>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <boost/iostreams/stream.hpp>
+#include <boost/serialization/string.hpp>
+#include <fstream>
+#include <iomanip>
+#include <scenario_simulator_exception/exception.hpp>
+#include <sstream>
+#include <string>
+#include <traffic_simulator/hdmap_utils/precompiled_map.hpp>
+#include <unistd.h>
+
+namespace hdmap_utils
+{
+/**
+ * @note Bump this whenever the contents of the map written into the cache change (e.g. the
+ * resolution of the fine centerline), otherwise stale entries would be reused.
+ */
+constexpr std::uint32_t precompiled_map_format_version = 1;
+
+PrecompiledMapCache::PrecompiledMapCache(const boost::filesystem::path & directory)
+: directory_(directory)
+{
+}
+
+auto PrecompiledMapCache::hash(const boost::filesystem::path & lanelet2_map_path) -> std::string
+{
+  if (sodium_init() < 0) {
+    THROW_SIMULATION_ERROR("Failed to initialize libsodium.");
+  }
+  std::ifstream ifs(lanelet2_map_path.string(), std::ios::binary);
+  if (!ifs) {
+    THROW_SIMULATION_ERROR("Failed to open lanelet map ", lanelet2_map_path.string(), ".");
+  }
+  crypto_generichash_state state;
+  crypto_generichash_init(&state, nullptr, 0, crypto_generichash_BYTES);
+  std::array<char, 1 << 16> buffer;
+  while (ifs.read(buffer.data(), buffer.size()) || ifs.gcount() > 0) {
+    crypto_generichash_update(
+      &state, reinterpret_cast<const unsigned char *>(buffer.data()),
+      static_cast<std::uint64_t>(ifs.gcount()));
+  }
+  std::array<unsigned char, crypto_generichash_BYTES> digest;
+  crypto_generichash_final(&state, digest.data(), digest.size());
+  std::stringstream ss;
+  for (const auto byte : digest) {
+    ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(byte);
+  }
+  return ss.str();
+}
+
+auto PrecompiledMapCache::entryPath(const std::string & hash) const -> boost::filesystem::path
+{
+  return directory_ / (hash + ".bin");
+}
+
+auto PrecompiledMapCache::load(const std::string & hash) const -> lanelet::LaneletMapPtr
+{
+  const auto path = entryPath(hash);
+  if (!boost::filesystem::exists(path) || boost::filesystem::file_size(path) == 0) {
+    return nullptr;
+  }
+  try {
+    boost::iostreams::mapped_file_source file(path.string());
+    boost::iostreams::stream<boost::iostreams::array_source> stream(file.data(), file.size());
+    boost::archive::binary_iarchive ia(stream);
+    std::uint32_t version;
+    std::string stored_hash;
+    ia >> version >> stored_hash;
+    if (version != precompiled_map_format_version || stored_hash != hash) {
+      return nullptr;
+    }
+    auto map = std::make_shared<lanelet::LaneletMap>();
+    ia >> *map;
+    lanelet::Id id_counter;
+    ia >> id_counter;
+    lanelet::utils::registerId(id_counter);
+    return map;
+  } catch (const std::exception &) {
+    /**
+     * @note A broken entry is treated as a cache miss. It is overwritten by the fresh load.
+     */
+    return nullptr;
+  }
+}
+
+void PrecompiledMapCache::save(const std::string & hash, const lanelet::LaneletMap & map) const
+{
+  boost::filesystem::create_directories(directory_);
+  const auto path = entryPath(hash);
+  const auto temporary_path =
+    boost::filesystem::path(path.string() + "." + std::to_string(::getpid()) + ".tmp");
+  {
+    std::ofstream ofs(temporary_path.string(), std::ios::binary | std::ios::trunc);
+    if (!ofs) {
+      THROW_SIMULATION_ERROR("Failed to write precompiled map ", temporary_path.string(), ".");
+    }
+    boost::archive::binary_oarchive oa(ofs);
+    oa << precompiled_map_format_version << hash;
+    oa << map;
+    auto id_counter = lanelet::utils::getId();
+    oa << id_counter;
+  }
+  boost::filesystem::rename(temporary_path, path);
+}
+}  // namespace hdmap_utils
@@ -0,0 +1,164 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <scenario_simulator_exception/exception.hpp>
+#include <traffic_simulator/hdmap_utils/route_table.hpp>
+#include <utility>
+#include <vector>
+
+namespace hdmap_utils
+{
+RouteTable::RouteTable(const std::vector<Lanelet> & lanelets, double horizon) : horizon_(horizon)
+{
+  if (!(horizon_ >= 0)) {
+    THROW_SIMULATION_ERROR("horizon of the route table must not be negative.");
+  }
+  ids_.reserve(lanelets.size());
+  for (const auto & lanelet : lanelets) {
+    if (!indices_.emplace(lanelet.id, ids_.size()).second) {
+      THROW_SIMULATION_ERROR("lanelet ", lanelet.id, " is given twice to the route table.");
+    }
+    ids_.emplace_back(lanelet.id);
+  }
+  std::vector<std::vector<std::size_t>> following(lanelets.size());
+  for (std::size_t index = 0; index < lanelets.size(); ++index) {
+    for (const auto id : lanelets[index].following_lanelet_ids) {
+      const auto iter = indices_.find(id);
+      if (iter != indices_.end()) {
+        following[index].emplace_back(iter->second);
+      }
+    }
+  }
+  /**
+   * @note One Dijkstra search bounded by the horizon from each lanelet. The distance and the first
+   * lanelet after the lanelet of departure are propagated together, so every entry knows the next
+   * hop of its shortest route.
+   */
+  constexpr auto infinity = std::numeric_limits<double>::infinity();
+  std::vector<double> distances(lanelets.size(), infinity);
+  std::vector<std::size_t> next_hops(lanelets.size());
+  std::vector<std::size_t> visited;
+  std::vector<Entry> entries;
+  using Candidate = std::pair<double, std::size_t>;
+  std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> candidates;
+  offsets_.reserve(lanelets.size() + 1);
+  offsets_.emplace_back(0);
+  for (std::size_t from = 0; from < lanelets.size(); ++from) {
+    distances[from] = 0;
+    visited.emplace_back(from);
+    for (const auto next : following[from]) {
+      if (distances[next] > 0) {
+        distances[next] = 0;
+        next_hops[next] = next;
+        visited.emplace_back(next);
+        candidates.emplace(0, next);
+      }
+    }
+    while (!candidates.empty()) {
+      const auto distance = candidates.top().first;
+      const auto index = candidates.top().second;
+      candidates.pop();
+      if (distance > distances[index]) {
+        continue;
+      }
+      entries.push_back({index, next_hops[index], distance});
+      const auto following_distance = distance + lanelets[index].length;
+      for (const auto next : following[index]) {
+        if (following_distance <= horizon_ && following_distance < distances[next]) {
+          if (distances[next] == infinity) {
+            visited.emplace_back(next);
+          }
+          distances[next] = following_distance;
+          next_hops[next] = next_hops[index];
+          candidates.emplace(following_distance, next);
+        }
+      }
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry & a, const Entry & b) {
+      return a.to < b.to;
+    });
+    entries_.insert(entries_.end(), entries.begin(), entries.end());
+    offsets_.emplace_back(entries_.size());
+    entries.clear();
+    for (const auto index : visited) {
+      distances[index] = infinity;
+    }
+    visited.clear();
+  }
+  entries_.shrink_to_fit();
+}
+
+auto RouteTable::find(std::size_t from, std::size_t to) const -> const Entry *
+{
+  const auto first = entries_.begin() + offsets_[from];
+  const auto last = entries_.begin() + offsets_[from + 1];
+  const auto iter =
+    std::lower_bound(first, last, to, [](const Entry & entry, std::size_t to) {
+      return entry.to < to;
+    });
+  return iter != last && iter->to == to ? &*iter : nullptr;
+}
+
+auto RouteTable::find(std::int64_t from_lanelet_id, std::int64_t to_lanelet_id) const
+  -> const Entry *
+{
+  const auto from = indices_.find(from_lanelet_id);
+  const auto to = indices_.find(to_lanelet_id);
+  if (from == indices_.end() || to == indices_.end()) {
+    return nullptr;
+  }
+  return find(from->second, to->second);
+}
+
+auto RouteTable::getDistance(std::int64_t from_lanelet_id, std::int64_t to_lanelet_id) const
+  -> boost::optional<double>
+{
+  if (const auto entry = find(from_lanelet_id, to_lanelet_id)) {
+    return entry->distance;
+  }
+  return boost::none;
+}
+
+auto RouteTable::getRoute(std::int64_t from_lanelet_id, std::int64_t to_lanelet_id) const
+  -> std::vector<std::int64_t>
+{
+  std::vector<std::int64_t> route;
+  const auto entry = find(from_lanelet_id, to_lanelet_id);
+  if (!entry) {
+    return route;
+  }
+  /**
+   * @note The rest of a shortest route is a shortest route from its second lanelet, which is
+   * closer to the lanelet of arrival, so it is in the table too.
+   */
+  const auto to = entry->to;
+  auto from = indices_.at(from_lanelet_id);
+  route.emplace_back(from_lanelet_id);
+  while (from != to) {
+    const auto hop = find(from, to);
+    if (!hop || route.size() > ids_.size()) {
+      THROW_SIMULATION_ERROR(
+        "route table has no route from lanelet ", ids_[from], " to lanelet ", to_lanelet_id,
+        " although it has one from lanelet ", from_lanelet_id, ".");
+    }
+    from = hop->next;
+    route.emplace_back(ids_[from]);
+  }
+  return route;
+}
+}  // namespace hdmap_utils
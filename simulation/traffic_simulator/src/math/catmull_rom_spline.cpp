@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <iostream>
 #include <limits>
 #include <rclcpp/rclcpp.hpp>
@@ -19,6 +20,7 @@
 #include <string>
 #include <traffic_simulator/math/catmull_rom_spline.hpp>
 #include <traffic_simulator/math/linear_algebra.hpp>
+#include <traffic_simulator/math/transform.hpp>
 #include <utility>
 #include <vector>
 
@@ -26,8 +28,38 @@ namespace traffic_simulator
 {
 namespace math
 {
+namespace
+{
+using BoundingBox = std::pair<geometry_msgs::msg::Point, geometry_msgs::msg::Point>;
+
+BoundingBox get2DBoundingBox(const std::vector<geometry_msgs::msg::Point> & points)
+{
+  BoundingBox box;
+  box.first.x = box.first.y = std::numeric_limits<double>::max();
+  box.second.x = box.second.y = std::numeric_limits<double>::lowest();
+  for (const auto & point : points) {
+    box.first.x = std::min(box.first.x, point.x);
+    box.first.y = std::min(box.first.y, point.y);
+    box.second.x = std::max(box.second.x, point.x);
+    box.second.y = std::max(box.second.y, point.y);
+  }
+  return box;
+}
+
+/**
+ * @note The margin covers rounding errors between the collision point found by the cubic solver
+ * and the bounding box of the curve.
+ */
+bool overlapsIn2D(const BoundingBox & a, const BoundingBox & b)
+{
+  constexpr double margin = 1e-6;
+  return a.first.x <= b.second.x + margin && b.first.x - margin <= a.second.x &&
+         a.first.y <= b.second.y + margin && b.first.y - margin <= a.second.y;
+}
+}  // namespace
+
 const std::vector<geometry_msgs::msg::Point> CatmullRomSpline::getPolygon(
-  double width, size_t num_points, double z_offset)
+  double width, size_t num_points, double z_offset) const
 {
   std::vector<geometry_msgs::msg::Point> points;
   std::vector<geometry_msgs::msg::Point> left_bounds = getLeftBounds(width, num_points, z_offset);
@@ -220,14 +252,21 @@ CatmullRomSpline::CatmullRomSpline(const std::vector<geometry_msgs::msg::Point>
       curves_.emplace_back(HermiteCurve(ax, bx, cx, dx, ay, by, cy, dy, az, bz, cz, dz));
     }
   }
+  accumulated_length_list_.emplace_back(0);
   for (const auto & curve : curves_) {
     length_list_.emplace_back(curve.getLength());
+    accumulated_length_list_.emplace_back(accumulated_length_list_.back() + curve.getLength());
     maximum_2d_curvatures_.emplace_back(curve.getMaximum2DCurvature());
+    bounding_boxes_.emplace_back(curve.get2DBoundingBox());
   }
-  total_length_ = 0;
-  for (const auto & length : length_list_) {
-    total_length_ = total_length_ + length;
+  bounding_box_ = bounding_boxes_.front();
+  for (const auto & box : bounding_boxes_) {
+    bounding_box_.first.x = std::min(bounding_box_.first.x, box.first.x);
+    bounding_box_.first.y = std::min(bounding_box_.first.y, box.first.y);
+    bounding_box_.second.x = std::max(bounding_box_.second.x, box.second.x);
+    bounding_box_.second.y = std::max(bounding_box_.second.y, box.second.y);
   }
+  total_length_ = accumulated_length_list_.back();
   checkConnection();
 }
 
@@ -240,56 +279,103 @@ std::pair<size_t, double> CatmullRomSpline::getCurveIndexAndS(double s) const
     return std::make_pair(
       curves_.size() - 1, s - (total_length_ - curves_[curves_.size() - 1].getLength()));
   }
-  double current_s = 0;
-  for (size_t i = 0; i < curves_.size(); i++) {
-    double prev_s = current_s;
-    current_s = current_s + length_list_[i];
-    if (prev_s <= s && s < current_s) {
-      return std::make_pair(i, s - prev_s);
-    }
+  /**
+   * @note accumulated_length_list_[i] is the s value at the start of the curve i, so the curve
+   * including s is the one before the first start point larger than s.
+   */
+  const auto iter =
+    std::upper_bound(accumulated_length_list_.begin(), accumulated_length_list_.end(), s);
+  if (iter == accumulated_length_list_.begin() || iter == accumulated_length_list_.end()) {
+    THROW_SIMULATION_ERROR("failed to calculate curve index");  // LCOV_EXCL_LINE
   }
-  THROW_SIMULATION_ERROR("failed to calculate curve index");  // LCOV_EXCL_LINE
+  const auto index = static_cast<size_t>(std::distance(accumulated_length_list_.begin(), iter)) - 1;
+  return std::make_pair(index, s - accumulated_length_list_[index]);
 }
 
 double CatmullRomSpline::getSInSplineCurve(size_t curve_index, double s) const
 {
-  size_t n = curves_.size();
-  double ret = 0;
-  for (size_t i = 0; i < n; i++) {
-    if (i == curve_index) {
-      return ret + s;
-    } else {
-      ret = ret + curves_[i].getLength();
-    }
+  if (curve_index >= curves_.size()) {
+    THROW_SEMANTIC_ERROR("curve index does not match");  // LCOV_EXCL_LINE
   }
-  THROW_SEMANTIC_ERROR("curve index does not match");  // LCOV_EXCL_LINE
+  return accumulated_length_list_[curve_index] + s;
 }
 
 boost::optional<double> CatmullRomSpline::getCollisionPointIn2D(
   const std::vector<geometry_msgs::msg::Point> & polygon, bool search_backward,
   bool close_start_end) const
 {
+  return getCollisionPointIn2D(
+    polygon, math::get2DBoundingBox(polygon), search_backward, close_start_end);
+}
+
+std::vector<boost::optional<double>> CatmullRomSpline::getCollisionPointsIn2D(
+  const std::vector<std::vector<geometry_msgs::msg::Point>> & polygons, bool search_backward,
+  bool close_start_end) const
+{
+  std::vector<boost::optional<double>> collision_points;
+  collision_points.reserve(polygons.size());
+  for (const auto & polygon : polygons) {
+    collision_points.emplace_back(getCollisionPointIn2D(
+      polygon, math::get2DBoundingBox(polygon), search_backward, close_start_end));
+  }
+  return collision_points;
+}
+
+boost::optional<double> CatmullRomSpline::getCollisionPointIn2D(
+  const std::vector<geometry_msgs::msg::Point> & polygon,
+  const std::pair<geometry_msgs::msg::Point, geometry_msgs::msg::Point> & polygon_bounding_box,
+  bool search_backward, bool close_start_end) const
+{
+  /**
+   * @note Same as HermiteCurve::getCollisionPointIn2D for each curve, but the curves whose bounding
+   * box does not overlap the one of the polygon are skipped, and so are the edges of the polygon
+   * whose bounding box does not overlap the one of the curve.
+   */
+  if (polygon.size() <= 1 || !overlapsIn2D(bounding_box_, polygon_bounding_box)) {
+    return boost::none;
+  }
   size_t n = curves_.size();
-  if (search_backward) {
-    for (size_t i = 0; i < n; i++) {
-      auto s = curves_[n - 1 - i].getCollisionPointIn2D(polygon, search_backward, close_start_end);
-      if (s) {
-        return getSInSplineCurve(n - 1 - i, s.get());
-      }
+  for (size_t i = 0; i < n; i++) {
+    const auto curve_index = search_backward ? n - 1 - i : i;
+    if (!overlapsIn2D(bounding_boxes_[curve_index], polygon_bounding_box)) {
+      continue;
     }
-    return boost::none;
-  } else {
-    for (size_t i = 0; i < n; i++) {
-      auto s = curves_[i].getCollisionPointIn2D(polygon, search_backward, close_start_end);
-      if (s) {
-        return getSInSplineCurve(i, s.get());
-      }
+    auto s = getCollisionPointIn2D(curve_index, polygon, search_backward, close_start_end);
+    if (s) {
+      return getSInSplineCurve(curve_index, s.get());
     }
-    return boost::none;
   }
   return boost::none;
 }
 
+boost::optional<double> CatmullRomSpline::getCollisionPointIn2D(
+  size_t curve_index, const std::vector<geometry_msgs::msg::Point> & polygon,
+  bool search_backward, bool close_start_end) const
+{
+  boost::optional<double> collision_point;
+  const auto collide = [&](const auto & point0, const auto & point1) {
+    if (!mayCollideIn2D(curve_index, point0, point1)) {
+      return;
+    }
+    const auto s = curves_[curve_index].getCollisionPointIn2D(point0, point1, search_backward);
+    if (!s) {
+      return;
+    }
+    if (
+      !collision_point ||
+      (search_backward ? s.get() > collision_point.get() : s.get() < collision_point.get())) {
+      collision_point = s;
+    }
+  };
+  for (size_t i = 0; i + 1 < polygon.size(); i++) {
+    collide(polygon[i], polygon[i + 1]);
+  }
+  if (close_start_end) {
+    collide(polygon.back(), polygon.front());
+  }
+  return collision_point;
+}
+
 boost::optional<double> CatmullRomSpline::getCollisionPointIn2D(
   const geometry_msgs::msg::Point & point0, const geometry_msgs::msg::Point & point1,
   bool search_backward) const
@@ -297,6 +383,9 @@ boost::optional<double> CatmullRomSpline::getCollisionPointIn2D(
   size_t n = curves_.size();
   if (search_backward) {
     for (size_t i = 0; i < n; i++) {
+      if (!mayCollideIn2D(n - 1 - i, point0, point1)) {
+        continue;
+      }
       auto s = curves_[n - 1 - i].getCollisionPointIn2D(point0, point1, search_backward);
       if (s) {
         return getSInSplineCurve(n - 1 - i, s.get());
@@ -305,6 +394,9 @@ boost::optional<double> CatmullRomSpline::getCollisionPointIn2D(
     return boost::none;
   } else {
     for (size_t i = 0; i < n; i++) {
+      if (!mayCollideIn2D(i, point0, point1)) {
+        continue;
+      }
       auto s = curves_[i].getCollisionPointIn2D(point0, point1, search_backward);
       if (s) {
         return getSInSplineCurve(i, s.get());
@@ -316,20 +408,40 @@ boost::optional<double> CatmullRomSpline::getCollisionPointIn2D(
 }
 
 boost::optional<double> CatmullRomSpline::getSValue(
-  const geometry_msgs::msg::Pose & pose, double threshold_distance)
+  const geometry_msgs::msg::Pose & pose, double threshold_distance) const
 {
-  double s = 0;
+  /**
+   * @note Same as HermiteCurve::getSValue for each curve, but the line is transformed only once
+   * and the curves far from it are skipped.
+   */
+  geometry_msgs::msg::Point p0, p1;
+  p0.y = threshold_distance;
+  p1.y = -threshold_distance;
+  const auto line = math::transformPoints(pose, {p0, p1});
   for (size_t i = 0; i < curves_.size(); i++) {
-    auto s_value = curves_[i].getSValue(pose, threshold_distance, true);
+    if (!mayCollideIn2D(i, line[0], line[1])) {
+      continue;
+    }
+    auto s_value = curves_[i].getCollisionPointIn2D(line[0], line[1], false);
     if (s_value) {
-      s = s + s_value.get();
-      return s;
+      return getSInSplineCurve(i, curves_[i].getArcLength(s_value.get()));
     }
-    s = s + curves_[i].getLength();
   }
   return boost::none;
 }
 
+bool CatmullRomSpline::mayCollideIn2D(
+  size_t curve_index, const geometry_msgs::msg::Point & point0,
+  const geometry_msgs::msg::Point & point1) const
+{
+  BoundingBox segment_bounding_box;
+  segment_bounding_box.first.x = std::min(point0.x, point1.x);
+  segment_bounding_box.first.y = std::min(point0.y, point1.y);
+  segment_bounding_box.second.x = std::max(point0.x, point1.x);
+  segment_bounding_box.second.y = std::max(point0.y, point1.y);
+  return overlapsIn2D(segment_bounding_box, bounding_boxes_[curve_index]);
+}
+
 double CatmullRomSpline::getSquaredDistanceIn2D(
   const geometry_msgs::msg::Point & point, double s) const
 {
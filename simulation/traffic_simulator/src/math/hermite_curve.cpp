@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <iostream>
 #include <limits>
@@ -25,6 +26,18 @@ namespace traffic_simulator
 {
 namespace math
 {
+namespace
+{
+/**
+ * @brief abscissas and weights of the 8 points Gauss-Legendre quadrature on [-1, 1].
+ * Only the positive half is listed because the rule is symmetric.
+ */
+constexpr std::array<double, 4> gauss_legendre_abscissas = {
+  0.1834346424956498, 0.5255324099163290, 0.7966664774136267, 0.9602898564975363};
+constexpr std::array<double, 4> gauss_legendre_weights = {
+  0.3626837833783620, 0.3137066458778873, 0.2223810344533745, 0.1012285362903763};
+}  // namespace
+
 HermiteCurve::HermiteCurve(
   double ax, double bx, double cx, double dx, double ay, double by, double cy, double dy, double az,
   double bz, double cz, double dz)
@@ -40,7 +53,8 @@ HermiteCurve::HermiteCurve(
   bz_(bz),
   cz_(cz),
   dz_(dz),
-  length_(getLength(100))
+  speed_extrema_(getSpeedExtrema()),
+  length_(getArcLength(1))
 {
 }
 
@@ -62,7 +76,8 @@ HermiteCurve::HermiteCurve(
   bz_ = -3 * start_pose.position.z + 3 * goal_pose.position.z - 2 * start_vec.z - goal_vec.z;
   cz_ = start_vec.z;
   dz_ = start_pose.position.z;
-  length_ = getLength(100);
+  speed_extrema_ = getSpeedExtrema();
+  length_ = getArcLength(1);
 }
 
 double HermiteCurve::getSquaredDistanceIn2D(
@@ -94,37 +109,26 @@ boost::optional<double> HermiteCurve::getCollisionPointIn2D(
   if (n <= 1) {
     return boost::none;
   }
-  std::vector<double> s_values;
-  for (size_t i = 0; i < (n - 1); i++) {
-    const auto p0 = polygon[i];
-    const auto p1 = polygon[i + 1];
-    auto s = getCollisionPointIn2D(p0, p1, search_backward);
-    if (s) {
-      s_values.emplace_back(s.get());
+  boost::optional<double> ret;
+  const auto append = [&](const boost::optional<double> & s) {
+    if (s && (!ret || (search_backward ? s.get() > ret.get() : s.get() < ret.get()))) {
+      ret = s;
     }
+  };
+  for (size_t i = 0; i < (n - 1); i++) {
+    append(getCollisionPointIn2D(polygon[i], polygon[i + 1], search_backward));
   }
   if (close_start_end) {
-    const auto p0 = polygon[n - 1];
-    const auto p1 = polygon[0];
-    auto s = getCollisionPointIn2D(p0, p1, search_backward);
-    if (s) {
-      s_values.emplace_back(s.get());
-    }
-  }
-  if (s_values.empty()) {
-    return boost::none;
-  }
-  if (search_backward) {
-    return *std::max_element(s_values.begin(), s_values.end());
+    append(getCollisionPointIn2D(polygon[n - 1], polygon[0], search_backward));
   }
-  return *std::min_element(s_values.begin(), s_values.end());
+  return ret;
 }
 
 boost::optional<double> HermiteCurve::getCollisionPointIn2D(
   const geometry_msgs::msg::Point & point0, const geometry_msgs::msg::Point & point1,
   bool search_backward) const
 {
-  std::vector<double> s_values;
+  PolynomialRoots s_values;
   double fx = point0.x;
   double ex = (point1.x - point0.x);
   double fy = point0.y;
@@ -172,6 +176,25 @@ boost::optional<double> HermiteCurve::getCollisionPointIn2D(
   return *std::min_element(s_values.begin(), s_values.end());
 }
 
+std::pair<geometry_msgs::msg::Point, geometry_msgs::msg::Point> HermiteCurve::get2DBoundingBox()
+  const
+{
+  const auto get_range = [](double a, double b, double c, double d) {
+    const std::array<double, 4> control_points = {
+      d, d + c / 3, d + (2 * c + b) / 3, d + c + b + a};
+    const auto range = std::minmax_element(control_points.begin(), control_points.end());
+    return std::make_pair(*range.first, *range.second);
+  };
+  const auto x = get_range(ax_, bx_, cx_, dx_);
+  const auto y = get_range(ay_, by_, cy_, dy_);
+  geometry_msgs::msg::Point min_point, max_point;
+  min_point.x = x.first;
+  min_point.y = y.first;
+  max_point.x = x.second;
+  max_point.y = y.second;
+  return std::make_pair(min_point, max_point);
+}
+
 boost::optional<double> HermiteCurve::getSValue(
   const geometry_msgs::msg::Pose & pose, double threshold_distance, bool autoscale) const
 {
@@ -184,7 +207,7 @@ boost::optional<double> HermiteCurve::getSValue(
     return boost::none;
   }
   if (autoscale) {
-    return s.get() * getLength();
+    return getArcLength(s.get());
   }
   return s.get();
 }
@@ -225,7 +248,7 @@ std::vector<geometry_msgs::msg::Point> HermiteCurve::getTrajectory(size_t num_po
 const geometry_msgs::msg::Vector3 HermiteCurve::getNormalVector(double s, bool autoscale) const
 {
   if (autoscale) {
-    s = s / getLength();
+    s = getParameter(s);
   }
   geometry_msgs::msg::Vector3 tangent_vec = getTangentVector(s);
   double theta = M_PI / 2.0;
@@ -238,7 +261,7 @@ const geometry_msgs::msg::Vector3 HermiteCurve::getNormalVector(double s, bool a
 const geometry_msgs::msg::Vector3 HermiteCurve::getTangentVector(double s, bool autoscale) const
 {
   if (autoscale) {
-    s = s / getLength();
+    s = getParameter(s);
   }
   geometry_msgs::msg::Vector3 vec;
   vec.x = 3 * ax_ * s * s + 2 * bx_ * s + cx_;
@@ -250,7 +273,7 @@ const geometry_msgs::msg::Vector3 HermiteCurve::getTangentVector(double s, bool
 const geometry_msgs::msg::Pose HermiteCurve::getPose(double s, bool autoscale) const
 {
   if (autoscale) {
-    s = s / getLength();
+    s = getParameter(s);
   }
   geometry_msgs::msg::Pose pose;
   geometry_msgs::msg::Vector3 tangent_vec = getTangentVector(s, false);
@@ -266,7 +289,7 @@ const geometry_msgs::msg::Pose HermiteCurve::getPose(double s, bool autoscale) c
 double HermiteCurve::get2DCurvature(double s, bool autoscale) const
 {
   if (autoscale) {
-    s = s / getLength();
+    s = getParameter(s);
   }
   double s2 = s * s;
   double x_dot = 3 * ax_ * s2 + 2 * bx_ * s + cx_;
@@ -314,10 +337,111 @@ double HermiteCurve::getLength(size_t num_points) const
   return ret;
 }
 
+double HermiteCurve::getSpeed(double t) const
+{
+  const auto tangent_vec = getTangentVector(t);
+  return std::sqrt(
+    tangent_vec.x * tangent_vec.x + tangent_vec.y * tangent_vec.y + tangent_vec.z * tangent_vec.z);
+}
+
+std::vector<double> HermiteCurve::getSpeedExtrema() const
+{
+  /**
+   * @note The speed |P'(t)| is not smooth where it touches zero (cusp), and the quadrature loses
+   * its accuracy across such points. d|P'(t)|^2/dt = 2 P'(t) * P''(t) is a cubic function, so the
+   * integration range is split at its roots.
+   */
+  const double a = 18 * (ax_ * ax_ + ay_ * ay_ + az_ * az_);
+  const double b = 18 * (ax_ * bx_ + ay_ * by_ + az_ * bz_);
+  const double c =
+    4 * (bx_ * bx_ + by_ * by_ + bz_ * bz_) + 6 * (ax_ * cx_ + ay_ * cy_ + az_ * cz_);
+  const double d = 2 * (bx_ * cx_ + by_ * cy_ + bz_ * cz_);
+  std::vector<double> extrema;
+  for (const auto t : solver_.solveCubicEquation(a, b, c, d, 0, 1)) {
+    if (0 < t && t < 1) {
+      extrema.emplace_back(t);
+    }
+  }
+  std::sort(extrema.begin(), extrema.end());
+  extrema.erase(std::unique(extrema.begin(), extrema.end()), extrema.end());
+  return extrema;
+}
+
+double HermiteCurve::getArcLength(double t) const
+{
+  /**
+   * @note Integrates the speed on each interval between speed extrema with 2 x 8 points
+   * Gauss-Legendre quadrature. It is exact for straight curves and much more accurate than sampling
+   * the curve as a polyline with the same number of points.
+   */
+  const auto integrate = [this](const double begin, const double end) {
+    constexpr std::size_t num_sections = 2;
+    const double section_length = (end - begin) / num_sections;
+    double ret = 0;
+    for (std::size_t i = 0; i < num_sections; ++i) {
+      const double center = begin + section_length * (static_cast<double>(i) + 0.5);
+      const double radius = section_length * 0.5;
+      for (std::size_t j = 0; j < gauss_legendre_abscissas.size(); ++j) {
+        ret = ret + gauss_legendre_weights[j] * radius *
+                      (getSpeed(center - radius * gauss_legendre_abscissas[j]) +
+                       getSpeed(center + radius * gauss_legendre_abscissas[j]));
+      }
+    }
+    return ret;
+  };
+  if (t <= 0) {
+    return 0;
+  }
+  double ret = 0;
+  double begin = 0;
+  for (const auto extremum : speed_extrema_) {
+    if (extremum >= t) {
+      break;
+    }
+    ret = ret + integrate(begin, extremum);
+    begin = extremum;
+  }
+  return ret + integrate(begin, t);
+}
+
+double HermiteCurve::getParameter(double arc_length) const
+{
+  if (arc_length <= 0 || getLength() <= 0) {
+    return getLength() <= 0 ? 0 : arc_length / getLength();
+  }
+  if (arc_length >= getLength()) {
+    return 1 + (arc_length - getLength()) / getLength();
+  }
+  /**
+   * @note Newton's method on getArcLength(t) - arc_length, safeguarded by bisection because the
+   * derivative (= speed) can be zero at cusps.
+   */
+  constexpr double tolerance = 1e-9;
+  constexpr std::size_t max_iterations = 30;
+  double lower = 0;
+  double upper = 1;
+  double t = arc_length / getLength();
+  for (std::size_t i = 0; i < max_iterations; ++i) {
+    const double error = getArcLength(t) - arc_length;
+    if (std::fabs(error) < tolerance) {
+      break;
+    }
+    if (error > 0) {
+      upper = t;
+    } else {
+      lower = t;
+    }
+    const double speed = getSpeed(t);
+    const double next = speed > std::numeric_limits<double>::epsilon() ? t - error / speed : lower;
+    t = (lower < next && next < upper) ? next : (lower + upper) * 0.5;
+  }
+  return t;
+}
+
 const geometry_msgs::msg::Point HermiteCurve::getPoint(double s, bool autoscale) const
 {
   if (autoscale) {
-    s = s / getLength();
+    s = getParameter(s);
   }
   geometry_msgs::msg::Point p;
 
@@ -12,12 +12,13 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <iostream>
 #include <limits>
 #include <rclcpp/rclcpp.hpp>
 #include <traffic_simulator/math/polynomial_solver.hpp>
-#include <vector>
 
 namespace traffic_simulator
 {
@@ -35,76 +36,120 @@ double PolynomialSolver::quadraticFunction(double a, double b, double c, double
   return a * t * t + b * t + c;
 }
 
-std::vector<double> PolynomialSolver::solveLinearEquation(
+PolynomialRoots PolynomialSolver::solveLinearEquation(
   double a, double b, double min_value, double max_value) const
 {
   constexpr double e = std::numeric_limits<double>::epsilon();
+  PolynomialRoots ret;
   if (std::fabs(a) < e) {
     if (std::fabs(b) < e) {
       if (min_value <= 0 && 0 <= max_value) {
-        return {0};
+        ret.emplace_back(0);
       }
     }
-    return {};
+    return ret;
   }
-  double ret = -b / a;
-  if (min_value <= ret && ret <= max_value) {
-    return {ret};
+  double solution = -b / a;
+  if (min_value <= solution && solution <= max_value) {
+    ret.emplace_back(solution);
   }
-  return {};
+  return ret;
 }
 
-std::vector<double> PolynomialSolver::solveQuadraticEquation(
+PolynomialRoots PolynomialSolver::solveQuadraticEquation(
   double a, double b, double c, double min_value, double max_value) const
 {
-  std::vector<double> candidates, ret;
   constexpr double e = std::numeric_limits<double>::epsilon();
   if (std::fabs(a) < e) {
-    return solveLinearEquation(b, c);
-  }
-  double root = b * b - 4 * a * c;
-  if (std::fabs(root) < e) {
-    candidates = {-b / (2 * a)};
-  } else if (root < 0) {
-    candidates = {};
-  } else {
-    candidates = {(-b - std::sqrt(root)) / (2 * a), (-b + std::sqrt(root)) / (2 * a)};
+    return solveLinearEquation(b, c, min_value, max_value);
   }
-  for (const auto candidate : candidates) {
+  PolynomialRoots ret;
+  const auto append = [&](double candidate) {
     if (min_value <= candidate && candidate <= max_value) {
       ret.emplace_back(candidate);
     }
+  };
+  double root = b * b - 4 * a * c;
+  if (std::fabs(root) < e) {
+    append(-b / (2 * a));
+  } else if (root > 0) {
+    /**
+     * @note -b and the square root are not subtracted from each other, which loses the precision
+     * of the root closer to 0 when |b| is much larger than |a * c|. The other root is found from
+     * the product of the roots c / a instead.
+     */
+    const double q = b < 0 ? 0.5 * (-b + std::sqrt(root)) : 0.5 * (-b - std::sqrt(root));
+    if (b < 0) {
+      append(c / q);
+      append(q / a);
+    } else {
+      append(q / a);
+      append(c / q);
+    }
   }
   return ret;
 }
 
-std::vector<double> PolynomialSolver::solveCubicEquation(
+PolynomialRoots PolynomialSolver::solveCubicEquation(
   double a, double b, double c, double d, double min_value, double max_value) const
 {
   constexpr double e = std::numeric_limits<double>::epsilon();
   if (std::fabs(a) < e) {
-    return solveQuadraticEquation(b, c, d);
+    return solveQuadraticEquation(b, c, d, min_value, max_value);
   }
-  std::vector<double> solutions, candidates, ret;
-  auto result = solveP3(solutions, b / a, c / a, d / a);
-  if (result == 3) {
-    candidates = solutions;
-  } else if (result == 2) {
-    candidates = {solutions[0], solutions[1]};
-  } else if (result == 1) {
-    candidates = {solutions[0]};
+  PolynomialRoots candidates;
+  if (std::fabs(a) < 1e-8 * std::max(std::max(std::fabs(b), std::fabs(c)), std::fabs(d))) {
+    /**
+     * @note The closed form divides the other coefficients by a, so it loses the roots of small
+     * magnitude when a is much smaller than them. In that case, two roots are close to the ones of
+     * the quadratic equation without a, and the sum of the roots -b / a gives the third one. They
+     * are refined by the Newton steps below.
+     */
+    constexpr double infinity = std::numeric_limits<double>::infinity();
+    const auto roots = solveQuadraticEquation(b, c, d, -infinity, infinity);
+    for (const auto root : roots) {
+      candidates.emplace_back(root);
+    }
+    if (std::fabs(b) >= e) {
+      candidates.emplace_back(-b / a + c / b);
+    }
+  } else {
+    std::array<double, 3> solutions;
+    const auto size = solveP3(solutions, b / a, c / a, d / a);
+    for (int i = 0; i < size; ++i) {
+      candidates.emplace_back(solutions[i]);
+    }
   }
+  PolynomialRoots ret;
   for (const auto candidate : candidates) {
-    if (min_value <= candidate && candidate <= max_value) {
-      ret.emplace_back(candidate);
+    const auto solution = polishCubicEquationRoot(a, b, c, d, candidate);
+    if (min_value <= solution && solution <= max_value) {
+      ret.emplace_back(solution);
     }
   }
   return ret;
 }
 
-int PolynomialSolver::solveP3(std::vector<double> & x, double a, double b, double c) const
+double PolynomialSolver::polishCubicEquationRoot(
+  double a, double b, double c, double d, double solution) const
+{
+  for (std::size_t iteration = 0; iteration < newton_iterations_; ++iteration) {
+    const double value = cubicFunction(a, b, c, d, solution);
+    const double derivative = quadraticFunction(3 * a, 2 * b, c, solution);
+    if (value == 0 || derivative == 0) {
+      break;
+    }
+    const double next_solution = solution - value / derivative;
+    if (!(std::fabs(cubicFunction(a, b, c, d, next_solution)) < std::fabs(value))) {
+      break;
+    }
+    solution = next_solution;
+  }
+  return solution;
+}
+
+int PolynomialSolver::solveP3(std::array<double, 3> & x, double a, double b, double c) const
 {
-  x = std::vector<double>(3);
   const double eps = std::numeric_limits<double>::epsilon();
   double a2 = a * a;
   double q = (a2 - 3 * b) / 9;
@@ -113,7 +158,11 @@ int PolynomialSolver::solveP3(std::vector<double> & x, double a, double b, doubl
   double r2 = r * r;
   double q3 = q * q * q;
   double A, B;
-  if (r2 <= (q3 + eps)) {  //<<-- FIXED!
+  /**
+   * @note With q3 <= 0, the roots are found by the second branch. The first one would divide by
+   * zero for a triple root (q = r = 0).
+   */
+  if (q3 > 0 && r2 <= (q3 + eps)) {  //<<-- FIXED!
     double t = r / sqrt(q3);
     if (t < -1) {
       t = -1;
@@ -51,6 +51,16 @@ const rosgraph_msgs::msg::Clock SimulationClock::getCurrentRosTimeAsMsg()
 }
 
 const rclcpp::Time SimulationClock::getCurrentRosTime()
+{
+  return toRosTime(current_simulation_time_);
+}
+
+const rclcpp::Time SimulationClock::getNextRosTime()
+{
+  return toRosTime(getNextSimulationTime());
+}
+
+const rclcpp::Time SimulationClock::toRosTime(double simulation_time)
 {
   if (!initialized_) {
     THROW_SIMULATION_ERROR("SimulationClock has not been initialized yet.");
@@ -59,7 +69,7 @@ const rclcpp::Time SimulationClock::getCurrentRosTime()
     return now();
   } else {
     return time_on_initialize_ +
-           rclcpp::Duration::from_seconds(current_simulation_time_ - initial_simulation_time_);
+           rclcpp::Duration::from_seconds(simulation_time - initial_simulation_time_);
   }
 }
 }  // namespace traffic_simulator
@@ -0,0 +1,55 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "allocation_counter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+std::atomic<std::uint64_t> allocation_count{0};
+
+std::atomic<std::uint64_t> allocated_byte_count{0};
+}  // namespace
+
+namespace allocation_counter
+{
+auto allocations() -> std::uint64_t { return allocation_count.load(std::memory_order_relaxed); }
+
+auto allocatedBytes() -> std::uint64_t
+{
+  return allocated_byte_count.load(std::memory_order_relaxed);
+}
+}  // namespace allocation_counter
+
+/**
+ * @note The other forms of operator new and operator delete except the aligned ones call these by
+ * default, so replacing these is enough to count almost all allocations.
+ */
+void * operator new(std::size_t size)
+{
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  allocated_byte_count.fetch_add(size, std::memory_order_relaxed);
+  if (auto pointer = std::malloc(size == 0 ? 1 : size)) {
+    return pointer;
+  } else {
+    throw std::bad_alloc();
+  }
+}
+
+void operator delete(void * pointer) noexcept { std::free(pointer); }
+
+void operator delete(void * pointer, std::size_t) noexcept { std::free(pointer); }
@@ -0,0 +1,62 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TRAFFIC_SIMULATOR__TEST__BENCHMARK__ALLOCATION_COUNTER_HPP_
+#define TRAFFIC_SIMULATOR__TEST__BENCHMARK__ALLOCATION_COUNTER_HPP_
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+namespace allocation_counter
+{
+/**
+ * @brief Number of calls of the global operator new since the program started.
+ * @note Counted by the replacement operator new of allocation_counter.cpp, which must be linked
+ * into the benchmark executable.
+ */
+auto allocations() -> std::uint64_t;
+
+auto allocatedBytes() -> std::uint64_t;
+
+/**
+ * @brief Adds the counters "allocs_per_op" and "bytes_per_op" to the benchmark when it goes out of
+ * scope. Construct it just before the benchmark loop so that the setup is not counted.
+ */
+class Scope
+{
+public:
+  explicit Scope(benchmark::State & state)
+  : state_(state), allocations_(allocations()), allocated_bytes_(allocatedBytes())
+  {
+  }
+
+  ~Scope()
+  {
+    state_.counters["allocs_per_op"] =
+      benchmark::Counter(allocations() - allocations_, benchmark::Counter::kAvgIterations);
+    state_.counters["bytes_per_op"] =
+      benchmark::Counter(allocatedBytes() - allocated_bytes_, benchmark::Counter::kAvgIterations);
+  }
+
+private:
+  benchmark::State & state_;
+
+  const std::uint64_t allocations_;
+
+  const std::uint64_t allocated_bytes_;
+};
+}  // namespace allocation_counter
+
+#endif  // TRAFFIC_SIMULATOR__TEST__BENCHMARK__ALLOCATION_COUNTER_HPP_
@@ -0,0 +1,130 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <traffic_simulator/entity/entity_spatial_index.hpp>
+#include <vector>
+
+#include "../allocation_counter.hpp"
+
+namespace
+{
+/**
+ * @note Dense traffic: entities are placed on a grid with 8 m spacing, one lanelet per row.
+ */
+std::shared_ptr<const traffic_simulator::entity::EntityStatusStore> makeStore(std::size_t size)
+{
+  auto store = std::make_shared<traffic_simulator::entity::EntityStatusStore>(1);
+  const auto columns = static_cast<std::size_t>(std::ceil(std::sqrt(size)));
+  for (std::size_t i = 0; i < size; ++i) {
+    traffic_simulator_msgs::msg::EntityStatus status;
+    status.name = "npc" + std::to_string(i);
+    status.pose.position.x = 8.0 * (i % columns);
+    status.pose.position.y = 8.0 * (i / columns);
+    status.pose.orientation.w = 1;
+    status.bounding_box.center.x = 1.5;
+    status.bounding_box.dimensions.x = 4.5;
+    status.bounding_box.dimensions.y = 2.1;
+    status.lanelet_pose.lanelet_id = i / columns;
+    status.lanelet_pose_valid = true;
+    store->emplace(status);
+  }
+  return store;
+}
+
+/**
+ * @note The candidates of the front entity are the entities in the view on both paths.
+ */
+std::size_t getFrontCandidates(const traffic_simulator::entity::EntityStatusView & view)
+{
+  std::size_t candidates = 0;
+  for (std::size_t i = 0; i < view.size(); ++i) {
+    candidates += view.laneletPoseValid(i);
+  }
+  return candidates;
+}
+
+/**
+ * @note Per entity, the view of the entities in 30 m and the candidates of the front entity, then
+ * the entities on the two lanelets next to its own like a right of way query.
+ */
+template <typename MakeView, typename GetCandidates, typename GetEntitiesOnLanelets>
+std::size_t queryAll(
+  const traffic_simulator::entity::EntityStatusStore & store, const MakeView & make_view,
+  const GetCandidates & get_candidates, const GetEntitiesOnLanelets & get_entities_on_lanelets)
+{
+  std::size_t found = 0;
+  for (std::size_t i = 0; i < store.size(); ++i) {
+    const auto & position = store.getPose(i).position;
+    const auto view = make_view(store.getName(i), position);
+    found += view.size() + get_candidates(view) +
+             get_entities_on_lanelets(view, store.getLaneletPose(i).lanelet_id);
+  }
+  return found;
+}
+}  // namespace
+
+static void LinearScanPerFrame(benchmark::State & state)
+{
+  const auto store = makeStore(state.range(0));
+  const allocation_counter::Scope scope(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(queryAll(
+      *store,
+      [&](const auto & name, const auto & position) {
+        return traffic_simulator::entity::EntityStatusView(store, name, position, 30);
+      },
+      getFrontCandidates,
+      [&](const auto & view, auto lanelet_id) {
+        std::size_t entities = 0;
+        for (std::size_t i = 0; i < view.size(); ++i) {
+          const auto id = view.getLaneletPose(i).lanelet_id;
+          entities += id == lanelet_id - 1 || id == lanelet_id + 1;
+        }
+        return entities;
+      }));
+  }
+}
+BENCHMARK(LinearScanPerFrame)->Arg(100)->Arg(500)->Arg(1000);
+
+static void SpatialIndexPerFrame(benchmark::State & state)
+{
+  const auto store = makeStore(state.range(0));
+  const allocation_counter::Scope scope(state);
+  for (auto _ : state) {
+    const auto index = std::make_shared<const traffic_simulator::entity::EntitySpatialIndex>(store);
+    benchmark::DoNotOptimize(queryAll(
+      *store,
+      [&](const auto & name, const auto & position) {
+        return traffic_simulator::entity::EntityStatusView(index, name, position, 30);
+      },
+      getFrontCandidates,
+      [&](const auto & view, auto lanelet_id) {
+        std::size_t entities = 0;
+        for (const auto id : {lanelet_id - 1, lanelet_id + 1}) {
+          for (const auto i : index->getEntitiesOnLanelet(id)) {
+            entities += static_cast<bool>(view.findIndex(i));
+          }
+        }
+        return entities;
+      }));
+  }
+}
+BENCHMARK(SpatialIndexPerFrame)->Arg(100)->Arg(500)->Arg(1000);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,135 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <traffic_simulator/entity/entity_status_store.hpp>
+#include <unordered_map>
+#include <vector>
+
+#include "../allocation_counter.hpp"
+
+namespace
+{
+/**
+ * @note Entities are placed on a grid with 8 m spacing, so each entity sees a few dozen others
+ * within the 30 m range like in a dense traffic scenario.
+ */
+std::vector<traffic_simulator_msgs::msg::EntityStatus> makeStatuses(std::size_t size)
+{
+  std::vector<traffic_simulator_msgs::msg::EntityStatus> statuses;
+  const auto columns = static_cast<std::size_t>(std::ceil(std::sqrt(size)));
+  for (std::size_t i = 0; i < size; ++i) {
+    traffic_simulator_msgs::msg::EntityStatus status;
+    status.name = "npc" + std::to_string(i);
+    status.pose.position.x = 8.0 * (i % columns);
+    status.pose.position.y = 8.0 * (i / columns);
+    status.action_status.twist.linear.x = 10;
+    status.lanelet_pose.lanelet_id = 34513 + i % 7;
+    statuses.emplace_back(status);
+  }
+  return statuses;
+}
+
+using EntityStatusDict = std::unordered_map<std::string, traffic_simulator_msgs::msg::EntityStatus>;
+
+/**
+ * @note Same filtering as the former EntityBase::setOtherStatus, kept here as the baseline.
+ */
+EntityStatusDict filterOtherStatus(
+  const EntityStatusDict & all_status, const traffic_simulator_msgs::msg::EntityStatus & self)
+{
+  EntityStatusDict other_status;
+  for (const auto & each : all_status) {
+    if (each.first != self.name) {
+      const auto p0 = each.second.pose.position;
+      const auto p1 = self.pose.position;
+      double distance =
+        std::sqrt(std::pow(p0.x - p1.x, 2) + std::pow(p0.y - p1.y, 2) + std::pow(p0.z - p1.z, 2));
+      if (distance < 30) {
+        other_status.insert(each);
+      }
+    }
+  }
+  return other_status;
+}
+}  // namespace
+
+/**
+ * @brief One frame of the former EntityManager::update : the map of all statuses is built and
+ * filtered into each entity twice, and each entity copies its map into the behavior plugin.
+ */
+static void EntityStatusDictPerFrame(benchmark::State & state)
+{
+  const auto statuses = makeStatuses(state.range(0));
+  std::vector<EntityStatusDict> other_status(statuses.size());
+  std::vector<EntityStatusDict> blackboard(statuses.size());
+  const allocation_counter::Scope scope(state);
+  for (auto _ : state) {
+    for (int pass = 0; pass < 2; ++pass) {
+      EntityStatusDict all_status;
+      for (const auto & status : statuses) {
+        all_status.emplace(status.name, status);
+      }
+      for (std::size_t i = 0; i < statuses.size(); ++i) {
+        other_status[i] = filterOtherStatus(all_status, statuses[i]);
+      }
+      if (pass == 0) {
+        for (std::size_t i = 0; i < statuses.size(); ++i) {
+          blackboard[i] = other_status[i];
+        }
+      }
+    }
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(EntityStatusDictPerFrame)->Arg(10)->Arg(100)->Arg(500);
+
+/**
+ * @brief One frame of EntityManager::update with the shared store : two snapshots are built and
+ * each entity and its behavior plugin only receive a view.
+ */
+static void EntityStatusStorePerFrame(benchmark::State & state)
+{
+  const auto statuses = makeStatuses(state.range(0));
+  std::vector<traffic_simulator::entity::EntityStatusView> other_status(statuses.size());
+  std::vector<traffic_simulator::entity::EntityStatusView> blackboard(statuses.size());
+  std::uint64_t frame = 0;
+  const allocation_counter::Scope scope(state);
+  for (auto _ : state) {
+    for (int pass = 0; pass < 2; ++pass) {
+      auto store = std::make_shared<traffic_simulator::entity::EntityStatusStore>(++frame);
+      store->reserve(statuses.size());
+      for (const auto & status : statuses) {
+        store->emplace(status);
+      }
+      for (std::size_t i = 0; i < statuses.size(); ++i) {
+        other_status[i] = traffic_simulator::entity::EntityStatusView(
+          store, statuses[i].name, statuses[i].pose.position, 30);
+      }
+      if (pass == 0) {
+        for (std::size_t i = 0; i < statuses.size(); ++i) {
+          blackboard[i] = other_status[i];
+        }
+      }
+    }
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(EntityStatusStorePerFrame)->Arg(10)->Arg(100)->Arg(500);
+
+BENCHMARK_MAIN();
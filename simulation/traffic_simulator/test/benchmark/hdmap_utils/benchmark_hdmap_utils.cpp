@@ -0,0 +1,262 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <benchmark/benchmark.h>
+
+#include <ament_index_cpp/get_package_share_directory.hpp>
+#include <memory>
+#include <random>
+#include <string>
+#include <traffic_simulator/hdmap_utils/hdmap_utils.hpp>
+#include <traffic_simulator/hdmap_utils/route_table.hpp>
+#include <utility>
+#include <vector>
+
+#include "../allocation_counter.hpp"
+
+namespace
+{
+/**
+ * @note The map is the one of the unit tests of HdMapUtils. It is loaded once and shared between
+ * the benchmarks, so the caches of HdMapUtils are warm after the first iterations like during a
+ * simulation.
+ */
+hdmap_utils::HdMapUtils & getHdMapUtils()
+{
+  static const auto hdmap_utils = [] {
+    geographic_msgs::msg::GeoPoint origin;
+    origin.latitude = 35.61836750154;
+    origin.longitude = 139.78066608243;
+    return std::make_unique<hdmap_utils::HdMapUtils>(
+      ament_index_cpp::get_package_share_directory("traffic_simulator") + "/map/lanelet2_map.osm",
+      origin);
+  }();
+  return *hdmap_utils;
+}
+
+/**
+ * @note Same as getHdMapUtils, with the routes between lanelets up to 500 m apart computed when
+ * the map is loaded.
+ */
+hdmap_utils::HdMapUtils & getHdMapUtilsWithRouteTable()
+{
+  static const auto hdmap_utils = [] {
+    geographic_msgs::msg::GeoPoint origin;
+    origin.latitude = 35.61836750154;
+    origin.longitude = 139.78066608243;
+    return std::make_unique<hdmap_utils::HdMapUtils>(
+      ament_index_cpp::get_package_share_directory("traffic_simulator") + "/map/lanelet2_map.osm",
+      origin, "", 0, 500);
+  }();
+  return *hdmap_utils;
+}
+
+const std::vector<std::int64_t> lanelet_ids = {34513, 34684, 34510, 34411, 120659, 34600};
+
+/**
+ * @note Poses slightly beside the centerline of the lanelets above, so that matching them has to
+ * search instead of hitting a point of the centerline exactly.
+ */
+std::vector<geometry_msgs::msg::Pose> makePoses()
+{
+  std::vector<geometry_msgs::msg::Pose> poses;
+  for (const auto lanelet_id : lanelet_ids) {
+    const auto length = getHdMapUtils().getLaneletLength(lanelet_id);
+    for (double s = 0.5; s < length; s += 3.0) {
+      poses.emplace_back(getHdMapUtils().toMapPose(lanelet_id, s, 0.3).pose);
+    }
+  }
+  return poses;
+}
+
+/**
+ * @note Poses at random positions and headings around the centerlines of all lanelets of the map,
+ * like the poses of entities returned from the sensor simulator. Some of them are too far from
+ * the centerline or too rotated to be matched.
+ */
+std::vector<geometry_msgs::msg::Pose> makeRandomPoses(std::size_t size)
+{
+  const auto ids = getHdMapUtils().getLaneletIds();
+  std::mt19937 engine(0);
+  std::uniform_int_distribution<std::size_t> id_distribution(0, ids.size() - 1);
+  std::uniform_real_distribution<double> ratio_distribution(0, 1);
+  std::uniform_real_distribution<double> offset_distribution(-1.5, 1.5);
+  std::uniform_real_distribution<double> yaw_distribution(-0.3, 0.3);
+  std::vector<geometry_msgs::msg::Pose> poses;
+  while (poses.size() < size) {
+    traffic_simulator_msgs::msg::LaneletPose lanelet_pose;
+    lanelet_pose.lanelet_id = ids[id_distribution(engine)];
+    lanelet_pose.s = getHdMapUtils().getLaneletLength(lanelet_pose.lanelet_id) *
+                     ratio_distribution(engine);
+    lanelet_pose.offset = offset_distribution(engine);
+    lanelet_pose.rpy.z = yaw_distribution(engine);
+    poses.emplace_back(getHdMapUtils().toMapPose(lanelet_pose).pose);
+  }
+  return poses;
+}
+
+std::vector<std::pair<std::int64_t, std::int64_t>> makeLaneletPairs()
+{
+  std::vector<std::pair<std::int64_t, std::int64_t>> pairs;
+  for (const auto from : lanelet_ids) {
+    for (const auto to : lanelet_ids) {
+      pairs.emplace_back(from, to);
+    }
+  }
+  return pairs;
+}
+
+/**
+ * @note Random pairs of lanelets of the whole map, most of which are not connected or too far from
+ * each other to be in the route table.
+ */
+std::vector<std::pair<std::int64_t, std::int64_t>> makeRandomLaneletPairs(std::size_t size)
+{
+  const auto ids = getHdMapUtils().getLaneletIds();
+  std::mt19937 engine(0);
+  std::uniform_int_distribution<std::size_t> id_distribution(0, ids.size() - 1);
+  std::vector<std::pair<std::int64_t, std::int64_t>> pairs;
+  while (pairs.size() < size) {
+    pairs.emplace_back(ids[id_distribution(engine)], ids[id_distribution(engine)]);
+  }
+  return pairs;
+}
+
+std::vector<hdmap_utils::RouteTable::Lanelet> makeRouteTableLanelets()
+{
+  std::vector<hdmap_utils::RouteTable::Lanelet> lanelets;
+  for (const auto id : getHdMapUtils().getLaneletIds()) {
+    lanelets.push_back(
+      {id, getHdMapUtils().getLaneletLength(id), getHdMapUtils().getNextLaneletIds(id)});
+  }
+  return lanelets;
+}
+}  // namespace
+
+static void HdMapUtilsToLaneletPose(benchmark::State & state)
+{
+  const auto poses = makePoses();
+  std::size_t i = 0;
+  const allocation_counter::Scope scope(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(getHdMapUtils().toLaneletPose(poses[i], false));
+    i = (i + 1) % poses.size();
+  }
+}
+BENCHMARK(HdMapUtilsToLaneletPose);
+
+static void HdMapUtilsToLaneletPoseWithBoundingBox(benchmark::State & state)
+{
+  const auto poses = makePoses();
+  traffic_simulator_msgs::msg::BoundingBox bbox;
+  bbox.dimensions.x = 4.5;
+  bbox.dimensions.y = 2;
+  bbox.dimensions.z = 1.5;
+  std::size_t i = 0;
+  const allocation_counter::Scope scope(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(getHdMapUtils().toLaneletPose(poses[i], bbox, false));
+    i = (i + 1) % poses.size();
+  }
+}
+BENCHMARK(HdMapUtilsToLaneletPoseWithBoundingBox);
+
+static void HdMapUtilsToLaneletPoseRandom(benchmark::State & state)
+{
+  const auto poses = makeRandomPoses(1000);
+  std::size_t i = 0;
+  const allocation_counter::Scope scope(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(getHdMapUtils().toLaneletPose(poses[i], false));
+    i = (i + 1) % poses.size();
+  }
+}
+BENCHMARK(HdMapUtilsToLaneletPoseRandom);
+
+/**
+ * @note HdMapUtils caches every route it has found, so this measures the cache lookup after the
+ * first iterations.
+ */
+static void HdMapUtilsGetRoute(benchmark::State & state)
+{
+  const auto pairs = makeLaneletPairs();
+  std::size_t i = 0;
+  const allocation_counter::Scope scope(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(getHdMapUtils().getRoute(pairs[i].first, pairs[i].second));
+    i = (i + 1) % pairs.size();
+  }
+}
+BENCHMARK(HdMapUtilsGetRoute);
+
+static void HdMapUtilsGetLongitudinalDistance(benchmark::State & state)
+{
+  const auto pairs = makeLaneletPairs();
+  std::size_t i = 0;
+  const allocation_counter::Scope scope(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+      getHdMapUtils().getLongitudinalDistance(pairs[i].first, 1.0, pairs[i].second, 2.0));
+    i = (i + 1) % pairs.size();
+  }
+}
+BENCHMARK(HdMapUtilsGetLongitudinalDistance);
+
+/**
+ * @note Every pair is searched in the routing graph once, then its route is found in the cache of
+ * HdMapUtils.
+ */
+static void HdMapUtilsGetLongitudinalDistanceRandom(benchmark::State & state)
+{
+  const auto pairs = makeRandomLaneletPairs(1000);
+  std::size_t i = 0;
+  const allocation_counter::Scope scope(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+      getHdMapUtils().getLongitudinalDistance(pairs[i].first, 1.0, pairs[i].second, 2.0));
+    i = (i + 1) % pairs.size();
+  }
+}
+BENCHMARK(HdMapUtilsGetLongitudinalDistanceRandom);
+
+static void HdMapUtilsGetLongitudinalDistanceRandomWithRouteTable(benchmark::State & state)
+{
+  const auto pairs = makeRandomLaneletPairs(1000);
+  std::size_t i = 0;
+  const allocation_counter::Scope scope(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(getHdMapUtilsWithRouteTable().getLongitudinalDistance(
+      pairs[i].first, 1.0, pairs[i].second, 2.0));
+    i = (i + 1) % pairs.size();
+  }
+}
+BENCHMARK(HdMapUtilsGetLongitudinalDistanceRandomWithRouteTable);
+
+/**
+ * @note Time and memory spent when loading the map to build the route table for the horizon in
+ * meters given as the argument.
+ */
+static void RouteTableBuild(benchmark::State & state)
+{
+  const auto lanelets = makeRouteTableLanelets();
+  std::size_t size = 0;
+  for (auto _ : state) {
+    const hdmap_utils::RouteTable table(lanelets, state.range(0));
+    size = table.size();
+  }
+  state.counters["lanelets"] = lanelets.size();
+  state.counters["pairs"] = size;
+}
+BENCHMARK(RouteTableBuild)->Arg(100)->Arg(500)->Arg(2000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,138 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <traffic_simulator/hdmap_utils/cache.hpp>
+#include <unordered_map>
+#include <vector>
+
+#include "../allocation_counter.hpp"
+
+namespace
+{
+constexpr std::int64_t key_count = 1000;
+
+/**
+ * @note A route of about 20 lanelets, which is the kind of value the caches hit most often.
+ */
+std::vector<std::int64_t> makeRoute(std::int64_t key) { return std::vector<std::int64_t>(20, key); }
+
+/**
+ * @note Same as the former RouteCache, kept here as the baseline : one mutex, a lookup for
+ * exists() and another one for getRoute(), which copies the value.
+ */
+class SingleMutexCache
+{
+public:
+  bool exists(std::int64_t key)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return data_.find(key) != data_.end();
+  }
+
+  std::vector<std::int64_t> get(std::int64_t key)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return data_.at(key);
+  }
+
+  void appendData(std::int64_t key, const std::vector<std::int64_t> & value)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    data_.emplace(key, value);
+  }
+
+private:
+  std::unordered_map<std::int64_t, std::vector<std::int64_t>> data_;
+
+  std::mutex mutex_;
+};
+
+SingleMutexCache single_mutex_cache;
+
+hdmap_utils::ShardedCache<std::int64_t, std::vector<std::int64_t>> sharded_cache;
+
+hdmap_utils::ShardedCache<std::int64_t, std::vector<std::int64_t>> bounded_sharded_cache(
+  key_count / 2);
+
+/**
+ * @note Each thread starts from another key so that the threads do not look up the same shard in
+ * lockstep. State::thread_index is not used because its type differs between the versions of
+ * google benchmark.
+ */
+std::int64_t getFirstKey()
+{
+  static std::atomic<std::int64_t> count{0};
+  return (count++ * 97) % key_count;
+}
+}  // namespace
+
+/**
+ * @brief Hits from several threads, like entities updated in parallel looking up their routes.
+ */
+static void SingleMutexCacheHit(benchmark::State & state)
+{
+  for (std::int64_t key = 0; key < key_count; ++key) {
+    single_mutex_cache.appendData(key, makeRoute(key));
+  }
+  std::int64_t key = getFirstKey();
+  const allocation_counter::Scope scope(state);
+  for (auto _ : state) {
+    if (single_mutex_cache.exists(key)) {
+      benchmark::DoNotOptimize(single_mutex_cache.get(key));
+    }
+    key = (key + 1) % key_count;
+  }
+}
+BENCHMARK(SingleMutexCacheHit)->ThreadRange(1, 8)->UseRealTime();
+
+static void ShardedCacheHit(benchmark::State & state)
+{
+  for (std::int64_t key = 0; key < key_count; ++key) {
+    sharded_cache.getOrCompute(key, [key]() { return makeRoute(key); });
+  }
+  std::int64_t key = getFirstKey();
+  const allocation_counter::Scope scope(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(sharded_cache.getOrCompute(key, [key]() { return makeRoute(key); }));
+    key = (key + 1) % key_count;
+  }
+}
+BENCHMARK(ShardedCacheHit)->ThreadRange(1, 8)->UseRealTime();
+
+/**
+ * @brief Same as ShardedCacheHit with half of the keys fitting in the cache, so that most lookups
+ * miss and evict another value.
+ */
+static void BoundedShardedCacheHitOrMiss(benchmark::State & state)
+{
+  std::int64_t key = getFirstKey();
+  const allocation_counter::Scope scope(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+      bounded_sharded_cache.getOrCompute(key, [key]() { return makeRoute(key); }));
+    key = (key + 1) % key_count;
+  }
+  const auto statistics = bounded_sharded_cache.statistics();
+  state.counters["hit_ratio"] = benchmark::Counter(
+    static_cast<double>(statistics.hits) / (statistics.hits + statistics.misses),
+    benchmark::Counter::kAvgThreads);
+}
+BENCHMARK(BoundedShardedCacheHitOrMiss)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK_MAIN();
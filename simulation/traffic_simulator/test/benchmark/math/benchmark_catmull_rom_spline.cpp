@@ -0,0 +1,144 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <random>
+#include <traffic_simulator/math/catmull_rom_spline.hpp>
+#include <vector>
+
+#include "../allocation_counter.hpp"
+
+namespace
+{
+std::vector<geometry_msgs::msg::Point> makeControlPoints(std::size_t size)
+{
+  std::vector<geometry_msgs::msg::Point> points;
+  for (std::size_t i = 0; i < size; ++i) {
+    geometry_msgs::msg::Point p;
+    p.x = 2.0 * i;
+    p.y = 10.0 * std::sin(0.05 * i);
+    points.emplace_back(p);
+  }
+  return points;
+}
+
+/**
+ * @note Squares of 4 m scattered around the spline, like the crosswalks and stop lines near the
+ * route of an entity. A few of them cross the spline.
+ */
+std::vector<std::vector<geometry_msgs::msg::Point>> makePolygons(
+  const traffic_simulator::math::CatmullRomSpline & spline, std::size_t size)
+{
+  std::mt19937 engine(0);
+  std::uniform_real_distribution<double> s_distribution(0, spline.getLength());
+  std::uniform_real_distribution<double> offset_distribution(-50, 50);
+  std::vector<std::vector<geometry_msgs::msg::Point>> polygons;
+  for (std::size_t i = 0; i < size; ++i) {
+    const auto center = spline.getPoint(s_distribution(engine), offset_distribution(engine));
+    std::vector<geometry_msgs::msg::Point> polygon;
+    for (const auto & corner : {std::make_pair(-2, -2), {2, -2}, {2, 2}, {-2, 2}}) {
+      geometry_msgs::msg::Point p;
+      p.x = center.x + corner.first;
+      p.y = center.y + corner.second;
+      polygon.emplace_back(p);
+    }
+    polygons.emplace_back(polygon);
+  }
+  return polygons;
+}
+}  // namespace
+
+static void CatmullRomSplineConstruct(benchmark::State & state)
+{
+  const auto points = makeControlPoints(state.range(0));
+  const allocation_counter::Scope scope(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(traffic_simulator::math::CatmullRomSpline(points));
+  }
+}
+BENCHMARK(CatmullRomSplineConstruct)->RangeMultiplier(10)->Range(10, 10000);
+
+static void CatmullRomSplineGetPoint(benchmark::State & state)
+{
+  const auto spline = traffic_simulator::math::CatmullRomSpline(makeControlPoints(state.range(0)));
+  const double step = spline.getLength() / 97.0;
+  double s = 0;
+  const allocation_counter::Scope scope(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(spline.getPoint(s));
+    s = std::fmod(s + step, spline.getLength());
+  }
+}
+BENCHMARK(CatmullRomSplineGetPoint)->RangeMultiplier(10)->Range(10, 10000);
+
+static void CatmullRomSplineGetPose(benchmark::State & state)
+{
+  const auto spline = traffic_simulator::math::CatmullRomSpline(makeControlPoints(state.range(0)));
+  const double step = spline.getLength() / 97.0;
+  double s = 0;
+  const allocation_counter::Scope scope(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(spline.getPose(s));
+    s = std::fmod(s + step, spline.getLength());
+  }
+}
+BENCHMARK(CatmullRomSplineGetPose)->RangeMultiplier(10)->Range(10, 10000);
+
+static void CatmullRomSplineGetTrajectory(benchmark::State & state)
+{
+  const auto spline = traffic_simulator::math::CatmullRomSpline(makeControlPoints(state.range(0)));
+  const double start_s = spline.getLength() * 0.5;
+  const allocation_counter::Scope scope(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(spline.getTrajectory(start_s, start_s + 100, 1.0));
+  }
+}
+BENCHMARK(CatmullRomSplineGetTrajectory)->RangeMultiplier(10)->Range(10, 10000);
+
+/**
+ * @brief Matching of a pose beside the spline, as in HdMapUtils::toLaneletPose.
+ */
+static void CatmullRomSplineGetSValue(benchmark::State & state)
+{
+  const auto spline = traffic_simulator::math::CatmullRomSpline(makeControlPoints(state.range(0)));
+  const double step = spline.getLength() / 97.0;
+  double s = 0;
+  const allocation_counter::Scope scope(state);
+  for (auto _ : state) {
+    auto pose = spline.getPose(s);
+    pose.position = spline.getPoint(s, 0.5);
+    benchmark::DoNotOptimize(spline.getSValue(pose, 1.0));
+    s = std::fmod(s + step, spline.getLength());
+  }
+}
+BENCHMARK(CatmullRomSplineGetSValue)->RangeMultiplier(10)->Range(10, 1000);
+
+/**
+ * @brief Collision points of a route with 100 polygons around it, as in
+ * HdMapUtils::getDistanceToStopLine.
+ */
+static void CatmullRomSplineGetCollisionPointsIn2D(benchmark::State & state)
+{
+  const auto spline = traffic_simulator::math::CatmullRomSpline(makeControlPoints(state.range(0)));
+  const auto polygons = makePolygons(spline, 100);
+  const allocation_counter::Scope scope(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(spline.getCollisionPointsIn2D(polygons));
+  }
+}
+BENCHMARK(CatmullRomSplineGetCollisionPointsIn2D)->RangeMultiplier(10)->Range(10, 1000);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,43 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <traffic_simulator/math/collision.hpp>
+
+#include "../allocation_counter.hpp"
+
+/**
+ * @brief Collision check of two rotated cars at the distance given by the argument in decimeters,
+ * which is a hit with 30 and a miss with 100.
+ */
+static void CheckCollision2D(benchmark::State & state)
+{
+  geometry_msgs::msg::Pose pose0, pose1;
+  pose1.position.x = state.range(0) * 0.1;
+  pose1.position.y = 0.5;
+  pose1.orientation.z = std::sin(0.2);
+  pose1.orientation.w = std::cos(0.2);
+  traffic_simulator_msgs::msg::BoundingBox bbox;
+  bbox.dimensions.x = 4.5;
+  bbox.dimensions.y = 2;
+  bbox.dimensions.z = 1.5;
+  const allocation_counter::Scope scope(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(traffic_simulator::math::checkCollision2D(pose0, bbox, pose1, bbox));
+  }
+}
+BENCHMARK(CheckCollision2D)->Arg(30)->Arg(100);
+
+BENCHMARK_MAIN();
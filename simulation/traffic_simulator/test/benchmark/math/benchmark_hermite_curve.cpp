@@ -0,0 +1,133 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <traffic_simulator/math/hermite_curve.hpp>
+#include <vector>
+
+#include "../allocation_counter.hpp"
+
+namespace
+{
+/**
+ * @note Curve of a lane change of 30 m to the left lane, like the ones built by
+ * HdMapUtils::getLaneChangeTrajectory.
+ */
+traffic_simulator::math::HermiteCurve makeCurve()
+{
+  geometry_msgs::msg::Pose start_pose, goal_pose;
+  goal_pose.position.x = 30;
+  goal_pose.position.y = 3;
+  geometry_msgs::msg::Vector3 start_vec, goal_vec;
+  start_vec.x = 30;
+  goal_vec.x = 30;
+  return traffic_simulator::math::HermiteCurve(start_pose, goal_pose, start_vec, goal_vec);
+}
+
+std::vector<geometry_msgs::msg::Point> makeBox(double x, double y)
+{
+  std::vector<geometry_msgs::msg::Point> polygon(4);
+  polygon[0].x = x - 2;
+  polygon[0].y = y - 1;
+  polygon[1].x = x + 2;
+  polygon[1].y = y - 1;
+  polygon[2].x = x + 2;
+  polygon[2].y = y + 1;
+  polygon[3].x = x - 2;
+  polygon[3].y = y + 1;
+  return polygon;
+}
+}  // namespace
+
+static void HermiteCurveConstruct(benchmark::State & state)
+{
+  geometry_msgs::msg::Pose start_pose, goal_pose;
+  goal_pose.position.x = 30;
+  goal_pose.position.y = 3;
+  geometry_msgs::msg::Vector3 start_vec, goal_vec;
+  start_vec.x = 30;
+  goal_vec.x = 30;
+  const allocation_counter::Scope scope(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+      traffic_simulator::math::HermiteCurve(start_pose, goal_pose, start_vec, goal_vec));
+  }
+}
+BENCHMARK(HermiteCurveConstruct);
+
+static void HermiteCurveGetPose(benchmark::State & state)
+{
+  const auto curve = makeCurve();
+  const double step = curve.getLength() / 97.0;
+  double s = 0;
+  const allocation_counter::Scope scope(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(curve.getPose(s, true));
+    s = std::fmod(s + step, curve.getLength());
+  }
+}
+BENCHMARK(HermiteCurveGetPose);
+
+static void HermiteCurveGetSValue(benchmark::State & state)
+{
+  const auto curve = makeCurve();
+  const double step = curve.getLength() / 97.0;
+  double s = 0;
+  const allocation_counter::Scope scope(state);
+  for (auto _ : state) {
+    auto pose = curve.getPose(s, true);
+    pose.position.y += 0.5;
+    benchmark::DoNotOptimize(curve.getSValue(pose, 3.0, true));
+    s = std::fmod(s + step, curve.getLength());
+  }
+}
+BENCHMARK(HermiteCurveGetSValue);
+
+static void HermiteCurveGetMaximum2DCurvature(benchmark::State & state)
+{
+  const auto curve = makeCurve();
+  const allocation_counter::Scope scope(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(curve.getMaximum2DCurvature());
+  }
+}
+BENCHMARK(HermiteCurveGetMaximum2DCurvature);
+
+/**
+ * @brief Collision of the curve with the polygon of an entity on it, or beside it if the argument
+ * is 0.
+ */
+static void HermiteCurveGetCollisionPointIn2D(benchmark::State & state)
+{
+  const auto curve = makeCurve();
+  const auto polygon = state.range(0) ? makeBox(15, 1.5) : makeBox(15, 10);
+  const allocation_counter::Scope scope(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(curve.getCollisionPointIn2D(polygon));
+  }
+}
+BENCHMARK(HermiteCurveGetCollisionPointIn2D)->Arg(0)->Arg(1);
+
+static void HermiteCurveGetTrajectory(benchmark::State & state)
+{
+  const auto curve = makeCurve();
+  const allocation_counter::Scope scope(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(curve.getTrajectory(0, curve.getLength(), 1.0, true));
+  }
+}
+BENCHMARK(HermiteCurveGetTrajectory);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,76 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <benchmark/benchmark.h>
+
+#include <traffic_simulator/math/polynomial_solver.hpp>
+
+#include "../allocation_counter.hpp"
+
+/**
+ * @note The coefficients are varied between iterations so that the solver cannot be specialized
+ * for one equation, and cover the cases of one and three real roots.
+ */
+static void PolynomialSolverSolveQuadraticEquation(benchmark::State & state)
+{
+  const traffic_simulator::math::PolynomialSolver solver;
+  double c = -1;
+  const allocation_counter::Scope scope(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(solver.solveQuadraticEquation(1, 0.5, c));
+    c = c < 1 ? c + 0.01 : -1;
+  }
+}
+BENCHMARK(PolynomialSolverSolveQuadraticEquation);
+
+static void PolynomialSolverSolveCubicEquation(benchmark::State & state)
+{
+  const traffic_simulator::math::PolynomialSolver solver;
+  double d = -1;
+  const allocation_counter::Scope scope(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(solver.solveCubicEquation(1, 0, -0.75, d));
+    d = d < 1 ? d + 0.01 : -1;
+  }
+}
+BENCHMARK(PolynomialSolverSolveCubicEquation);
+
+static void PolynomialSolverSolveCubicEquationWithoutNewtonPolish(benchmark::State & state)
+{
+  const traffic_simulator::math::PolynomialSolver solver(0);
+  double d = -1;
+  const allocation_counter::Scope scope(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(solver.solveCubicEquation(1, 0, -0.75, d));
+    d = d < 1 ? d + 0.01 : -1;
+  }
+}
+BENCHMARK(PolynomialSolverSolveCubicEquationWithoutNewtonPolish);
+
+/**
+ * @note Equations of nearly straight curves, whose leading coefficient is much smaller than the
+ * other ones.
+ */
+static void PolynomialSolverSolveCubicEquationWithSmallLeadingCoefficient(benchmark::State & state)
+{
+  const traffic_simulator::math::PolynomialSolver solver;
+  double d = 0;
+  const allocation_counter::Scope scope(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(solver.solveCubicEquation(1e-10, 1, -1, d));
+    d = d < 0.25 ? d + 0.001 : 0;
+  }
+}
+BENCHMARK(PolynomialSolverSolveCubicEquationWithSmallLeadingCoefficient);
+
+BENCHMARK_MAIN();
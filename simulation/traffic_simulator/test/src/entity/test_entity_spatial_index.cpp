@@ -0,0 +1,183 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <quaternion_operation/quaternion_operation.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <scenario_simulator_exception/exception.hpp>
+#include <string>
+#include <traffic_simulator/entity/entity_spatial_index.hpp>
+#include <traffic_simulator/math/bounding_box.hpp>
+#include <vector>
+
+namespace
+{
+/**
+ * @note Entities are scattered over a 200 m square around the origin with random headings, so
+ * footprints cross cell borders and negative coordinates are covered.
+ */
+std::shared_ptr<const traffic_simulator::entity::EntityStatusStore> makeStore(std::size_t size)
+{
+  std::mt19937 engine(0);
+  std::uniform_real_distribution<double> position(-100, 100);
+  std::uniform_real_distribution<double> yaw(-M_PI, M_PI);
+  std::uniform_int_distribution<std::int64_t> lanelet(0, 9);
+  auto store = std::make_shared<traffic_simulator::entity::EntityStatusStore>(1);
+  for (std::size_t i = 0; i < size; ++i) {
+    traffic_simulator_msgs::msg::EntityStatus status;
+    status.name = "npc" + std::to_string(i);
+    status.pose.position.x = position(engine);
+    status.pose.position.y = position(engine);
+    geometry_msgs::msg::Vector3 rpy;
+    rpy.z = yaw(engine);
+    status.pose.orientation = quaternion_operation::convertEulerAngleToQuaternion(rpy);
+    status.bounding_box.center.x = 1.5;
+    status.bounding_box.dimensions.x = i % 10 == 0 ? 12 : 4.5;
+    status.bounding_box.dimensions.y = 2.1;
+    status.lanelet_pose.lanelet_id = lanelet(engine);
+    status.lanelet_pose_valid = i % 7 != 0;
+    store->emplace(status);
+  }
+  return store;
+}
+
+bool overlaps(
+  const traffic_simulator::entity::EntityStatusStore & store, std::size_t index, double min_x,
+  double min_y, double max_x, double max_y)
+{
+  const auto & pose = store.getPose(index);
+  auto points = traffic_simulator::math::transformPoints(
+    pose, traffic_simulator::math::getPointsFromBbox(store.getBoundingBox(index)));
+  points.emplace_back(pose.position);
+  const auto x = std::minmax_element(
+    points.begin(), points.end(), [](const auto & a, const auto & b) { return a.x < b.x; });
+  const auto y = std::minmax_element(
+    points.begin(), points.end(), [](const auto & a, const auto & b) { return a.y < b.y; });
+  return x.first->x <= max_x && min_x <= x.second->x && y.first->y <= max_y && min_y <= y.second->y;
+}
+}  // namespace
+
+TEST(EntitySpatialIndex, QueryEqualsLinearScan)
+{
+  const auto store = makeStore(1000);
+  const traffic_simulator::entity::EntitySpatialIndex index(store, 10);
+  std::mt19937 engine(1);
+  std::uniform_real_distribution<double> position(-120, 120);
+  std::uniform_real_distribution<double> size(0, 50);
+  for (int i = 0; i < 100; ++i) {
+    const double min_x = position(engine);
+    const double min_y = position(engine);
+    const double max_x = min_x + size(engine);
+    const double max_y = min_y + size(engine);
+    std::vector<std::size_t> expected;
+    for (std::size_t j = 0; j < store->size(); ++j) {
+      if (overlaps(*store, j, min_x, min_y, max_x, max_y)) {
+        expected.emplace_back(j);
+      }
+    }
+    EXPECT_EQ(index.query(min_x, min_y, max_x, max_y), expected);
+  }
+}
+
+TEST(EntitySpatialIndex, QueryLargeBox)
+{
+  const auto store = makeStore(50);
+  const traffic_simulator::entity::EntitySpatialIndex index(store, 1);
+  EXPECT_EQ(index.query(-1e3, -1e3, 1e3, 1e3).size(), store->size());
+}
+
+TEST(EntitySpatialIndex, OversizedEntity)
+{
+  auto store = std::make_shared<traffic_simulator::entity::EntityStatusStore>(1);
+  traffic_simulator_msgs::msg::EntityStatus status;
+  status.pose.orientation.w = 1;
+  status.bounding_box.dimensions.x = 4.5;
+  status.bounding_box.dimensions.y = 2.1;
+  for (int i = 0; i < 100; ++i) {
+    status.name = "npc" + std::to_string(i);
+    status.pose.position.x = 8.0 * i;
+    status.pose.position.y = 100;
+    store->emplace(status);
+  }
+  status.name = "long";
+  status.pose.position.x = 0;
+  status.pose.position.y = 0;
+  status.bounding_box.dimensions.x = 1000;
+  status.bounding_box.dimensions.y = 2;
+  store->emplace(status);
+  const traffic_simulator::entity::EntitySpatialIndex index(store, 1);
+  EXPECT_EQ(index.query(400, -1, 401, 1), std::vector<std::size_t>({100}));
+  EXPECT_TRUE(index.query(401, 10, 402, 11).empty());
+}
+
+TEST(EntitySpatialIndex, EntitiesOnLanelet)
+{
+  const auto store = makeStore(300);
+  const traffic_simulator::entity::EntitySpatialIndex index(store);
+  for (std::int64_t lanelet_id = 0; lanelet_id < 11; ++lanelet_id) {
+    std::vector<std::size_t> expected;
+    for (std::size_t j = 0; j < store->size(); ++j) {
+      if (store->getLaneletPose(j).lanelet_id == lanelet_id) {
+        expected.emplace_back(j);
+      }
+    }
+    EXPECT_EQ(index.getEntitiesOnLanelet(lanelet_id), expected);
+  }
+}
+
+TEST(EntitySpatialIndex, InvalidCellSize)
+{
+  EXPECT_THROW(
+    traffic_simulator::entity::EntitySpatialIndex(makeStore(1), 0), common::SimulationError);
+}
+
+TEST(EntityStatusView, SpatialIndexEqualsLinearScan)
+{
+  const auto store = makeStore(300);
+  const auto index = std::make_shared<const traffic_simulator::entity::EntitySpatialIndex>(store);
+  for (std::size_t i = 0; i < store->size(); ++i) {
+    const traffic_simulator::entity::EntityStatusView expected(
+      store, store->getName(i), store->getPose(i).position, 30);
+    const traffic_simulator::entity::EntityStatusView actual(
+      index, store->getName(i), store->getPose(i).position, 30);
+    EXPECT_EQ(actual.frame(), expected.frame());
+    ASSERT_EQ(actual.size(), expected.size());
+    for (std::size_t j = 0; j < expected.size(); ++j) {
+      EXPECT_EQ(actual.getName(j), expected.getName(j));
+    }
+  }
+}
+
+TEST(EntityStatusView, FindIndex)
+{
+  const auto store = makeStore(300);
+  const auto index = std::make_shared<const traffic_simulator::entity::EntitySpatialIndex>(store);
+  const traffic_simulator::entity::EntityStatusView view(
+    index, store->getName(0), store->getPose(0).position, 30);
+  EXPECT_FALSE(view.findIndex(0));
+  for (std::size_t j = 0; j < view.size(); ++j) {
+    const auto found = view.findIndex(store->find(view.getName(j)).get());
+    ASSERT_TRUE(found);
+    EXPECT_EQ(found.get(), j);
+  }
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,112 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <scenario_simulator_exception/exception.hpp>
+#include <string>
+#include <traffic_simulator/entity/entity_status_store.hpp>
+
+#include "../expect_eq_macros.hpp"
+
+namespace
+{
+traffic_simulator_msgs::msg::EntityStatus makeStatus(const std::string & name, double x)
+{
+  traffic_simulator_msgs::msg::EntityStatus status;
+  status.name = name;
+  status.time = 1.5;
+  status.pose.position.x = x;
+  status.action_status.twist.linear.x = x * 0.1;
+  status.action_status.accel.linear.x = -x;
+  status.action_status.current_action = "follow_lane";
+  status.lanelet_pose.lanelet_id = 34513;
+  status.lanelet_pose.s = x;
+  status.lanelet_pose_valid = x >= 0;
+  status.bounding_box.dimensions.x = 4.0;
+  return status;
+}
+
+std::shared_ptr<const traffic_simulator::entity::EntityStatusStore> makeStore()
+{
+  auto store = std::make_shared<traffic_simulator::entity::EntityStatusStore>(3);
+  store->emplace(makeStatus("ego", 0));
+  store->emplace(makeStatus("near", 10));
+  store->emplace(makeStatus("far", 100));
+  store->emplace(makeStatus("behind", -20));
+  return store;
+}
+}  // namespace
+
+TEST(EntityStatusStore, GetStatus)
+{
+  const auto store = makeStore();
+  EXPECT_EQ(store->frame(), static_cast<std::uint64_t>(3));
+  EXPECT_EQ(store->size(), static_cast<std::size_t>(4));
+  EXPECT_FALSE(store->find("unknown"));
+  const auto index = store->find("near");
+  ASSERT_TRUE(index);
+  const auto expected = makeStatus("near", 10);
+  const auto status = store->getStatus(index.get());
+  EXPECT_STREQ(status.name.c_str(), expected.name.c_str());
+  EXPECT_DOUBLE_EQ(status.time, expected.time);
+  EXPECT_POSE_EQ(status.pose, expected.pose);
+  EXPECT_ACTION_STATUS_EQ(status.action_status, expected.action_status);
+  EXPECT_LANELET_POSE_EQ(status.lanelet_pose, expected.lanelet_pose);
+  EXPECT_EQ(status.lanelet_pose_valid, expected.lanelet_pose_valid);
+  EXPECT_DOUBLE_EQ(status.bounding_box.dimensions.x, expected.bounding_box.dimensions.x);
+  EXPECT_FALSE(store->laneletPoseValid(store->find("behind").get()));
+}
+
+TEST(EntityStatusStore, EmplaceTwice)
+{
+  traffic_simulator::entity::EntityStatusStore store;
+  store.emplace(makeStatus("ego", 0));
+  EXPECT_THROW(store.emplace(makeStatus("ego", 1)), common::SimulationError);
+}
+
+TEST(EntityStatusView, FilterSelfAndRange)
+{
+  const auto store = makeStore();
+  const traffic_simulator::entity::EntityStatusView view(
+    store, "ego", makeStatus("ego", 0).pose.position, 30);
+  EXPECT_EQ(view.frame(), store->frame());
+  EXPECT_EQ(view.size(), static_cast<std::size_t>(2));
+  EXPECT_FALSE(view.contains("ego"));
+  EXPECT_FALSE(view.contains("far"));
+  EXPECT_FALSE(view.contains("unknown"));
+  ASSERT_TRUE(view.contains("near"));
+  ASSERT_TRUE(view.contains("behind"));
+  const auto near = view.find("near").get();
+  EXPECT_STREQ(view.getName(near).c_str(), "near");
+  EXPECT_TWIST_EQ(view.getTwist(near), makeStatus("near", 10).action_status.twist);
+  EXPECT_ACCEL_EQ(view.getAccel(near), makeStatus("near", 10).action_status.accel);
+  EXPECT_TRUE(view.getStatus("near"));
+  EXPECT_FALSE(view.getStatus("far"));
+}
+
+TEST(EntityStatusView, Empty)
+{
+  const traffic_simulator::entity::EntityStatusView view;
+  EXPECT_TRUE(view.empty());
+  EXPECT_EQ(view.frame(), static_cast<std::uint64_t>(0));
+  EXPECT_FALSE(view.find("ego"));
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -14,6 +14,10 @@
 
 #include <gtest/gtest.h>
 
+#include <quaternion_operation/quaternion_operation.h>
+
+#include <algorithm>
+#include <random>
 #include <scenario_simulator_exception/exception.hpp>
 #include <traffic_simulator/math/catmull_rom_spline.hpp>
 
@@ -183,6 +187,166 @@ TEST(CatmullRomSpline, CheckThrowingErrorWhenTheControlPointisAreNotEnough)
     common::SemanticError);
 }
 
+TEST(CatmullRomSpline, GetLengthAlongCurvedControlPoints)
+{
+  std::vector<geometry_msgs::msg::Point> points;
+  for (int i = 0; i <= 60; ++i) {
+    geometry_msgs::msg::Point p;
+    p.x = 50 * std::cos(i * 0.05) + 0.1 * i * i;
+    p.y = 50 * std::sin(i * 0.05);
+    points.emplace_back(p);
+  }
+  auto spline = traffic_simulator::math::CatmullRomSpline(points);
+  const auto trajectory = spline.getTrajectory(0, spline.getLength(), 0.001);
+  double length = 0;
+  for (size_t i = 1; i < trajectory.size(); ++i) {
+    const auto & point = trajectory[i];
+    const auto & previous = trajectory[i - 1];
+    length = length + std::hypot(point.x - previous.x, point.y - previous.y);
+  }
+  EXPECT_NEAR(spline.getLength(), length, 1e-2);
+  for (double s = 0.3; s < spline.getLength(); s = s + 1.37) {
+    const auto s_value = spline.getSValue(spline.getPose(s));
+    ASSERT_TRUE(s_value);
+    EXPECT_NEAR(s_value.get(), s, 1e-6);
+  }
+  /**
+   * @note Points at equal steps of s are equally spaced along the spline, also inside a curve whose
+   * speed varies.
+   */
+  for (double s = 0; s + 1 < spline.getLength(); s = s + 1) {
+    const auto point = spline.getPoint(s);
+    const auto next = spline.getPoint(s + 1);
+    EXPECT_NEAR(std::hypot(next.x - point.x, next.y - point.y), 1, 1e-3) << "s = " << s;
+  }
+}
+
+/**
+ * @note getSValue skips the curves whose bounding box does not overlap the line of the pose, so the
+ * result is compared with the first crossing of the line found by sampling the whole spline.
+ */
+TEST(CatmullRomSpline, GetSValueAlongCurvedControlPoints)
+{
+  std::vector<geometry_msgs::msg::Point> points;
+  for (int i = 0; i <= 60; ++i) {
+    geometry_msgs::msg::Point p;
+    p.x = 2.0 * i;
+    p.y = 10 * std::sin(i * 0.2);
+    points.emplace_back(p);
+  }
+  auto spline = traffic_simulator::math::CatmullRomSpline(points);
+  constexpr double threshold_distance = 3.0;
+  constexpr double resolution = 0.001;
+  std::mt19937 engine(0);
+  std::uniform_real_distribution<double> s_distribution(0, spline.getLength());
+  std::uniform_real_distribution<double> offset_distribution(-4, 4);
+  std::uniform_real_distribution<double> yaw_distribution(-0.5, 0.5);
+  for (int i = 0; i < 200; ++i) {
+    const auto s = s_distribution(engine);
+    auto pose = spline.getPose(s);
+    const auto offset = offset_distribution(engine);
+    pose.position = spline.getPoint(s, offset);
+    auto rpy = quaternion_operation::convertQuaternionToEulerAngle(pose.orientation);
+    rpy.z = rpy.z + yaw_distribution(engine);
+    pose.orientation = quaternion_operation::convertEulerAngleToQuaternion(rpy);
+    const double yaw = rpy.z;
+    const double normal_x = -std::sin(yaw);
+    const double normal_y = std::cos(yaw);
+    boost::optional<double> expected;
+    double previous_side = 0;
+    for (double t = 0; t <= spline.getLength(); t = t + resolution) {
+      const auto point = spline.getPoint(t);
+      const double dx = point.x - pose.position.x;
+      const double dy = point.y - pose.position.y;
+      const double side = dx * normal_y - dy * normal_x;
+      if (
+        t > 0 && (previous_side < 0) != (side < 0) &&
+        std::fabs(dx * normal_x + dy * normal_y) <= threshold_distance) {
+        expected = t;
+        break;
+      }
+      previous_side = side;
+    }
+    const auto actual = spline.getSValue(pose, threshold_distance);
+    /**
+     * @note Crossings at the very end of the line may be found by only one of them.
+     */
+    if (std::fabs(offset) < 2) {
+      ASSERT_EQ(static_cast<bool>(expected), static_cast<bool>(actual)) << "s = " << s;
+    }
+    if (expected && actual) {
+      EXPECT_NEAR(actual.get(), expected.get(), 0.01) << "s = " << s;
+    }
+  }
+}
+
+/**
+ * @note getCollisionPointIn2D skips the curves and edges whose bounding boxes do not overlap, so
+ * the result is compared with the collision points of every edge of the polygon.
+ */
+TEST(CatmullRomSpline, GetCollisionPointIn2DWithRandomPolygons)
+{
+  std::vector<geometry_msgs::msg::Point> points;
+  for (int i = 0; i <= 60; ++i) {
+    geometry_msgs::msg::Point p;
+    p.x = 2.0 * i;
+    p.y = 10 * std::sin(i * 0.2);
+    points.emplace_back(p);
+  }
+  auto spline = traffic_simulator::math::CatmullRomSpline(points);
+  const auto box = spline.get2DBoundingBox();
+  for (double s = 0; s < spline.getLength(); s = s + 0.1) {
+    const auto point = spline.getPoint(s);
+    EXPECT_LE(box.first.x, point.x);
+    EXPECT_LE(box.first.y, point.y);
+    EXPECT_GE(box.second.x, point.x);
+    EXPECT_GE(box.second.y, point.y);
+  }
+  std::mt19937 engine(0);
+  std::uniform_real_distribution<double> x_distribution(-10, 130);
+  std::uniform_real_distribution<double> y_distribution(-15, 15);
+  std::uniform_real_distribution<double> size_distribution(-4, 4);
+  std::vector<std::vector<geometry_msgs::msg::Point>> polygons;
+  for (int i = 0; i < 500; ++i) {
+    geometry_msgs::msg::Point center;
+    center.x = x_distribution(engine);
+    center.y = y_distribution(engine);
+    std::vector<geometry_msgs::msg::Point> polygon;
+    for (int j = 0; j < 2 + i % 4; ++j) {
+      geometry_msgs::msg::Point p;
+      p.x = center.x + size_distribution(engine);
+      p.y = center.y + size_distribution(engine);
+      polygon.emplace_back(p);
+    }
+    polygons.emplace_back(polygon);
+  }
+  for (const bool search_backward : {false, true}) {
+    const auto collision_points = spline.getCollisionPointsIn2D(polygons, search_backward);
+    ASSERT_EQ(collision_points.size(), polygons.size());
+    for (std::size_t i = 0; i < polygons.size(); ++i) {
+      const auto & polygon = polygons[i];
+      std::vector<double> s_values;
+      for (std::size_t j = 0; j < polygon.size(); ++j) {
+        const auto s = spline.getCollisionPointIn2D(
+          polygon[j], polygon[(j + 1) % polygon.size()], search_backward);
+        if (s) {
+          s_values.emplace_back(s.get());
+        }
+      }
+      const auto actual = spline.getCollisionPointIn2D(polygon, search_backward);
+      ASSERT_EQ(!s_values.empty(), static_cast<bool>(actual)) << i;
+      ASSERT_EQ(static_cast<bool>(actual), static_cast<bool>(collision_points[i])) << i;
+      if (actual) {
+        EXPECT_DOUBLE_EQ(
+          actual.get(), search_backward ? *std::max_element(s_values.begin(), s_values.end())
+                                        : *std::min_element(s_values.begin(), s_values.end()))
+          << i;
+        EXPECT_DOUBLE_EQ(actual.get(), collision_points[i].get()) << i;
+      }
+    }
+  }
+}
+
 int main(int argc, char ** argv)
 {
   testing::InitGoogleTest(&argc, argv);
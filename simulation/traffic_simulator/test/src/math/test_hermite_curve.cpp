@@ -14,6 +14,7 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
 #include <traffic_simulator/math/hermite_curve.hpp>
 
 TEST(HermiteCurveTest, CheckCollisionToLine)
@@ -161,6 +162,130 @@ TEST(HermiteCurveTest, CheckNormalVector)
   }
 }
 
+TEST(HermiteCurveTest, GetLength)
+{
+  {  //p(0,0) v(1,0)-> p(1,1) v(0,1)
+    geometry_msgs::msg::Pose start_pose, goal_pose;
+    geometry_msgs::msg::Vector3 start_vec, goal_vec;
+    goal_pose.position.x = 1;
+    goal_pose.position.y = 1;
+    start_vec.x = 1;
+    goal_vec.y = 1;
+    traffic_simulator::math::HermiteCurve curve(start_pose, goal_pose, start_vec, goal_vec);
+    EXPECT_NEAR(curve.getLength(), curve.getLength(10000), 1e-6);
+    EXPECT_NEAR(curve.getLength(), curve.getLength(100), 1e-4);
+  }
+  {  // the curve turns back and has a cusp, p(0,0) v(-5,0)-> p(1,0) v(-5,0)
+    geometry_msgs::msg::Pose start_pose, goal_pose;
+    geometry_msgs::msg::Vector3 start_vec, goal_vec;
+    goal_pose.position.x = 1;
+    start_vec.x = -5;
+    goal_vec.x = -5;
+    traffic_simulator::math::HermiteCurve curve(start_pose, goal_pose, start_vec, goal_vec);
+    EXPECT_NEAR(curve.getLength(), curve.getLength(10000), 1e-6);
+  }
+}
+
+TEST(HermiteCurveTest, GetParameter)
+{
+  geometry_msgs::msg::Pose start_pose, goal_pose;
+  geometry_msgs::msg::Vector3 start_vec, goal_vec;
+  goal_pose.position.x = 10;
+  goal_pose.position.y = 5;
+  start_vec.x = 20;
+  goal_vec.y = 10;
+  traffic_simulator::math::HermiteCurve curve(start_pose, goal_pose, start_vec, goal_vec);
+  EXPECT_DOUBLE_EQ(curve.getParameter(0), 0);
+  EXPECT_DOUBLE_EQ(curve.getParameter(curve.getLength()), 1);
+  EXPECT_DOUBLE_EQ(curve.getArcLength(1), curve.getLength());
+  for (double s = 0; s <= curve.getLength(); s = s + 0.5) {
+    const auto t = curve.getParameter(s);
+    EXPECT_GE(t, 0);
+    EXPECT_LE(t, 1);
+    EXPECT_NEAR(curve.getArcLength(t), s, 1e-8);
+  }
+}
+
+TEST(HermiteCurveTest, Get2DBoundingBox)
+{
+  geometry_msgs::msg::Pose start_pose, goal_pose;
+  geometry_msgs::msg::Vector3 start_vec, goal_vec;
+  {  // the curve turns back and has a cusp, p(0,0) v(-5,0)-> p(1,0) v(-5,0)
+    goal_pose.position.x = 1;
+    start_vec.x = -5;
+    goal_vec.x = -5;
+    traffic_simulator::math::HermiteCurve curve(start_pose, goal_pose, start_vec, goal_vec);
+    const auto box = curve.get2DBoundingBox();
+    for (double t = 0; t <= 1; t = t + 0.001) {
+      const auto point = curve.getPoint(t, false);
+      EXPECT_LE(box.first.x, point.x);
+      EXPECT_LE(point.x, box.second.x);
+      EXPECT_LE(box.first.y, point.y);
+      EXPECT_LE(point.y, box.second.y);
+    }
+    EXPECT_DOUBLE_EQ(box.first.y, 0);
+    EXPECT_DOUBLE_EQ(box.second.y, 0);
+  }
+  {  // p(0,0) v(20,0)-> p(10,5) v(0,10)
+    goal_pose.position.x = 10;
+    goal_pose.position.y = 5;
+    start_vec.x = 20;
+    goal_vec.x = 0;
+    goal_vec.y = 10;
+    traffic_simulator::math::HermiteCurve curve(start_pose, goal_pose, start_vec, goal_vec);
+    const auto box = curve.get2DBoundingBox();
+    for (double t = 0; t <= 1; t = t + 0.001) {
+      const auto point = curve.getPoint(t, false);
+      EXPECT_LE(box.first.x, point.x);
+      EXPECT_LE(point.x, box.second.x);
+      EXPECT_LE(box.first.y, point.y);
+      EXPECT_LE(point.y, box.second.y);
+    }
+    EXPECT_DOUBLE_EQ(box.first.x, 0);
+    EXPECT_DOUBLE_EQ(box.first.y, 0);
+  }
+}
+
+/**
+ * @note With autoscale, s is the arc length along the curve and is mapped to the curve parameter by
+ * getParameter. At both ends of the curve it gives the same result as the former s / getLength().
+ */
+TEST(HermiteCurveTest, AutoscaleByArcLength)
+{
+  geometry_msgs::msg::Pose start_pose, goal_pose;
+  geometry_msgs::msg::Vector3 start_vec, goal_vec;
+  goal_pose.position.x = 10;
+  goal_pose.position.y = 5;
+  start_vec.x = 20;
+  goal_vec.y = 10;
+  traffic_simulator::math::HermiteCurve curve(start_pose, goal_pose, start_vec, goal_vec);
+  EXPECT_DOUBLE_EQ(curve.getPoint(0, true).x, curve.getPoint(0, false).x);
+  EXPECT_DOUBLE_EQ(curve.getPoint(0, true).y, curve.getPoint(0, false).y);
+  EXPECT_DOUBLE_EQ(curve.getPoint(curve.getLength(), true).x, curve.getPoint(1, false).x);
+  EXPECT_DOUBLE_EQ(curve.getPoint(curve.getLength(), true).y, curve.getPoint(1, false).y);
+  for (double s = 0.25; s < curve.getLength(); s = s + 0.5) {
+    const auto t = curve.getParameter(s);
+    EXPECT_DOUBLE_EQ(curve.getPoint(s, true).x, curve.getPoint(t, false).x);
+    EXPECT_DOUBLE_EQ(curve.getPoint(s, true).y, curve.getPoint(t, false).y);
+    EXPECT_DOUBLE_EQ(curve.getPose(s, true).orientation.z, curve.getPose(t, false).orientation.z);
+    EXPECT_DOUBLE_EQ(curve.getTangentVector(s, true).x, curve.getTangentVector(t, false).x);
+    EXPECT_DOUBLE_EQ(curve.getNormalVector(s, true).y, curve.getNormalVector(t, false).y);
+    EXPECT_DOUBLE_EQ(curve.get2DCurvature(s, true), curve.get2DCurvature(t, false));
+    constexpr std::size_t num_points = 10000;
+    double length = 0;
+    auto previous = curve.getPoint(0, false);
+    for (std::size_t i = 1; i <= num_points; ++i) {
+      const auto point = curve.getPoint(t * i / num_points, false);
+      length = length + std::hypot(point.x - previous.x, point.y - previous.y);
+      previous = point;
+    }
+    EXPECT_NEAR(length, s, 1e-4);
+    const auto s_value = curve.getSValue(curve.getPose(s, true), 3.0, true);
+    ASSERT_TRUE(s_value);
+    EXPECT_NEAR(s_value.get(), s, 1e-6);
+  }
+}
+
 int main(int argc, char ** argv)
 {
   testing::InitGoogleTest(&argc, argv);
@@ -14,9 +14,12 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
 #include <scenario_simulator_exception/exception.hpp>
 #include <traffic_simulator/math/hermite_curve.hpp>
 #include <traffic_simulator/math/polynomial_solver.hpp>
+#include <vector>
 
 bool checkValueWithTolerance(double value, double expected, double tolerance)
 {
@@ -100,6 +103,73 @@ TEST(PolynomialSolverTest, SolveCubicEquation)
   }
 }
 
+/**
+ * @note The leading coefficient is small but not negligible, like for a nearly straight
+ * HermiteCurve, so the other coefficients are divided by it in the closed form.
+ */
+TEST(PolynomialSolverTest, SolveCubicEquationWithSmallLeadingCoefficient)
+{
+  const double a = 1e-10;
+  const double b = 1;
+  const double c = -1;
+  const double d = 0.21;
+  traffic_simulator::math::PolynomialSolver solver;
+  traffic_simulator::math::PolynomialSolver solver_without_polish(0);
+  const auto ret = solver.solveCubicEquation(a, b, c, d);
+  const auto ret_without_polish = solver_without_polish.solveCubicEquation(a, b, c, d);
+  ASSERT_EQ(ret.size(), 2U);
+  ASSERT_EQ(ret_without_polish.size(), 2U);
+  for (std::size_t i = 0; i < ret.size(); ++i) {
+    EXPECT_NEAR(ret[i], i == 0 ? 0.3 : 0.7, 1e-9);
+    EXPECT_NEAR(solver.cubicFunction(a, b, c, d, ret[i]), 0, 1e-15);
+    EXPECT_LE(
+      std::fabs(solver.cubicFunction(a, b, c, d, ret[i])),
+      std::fabs(solver.cubicFunction(a, b, c, d, ret_without_polish[i])));
+  }
+  const auto all_roots = solver.solveCubicEquation(a, b, c, d, -1e11, 1e11);
+  ASSERT_EQ(all_roots.size(), 3U);
+  EXPECT_NEAR(*std::min_element(all_roots.begin(), all_roots.end()), -1e10 - 1, 1e-3);
+}
+
+TEST(PolynomialSolverTest, SolveQuadraticEquationWithCancellation)
+{
+  traffic_simulator::math::PolynomialSolver solver;
+  const auto ret = solver.solveQuadraticEquation(1, -1e8, 1);
+  ASSERT_EQ(ret.size(), 1U);
+  EXPECT_NEAR(ret[0], 1e-8, 1e-22);
+}
+
+TEST(PolynomialSolverTest, SolveCubicEquationWithTripleRoot)
+{
+  traffic_simulator::math::PolynomialSolver solver;
+  const auto ret = solver.solveCubicEquation(1, -1.5, 0.75, -0.125);
+  ASSERT_FALSE(ret.empty());
+  for (const auto solution : ret) {
+    EXPECT_NEAR(solution, 0.5, 1e-5);
+  }
+}
+
+TEST(PolynomialSolverTest, SolveCubicEquationWithCloseRoots)
+{
+  /**
+   * @note (t - 0.3) * (t - 0.300001) * (t - 2)
+   */
+  const double r0 = 0.3;
+  const double r1 = 0.300001;
+  const double r2 = 2;
+  for (const double scale : {1e-6, 1.0, 1e6}) {
+    traffic_simulator::math::PolynomialSolver solver;
+    auto ret = solver.solveCubicEquation(
+      scale, -scale * (r0 + r1 + r2), scale * (r0 * r1 + r1 * r2 + r2 * r0),
+      -scale * r0 * r1 * r2);
+    ASSERT_EQ(ret.size(), 2U) << scale;
+    std::vector<double> solutions(ret.begin(), ret.end());
+    std::sort(solutions.begin(), solutions.end());
+    EXPECT_NEAR(solutions[0], r0, 1e-9) << scale;
+    EXPECT_NEAR(solutions[1], r1, 1e-9) << scale;
+  }
+}
+
 int main(int argc, char ** argv)
 {
   testing::InitGoogleTest(&argc, argv);
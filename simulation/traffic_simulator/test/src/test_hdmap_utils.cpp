@@ -14,9 +14,11 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <ament_index_cpp/get_package_share_directory.hpp>
 #include <string>
 #include <traffic_simulator/hdmap_utils/hdmap_utils.hpp>
+#include <traffic_simulator/hdmap_utils/precompiled_map.hpp>
 #include <traffic_simulator/helper/helper.hpp>
 
 TEST(HdMapUtils, Construct)
@@ -98,6 +100,120 @@ TEST(HdMapUtils, AlongLaneletPose)
     hdmap_utils.getLaneletLength(34684) - 10.0);
 }
 
+TEST(HdMapUtils, ToLaneletPoseOnAllLanelets)
+{
+  std::string path =
+    ament_index_cpp::get_package_share_directory("traffic_simulator") + "/map/lanelet2_map.osm";
+  geographic_msgs::msg::GeoPoint origin;
+  origin.latitude = 35.61836750154;
+  origin.longitude = 139.78066608243;
+  hdmap_utils::HdMapUtils hdmap_utils(path, origin);
+  for (const auto lanelet_id : hdmap_utils.getLaneletIds()) {
+    const auto length = hdmap_utils.getLaneletLength(lanelet_id);
+    for (double s = 0.5; s < length - 0.5; s = s + 2.0) {
+      for (const double offset : {-0.5, 0.0, 0.5}) {
+        const auto pose = hdmap_utils.toMapPose(lanelet_id, s, offset).pose;
+        const auto lanelet_pose = hdmap_utils.toLaneletPose(pose, lanelet_id);
+        ASSERT_TRUE(lanelet_pose) << lanelet_id << " " << s << " " << offset;
+        EXPECT_EQ(lanelet_pose->lanelet_id, lanelet_id);
+        EXPECT_NEAR(lanelet_pose->s, s, 1e-3) << lanelet_id;
+        EXPECT_NEAR(lanelet_pose->offset, offset, 1e-3) << lanelet_id;
+      }
+    }
+  }
+}
+
+TEST(HdMapUtils, PrecompiledMap)
+{
+  std::string path =
+    ament_index_cpp::get_package_share_directory("traffic_simulator") + "/map/lanelet2_map.osm";
+  geographic_msgs::msg::GeoPoint origin;
+  origin.latitude = 35.61836750154;
+  origin.longitude = 139.78066608243;
+  const auto cache_directory =
+    boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+  hdmap_utils::HdMapUtils fresh(path, origin);
+  hdmap_utils::HdMapUtils miss(path, origin, cache_directory);
+  EXPECT_TRUE(boost::filesystem::exists(
+    hdmap_utils::PrecompiledMapCache(cache_directory)
+      .entryPath(hdmap_utils::PrecompiledMapCache::hash(path))));
+  hdmap_utils::HdMapUtils hit(path, origin, cache_directory);
+  EXPECT_EQ(fresh.getLaneletIds(), hit.getLaneletIds());
+  EXPECT_EQ(fresh.getRoute(34684, 34510), hit.getRoute(34684, 34510));
+  EXPECT_EQ(fresh.getRoute(34513, 34510), hit.getRoute(34513, 34510));
+  for (const auto id : fresh.getLaneletIds()) {
+    const auto expected = fresh.getCenterPoints(id);
+    const auto actual = hit.getCenterPoints(id);
+    ASSERT_EQ(expected.size(), actual.size());
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+      EXPECT_DOUBLE_EQ(expected[i].x, actual[i].x);
+      EXPECT_DOUBLE_EQ(expected[i].y, actual[i].y);
+      EXPECT_DOUBLE_EQ(expected[i].z, actual[i].z);
+    }
+  }
+  for (const auto id : {120659, 34411, 34513}) {
+    const auto pose = fresh.toMapPose(id, 1, 0.5).pose;
+    const auto expected = fresh.toLaneletPose(pose, false);
+    const auto actual = hit.toLaneletPose(pose, false);
+    ASSERT_TRUE(expected);
+    ASSERT_TRUE(actual);
+    EXPECT_EQ(expected->lanelet_id, actual->lanelet_id);
+    EXPECT_DOUBLE_EQ(expected->s, actual->s);
+    EXPECT_DOUBLE_EQ(expected->offset, actual->offset);
+  }
+  boost::filesystem::remove_all(cache_directory);
+}
+
+/**
+ * @note Routes and distances between lanelets within the horizon are looked up in the route table,
+ * and the others are searched in the routing graph like without the table.
+ */
+TEST(HdMapUtils, RouteTable)
+{
+  std::string path =
+    ament_index_cpp::get_package_share_directory("traffic_simulator") + "/map/lanelet2_map.osm";
+  geographic_msgs::msg::GeoPoint origin;
+  origin.latitude = 35.61836750154;
+  origin.longitude = 139.78066608243;
+  hdmap_utils::HdMapUtils expected(path, origin);
+  hdmap_utils::HdMapUtils actual(path, origin, "", 0, 100);
+  ASSERT_TRUE(actual.getRouteTable());
+  EXPECT_FALSE(expected.getRouteTable());
+  std::size_t in_table = 0;
+  for (const auto from : expected.getLaneletIds()) {
+    for (const auto to : expected.getLaneletIds()) {
+      const auto expected_distance = expected.getLongitudinalDistance(from, 0.5, to, 0.5);
+      const auto actual_distance = actual.getLongitudinalDistance(from, 0.5, to, 0.5);
+      ASSERT_EQ(static_cast<bool>(expected_distance), static_cast<bool>(actual_distance))
+        << from << " " << to;
+      if (!expected_distance) {
+        continue;
+      }
+      EXPECT_NEAR(expected_distance.get(), actual_distance.get(), 1e-6) << from << " " << to;
+      if (from == to || !actual.getRouteTable()->getDistance(from, to)) {
+        EXPECT_EQ(expected.getRoute(from, to), actual.getRoute(from, to)) << from << " " << to;
+        continue;
+      }
+      ++in_table;
+      const auto route = actual.getRoute(from, to);
+      ASSERT_GE(route.size(), 2U);
+      EXPECT_EQ(route.front(), from);
+      EXPECT_EQ(route.back(), to);
+      double length = 0;
+      for (std::size_t i = 1; i < route.size(); ++i) {
+        const auto next = actual.getNextLaneletIds(route[i - 1]);
+        EXPECT_NE(std::find(next.begin(), next.end(), route[i]), next.end()) << from << " " << to;
+        if (i + 1 < route.size()) {
+          length = length + actual.getLaneletLength(route[i]);
+        }
+      }
+      EXPECT_LE(length, 100 + 1e-6);
+      EXPECT_NEAR(actual.getRouteTable()->getDistance(from, to).get(), length, 1e-6);
+    }
+  }
+  EXPECT_GT(in_table, 0U);
+}
+
 int main(int argc, char ** argv)
 {
   testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,125 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <traffic_simulator/hdmap_utils/cache.hpp>
+#include <vector>
+
+TEST(ShardedCache, ComputeOnlyOnMiss)
+{
+  hdmap_utils::ShardedCache<std::int64_t, std::string> cache;
+  int computed = 0;
+  const auto compute = [&]() {
+    ++computed;
+    return std::string("value");
+  };
+  const auto first = cache.getOrCompute(1, compute);
+  const auto second = cache.getOrCompute(1, compute);
+  EXPECT_EQ(computed, 1);
+  EXPECT_EQ(*first, "value");
+  EXPECT_EQ(first, second);
+  EXPECT_EQ(cache.find(1), first);
+  EXPECT_EQ(cache.find(2), nullptr);
+  const auto statistics = cache.statistics();
+  EXPECT_EQ(statistics.hits, 1U);
+  EXPECT_EQ(statistics.misses, 1U);
+  EXPECT_EQ(statistics.evictions, 0U);
+  EXPECT_EQ(statistics.size, 1U);
+}
+
+TEST(ShardedCache, EvictLeastRecentlyUsed)
+{
+  hdmap_utils::ShardedCache<std::int64_t, std::int64_t> cache(2, 1);
+  const auto identity = [](std::int64_t key) { return [key]() { return key; }; };
+  const auto one = cache.getOrCompute(1, identity(1));
+  cache.getOrCompute(2, identity(2));
+  cache.getOrCompute(1, identity(1));
+  cache.getOrCompute(3, identity(3));
+  EXPECT_NE(cache.find(1), nullptr);
+  EXPECT_EQ(cache.find(2), nullptr);
+  EXPECT_NE(cache.find(3), nullptr);
+  cache.getOrCompute(4, identity(4));
+  EXPECT_EQ(cache.find(1), nullptr);
+  EXPECT_EQ(*one, 1);
+  const auto statistics = cache.statistics();
+  EXPECT_EQ(statistics.evictions, 2U);
+  EXPECT_EQ(statistics.size, 2U);
+}
+
+TEST(ShardedCache, UnboundedByDefault)
+{
+  hdmap_utils::ShardedCache<std::int64_t, std::int64_t> cache;
+  for (std::int64_t key = 0; key < 10000; ++key) {
+    cache.getOrCompute(key, [key]() { return key; });
+  }
+  EXPECT_EQ(cache.statistics().size, 10000U);
+  EXPECT_EQ(cache.statistics().evictions, 0U);
+}
+
+TEST(ShardedCache, CapacityOverAllShards)
+{
+  hdmap_utils::ShardedCache<std::int64_t, std::int64_t> cache(64, 4);
+  for (std::int64_t key = 0; key < 10000; ++key) {
+    cache.getOrCompute(key, [key]() { return key; });
+  }
+  EXPECT_LE(cache.statistics().size, 64U);
+  EXPECT_EQ(cache.statistics().size + cache.statistics().evictions, 10000U);
+}
+
+TEST(ShardedCache, DoNotCacheExceptions)
+{
+  hdmap_utils::ShardedCache<std::int64_t, std::int64_t> cache;
+  EXPECT_THROW(
+    cache.getOrCompute(1, []() -> std::int64_t { throw std::runtime_error("no lanelet"); }),
+    std::runtime_error);
+  EXPECT_EQ(cache.find(1), nullptr);
+  EXPECT_EQ(*cache.getOrCompute(1, []() { return std::int64_t(1); }), 1);
+}
+
+TEST(ShardedCache, ConcurrentAccess)
+{
+  hdmap_utils::ShardedCache<std::int64_t, std::vector<std::int64_t>> cache(256);
+  std::atomic<int> errors{0};
+  std::vector<std::thread> threads;
+  for (int thread = 0; thread < 8; ++thread) {
+    threads.emplace_back([&, thread]() {
+      for (std::int64_t i = 0; i < 20000; ++i) {
+        const std::int64_t key = (i * (thread + 1)) % 1000;
+        const auto value = cache.getOrCompute(key, [key]() {
+          return std::vector<std::int64_t>(4, key);
+        });
+        if (value->size() != 4 || value->front() != key) {
+          ++errors;
+        }
+      }
+    });
+  }
+  for (auto & thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(errors, 0);
+  const auto statistics = cache.statistics();
+  EXPECT_EQ(statistics.hits + statistics.misses, 8U * 20000U);
+  EXPECT_LE(statistics.size, 256U);
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,81 @@
+// Copyright 2015-2020 Tier IV, Inc. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <scenario_simulator_exception/exception.hpp>
+#include <traffic_simulator/hdmap_utils/route_table.hpp>
+#include <vector>
+
+/**
+ * @note 1 -> 2 -> 3 -> 5 and 1 -> 4 -> 5 with a longer lanelet 4, then 5 -> 6 -> 1 back to the
+ * start.
+ */
+std::vector<hdmap_utils::RouteTable::Lanelet> makeLanelets()
+{
+  return {
+    {1, 10, {2, 4}}, {2, 5, {3}}, {3, 5, {5}}, {4, 30, {5}}, {5, 20, {6}}, {6, 40, {1}},
+  };
+}
+
+TEST(RouteTable, ShortestRoute)
+{
+  const hdmap_utils::RouteTable table(makeLanelets(), 1000);
+  EXPECT_EQ(table.getRoute(1, 5), std::vector<std::int64_t>({1, 2, 3, 5}));
+  ASSERT_TRUE(table.getDistance(1, 5));
+  EXPECT_DOUBLE_EQ(table.getDistance(1, 5).get(), 10);
+  EXPECT_EQ(table.getRoute(4, 2), std::vector<std::int64_t>({4, 5, 6, 1, 2}));
+  EXPECT_DOUBLE_EQ(table.getDistance(4, 2).get(), 70);
+}
+
+TEST(RouteTable, AdjacentLanelets)
+{
+  const hdmap_utils::RouteTable table(makeLanelets(), 0);
+  EXPECT_EQ(table.getRoute(1, 4), std::vector<std::int64_t>({1, 4}));
+  EXPECT_DOUBLE_EQ(table.getDistance(1, 4).get(), 0);
+  EXPECT_FALSE(table.getDistance(1, 3));
+  EXPECT_EQ(table.size(), 7U);
+}
+
+TEST(RouteTable, Horizon)
+{
+  const hdmap_utils::RouteTable table(makeLanelets(), 30);
+  EXPECT_DOUBLE_EQ(table.getDistance(1, 5).get(), 10);
+  EXPECT_DOUBLE_EQ(table.getDistance(1, 6).get(), 30);
+  EXPECT_FALSE(table.getDistance(1, 1));
+  EXPECT_FALSE(table.getDistance(5, 2));
+  EXPECT_TRUE(table.getRoute(5, 2).empty());
+  EXPECT_EQ(table.getRoute(2, 6), std::vector<std::int64_t>({2, 3, 5, 6}));
+}
+
+TEST(RouteTable, UnknownLanelet)
+{
+  const hdmap_utils::RouteTable table(makeLanelets(), 1000);
+  EXPECT_FALSE(table.getDistance(1, 7));
+  EXPECT_FALSE(table.getDistance(7, 1));
+  EXPECT_TRUE(table.getRoute(7, 1).empty());
+}
+
+TEST(RouteTable, InvalidArguments)
+{
+  EXPECT_THROW(hdmap_utils::RouteTable(makeLanelets(), -1), common::SimulationError);
+  EXPECT_THROW(
+    hdmap_utils::RouteTable({{1, 10, {}}, {1, 10, {}}}, 100), common::SimulationError);
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -57,37 +57,61 @@ def default_autoware_launch_file_of(architecture_type):
 def launch_setup(context, *args, **kwargs):
     # fmt: off
     architecture_type       = LaunchConfiguration("architecture_type",       default="awf/universe")
+    async_sensor_update     = LaunchConfiguration("async_sensor_update",     default=False)
     autoware_launch_file    = LaunchConfiguration("autoware_launch_file",    default=default_autoware_launch_file_of(architecture_type.perform(context)))
     autoware_launch_package = LaunchConfiguration("autoware_launch_package", default=default_autoware_launch_package_of(architecture_type.perform(context)))
+    cache_conditions        = LaunchConfiguration("cache_conditions",        default=False)
+    combine_frame_requests  = LaunchConfiguration("combine_frame_requests",  default=False)
+    entity_status_delta     = LaunchConfiguration("entity_status_delta",     default=False)
     global_frame_rate       = LaunchConfiguration("global_frame_rate",       default=30.0)
     global_real_time_factor = LaunchConfiguration("global_real_time_factor", default=1.0)
     global_timeout          = LaunchConfiguration("global_timeout",          default=180)
+    hdmap_cache_capacity    = LaunchConfiguration("hdmap_cache_capacity",    default=0)
     initialize_duration     = LaunchConfiguration("initialize_duration",     default=30)
     launch_autoware         = LaunchConfiguration("launch_autoware",         default=True)
     launch_rviz             = LaunchConfiguration("launch_rviz",             default=False)
+    npc_update_threads      = LaunchConfiguration("npc_update_threads",      default=1)
     output_directory        = LaunchConfiguration("output_directory",        default=Path("/tmp"))
     port                    = LaunchConfiguration("port",                    default=8080)
+    precompiled_map_path    = LaunchConfiguration("precompiled_map_path",    default="")
+    raycast_threads         = LaunchConfiguration("raycast_threads",         default=1)
     record                  = LaunchConfiguration("record",                  default=True)
+    route_table_horizon     = LaunchConfiguration("route_table_horizon",     default=0.0)
     scenario                = LaunchConfiguration("scenario",                default=Path("/dev/null"))
     sensor_model            = LaunchConfiguration("sensor_model",            default="")
+    sensor_update_threads   = LaunchConfiguration("sensor_update_threads",   default=1)
+    transport_protocol      = LaunchConfiguration("transport_protocol",      default="tcp")
+    use_loaned_messages     = LaunchConfiguration("use_loaned_messages",     default=False)
     vehicle_model           = LaunchConfiguration("vehicle_model",           default="")
     workflow                = LaunchConfiguration("workflow",                default=Path("/dev/null"))
     # fmt: on
 
     print(f"architecture_type       := {architecture_type.perform(context)}")
+    print(f"async_sensor_update     := {async_sensor_update.perform(context)}")
     print(f"autoware_launch_file    := {autoware_launch_file.perform(context)}")
     print(f"autoware_launch_package := {autoware_launch_package.perform(context)}")
+    print(f"cache_conditions        := {cache_conditions.perform(context)}")
+    print(f"combine_frame_requests  := {combine_frame_requests.perform(context)}")
+    print(f"entity_status_delta     := {entity_status_delta.perform(context)}")
     print(f"global_frame_rate       := {global_frame_rate.perform(context)}")
     print(f"global_real_time_factor := {global_real_time_factor.perform(context)}")
     print(f"global_timeout          := {global_timeout.perform(context)}")
+    print(f"hdmap_cache_capacity    := {hdmap_cache_capacity.perform(context)}")
     print(f"initialize_duration     := {initialize_duration.perform(context)}")
     print(f"launch_autoware         := {launch_autoware.perform(context)}")
     print(f"launch_rviz             := {launch_rviz.perform(context)}")
+    print(f"npc_update_threads      := {npc_update_threads.perform(context)}")
     print(f"output_directory        := {output_directory.perform(context)}")
     print(f"port                    := {port.perform(context)}")
+    print(f"precompiled_map_path    := {precompiled_map_path.perform(context)}")
+    print(f"raycast_threads         := {raycast_threads.perform(context)}")
     print(f"record                  := {record.perform(context)}")
+    print(f"route_table_horizon     := {route_table_horizon.perform(context)}")
     print(f"scenario                := {scenario.perform(context)}")
     print(f"sensor_model            := {sensor_model.perform(context)}")
+    print(f"sensor_update_threads   := {sensor_update_threads.perform(context)}")
+    print(f"transport_protocol      := {transport_protocol.perform(context)}")
+    print(f"use_loaned_messages     := {use_loaned_messages.perform(context)}")
     print(f"vehicle_model           := {vehicle_model.perform(context)}")
     print(f"workflow                := {workflow.perform(context)}")
 
@@ -96,11 +120,19 @@ def launch_setup(context, *args, **kwargs):
             {"architecture_type": architecture_type},
             {"autoware_launch_file": autoware_launch_file},
             {"autoware_launch_package": autoware_launch_package},
+            {"cache_conditions": cache_conditions},
+            {"combine_frame_requests": combine_frame_requests},
+            {"entity_status_delta": entity_status_delta},
+            {"hdmap_cache_capacity": hdmap_cache_capacity},
             {"initialize_duration": initialize_duration},
             {"launch_autoware": launch_autoware},
+            {"npc_update_threads": npc_update_threads},
             {"port": port},
+            {"precompiled_map_path": precompiled_map_path},
             {"record": record},
+            {"route_table_horizon": route_table_horizon},
             {"sensor_model": sensor_model},
+            {"transport_protocol": transport_protocol},
             {"vehicle_model": vehicle_model},
         ]
 
@@ -118,16 +150,28 @@ def launch_setup(context, *args, **kwargs):
     return [
         # fmt: off
         DeclareLaunchArgument("architecture_type",       default_value=architecture_type      ),
+        DeclareLaunchArgument("async_sensor_update",     default_value=async_sensor_update    ),
         DeclareLaunchArgument("autoware_launch_file",    default_value=autoware_launch_file   ),
         DeclareLaunchArgument("autoware_launch_package", default_value=autoware_launch_package),
+        DeclareLaunchArgument("cache_conditions",        default_value=cache_conditions       ),
+        DeclareLaunchArgument("combine_frame_requests",  default_value=combine_frame_requests ),
+        DeclareLaunchArgument("entity_status_delta",     default_value=entity_status_delta    ),
         DeclareLaunchArgument("global_frame_rate",       default_value=global_frame_rate      ),
         DeclareLaunchArgument("global_real_time_factor", default_value=global_real_time_factor),
         DeclareLaunchArgument("global_timeout",          default_value=global_timeout         ),
+        DeclareLaunchArgument("hdmap_cache_capacity",    default_value=hdmap_cache_capacity   ),
         DeclareLaunchArgument("launch_autoware",         default_value=launch_autoware        ),
         DeclareLaunchArgument("launch_rviz",             default_value=launch_rviz            ),
+        DeclareLaunchArgument("npc_update_threads",      default_value=npc_update_threads     ),
         DeclareLaunchArgument("output_directory",        default_value=output_directory       ),
+        DeclareLaunchArgument("precompiled_map_path",    default_value=precompiled_map_path   ),
+        DeclareLaunchArgument("raycast_threads",         default_value=raycast_threads        ),
+        DeclareLaunchArgument("route_table_horizon",     default_value=route_table_horizon    ),
         DeclareLaunchArgument("scenario",                default_value=scenario               ),
         DeclareLaunchArgument("sensor_model",            default_value=sensor_model           ),
+        DeclareLaunchArgument("sensor_update_threads",   default_value=sensor_update_threads  ),
+        DeclareLaunchArgument("transport_protocol",      default_value=transport_protocol     ),
+        DeclareLaunchArgument("use_loaned_messages",     default_value=use_loaned_messages    ),
         DeclareLaunchArgument("vehicle_model",           default_value=vehicle_model          ),
         DeclareLaunchArgument("workflow",                default_value=workflow               ),
         # fmt: on
@@ -155,7 +199,14 @@ def launch_setup(context, *args, **kwargs):
             namespace="simulation",
             name="simple_sensor_simulator",
             output="screen",
-            parameters=[{"port": port}],
+            parameters=[
+                {"async_sensor_update": async_sensor_update},
+                {"port": port},
+                {"raycast_threads": raycast_threads},
+                {"sensor_update_threads": sensor_update_threads},
+                {"transport_protocol": transport_protocol},
+                {"use_loaned_messages": use_loaned_messages},
+            ],
         ),
         LifecycleNode(
             package="openscenario_interpreter",